@@ -77,23 +77,16 @@ function syncDuplicateState(sourceNode) {
 
 /**
  * Called by C++ when panel opens to report Python addon status
- * Controls whether Complex Build button is available
+ * Shows whether the optional Python addon (LLM tree options) is available
  */
 window.onPythonAddonStatus = function(statusStr) {
     var installed = (statusStr === 'true');
     state.pythonAddonInstalled = installed;
     console.log('[SpellLearning] Python addon (SpellTreeBuilder) installed:', installed);
     
+    // Complex Build runs on the native C++ tree builder - the Python addon only adds LLM options.
+    // The button stays disabled until spells are scanned (the scan callback enables it).
     var buildTreeBtn = document.getElementById('visualFirstBtn');
-    if (buildTreeBtn) {
-        if (!installed) {
-            // Gray out Complex Build button if Python addon not installed
-            buildTreeBtn.disabled = true;
-            buildTreeBtn.title = 'Requires Python Addon - Install HeartOfMagic_PythonAddon to enable Complex Build';
-        }
-        // Note: Button stays disabled until spells are scanned even if addon is installed
-        // The scan callback handles enabling it when both conditions are met
-    }
     
     // Update the description text to show addon status
     var genModeRow = buildTreeBtn ? buildTreeBtn.closest('.gen-mode-row') : null;
@@ -101,11 +94,11 @@ window.onPythonAddonStatus = function(statusStr) {
         var consSpan = genModeRow.querySelector('.gen-mode-cons');
         if (consSpan) {
             if (installed) {
-                consSpan.textContent = 'Requires Python (addon installed)';
+                consSpan.textContent = 'Python addon installed (LLM options available)';
                 consSpan.style.color = '#22c55e';  // Green
             } else {
-                consSpan.textContent = 'Requires Python Addon (not installed)';
-                consSpan.style.color = '#ef4444';  // Red
+                consSpan.textContent = 'LLM options need the Python addon';
+                consSpan.style.color = '#f59e0b';  // Amber
             }
         }
     }
@@ -144,16 +137,10 @@ window.updateSpellData = function(jsonStr) {
         }
         
         // Enable BUILD TREE buttons after successful scan
-        // Complex Build (visualFirstBtn) only enabled if Python addon is installed
+        // Complex Build (visualFirstBtn) uses the native tree builder, Python addon is optional
         var buildTreeBtn = document.getElementById('visualFirstBtn');
         if (buildTreeBtn && data.spells && data.spells.length > 0) {
-            if (state.pythonAddonInstalled) {
-                buildTreeBtn.disabled = false;
-            } else {
-                // Keep disabled and update tooltip
-                buildTreeBtn.disabled = true;
-                buildTreeBtn.title = 'Requires Python Addon - Install HeartOfMagic_PythonAddon to enable Complex Build';
-            }
+            buildTreeBtn.disabled = false;
         }
         
         // Simple Build (proceduralBtn) always enabled when spells are available
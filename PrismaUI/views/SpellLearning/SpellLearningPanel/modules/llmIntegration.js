@@ -66,62 +66,15 @@ function checkLLMAvailability() {
 }
 
 /**
- * Send a correction request to the LLM with info about unreachable nodes
- * The LLM will attempt to fix the tree structure while preserving intent
+ * Send a correction request to the LLM with info about unreachable nodes.
+ * C++ (TreeRepair) finds the invalid region of the tree - cycles, orphans,
+ * dangling prerequisites and missing spells - sends only that region to the
+ * LLM and splices the answer back, so the rest of the tree stays unchanged.
  */
 function sendCorrectionRequest(schoolName, originalResponse, reachabilityInfo) {
     console.log('[SpellLearning] Sending correction request for ' + schoolName);
-    
-    // Build a detailed description of the issues
-    var issuesList = reachabilityInfo.unreachable.map(function(node) {
-        var blocking = node.blockingPrereqs.length > 0 
-            ? ' (blocked by unreachable prereqs: ' + node.blockingPrereqs.join(', ') + ')'
-            : ' (has no path to root)';
-        return '- ' + node.formId + ' "' + node.name + '" tier ' + node.tier + blocking;
-    }).join('\n');
-    
-    var correctionPrompt = 'Your previous response had ' + reachabilityInfo.unreachable.length + ' unreachable spells out of ' + reachabilityInfo.total + ' total.\n\n' +
-        '## UNREACHABLE NODES\n' + issuesList + '\n\n' +
-        '## WHAT WENT WRONG\n' +
-        'These spells cannot be unlocked because their prerequisites form cycles or reference other unreachable spells.\n' +
-        'Remember: Every spell must have a valid path from root. If spell A requires spell B, then B must be reachable from root.\n\n' +
-        '## YOUR TASK\n' +
-        'Fix ONLY the prerequisites of the unreachable spells. Keep all other spells unchanged.\n' +
-        'Options for each unreachable spell:\n' +
-        '1. Change its prerequisites to point to REACHABLE spells of lower tier\n' +
-        '2. Remove one or more blocking prerequisites\n' +
-        '3. Add an additional prerequisite to a reachable spell (for convergence)\n\n' +
-        '## YOUR PREVIOUS RESPONSE\n' + originalResponse + '\n\n' +
-        '## CORRECTED OUTPUT\n' +
-        'Return the COMPLETE corrected JSON (same format as before). Only modify the unreachable nodes\' prerequisites.';
-    
-    // Get prompt rules
-    var promptRules = '';
-    if (typeof getTreeRulesPrompt === 'function') {
-        promptRules = getTreeRulesPrompt();
-    }
-    
-    // Prepare request with correction flag
-    var request = {
-        school: schoolName,
-        spellData: '', // Not needed for correction
-        promptRules: promptRules,
-        model: state.llmConfig.model || 'anthropic/claude-sonnet-4',
-        maxTokens: state.llmConfig.maxTokens || 4096,
-        apiKey: state.llmConfig.apiKey,
-        // Mark as correction request
-        isCorrection: true,
-        correctionPrompt: correctionPrompt,
-        // Settings
-        allowMultiplePrereqs: settings.allowLLMMultiplePrereqs,
-        aggressiveValidation: settings.aggressivePathValidation
-    };
-    
-    appendToOutput('>>> CORRECTION: ' + schoolName + ' (fixing ' + reachabilityInfo.unreachable.length + ' nodes)');
-    
-    if (window.callCpp) {
-        window.callCpp('LLMGenerate', JSON.stringify(request));
-    }
+    sendTreeRepairRequest(schoolName, originalResponse,
+        'fixing ' + reachabilityInfo.unreachable.length + ' unreachable nodes');
 }
 
 /**
@@ -133,45 +86,39 @@ function sendCorrectionRequest(schoolName, originalResponse, reachabilityInfo) {
  */
 function sendMissingSpellsCorrectionRequest(schoolName, originalResponse, missingSpells, totalExpected) {
     console.log('[SpellLearning] Sending missing spells correction for ' + schoolName + ' (' + missingSpells.length + ' missing)');
-    
-    // Build list of missing spells with their details
-    var missingList = missingSpells.map(function(spell) {
-        return '- ' + spell.formId + ' "' + spell.name + '" (' + spell.skillLevel + ')';
-    }).join('\n');
-    
-    var correctionPrompt = 'Your previous response for ' + schoolName + ' included only ' + 
-        (totalExpected - missingSpells.length) + ' out of ' + totalExpected + ' spells.\n\n' +
-        '## CRITICAL: ' + missingSpells.length + ' SPELLS ARE MISSING\n\n' +
-        'These spells from the input were NOT included in your output:\n' + missingList + '\n\n' +
-        '## YOUR TASK\n' +
-        'You MUST include ALL spells. Return the COMPLETE corrected JSON with ALL ' + totalExpected + ' spells.\n' +
-        'Add the missing spells to appropriate locations in the tree based on their skill level:\n' +
-        '- Novice spells: tier 1-2, can branch from root or other Novice\n' +
-        '- Apprentice spells: tier 2-3, require Novice prereqs\n' +
-        '- Adept spells: tier 3-4, require Apprentice prereqs\n' +
-        '- Expert spells: tier 4-5, require Adept prereqs\n' +
-        '- Master spells: tier 5-6, require Expert prereqs\n\n' +
-        '## MISSING SPELL DATA (for reference)\n' +
-        JSON.stringify(missingSpells, null, 2) + '\n\n' +
-        '## YOUR PREVIOUS (INCOMPLETE) RESPONSE\n' + originalResponse + '\n\n' +
-        '## CORRECTED OUTPUT\n' +
-        'Return the COMPLETE JSON with ALL ' + totalExpected + ' spells included.';
-    
-    // Prepare request
+    sendTreeRepairRequest(schoolName, originalResponse,
+        'adding ' + missingSpells.length + ' of ' + totalExpected + ' spells');
+}
+
+/**
+ * Repair request for the current school's tree (see sendCorrectionRequest)
+ * @param {string} schoolName - Name of the school
+ * @param {string} originalResponse - The tree JSON to repair
+ * @param {string} description - What is being fixed, for the output log
+ */
+function sendTreeRepairRequest(schoolName, originalResponse, description) {
     var request = {
         school: schoolName,
-        spellData: '', // Not needed for correction
+        spellData: JSON.stringify(state.llmCurrentSpells || []), // Missing spells are found against this
         promptRules: typeof getTreeRulesPrompt === 'function' ? getTreeRulesPrompt() : '',
         model: state.llmConfig.model || 'anthropic/claude-sonnet-4',
-        maxTokens: state.llmConfig.maxTokens || 64000,
+        maxTokens: state.llmConfig.maxTokens || 4096,
         apiKey: state.llmConfig.apiKey,
-        isCorrection: true,
-        correctionPrompt: correctionPrompt,
+        // Mark as repair request
+        isRepair: true,
+        originalResponse: originalResponse,
+        // Settings
         allowMultiplePrereqs: settings.allowLLMMultiplePrereqs,
-        aggressiveValidation: settings.aggressivePathValidation
+        aggressiveValidation: settings.aggressivePathValidation,
+        bypassCache: !settings.llmResponseCache
     };
     
-    appendToOutput('>>> CORRECTION: ' + schoolName + ' (adding ' + missingSpells.length + ' missing spells)');
+    appendToOutput('>>> CORRECTION: ' + schoolName + ' (' + description + ')');
+    
+    // The school stays in flight until the corrected tree arrives
+    if (state.llmInFlight && state.llmInFlight[schoolName]) {
+        state.llmInFlight[schoolName].awaitingCorrection = true;
+    }
     
     if (window.callCpp) {
         window.callCpp('LLMGenerate', JSON.stringify(request));
@@ -567,24 +514,41 @@ function startLLMAutoGenerate() {
     processNextLLMSchool();
 }
 
+/**
+ * Send every queued school at once - C++ runs them in parallel up to its
+ * concurrency limit (maxConcurrentRequests) and queues the rest
+ */
 function processNextLLMSchool() {
+    state.llmInFlight = state.llmInFlight || {};
+    
     if (state.llmQueue.length === 0) {
-        // All done
-        finishLLMGeneration();
+        // All done once the last in-flight school has reported back (several
+        // schools can finish close together - only the first one finishes)
+        if (state.llmGenerating && Object.keys(state.llmInFlight).length === 0) {
+            finishLLMGeneration();
+        }
         return;
     }
     
-    var schoolData = state.llmQueue.shift();
-    state.llmCurrentSchool = schoolData.school;
-    
-    // Track expected spell IDs for validation after response
-    state.llmExpectedSpellIds = schoolData.spells.map(function(s) { return s.formId; });
-    state.llmExpectedSpellCount = schoolData.spells.length;
-    state.llmCurrentSpells = schoolData.spells; // Keep full spell data for correction requests
+    while (state.llmQueue.length > 0) {
+        sendLLMSchoolRequest(state.llmQueue.shift());
+    }
+}
+
+function sendLLMSchoolRequest(schoolData) {
+    // Per-school state, restored by onLLMPollResult when this school's result arrives
+    state.llmInFlight[schoolData.school] = {
+        spells: schoolData.spells, // Keep full spell data for correction requests
+        expectedSpellIds: schoolData.spells.map(function(s) { return s.formId; }),
+        retryCount: schoolData.retryCount || 0,
+        correctionCount: 0,
+        missingCorrectionCount: 0,
+        awaitingCorrection: false
+    };
     
-    var step = state.llmStats.successSchools.length + state.llmStats.failedSchools.length + 1;
-    var remaining = state.llmQueue.length;
-    var total = step + remaining;
+    var inFlight = Object.keys(state.llmInFlight).length;
+    var step = state.llmStats.successSchools.length + state.llmStats.failedSchools.length + inFlight;
+    var total = step + state.llmQueue.length;
     
     var progressMsg = 'Generating ' + schoolData.school + ' (' + schoolData.spells.length + ' spells)...';
     
@@ -615,7 +579,9 @@ function processNextLLMSchool() {
         aggressiveValidation: settings.aggressivePathValidation,
         // LLM self-correction settings
         selfCorrection: settings.llmSelfCorrection,
-        selfCorrectionMaxLoops: settings.llmSelfCorrectionMaxLoops
+        selfCorrectionMaxLoops: settings.llmSelfCorrectionMaxLoops,
+        // A retry must not be answered with the same cached response
+        bypassCache: !settings.llmResponseCache || (schoolData.retryCount || 0) > 0
     };
     
     console.log('[SpellLearning] Generating ' + schoolData.school + ' with model:', request.model, 'maxTokens:', request.maxTokens);
@@ -640,6 +606,13 @@ window.onLLMQueued = function(responseStr) {
     
     console.log('[SpellLearning] LLM request queued parsed:', response);
     setTreeStatus(response.school + ': ' + response.message);
+    if (response.prompt) {
+        var p = response.prompt;
+        appendToOutput('    Prompt: ' + (p.jsonBytes / 1024).toFixed(1) + ' KB -> ' + (p.compactBytes / 1024).toFixed(1) +
+            ' KB (~' + p.jsonTokens + ' -> ~' + p.compactTokens + ' tokens), ' + p.parts + ' part(s)');
+    }
+    state.llmStreamedNodes = state.llmStreamedNodes || {};
+    delete state.llmStreamedNodes[response.school];
     
     // Start polling for response
     if (state.llmPollInterval) {
@@ -653,6 +626,29 @@ window.onLLMQueued = function(responseStr) {
     }, 2000); // Poll every 2 seconds
 };
 
+/**
+ * Batch of tree nodes parsed from a streaming LLM response (arrives before onLLMPollResult)
+ */
+window.onLLMStreamNodes = function(batchStr) {
+    var batch;
+    try {
+        batch = typeof batchStr === 'string' ? JSON.parse(batchStr) : batchStr;
+    } catch (e) {
+        console.error('[SpellLearning] Failed to parse streamed nodes:', e);
+        return;
+    }
+    if (!batch || !batch.nodes || batch.nodes.length === 0) return;
+    
+    state.llmStreamedNodes = state.llmStreamedNodes || {};
+    var isFirst = !state.llmStreamedNodes[batch.school];
+    state.llmStreamedNodes[batch.school] = (state.llmStreamedNodes[batch.school] || []).concat(batch.nodes);
+    
+    if (isFirst) {
+        appendToOutput('    Streaming: first nodes received');
+    }
+    setTreeStatus(batch.school + ': receiving... ' + batch.received + ' spells');
+};
+
 window.onLLMPollResult = function(resultStr) {
     var result;
     try {
@@ -672,16 +668,10 @@ window.onLLMPollResult = function(resultStr) {
         state.llmPollInterval = null;
     }
     
-    console.log('[SpellLearning] Got LLM response, success=' + result.success + ', currentSchool=' + state.llmCurrentSchool);
-    
-    // Ignore stray responses when not expecting any
-    if (!state.llmCurrentSchool) {
-        console.warn('[SpellLearning] Received response but no current school - ignoring stray response');
-        return;
-    }
+    console.log('[SpellLearning] Got LLM response, success=' + result.success + ', school=' + (result.school || state.llmCurrentSchool));
     
     // Check if this is a color suggestion response
-    if (state.llmCurrentSchool === '_ColorSuggestion') {
+    if ((result.school || state.llmCurrentSchool) === '_ColorSuggestion') {
         console.log('[SpellLearning] Routing to color suggestion handler');
         if (typeof handleColorSuggestionResponse === 'function') {
             handleColorSuggestionResponse(result);
@@ -692,6 +682,126 @@ window.onLLMPollResult = function(resultStr) {
         return;
     }
     
+    // Legacy file-polled responses carry no school and belong to llmCurrentSchool
+    var ctx = null;
+    if (result.school) {
+        ctx = state.llmInFlight && state.llmInFlight[result.school];
+        if (!ctx) {
+            console.warn('[SpellLearning] Received response for ' + result.school + ' which is not in flight - ignoring stray response');
+            return;
+        }
+        restoreLLMSchoolContext(result.school, ctx);
+    } else if (!state.llmCurrentSchool) {
+        // Ignore stray responses when not expecting any
+        console.warn('[SpellLearning] Received response but no current school - ignoring stray response');
+        return;
+    }
+    
+    if (result.metrics) {
+        state.llmStats.promptTokens = (state.llmStats.promptTokens || 0) + (result.metrics.promptTokens || 0);
+        state.llmStats.completionTokens = (state.llmStats.completionTokens || 0) + (result.metrics.completionTokens || 0);
+    }
+    
+    if (result.cancelled) {
+        handleLLMCancelled(result);
+        return;
+    }
+    
+    if (ctx) ctx.awaitingCorrection = false;
+    handleLLMSchoolResult(result);
+    
+    // Keep the school's counters while a correction is pending, otherwise it is done
+    if (ctx) {
+        if (ctx.awaitingCorrection) {
+            ctx.retryCount = state.llmRetryCount || 0;
+            ctx.correctionCount = state.llmCorrectionCount || 0;
+            ctx.missingCorrectionCount = state.llmMissingCorrectionCount || 0;
+        } else {
+            delete state.llmInFlight[result.school];
+        }
+    }
+};
+
+/**
+ * Make a school's in-flight state current for the result handler below
+ */
+function restoreLLMSchoolContext(school, ctx) {
+    state.llmCurrentSchool = school;
+    state.llmCurrentSpells = ctx.spells;
+    state.llmExpectedSpellIds = ctx.expectedSpellIds;
+    state.llmExpectedSpellCount = ctx.spells.length;
+    state.llmRetryCount = ctx.retryCount;
+    state.llmCorrectionCount = ctx.correctionCount;
+    state.llmMissingCorrectionCount = ctx.missingCorrectionCount;
+}
+
+/**
+ * Requests are cancelled by C++ when the panel closes - no retries, the
+ * remaining schools can be regenerated with "Retry failed"
+ */
+function handleLLMCancelled(result) {
+    var school = result.school || state.llmCurrentSchool;
+    appendToOutput('<<< CANCELLED: ' + school);
+    
+    if (state.llmStats.failedSchools.indexOf(school) === -1) {
+        state.llmStats.failedSchools.push(school);
+    }
+    if (state.llmInFlight) delete state.llmInFlight[school];
+    state.llmQueue = [];
+    
+    if (!state.llmInFlight || Object.keys(state.llmInFlight).length === 0) {
+        finishLLMGeneration();
+    }
+}
+
+/**
+ * One-line timing/token summary of a request (metrics from LLMScheduler)
+ */
+function formatLLMMetrics(metrics) {
+    if (metrics.cached) {
+        return '    Cached: served in ' + metrics.totalMs + ' ms (live request took ' + (metrics.liveMs / 1000).toFixed(1) + 's)';
+    }
+    var line = '    Timing: ' + (metrics.totalMs / 1000).toFixed(1) + 's total';
+    if (metrics.queuedMs > 0) line += ', ' + (metrics.queuedMs / 1000).toFixed(1) + 's queued';
+    if (metrics.firstTokenMs >= 0) line += ', first token ' + (metrics.firstTokenMs / 1000).toFixed(1) + 's';
+    if (metrics.attempts > 1) line += ', ' + metrics.attempts + ' attempts';
+    if (metrics.promptTokens || metrics.completionTokens) {
+        line += ' | Tokens: ' + metrics.promptTokens + ' in / ' + metrics.completionTokens + ' out';
+    }
+    return line;
+}
+
+/**
+ * One-line summary of a TreeRepair result (region sent, what was spliced back)
+ */
+function formatTreeRepair(repair) {
+    if (!repair.region) {
+        return '    Repair: nothing to repair';
+    }
+    var line = '    Repair: sent ' + repair.region + ' of ' + (repair.nodes + repair.missing) + ' spells (' +
+        repair.cycleMembers + ' in ' + repair.cycles + ' cycles, ' + repair.orphans + ' orphans, ' +
+        repair.dangling + ' dangling, ' + repair.missing + ' missing)';
+    line += ', ' + (repair.repaired || 0) + ' relinked, ' + (repair.added || 0) + ' added';
+    if (repair.remaining) line += ', ' + repair.remaining + ' still invalid';
+    return line;
+}
+
+/**
+ * Retry notice from C++ while a request backs off after a 429 / 5xx response
+ */
+window.onLLMRequestStatus = function(statusStr) {
+    var status;
+    try {
+        status = typeof statusStr === 'string' ? JSON.parse(statusStr) : statusStr;
+    } catch (e) {
+        console.error('[SpellLearning] Failed to parse request status:', e);
+        return;
+    }
+    setTreeStatus(status.school + ': ' + status.message);
+    appendToOutput('    ' + status.school + ': ' + status.message);
+};
+
+function handleLLMSchoolResult(result) {
     if (result.success === 1 && result.response) {
         // Try to parse and import the tree
         try {
@@ -720,6 +830,15 @@ window.onLLMPollResult = function(resultStr) {
             appendToOutput('<<< RECEIVED: ' + state.llmCurrentSchool + ' - SUCCESS');
             appendToOutput('    Spells: ' + spellCount + ', Layout: ' + layoutStyle);
             appendToOutput('    Response size: ' + (result.response.length / 1024).toFixed(1) + ' KB');
+            if (result.parts) {
+                appendToOutput('    Merged from ' + result.parts + ' parts' +
+                    (result.mergeIssues && result.mergeIssues.length ? ', repairs: ' + result.mergeIssues.join('; ') : ''));
+            }
+            if (result.defects && result.defects.length) {
+                appendToOutput('    Parser fixes: ' + result.defects.join('; '));
+            }
+            if (result.repair) appendToOutput(formatTreeRepair(result.repair));
+            if (result.metrics) appendToOutput(formatLLMMetrics(result.metrics));
             
             // Merge with existing tree
             if (state.treeData && state.treeData.success && state.treeData.rawData) {
@@ -873,7 +992,7 @@ window.onLLMPollResult = function(resultStr) {
                 // Re-queue this school at the front
                 var retrySchool = state.llmCurrentSchool;
                 var retrySpells = state.lastSpellData.spells.filter(function(s) { return s.school === retrySchool; });
-                state.llmQueue.unshift({ school: retrySchool, spells: retrySpells });
+                state.llmQueue.unshift({ school: retrySchool, spells: retrySpells, retryCount: state.llmRetryCount });
                 
                 // Longer delay before retry
                 setTimeout(processNextLLMSchool, 3000);
@@ -891,6 +1010,7 @@ window.onLLMPollResult = function(resultStr) {
         // Output failure to textarea
         appendToOutput('<<< RECEIVED: ' + state.llmCurrentSchool + ' - REQUEST FAILED');
         appendToOutput('    Error: ' + (result.response || 'unknown error'));
+        if (result.metrics) appendToOutput(formatLLMMetrics(result.metrics));
         
         // Retry logic for failed requests
         state.llmRetryCount = (state.llmRetryCount || 0) + 1;
@@ -902,7 +1022,7 @@ window.onLLMPollResult = function(resultStr) {
             // Re-queue this school at the front
             var retrySchool = state.llmCurrentSchool;
             var retrySpells = state.lastSpellData.spells.filter(function(s) { return s.school === retrySchool; });
-            state.llmQueue.unshift({ school: retrySchool, spells: retrySpells });
+            state.llmQueue.unshift({ school: retrySchool, spells: retrySpells, retryCount: state.llmRetryCount });
             
             // Longer delay before retry
             setTimeout(processNextLLMSchool, 3000);
@@ -922,6 +1042,7 @@ window.onLLMPollResult = function(resultStr) {
 function finishLLMGeneration() {
     state.llmGenerating = false;
     state.llmCurrentSchool = null;
+    state.llmInFlight = {};
     state.llmRetryCount = 0;
     
     // Show summary
@@ -934,6 +1055,9 @@ function finishLLMGeneration() {
     appendToOutput('Successful schools: ' + stats.successSchools.length);
     appendToOutput('  - ' + (stats.successSchools.join(', ') || 'none'));
     appendToOutput('Total spells processed: ' + stats.processedSpells);
+    if (stats.promptTokens || stats.completionTokens) {
+        appendToOutput('Tokens used: ' + (stats.promptTokens || 0) + ' in / ' + (stats.completionTokens || 0) + ' out');
+    }
     
     if (stats.failedSchools.length > 0) {
         statusMsg += ' | Failed: ' + stats.failedSchools.join(', ');
@@ -27,7 +27,8 @@ var PROCEDURAL_CONFIG = {
     preferVanillaRoots: true,
     convergenceAtTier: 3,
     convergenceChance: 0.4,
-    tierOrder: ['Novice', 'Apprentice', 'Adept', 'Expert', 'Master']
+    tierOrder: ['Novice', 'Apprentice', 'Adept', 'Expert', 'Master'],
+    pythonTimeoutSeconds: 600   // Python addon is killed after this long (LLM calls included)
 };
 
 // Vanilla root spell FormIDs (preferred starting points)
@@ -1143,6 +1144,10 @@ function startProceduralPythonGenerate(schoolFilter, schoolConfig) {
     updateStatus(statusMsg);
     setStatusIcon('...');
     
+    if (config.process_timeout_seconds === undefined) {
+        config.process_timeout_seconds = PROCEDURAL_CONFIG.pythonTimeoutSeconds;
+    }
+    
     // Send to Python via C++
     if (window.callCpp) {
         var request = {
@@ -1174,10 +1179,16 @@ function resetProceduralPlusButton() {
 
 function onProceduralPlusClick() {
     console.log('[Procedural] Python button clicked');
+    
+    // Second click while running cancels the Python process
+    if (state.proceduralPlusPending) {
+        cancelProceduralPythonGenerate();
+        return;
+    }
+    
     var btn = document.getElementById('proceduralPlusBtn');
     if (btn) {
-        btn.disabled = true;
-        btn.innerHTML = '<span class="btn-icon">...</span> Python...';
+        btn.innerHTML = '<span class="btn-icon">X</span> Cancel';
     }
     state.proceduralPlusPending = true;
     
@@ -1190,6 +1201,28 @@ function onProceduralPlusClick() {
     }
 }
 
+function cancelProceduralPythonGenerate() {
+    console.log('[Procedural] Cancelling Python generation');
+    updateStatus('Cancelling...');
+    if (window.callCpp) {
+        window.callCpp('ProceduralPythonCancel', '');
+    }
+}
+
+/**
+ * Progress line from the Python addon ("@progress <message>" on its stdout)
+ */
+window.onProceduralPythonProgress = function(progressStr) {
+    try {
+        var progress = typeof progressStr === 'string' ? JSON.parse(progressStr) : progressStr;
+        if (progress && progress.message) {
+            updateStatus('Python: ' + progress.message);
+        }
+    } catch (e) {
+        console.warn('[Procedural] Bad progress message:', e);
+    }
+};
+
 /**
  * Callback from C++ when Python procedural generation completes
  */
@@ -1199,6 +1232,15 @@ window.onProceduralPythonComplete = function(resultStr) {
     try {
         var result = typeof resultStr === 'string' ? JSON.parse(resultStr) : resultStr;
         
+        if (result.cancelled) {
+            state.visualFirstConfigPending = false;
+            updateStatus('Generation cancelled');
+            setStatusIcon('X');
+            resetProceduralPlusButton();
+            resetVisualFirstButton();
+            return;
+        }
+        
         // Check if visual-first mode was waiting for LLM configs + fuzzy data
         if (state.visualFirstConfigPending && result.success) {
             state.visualFirstConfigPending = false;
@@ -1613,6 +1655,8 @@ function startVisualFirstPythonConfig() {
         console.log('[VisualFirst] Running without LLM (default settings)');
     }
     
+    config.process_timeout_seconds = PROCEDURAL_CONFIG.pythonTimeoutSeconds;
+    
     var request = {
         spells: state.lastSpellData.spells,
         config: config
@@ -1853,6 +1897,7 @@ window.resetVisualFirstButton = resetVisualFirstButton;
 window.onProceduralClick = onProceduralClick;
 window.resetProceduralButton = resetProceduralButton;
 window.startProceduralPythonGenerate = startProceduralPythonGenerate;
+window.cancelProceduralPythonGenerate = cancelProceduralPythonGenerate;
 window.onProceduralPlusClick = onProceduralPlusClick;
 window.resetProceduralPlusButton = resetProceduralPlusButton;
 window.applySchoolConfigsToUI = applySchoolConfigsToUI;
@@ -16,6 +16,8 @@
  * - saveUnifiedConfig()
  * - resetSettings()
  * - window.onUnifiedConfigLoaded
+ * - window.onTraceSaved
+ * - window.onHookStats
  */
 
 // =============================================================================
@@ -128,6 +130,45 @@ function updateDeveloperModeVisibility(enabled) {
     }
 }
 
+// Plugin log levels - one select per subsystem reported by the C++ config
+var LOG_LEVEL_NAMES = ['trace', 'debug', 'info', 'warning', 'error', 'off'];
+
+function renderLogLevelControls() {
+    var container = document.getElementById('logLevelControls');
+    if (!container) return;
+    container.innerHTML = '';
+    
+    Object.keys(settings.logLevels || {}).forEach(function(subsystem) {
+        var label = document.createElement('label');
+        label.className = 'log-level-control';
+        label.textContent = subsystem;
+        
+        var select = document.createElement('select');
+        select.className = 'setting-select';
+        LOG_LEVEL_NAMES.forEach(function(level) {
+            var option = document.createElement('option');
+            option.value = level;
+            option.textContent = level;
+            select.appendChild(option);
+        });
+        select.value = settings.logLevels[subsystem];
+        select.addEventListener('change', function() {
+            settings.logLevels[subsystem] = this.value;
+            var update = {};
+            update[subsystem] = this.value;
+            
+            // Notify C++ immediately, persisted with the next save
+            if (window.callCpp) {
+                window.callCpp('SetLogLevels', JSON.stringify(update));
+            }
+            autoSaveSettings();
+        });
+        
+        label.appendChild(select);
+        container.appendChild(label);
+    });
+}
+
 function initializeSettings() {
     // Load saved settings
     loadSettings();
@@ -141,6 +182,52 @@ function initializeSettings() {
         });
     }
     
+    renderLogLevelControls();
+    
+    // Performance trace - recording starts with the game when traceOnStartup is set
+    var traceRecordingToggle = document.getElementById('traceRecordingToggle');
+    if (traceRecordingToggle) {
+        traceRecordingToggle.addEventListener('change', function() {
+            if (window.callCpp) {
+                window.callCpp('SetTraceRecording', this.checked ? 'true' : 'false');
+            }
+        });
+    }
+    var traceOnStartupToggle = document.getElementById('traceOnStartupToggle');
+    if (traceOnStartupToggle) {
+        traceOnStartupToggle.checked = settings.traceOnStartup;
+        traceOnStartupToggle.addEventListener('change', function() {
+            settings.traceOnStartup = this.checked;
+            autoSaveSettings();
+        });
+    }
+    
+    // Metrics export interval - applied by C++ on save
+    var metricsExportInput = document.getElementById('metricsExportInput');
+    if (metricsExportInput) {
+        metricsExportInput.value = settings.metricsExportSeconds;
+        metricsExportInput.addEventListener('change', function() {
+            var seconds = Math.max(0, Math.min(3600, parseInt(this.value) || 0));
+            this.value = seconds;
+            settings.metricsExportSeconds = seconds;
+            autoSaveSettings();
+        });
+    }
+    
+    // Hook timings - C++ answers with onHookStats
+    var refreshHookStatsBtn = document.getElementById('refreshHookStatsBtn');
+    if (refreshHookStatsBtn) {
+        refreshHookStatsBtn.addEventListener('click', function() {
+            if (window.callCpp) window.callCpp('GetHookStats', '');
+        });
+    }
+    var resetHookStatsBtn = document.getElementById('resetHookStatsBtn');
+    if (resetHookStatsBtn) {
+        resetHookStatsBtn.addEventListener('click', function() {
+            if (window.callCpp) window.callCpp('GetHookStats', 'reset');
+        });
+    }
+    
     // Debug grid toggle - shows grid candidate positions
     var debugGridToggle = document.getElementById('debugGridToggle');
     if (debugGridToggle) {
@@ -578,6 +665,16 @@ function initializeSettings() {
         });
     }
     
+    var llmResponseCacheToggle = document.getElementById('llmResponseCacheToggle');
+    if (llmResponseCacheToggle) {
+        llmResponseCacheToggle.checked = settings.llmResponseCache;
+        llmResponseCacheToggle.addEventListener('change', function() {
+            settings.llmResponseCache = this.checked;
+            console.log('[SpellLearning] LLM response cache:', settings.llmResponseCache);
+            scheduleAutoSave();
+        });
+    }
+    
     var llmCorrectionLoopsSlider = document.getElementById('llmCorrectionLoopsSlider');
     var llmCorrectionLoopsValue = document.getElementById('llmCorrectionLoopsValue');
     if (llmCorrectionLoopsSlider) {
@@ -1107,6 +1204,9 @@ function saveUnifiedConfig() {
         dividerCustomColor: settings.dividerCustomColor,
         preserveMultiPrereqs: settings.preserveMultiPrereqs,
         verboseLogging: settings.verboseLogging,
+        logLevels: settings.logLevels,
+        traceOnStartup: settings.traceOnStartup,
+        metricsExportSeconds: settings.metricsExportSeconds,
         // UI Display settings
         uiTheme: settings.uiTheme,
         learningColor: settings.learningColor,
@@ -1115,6 +1215,7 @@ function saveUnifiedConfig() {
         allowLLMMultiplePrereqs: settings.allowLLMMultiplePrereqs,
         llmSelfCorrection: settings.llmSelfCorrection,
         llmSelfCorrectionMaxLoops: settings.llmSelfCorrectionMaxLoops,
+        llmResponseCache: settings.llmResponseCache,
         proceduralPrereqInjection: settings.proceduralPrereqInjection,
         proceduralInjection: settings.proceduralInjection,
         
@@ -1230,6 +1331,14 @@ function resetSettings() {
     settings.showNodeNames = true;
     settings.showSchoolDividers = true;
     settings.verboseLogging = false;
+    Object.keys(settings.logLevels || {}).forEach(function(subsystem) {
+        settings.logLevels[subsystem] = 'info';
+    });
+    if (window.callCpp && settings.logLevels) {
+        window.callCpp('SetLogLevels', JSON.stringify(settings.logLevels));
+    }
+    settings.traceOnStartup = false;
+    settings.metricsExportSeconds = 0;
     // UI Display defaults
     settings.uiTheme = 'skyrim';
     settings.learningColor = '#7890A8';
@@ -1267,6 +1376,11 @@ function resetSettings() {
     var showDividersToggle = document.getElementById('showSchoolDividersToggle');
     if (showDividersToggle) showDividersToggle.checked = true;
     if (verboseToggle) verboseToggle.checked = false;
+    renderLogLevelControls();
+    var traceOnStartupToggle = document.getElementById('traceOnStartupToggle');
+    if (traceOnStartupToggle) traceOnStartupToggle.checked = false;
+    var metricsExportInput = document.getElementById('metricsExportInput');
+    if (metricsExportInput) metricsExportInput.value = 0;
     updateDeveloperModeVisibility(false);
     if (hotkeyInput) hotkeyInput.value = 'F9';
     if (cheatInfo) cheatInfo.classList.add('hidden');
@@ -1351,6 +1465,51 @@ function resetSettings() {
     console.log('[SpellLearning] Settings reset to defaults');
 }
 
+// Trace saved after Record Performance Trace was turned off
+window.onTraceSaved = function(dataStr) {
+    try {
+        var data = typeof dataStr === 'string' ? JSON.parse(dataStr) : dataStr;
+        var desc = document.getElementById('traceRecordingDesc');
+        var text = data.success
+            ? 'Saved ' + data.events + ' zones from ' + data.threads + ' threads to ' + data.path +
+              (data.dropped ? ' (' + data.dropped + ' dropped)' : '')
+            : 'Trace not saved: ' + data.error;
+        if (desc) desc.textContent = text;
+        console.log('[SpellLearning] ' + text);
+    } catch (e) {
+        console.error('[SpellLearning] Failed to parse trace result:', e);
+    }
+};
+
+// Hook timings since startup or the last reset
+window.onHookStats = function(dataStr) {
+    try {
+        var data = typeof dataStr === 'string' ? JSON.parse(dataStr) : dataStr;
+        var table = document.getElementById('hookStatsTable');
+        if (!table || !data || !data.hooks) return;
+        
+        var formatUs = function(us) {
+            return us >= 1000 ? (us / 1000).toFixed(2) + ' ms' : us.toFixed(2) + ' us';
+        };
+        var html = '<table><tr><th>Hook</th><th>Calls</th><th>Calls/s</th>' +
+                   '<th>p50</th><th>p99</th><th>Max</th></tr>';
+        data.hooks.forEach(function(hook) {
+            html += '<tr><td>' + hook.name + '</td><td>' + hook.calls + '</td>' +
+                    '<td>' + hook.callsPerSec.toFixed(1) + '</td>' +
+                    '<td>' + formatUs(hook.p50Us) + '</td>' +
+                    '<td>' + formatUs(hook.p99Us) + '</td>' +
+                    '<td>' + formatUs(hook.maxUs) + '</td></tr>';
+        });
+        table.innerHTML = html + '</table>';
+        table.classList.remove('hidden');
+        
+        var desc = document.getElementById('hookStatsDesc');
+        if (desc) desc.textContent = 'Last ' + data.windowSeconds.toFixed(0) + 's - also written to SpellLearning.log';
+    } catch (e) {
+        console.error('[SpellLearning] Failed to parse hook stats:', e);
+    }
+};
+
 // C++ callback for loading unified config
 window.onUnifiedConfigLoaded = function(dataStr) {
     console.log('[SpellLearning] Unified config received');
@@ -1373,6 +1532,9 @@ window.onUnifiedConfigLoaded = function(dataStr) {
         settings.dividerCustomColor = data.dividerCustomColor || '#ffffff';
         settings.preserveMultiPrereqs = data.preserveMultiPrereqs !== false;  // default true
         settings.verboseLogging = data.verboseLogging || false;
+        settings.logLevels = data.logLevels || {};
+        settings.traceOnStartup = data.traceOnStartup || false;
+        settings.metricsExportSeconds = data.metricsExportSeconds || 0;
         // UI Display settings
         settings.uiTheme = data.uiTheme || 'skyrim';
         settings.learningColor = data.learningColor || '#7890A8';
@@ -1381,6 +1543,7 @@ window.onUnifiedConfigLoaded = function(dataStr) {
         settings.allowLLMMultiplePrereqs = data.allowLLMMultiplePrereqs !== false;  // default true
         settings.llmSelfCorrection = data.llmSelfCorrection !== false;  // default true
         settings.llmSelfCorrectionMaxLoops = data.llmSelfCorrectionMaxLoops !== undefined ? data.llmSelfCorrectionMaxLoops : 5;
+        settings.llmResponseCache = data.llmResponseCache !== false;  // default true
         settings.proceduralPrereqInjection = data.proceduralPrereqInjection || false;  // default false
         // Procedural injection settings
         if (data.proceduralInjection) {
@@ -1489,6 +1652,9 @@ window.onUnifiedConfigLoaded = function(dataStr) {
         var llmSelfCorrectionToggle = document.getElementById('llmSelfCorrectionToggle');
         if (llmSelfCorrectionToggle) llmSelfCorrectionToggle.checked = settings.llmSelfCorrection;
         
+        var llmResponseCacheToggle = document.getElementById('llmResponseCacheToggle');
+        if (llmResponseCacheToggle) llmResponseCacheToggle.checked = settings.llmResponseCache;
+        
         var llmCorrectionLoopsRow = document.getElementById('llmCorrectionLoopsRow');
         if (llmCorrectionLoopsRow) {
             llmCorrectionLoopsRow.style.display = settings.llmSelfCorrection ? '' : 'none';
@@ -1744,6 +1910,13 @@ window.onUnifiedConfigLoaded = function(dataStr) {
         updateCustomProfilesUI();
         
         if (verboseToggle) verboseToggle.checked = settings.verboseLogging;
+        renderLogLevelControls();
+        var traceOnStartupToggle = document.getElementById('traceOnStartupToggle');
+        if (traceOnStartupToggle) traceOnStartupToggle.checked = settings.traceOnStartup;
+        var metricsExportInput = document.getElementById('metricsExportInput');
+        if (metricsExportInput) metricsExportInput.value = settings.metricsExportSeconds;
+        var traceRecordingToggle = document.getElementById('traceRecordingToggle');
+        if (traceRecordingToggle) traceRecordingToggle.checked = data.traceRecording === true;
         if (hotkeyInput) hotkeyInput.value = settings.hotkey;
         if (cheatInfo) cheatInfo.classList.toggle('hidden', !settings.cheatMode);
         
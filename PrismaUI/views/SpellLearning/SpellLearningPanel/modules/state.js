@@ -60,6 +60,9 @@ var settings = {
     dividerCustomColor: '#ffffff',
     preserveMultiPrereqs: true,
     verboseLogging: false,
+    logLevels: {},              // C++ log level per subsystem (filled from the unified config)
+    traceOnStartup: false,      // Record trace zones from plugin load (saved on the next trace stop)
+    metricsExportSeconds: 0,    // OpenMetrics snapshot interval, 0 = off
     // UI Display settings
     uiTheme: 'skyrim',          // Current UI theme key
     learningColor: '#7890A8',   // Color for learning state nodes/lines
@@ -69,6 +72,7 @@ var settings = {
     allowLLMMultiplePrereqs: true,    // Let LLM design multiple prerequisites per spell
     llmSelfCorrection: true,          // Let LLM fix its own unreachable nodes
     llmSelfCorrectionMaxLoops: 5,     // Max correction attempts before fallback
+    llmResponseCache: true,           // Answer identical LLM requests from the on-disk cache
     proceduralPrereqInjection: false, // Add extra prereqs programmatically after generation
     // Procedural injection settings
     proceduralInjection: {
@@ -224,6 +228,7 @@ var state = {
     llmGenerating: false,
     llmQueue: [],
     llmCurrentSchool: null,
+    llmInFlight: {},  // school -> per-school request state while generations run in parallel
     llmPollInterval: null,
     llmStats: {
         totalSpells: 0,
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <memory_resource>
+
+// =============================================================================
+// Arena
+// =============================================================================
+// Monotonic memory for one operation (currently tree validation):
+// containers built on it take their memory from a few large blocks and free
+// nothing until the arena goes out of scope, when everything is released at
+// once.
+//
+//   Arena arena("ValidateTree");
+//   std::pmr::vector<size_t> nodesToRemove(&arena);
+//
+// Not thread-safe - one arena per operation and thread. Only transient data
+// belongs here; anything that outlives the operation (json documents handed to
+// the panel, cache records) stays on the normal heap.
+//
+// On destruction the allocation count and the heap blocks it took are added to
+// the spelllearning_arena_* metrics and logged at debug level.
+// =============================================================================
+
+class Arena : public std::pmr::memory_resource
+{
+public:
+    // operation must be a string literal - used as the metrics label
+    explicit Arena(const char* operation, size_t initialSize = 16 * 1024);
+    ~Arena() override;
+
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    size_t GetAllocationCount() const { return m_allocations; }
+
+private:
+    // Counts the blocks the arena takes from the heap
+    class Upstream : public std::pmr::memory_resource
+    {
+    public:
+        size_t GetBlockCount() const { return m_blocks; }
+        size_t GetBytes() const { return m_bytes; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        size_t m_blocks = 0;
+        size_t m_bytes  = 0;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}  // Released with the arena
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    const char* m_operation;
+    std::chrono::steady_clock::time_point m_start;
+    Upstream m_upstream;
+    std::pmr::monotonic_buffer_resource m_buffer;  // After m_upstream - allocates from it
+    size_t m_allocations = 0;
+    size_t m_bytes       = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+
+// =============================================================================
+// AsyncFileWriter
+// =============================================================================
+// Writes the plugin's files (tree, prompt, config, scan outputs, scan cache)
+// from a job on the thread pool's blocking lane instead of the caller:
+//
+//   - A write waits a short debounce window first. Writing the same path again
+//     inside the window replaces the queued content, so a burst of saves
+//     becomes one write.
+//   - Content goes to "<path>.tmp", is flushed to disk and then renamed over
+//     the target, so a crash mid-write leaves the previous file intact.
+//   - Write() returns a future for the result. The optional callback runs on
+//     the game thread - for status messages in the panel.
+//
+// Code that reads one of these files back calls Flush(path) first so it never
+// sees the content from before a queued write.
+// =============================================================================
+
+class AsyncFileWriter
+{
+public:
+    using Callback = std::function<void(bool success)>;
+
+    static AsyncFileWriter* GetSingleton();
+
+    std::shared_future<bool> Write(std::filesystem::path path, std::string content, Callback onWritten = {});
+
+    // Write anything queued for the path right away and wait for it
+    void Flush(const std::filesystem::path& path);
+
+    // Start every queued write now instead of waiting out the window (panel closed)
+    void Expedite();
+
+private:
+    AsyncFileWriter() = default;
+
+    struct Pending
+    {
+        std::string content;
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+        std::vector<Callback> callbacks;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    // Writes queued files as they come due, returns once nothing is queued
+    void WriterLoop();
+
+    static bool WriteFile(const std::filesystem::path& path, const std::string& content);
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::map<std::filesystem::path, Pending> m_pending;
+    std::filesystem::path m_writingPath;  // Taken off m_pending, being written
+    std::shared_future<bool> m_writingFuture;
+    bool m_writerRunning = false;  // A WriterLoop job is queued or running
+};
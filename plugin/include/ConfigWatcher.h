@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <functional>
+
+// =============================================================================
+// ConfigWatcher
+// =============================================================================
+// Change detection for the config files:
+//
+//   - Hash() fingerprints a config section, so a reload re-applies only the
+//     subsystems whose section differs from what was applied last.
+//   - Watch() polls files in the background and runs a callback on the game
+//     thread once one of them was edited on disk. A file has to stay unchanged
+//     for one poll before the callback runs, so an editor saving in several
+//     steps triggers one reload.
+// =============================================================================
+
+namespace ConfigWatcher
+{
+// FNV-1a over the compact dump - object keys are sorted, so equal content hashes equal
+uint64_t Hash(const json& value);
+
+// Poll paths for a new write time or size (also created / deleted) and call onChanged afterwards
+void Watch(std::vector<std::filesystem::path> paths, std::function<void()> onChanged);
+}  // namespace ConfigWatcher
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PCH.h"
+#include "ThreadPool.h"
+
+#include <coroutine>
+
+// =============================================================================
+// Coroutine
+// =============================================================================
+// Fire-and-forget coroutines for panel callbacks that mix file I/O and parsing
+// with game-thread-only work (form lookups, learning state, view calls):
+//
+//   Coroutine::Task LoadSomething(std::filesystem::path path)
+//   {
+//     co_await Coroutine::OnWorker();      // Read and parse on the thread pool
+//     json data = ...;
+//     co_await Coroutine::OnGameThread();  // Back for forms and the view
+//     ...
+//     co_await Coroutine::NextFrame();     // Let the game render before continuing
+//   }
+//
+// A Task starts running on the calling thread as soon as it is called and
+// frees itself when it finishes - the caller does not wait for or own it.
+// Parameters are the coroutine's own copies, so pass values rather than
+// references or pointers into the caller's frame. An exception that escapes
+// the coroutine is logged and ends it.
+//
+// Trace zones must not span a co_await: the rest of the scope may run on a
+// different thread.
+// =============================================================================
+
+namespace Coroutine
+{
+class Task
+{
+public:
+  struct promise_type
+  {
+    Task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept;
+  };
+};
+
+// Continue on a thread pool worker
+class OnWorker
+{
+public:
+  explicit OnWorker(ThreadPool::Priority priority = ThreadPool::Priority::Normal) : m_priority(priority) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const;
+  void await_resume() const noexcept {}
+
+private:
+  ThreadPool::Priority m_priority;
+};
+
+// Continue on the game thread - right away when already there
+class OnGameThread
+{
+public:
+  bool await_ready() const noexcept;
+  void await_suspend(std::coroutine_handle<> handle) const;
+  void await_resume() const noexcept {}
+};
+
+// Continue on the game thread in a later frame, even when already on it
+class NextFrame
+{
+public:
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const;
+  void await_resume() const noexcept {}
+};
+
+// Whether the calling thread is the game thread. Known once the game thread ran a queued task.
+bool IsGameThread();
+}  // namespace Coroutine
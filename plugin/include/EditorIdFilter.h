@@ -0,0 +1,87 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <array>
+
+// =============================================================================
+// EditorIdFilter
+// =============================================================================
+// Classifies spell editor IDs against a list of data-driven filter rules
+// (SKSE/Plugins/SpellLearning/spell_filter_rules.json). All literal terms are
+// compiled into one case-insensitive Aho-Corasick automaton, so an editor ID is
+// classified in a single pass no matter how many rules a modlist adds.
+//
+// Rule kinds:
+//   prefix   - editor ID starts with the term
+//   contains - editor ID contains the term (a list of terms must ALL match)
+//   pattern  - regex-lite glob over the whole ID: '#' digit, '?' any char, '*' any run
+// =============================================================================
+
+class EditorIdFilter
+{
+public:
+    enum class RuleKind : uint8_t
+    {
+        kPrefix,
+        kContains,
+        kPattern
+    };
+
+    struct Rule
+    {
+        RuleKind kind = RuleKind::kContains;
+        std::vector<std::string> terms;  // Lowercased; pattern rules hold the glob in terms[0]
+        std::string reason;
+    };
+
+    // Load rules from a JSON file, falling back to the built-in defaults if it is missing or invalid
+    static EditorIdFilter LoadFromFile(const std::filesystem::path& path);
+
+    // Built-in rules (same as the shipped spell_filter_rules.json)
+    static EditorIdFilter CreateDefault();
+
+    static std::filesystem::path GetRulesPath();
+
+    // Compile rules into the automaton. Invalid rules are skipped with a warning.
+    explicit EditorIdFilter(std::vector<Rule> rules = {});
+
+    // First rule that matches the editor ID, or nullptr if the ID passes the filter
+    const Rule* Match(std::string_view editorId) const;
+    bool IsFiltered(std::string_view editorId) const { return Match(editorId) != nullptr; }
+
+    const std::vector<Rule>& GetRules() const { return m_rules; }
+
+    // Hash of the compiled rule set (for invalidating cached scan results)
+    uint64_t GetRulesHash() const { return m_rulesHash; }
+
+private:
+    static std::vector<Rule> ParseRules(const json& j);
+    void Compile();
+
+    // A requirement that can be satisfied during the automaton pass
+    struct Condition
+    {
+        RuleKind kind;
+        uint32_t termLength;  // For prefix conditions (match must start at 0)
+    };
+
+    struct PatternRule
+    {
+        size_t ruleIndex;
+        int anchorCondition;  // -1 = no literal anchor, always verify
+    };
+
+    std::vector<Rule> m_rules;
+    uint64_t m_rulesHash = 0;
+
+    // Automaton: dense transition table over a compacted, case-folded alphabet
+    std::array<uint8_t, 256> m_charClass{};
+    uint32_t m_classCount = 1;  // Class 0 = character not used by any term
+    std::vector<uint32_t> m_transitions;                  // state * m_classCount + class -> state
+    std::vector<std::vector<uint32_t>> m_stateOutputs;     // state -> conditions ending here (incl. suffix links)
+
+    std::vector<Condition> m_conditions;
+    std::vector<std::vector<uint32_t>> m_ruleConditions;  // rule -> conditions that must all hold
+    std::vector<PatternRule> m_patterns;
+};
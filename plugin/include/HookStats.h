@@ -0,0 +1,98 @@
+#pragma once
+
+#include "PCH.h"
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#else
+#  include <x86intrin.h>
+#endif
+
+// =============================================================================
+// HookStats
+// =============================================================================
+// Always-on call counts and latency histograms for the engine hooks and event
+// sinks, so a slow frame can be blamed on (or cleared of) this plugin:
+//
+//   static const char* thunk(RE::TESFullName* a_fullName)
+//   {
+//     const char* originalName = func(a_fullName);
+//     SL_HOOK_TIMER(SpellName);
+//     ...
+//
+// The timer reads the TSC on entry and exit and bumps a log-linear histogram
+// owned by the calling thread - no locks, no shared cache lines, two rdtsc
+// and a handful of plain stores per call. Hooks that call the original
+// function first start the timer after it, so only the plugin's own work is
+// measured. Collect() merges all threads on demand.
+// =============================================================================
+
+namespace HookStats
+{
+enum class Hook : uint8_t
+{
+  AdjustForPerks,  // ActiveEffect::AdjustForPerks - effectiveness scaling
+  SpellName,       // TESFullName::GetFullName on SpellItem - "(Learning - N%)"
+  MagicMenuUI,     // MagicMenu::PostDisplay - menu text refresh
+  SpellTomeRead,   // TESObjectBOOK::ProcessBook patch
+  SpellCastEvent,  // TESSpellCastEvent sink - XP on cast
+  InputEvent,      // InputEvent sink - panel hotkey
+
+  Count
+};
+
+const char* GetName(Hook hook);
+
+namespace detail
+{
+inline uint64_t ReadTsc()
+{
+  return __rdtsc();
+}
+
+void Record(Hook hook, uint64_t cycles);
+}  // namespace detail
+
+struct Summary
+{
+  const char* name = "";
+  uint64_t calls     = 0;
+  double callsPerSec = 0.0;
+  double meanUs      = 0.0;
+  double p50Us       = 0.0;  // Percentiles are bucket midpoints - within ~6% of the true value
+  double p99Us       = 0.0;
+  double maxUs       = 0.0;
+};
+
+// Per-hook figures since startup or the last Reset(), in Hook order
+std::vector<Summary> Collect();
+
+// Seconds covered by Collect()
+double GetWindowSeconds();
+
+// Start a new measurement window
+void Reset();
+
+// Collect() as {windowSeconds, hooks: [{name, calls, callsPerSec, meanUs, p50Us, p99Us, maxUs}]}
+json ToJson(const std::vector<Summary>& summaries);
+
+// Write one line per hook that was called to the log
+void LogSummary(const std::vector<Summary>& summaries);
+
+class Timer
+{
+public:
+  explicit Timer(Hook hook) : m_hook(hook), m_start(detail::ReadTsc()) {}
+
+  ~Timer() { detail::Record(m_hook, detail::ReadTsc() - m_start); }
+
+  Timer(const Timer&)            = delete;
+  Timer& operator=(const Timer&) = delete;
+
+private:
+  Hook m_hook;
+  uint64_t m_start;
+};
+}  // namespace HookStats
+
+#define SL_HOOK_TIMER(hook) HookStats::Timer slHookTimer(HookStats::Hook::hook)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <functional>
+
+// =============================================================================
+// HttpClient
+// =============================================================================
+// Minimal HTTP client for the LLM integration. A transport object is created
+// once and reused for every request, so connections (and TLS sessions) stay
+// alive between the per-school generation and correction calls.
+//
+//   WinHttpTransport - one WinHTTP session for the plugin lifetime; WinHTTP
+//                      pools keep-alive connections per session.
+//   SocketTransport  - plain HTTP/1.1 over POSIX sockets with its own idle
+//                      connection pool (no TLS). Used against local mock
+//                      servers for tests and latency measurements.
+//
+// Transports are safe to use from several threads at once. Responses can be
+// streamed through Request::onBody; SseParser decodes server-sent events.
+// =============================================================================
+
+namespace HttpClient
+{
+struct Request
+{
+  std::string method = "POST";
+  std::string host;
+  uint16_t port    = 443;
+  bool secure      = true;
+  std::string path = "/";
+  std::vector<std::pair<std::string, std::string>> headers;  // Content-Length / Host are added by the transport
+  std::string_view body;                                     // Not owned - must outlive Send()
+
+  // Streaming: body bytes of a 2xx response are passed here as they arrive instead of being
+  // collected in Response::body. Return false to abort the transfer.
+  std::function<bool(std::string_view)> onBody;
+};
+
+struct Response
+{
+  int status = 0;  // HTTP status, 0 if the request never completed
+  std::string body;
+  std::string error;              // Transport error description
+  bool reusedConnection = false;  // Served over a pooled connection (socket transport only)
+
+  bool Ok() const { return error.empty() && status >= 200 && status < 300; }
+};
+
+struct TransportOptions
+{
+  std::string userAgent = "SpellLearning/1.0";
+  std::chrono::milliseconds connectTimeout{30s};
+  std::chrono::milliseconds receiveTimeout{300s};  // Long completions can take minutes
+  size_t maxIdleConnectionsPerHost = 4;
+};
+
+class ITransport
+{
+public:
+  virtual ~ITransport() = default;
+
+  virtual Response Send(const Request& request) = 0;
+  virtual std::string_view Name() const         = 0;
+};
+
+// Server-sent events decoder for streamed bodies (text/event-stream).
+// Feed() accepts arbitrary chunks; onData receives the data of every complete event.
+class SseParser
+{
+public:
+  // Returns false if onData asked to stop
+  bool Feed(std::string_view chunk, const std::function<bool(std::string_view)>& onData);
+
+private:
+  std::string m_line;  // Incomplete line carried over between chunks
+  std::string m_data;  // Data lines of the current event
+  bool m_hasData = false;
+};
+
+// "https://host[:port]/path" -> host, port, secure and path of request
+bool ParseUrl(std::string_view url, Request& request);
+
+#ifdef _WIN32
+std::unique_ptr<ITransport> CreateWinHttpTransport(const TransportOptions& options = {});
+#else
+std::unique_ptr<ITransport> CreateSocketTransport(const TransportOptions& options = {});
+#endif
+
+// WinHTTP on Windows, sockets elsewhere
+std::unique_ptr<ITransport> CreateDefaultTransport(const TransportOptions& options = {});
+}  // namespace HttpClient
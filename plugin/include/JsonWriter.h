@@ -0,0 +1,93 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// JsonWriter
+// =============================================================================
+// Streaming JSON writer - emits values straight into a string buffer or an
+// output stream without building a json DOM first. Used for the scan output
+// (UI payload and spell_scan_output.json) and the LLM request body, which are
+// large enough that DOM copies dominate memory.
+//
+// Pretty mode matches json::dump(2) layout. Pre-serialized fragments written
+// with RawValue are copied as-is (one line each in pretty mode).
+// Strings that are not valid UTF-8 are sanitized with TextUtils::SanitizeToUTF8.
+// =============================================================================
+
+class JsonWriter
+{
+public:
+    // Append to a string buffer
+    explicit JsonWriter(std::string& buffer, bool pretty = false);
+
+    // Stream to an output stream, flushed in chunks
+    explicit JsonWriter(std::ostream& stream, bool pretty = false);
+
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(std::string_view key);
+
+    JsonWriter& String(std::string_view value);
+    JsonWriter& Int(int64_t value);
+    JsonWriter& UInt(uint64_t value);
+    JsonWriter& Double(double value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+
+    // Write a json DOM value (small records, config fragments)
+    JsonWriter& Value(const json& value);
+
+    // Write an already serialized JSON value verbatim
+    JsonWriter& RawValue(std::string_view serialized);
+
+    // Open an already serialized object so more members can be appended (close with EndObject)
+    JsonWriter& BeginRawObject(std::string_view serializedObject);
+
+    // Key + value shorthands
+    JsonWriter& Member(std::string_view key, std::string_view value) { return Key(key).String(value); }
+    JsonWriter& Member(std::string_view key, const char* value) { return Key(key).String(value ? value : ""); }
+    JsonWriter& Member(std::string_view key, const std::string& value) { return Key(key).String(value); }
+    JsonWriter& Member(std::string_view key, bool value) { return Key(key).Bool(value); }
+    JsonWriter& Member(std::string_view key, int value) { return Key(key).Int(value); }
+    JsonWriter& Member(std::string_view key, int64_t value) { return Key(key).Int(value); }
+    JsonWriter& Member(std::string_view key, uint32_t value) { return Key(key).UInt(value); }
+    JsonWriter& Member(std::string_view key, uint64_t value) { return Key(key).UInt(value); }
+    JsonWriter& Member(std::string_view key, float value) { return Key(key).Double(value); }
+    JsonWriter& Member(std::string_view key, double value) { return Key(key).Double(value); }
+
+    // Push buffered output to the stream (no-op for string sinks)
+    void Flush();
+
+    // Total bytes produced so far
+    size_t BytesWritten() const { return m_flushed + m_out->size() - m_baseSize; }
+
+private:
+    struct Level
+    {
+        bool isObject;
+        bool hasElements;
+    };
+
+    void BeforeValue();
+    void Newline(size_t depth);
+    void WriteEscaped(std::string_view value);
+    void MaybeFlush();
+
+    std::string* m_out;
+    std::string m_chunk;               // Staging buffer for stream sinks
+    std::ostream* m_stream = nullptr;
+    size_t m_baseSize      = 0;        // Pre-existing content of a string sink
+    size_t m_flushed       = 0;
+    bool m_pretty          = false;
+    bool m_afterKey        = false;
+    std::vector<Level> m_levels;
+};
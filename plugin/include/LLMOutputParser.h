@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <unordered_set>
+
+// =============================================================================
+// LLMOutputParser
+// =============================================================================
+// Tolerant parsing of LLM completions before they reach the panel.
+//
+// RepairJson() makes one pass over the response and copies the JSON payload
+// while fixing what models commonly get wrong:
+//
+//   - markdown fences and chatter before / after the payload
+//   - // and /* */ comments
+//   - trailing commas and missing commas between values
+//   - raw line breaks and control characters inside strings
+//   - truncation (max_tokens reached): the payload is cut after the last
+//     complete value - inside a "nodes" array after the last complete node -
+//     and every open array / object is closed
+//
+// ParseTree() then normalizes a tree response: formIds are canonicalized and
+// checked against the scanned spell set, unknown and duplicate spells and
+// dangling links are dropped, and a missing root is chosen. Every fix is
+// reported in the defect list.
+// =============================================================================
+
+namespace LLMOutputParser
+{
+struct Result
+{
+  bool success = false;
+  std::string error;
+  json document;                     // Repaired (and for trees normalized) JSON
+  std::vector<std::string> defects;  // Human-readable, one entry per kind of fix
+  size_t nodeCount = 0;              // Trees: nodes kept
+};
+
+// Extract and repair the JSON payload of a response
+Result RepairJson(std::string_view response);
+
+// Repair, then normalize a generation response for one school. knownFormIds are the
+// canonical formIds of the scanned spells; without them formIds are not checked.
+Result ParseTree(std::string_view response, const std::string& school,
+                 const std::unordered_set<std::string>* knownFormIds = nullptr);
+}  // namespace LLMOutputParser
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <optional>
+
+// =============================================================================
+// LLMResponseCache
+// =============================================================================
+// Content-addressed on-disk cache of LLM completions. The key is a 128-bit
+// hash of (model, system prompt, user prompt, maxTokens), so re-running a
+// generation with the same scan, rules and model is answered from disk
+// instead of being billed and waited for again.
+//
+// One JSON file per entry in SKSE/Plugins/SpellLearning/llm_cache. The file's
+// write time doubles as the LRU stamp (touched on every hit); once the total
+// size exceeds the limit the least recently used entries are deleted.
+// Only responses with a valid JSON body (PromptBuilder::JsonBody) are stored.
+// Safe to use from any thread; Lookup / Store read and write files, so callers
+// run them on the thread pool's blocking lane.
+// =============================================================================
+
+namespace LLMResponseCache
+{
+struct Entry
+{
+  std::string content;
+  int64_t liveMs       = 0;  // Latency of the live request that produced the entry
+  int promptTokens     = 0;
+  int completionTokens = 0;
+};
+
+struct Stats
+{
+  uint64_t hits      = 0;
+  uint64_t misses    = 0;
+  uint64_t stores    = 0;
+  uint64_t evictions = 0;
+  size_t entries     = 0;
+  uint64_t bytes     = 0;
+  double hitMs       = 0;  // Average lookup time of a hit
+  double liveMs      = 0;  // Average latency of the live requests stored
+
+  double HitRate() const
+  {
+    return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+  }
+};
+
+// Hex key of a request
+std::string MakeKey(std::string_view model, std::string_view systemPrompt, std::string_view userPrompt,
+                    int maxTokens);
+
+// Cached response for a key, counts a hit or miss
+std::optional<Entry> Lookup(const std::string& key);
+
+// Store a response (ignored unless its JSON body is valid), then evict down to the size limit
+void Store(const std::string& key, std::string_view model, int maxTokens, const Entry& entry);
+
+// Size limit of the cache directory in bytes
+void SetMaxBytes(uint64_t maxBytes);
+
+// Delete every entry
+void Clear();
+
+Stats GetStats();
+
+std::filesystem::path GetCacheDirectory();
+}  // namespace LLMResponseCache
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "PCH.h"
+#include "OpenRouterAPI.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <stop_token>
+
+// =============================================================================
+// LLMScheduler
+// =============================================================================
+// Runs OpenRouter requests with a bounded number of workers so every school of
+// a tree generation can be in flight at once without an unbounded thread per
+// request. Workers run on the thread pool's blocking lane.
+//
+//   - Each request carries its own copy of the OpenRouter config; nothing
+//     shared is modified while requests run.
+//   - 429 / 408 / 5xx answers are retried with exponential backoff (with
+//     jitter), unless part of the response was already streamed to the caller.
+//   - CancelAll() (panel closed) drops queued requests and aborts running ones.
+//   - Completion callbacks run on the game thread and receive timing and token
+//     metrics for the request.
+// =============================================================================
+
+class LLMScheduler
+{
+public:
+    struct Request
+    {
+        std::string tag;                          // Label for logs and metrics (school name)
+        OpenRouterAPI::Config config;             // Copied at submit, never changed afterwards
+        std::string systemPrompt;
+        std::string userPrompt;
+        OpenRouterAPI::DeltaCallback onDelta;     // Worker thread, while the response streams
+        OpenRouterAPI::ResponseValidator accept;  // Racing: picks the winning response (config.raceModels)
+    };
+
+    struct Metrics
+    {
+        uint64_t id = 0;
+        std::string tag;
+        std::string model;
+        int attempts = 0;
+        int64_t queuedMs = 0;       // Submit -> first attempt started
+        int64_t firstTokenMs = -1;  // First attempt started -> first streamed text, -1 if none
+        int64_t totalMs = 0;        // Submit -> completion (including backoff)
+        int promptTokens = 0;
+        int completionTokens = 0;
+
+        json ToJson() const;
+    };
+
+    // Game thread
+    using Callback = std::function<void(const OpenRouterAPI::Response&, const Metrics&)>;
+
+    // Retry status for the panel ("rate limited, retrying in 4s"), game thread
+    using RetryCallback = std::function<void(int attempt, int httpStatus, std::chrono::milliseconds delay)>;
+
+    static LLMScheduler* GetSingleton();
+
+    // Queue a request; returns its id
+    uint64_t Submit(Request request, Callback onComplete, RetryCallback onRetry = {});
+
+    // Number of requests allowed to run at once (at least 1)
+    void SetConcurrencyLimit(size_t limit);
+    size_t GetConcurrencyLimit() const;
+
+    // Drop queued requests and abort running ones - their callbacks report cancelled
+    void CancelAll();
+
+    size_t QueuedCount() const;
+    size_t RunningCount() const;
+
+private:
+    LLMScheduler() = default;
+
+    struct Job
+    {
+        uint64_t id = 0;
+        Request request;
+        Callback onComplete;
+        RetryCallback onRetry;
+        std::stop_token stopToken;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    // Start workers while slots and queued jobs are available (m_mutex held)
+    void StartWorkersLocked();
+    void WorkerLoop();
+    void Execute(Job& job);
+
+    // Sleeps for the backoff delay; false if cancelled meanwhile
+    bool WaitBackoff(std::stop_token stopToken, std::chrono::milliseconds delay);
+
+    static void Complete(Job& job, OpenRouterAPI::Response response, Metrics metrics);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_backoffWake;
+    std::deque<std::unique_ptr<Job>> m_queue;
+    std::stop_source m_stopSource;  // Replaced on every CancelAll
+    size_t m_limit = 5;
+    size_t m_workers = 0;           // Workers alive
+    size_t m_running = 0;           // Jobs currently executing
+    uint64_t m_nextId = 1;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// Logging
+// =============================================================================
+// The log file is written by spdlog's async logger: callers format the line
+// and push it into a fixed ring buffer, a background thread writes it out and
+// flushes once a second (immediately for warnings and errors). When the buffer
+// is full the oldest lines are overwritten instead of blocking the game thread.
+//
+// logger::info / warn / ... go to the core logger as before. Hot per-item paths
+// log through SL_LOG_* with a subsystem, each subsystem has its own level that
+// the panel can change at runtime (Settings > Debug Options). SL_LOG_TRACE
+// compiles to nothing in release builds, arguments are not evaluated.
+// =============================================================================
+
+namespace Logging
+{
+enum class Subsystem : uint8_t
+{
+  Core,         // logger:: calls
+  UI,           // Panel requests
+  Progression,  // XP, prerequisites, co-save
+  Hooks,        // Spell cast, effectiveness and tome hooks
+  Scanner,      // Spell scanning
+  LLM,          // Tree generation requests and responses
+  Count
+};
+
+// Creates the async loggers - call once, before anything logs
+void Setup();
+
+// Logger of a subsystem (the default logger until Setup() has run)
+spdlog::logger* Get(Subsystem subsystem);
+
+const char* GetName(Subsystem subsystem);
+
+// {"core": "info", "ui": "debug", ...} - unknown subsystems and levels are ignored
+void SetLevels(const json& levels);
+json GetLevels();
+}  // namespace Logging
+
+#define SL_LOG(subsystem, level, ...)                                         \
+  do {                                                                        \
+    auto* slLogger = Logging::Get(Logging::Subsystem::subsystem);             \
+    if (slLogger->should_log(level)) {                                        \
+      slLogger->log(level, __VA_ARGS__);                                      \
+    }                                                                         \
+  } while (false)
+
+#ifdef NDEBUG
+#  define SL_LOG_TRACE(subsystem, ...) ((void)0)
+#else
+#  define SL_LOG_TRACE(subsystem, ...) SL_LOG(subsystem, spdlog::level::trace, __VA_ARGS__)
+#endif
+#define SL_LOG_DEBUG(subsystem, ...) SL_LOG(subsystem, spdlog::level::debug, __VA_ARGS__)
+#define SL_LOG_INFO(subsystem, ...)  SL_LOG(subsystem, spdlog::level::info, __VA_ARGS__)
+#define SL_LOG_WARN(subsystem, ...)  SL_LOG(subsystem, spdlog::level::warn, __VA_ARGS__)
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <map>
+#include <memory>
+
+// =============================================================================
+// Metrics
+// =============================================================================
+// Named counters, gauges and histograms for graphing long play sessions.
+// Subsystems look a series up once and keep the reference - updates are
+// relaxed atomics, safe from any thread:
+//
+//   static auto& requests = Metrics::GetCounter("spelllearning_llm_requests", "LLM requests sent");
+//   requests.Add();
+//
+// Series with label values only known at runtime (XP source and school) are
+// looked up per event; that takes a shared lock on the registry.
+//
+// With an export interval set, a background thread writes the registry in
+// OpenMetrics text format to GetExportPath() (latest snapshot) and appends the
+// same snapshot to GetHistoryPath(), which is restarted each game launch.
+//
+// The history is not one OpenMetrics exposition: it is a concatenation of
+// complete snapshots, each ending in "# EOF" and with every sample stamped
+// with the export time. Split it at the "# EOF" lines to feed the snapshots to
+// an OpenMetrics parser one at a time.
+// =============================================================================
+
+namespace Metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Metric
+{
+public:
+  virtual ~Metric() = default;
+
+  // Append the sample lines of this series
+  virtual void Render(std::string& out, const std::string& name, const std::string& labels) const = 0;
+};
+
+class Counter : public Metric
+{
+public:
+  void Add(uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+  uint64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+
+  void Render(std::string& out, const std::string& name, const std::string& labels) const override;
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+class Gauge : public Metric
+{
+public:
+  void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+  void Add(double amount) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+  double Get() const { return m_value.load(std::memory_order_relaxed); }
+
+  void Render(std::string& out, const std::string& name, const std::string& labels) const override;
+
+private:
+  std::atomic<double> m_value{0.0};
+};
+
+class Histogram : public Metric
+{
+public:
+  // Upper bounds of the buckets, ascending - a +Inf bucket is added
+  explicit Histogram(std::vector<double> bounds);
+
+  void Observe(double value);
+
+  void Render(std::string& out, const std::string& name, const std::string& labels) const override;
+
+private:
+  std::vector<double> m_bounds;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;  // Not cumulative - summed when rendered
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<double> m_sum{0.0};
+};
+
+// Find or register a series. The same name always has the same type and help; the returned
+// reference stays valid for the process lifetime.
+Counter& GetCounter(std::string_view name, std::string_view help, const Labels& labels = {});
+Gauge& GetGauge(std::string_view name, std::string_view help, const Labels& labels = {});
+Histogram& GetHistogram(std::string_view name, std::string_view help, const std::vector<double>& bounds,
+                        const Labels& labels = {});
+
+// All series in OpenMetrics text format, terminated by "# EOF"
+std::string Render();
+
+// Seconds between exports, 0 stops exporting
+void SetExportInterval(uint32_t seconds);
+uint32_t GetExportInterval();
+
+std::filesystem::path GetExportPath();
+std::filesystem::path GetHistoryPath();  // Concatenated snapshots, see above
+}  // namespace Metrics
@@ -3,6 +3,9 @@
 #include <string>
 #include <functional>
 #include <future>
+#include <stop_token>
+#include <string_view>
+#include <vector>
 
 namespace OpenRouterAPI {
 
@@ -10,14 +13,34 @@ namespace OpenRouterAPI {
         std::string apiKey;
         std::string model = "anthropic/claude-sonnet-4";  // Default model
         int maxTokens = 64000;
+        bool stream = true;  // Stream completions (SSE) when the caller wants deltas
+        int maxConcurrentRequests = 5;  // LLMScheduler slots - one per vanilla school
+        int maxRetries = 3;             // Extra attempts after a 429 / 5xx response
+        bool responseCache = true;      // Answer repeated prompts from LLMResponseCache
+        int responseCacheMaxMB = 64;
+        int promptTokenBudget = 30000;  // Spell table tokens per prompt before a school is split
+        std::string endpoint = "https://openrouter.ai/api/v1/chat/completions";  // Or a local stand-in
+        std::vector<std::string> raceModels;  // Racing: also send each prompt to these (up to 2)
     };
 
+    // Receives each piece of generated text as it streams in (worker thread)
+    using DeltaCallback = std::function<void(std::string_view)>;
+
     struct Response {
         bool success = false;
         std::string content;
         std::string error;
+        int httpStatus = 0;        // HTTP status (or API error code), 0 if never answered
+        bool cancelled = false;    // Aborted through the stop token
+        int promptTokens = 0;      // From the "usage" report, 0 if none was sent
+        int completionTokens = 0;
+        std::string model;         // Model that answered (the winner when racing)
     };
 
+    // Accepts or rejects a successful response. Racing takes the first accepted one;
+    // called from the request threads, so it must not touch shared state.
+    using ResponseValidator = std::function<bool(const Response&)>;
+
     // Initialize with API key (loaded from config file)
     bool Initialize();
     
@@ -27,18 +50,41 @@ namespace OpenRouterAPI {
     // Save config to file
     void SaveConfig();
 
-    // Send a prompt to OpenRouter (async)
-    // Callback will be called on completion
+    // Send a prompt to OpenRouter (async, through LLMScheduler with a copy of the current config)
+    // Callback will be called on completion, onDelta while the response streams
     void SendPromptAsync(
         const std::string& systemPrompt,
         const std::string& userPrompt,
-        std::function<void(const Response&)> callback
+        std::function<void(const Response&)> callback,
+        DeltaCallback onDelta = {}
+    );
+
+    // Send a prompt (blocking) with the current config
+    Response SendPrompt(
+        const std::string& systemPrompt,
+        const std::string& userPrompt,
+        const DeltaCallback& onDelta = {}
     );
 
-    // Send a prompt (blocking)
+    // Send a prompt (blocking) with an explicit config - safe to call from several threads.
+    // A stop request aborts the transfer while the response body is being received.
     Response SendPrompt(
+        const Config& config,
+        const std::string& systemPrompt,
+        const std::string& userPrompt,
+        const DeltaCallback& onDelta = {},
+        std::stop_token stopToken = {}
+    );
+
+    // Send the same prompt to config.model and config.raceModels at once (blocking). The
+    // first successful response the validator accepts wins, the other requests are
+    // cancelled. Nothing is streamed. Without race models this is SendPrompt().
+    Response SendPromptRace(
+        const Config& config,
         const std::string& systemPrompt,
-        const std::string& userPrompt
+        const std::string& userPrompt,
+        const ResponseValidator& accept = {},
+        std::stop_token stopToken = {}
     );
 
 }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <functional>
+#include <stop_token>
+
+// =============================================================================
+// ProcessRunner
+// =============================================================================
+// Runs an external helper (e.g. the SpellTreeBuilder Python addon) with its
+// stdin/stdout/stderr connected to pipes. Input is written from memory, output
+// is collected in memory - no temp files. Stdout lines starting with the
+// progress prefix are reported through a callback instead of being collected.
+//
+// Run() blocks the calling thread and returns when the process exits, times
+// out or is cancelled through the stop token. RunAsync() does the same on the
+// thread pool's blocking lane. A timed out / cancelled process is killed
+// together with any processes it started.
+// =============================================================================
+
+namespace ProcessRunner
+{
+struct Options
+{
+  std::vector<std::string> args;             // args[0] = program (searched on PATH)
+  std::string input;                         // Written to stdin, which is then closed
+  std::filesystem::path workingDirectory;    // Empty = inherit
+  std::chrono::milliseconds timeout{0};      // 0 = no limit
+  std::string progressPrefix = "@progress";  // Stdout lines starting with this are progress
+
+  // Receives progress lines (prefix stripped) on the runner thread
+  std::function<void(std::string_view)> onProgress;
+};
+
+enum class Status
+{
+  Exited,        // Process ran to completion (check exitCode)
+  LaunchFailed,  // Could not create pipes or start the program
+  TimedOut,
+  Cancelled
+};
+
+struct Result
+{
+  Status status = Status::LaunchFailed;
+  int exitCode  = -1;
+  std::string output;       // Stdout without progress lines
+  std::string errorOutput;  // Stderr (tail only, see kMaxErrorOutput)
+  std::string error;        // Launch error description
+
+  bool Succeeded() const { return status == Status::Exited && exitCode == 0; }
+
+  // One-line description for logs and the panel
+  std::string Describe() const;
+};
+
+// Bytes of stderr kept in Result::errorOutput
+constexpr size_t kMaxErrorOutput = 16 * 1024;
+
+// Run a process to completion on the calling thread
+Result Run(const Options& options, std::stop_token stopToken = {});
+
+// Run on a blocking-lane thread. The returned source cancels the process.
+std::stop_source RunAsync(Options options, std::function<void(Result)> onComplete);
+}  // namespace ProcessRunner
@@ -61,6 +61,9 @@ public:
     void OnSpellCast(const std::string& school, RE::FormID castSpellId, float baseXP);
     void AddXP(RE::FormID targetSpellId, float amount);
     void AddXP(const std::string& formIdStr, float amount);  // String overload for DEST integration
+
+    // Metrics: one XP grant from a source ("cast_school", "tome", ...) toward a spell of a school
+    static void CountXPEvent(std::string_view source, std::string_view school);
     SpellProgress GetProgress(RE::FormID formId) const;
     void SetRequiredXP(RE::FormID formId, float required);
     
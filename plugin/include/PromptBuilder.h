@@ -0,0 +1,87 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// PromptBuilder
+// =============================================================================
+// Turns the per-school spell list sent by the panel into LLM user prompts.
+//
+// Spells are encoded as a table - one header line naming the columns, then
+// one "|"-separated row per spell - instead of a JSON array that repeats
+// every key for every spell. Constant or load-order-only fields (school,
+// persistentId) are dropped.
+//
+// Schools whose table would exceed the token budget, or whose tree would not
+// fit the response limit, are split into parts. Spells are ordered by tier
+// and variant families are never split, so every part is a tier band. Part 1
+// holds the root; later parts attach to spells of earlier parts. MergeParts()
+// stitches the part responses back into one tree and repairs what does not
+// fit together (unknown/duplicate spells, dangling prerequisites, cycles
+// across parts), then checks the result with TreeRepair::Analyze.
+// =============================================================================
+
+namespace PromptBuilder
+{
+struct Part
+{
+  std::string table;                 // Header + rows of this part
+  std::vector<std::string> formIds;  // Spells of this part, in table order
+  std::vector<std::string> names;    // Parallel to formIds
+  size_t estimatedTokens = 0;
+};
+
+struct Plan
+{
+  std::string school;
+  std::vector<Part> parts;
+  std::unordered_map<std::string, int> tiers;  // formId -> tier (1 = Novice .. 5 = Master)
+
+  // Size of the spell data as received vs. as encoded
+  size_t jsonBytes     = 0;
+  size_t compactBytes  = 0;
+  size_t jsonTokens    = 0;
+  size_t compactTokens = 0;
+
+  size_t SpellCount() const { return tiers.size(); }
+  json StatsToJson() const;
+};
+
+struct Limits
+{
+  size_t tokenBudget  = 30000;  // Estimated tokens of spell table per prompt
+  int maxOutputTokens = 64000;  // Response limit of the request
+};
+
+// "0x0001a4b2" / " 0X0001A4B2" -> "0x0001A4B2" so LLM spelling variants still match
+std::string CanonicalFormId(std::string_view formId);
+
+// Tier of a scanned spell (1 = Novice .. 5 = Master) from skillLevel, else minimumSkill
+int SpellTier(const json& spell);
+
+// Response text between the first '{' and the last '}' (drops ```json fences and chatter)
+std::string_view JsonBody(std::string_view response);
+
+// Rough BPE token estimate: alphanumeric runs count one token per 4 characters,
+// every other visible character one token
+size_t EstimateTokens(std::string_view text);
+
+// Parse the panel's spellData (JSON array of spell objects) and plan the prompt parts.
+// Returns false if spellData is not a spell array - the caller then sends it unchanged.
+bool BuildPlan(const std::string& school, const std::string& spellData, const Limits& limits, Plan& plan);
+
+// User prompt for one part of the plan
+std::string BuildUserPrompt(const Plan& plan, size_t partIndex, const std::string& promptRules);
+
+struct MergeResult
+{
+  bool success = false;
+  std::string error;
+  std::string tree;                 // Merged response in the single-request format
+  std::vector<std::string> issues;  // Repairs that were made, for the log and the panel
+  size_t nodeCount = 0;
+};
+
+// Combine the responses of all parts (in part order) into one tree
+MergeResult MergeParts(const Plan& plan, const std::vector<std::string>& responses);
+}  // namespace PromptBuilder
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <unordered_set>
+
+// =============================================================================
+// ScanCache
+// =============================================================================
+// Persists spell scan results between sessions in a compact binary file next to
+// spell_scan_output.json. Entries are keyed by FormID and remember which plugins
+// defined/overrode the form, so after a load order change only the forms that
+// touch changed plugins have to be rebuilt.
+// =============================================================================
+
+namespace ScanCache
+{
+// One plugin of the active load order
+struct PluginStamp
+{
+  std::string name;
+  uint32_t loadIndex = 0;  // Compile index, or 0xFE000 | light index for ESL plugins
+  uint64_t fileSize  = 0;
+  int64_t writeTime  = 0;  // Raw file_time ticks
+
+  bool operator==(const PluginStamp&) const = default;
+};
+
+// Fingerprint of the active load order (names, order, sizes, timestamps)
+struct LoadOrderFingerprint
+{
+  std::vector<PluginStamp> plugins;
+  uint64_t hash = 0;
+};
+
+// Build the fingerprint of the currently loaded plugins (requires kDataLoaded)
+LoadOrderFingerprint BuildLoadOrderFingerprint();
+
+// Names of every plugin that defines or overrides a form, in load order
+std::vector<std::string> GetFormSourceFiles(const RE::TESForm* form);
+
+// Cached scan outcome for one form
+struct CachedForm
+{
+  uint8_t verdict = 0;               // Scanner-defined result (included / skipped / filtered)
+  std::vector<std::string> sources;  // Plugins the record was built from
+  std::string record;                // Serialized output record (empty when not included)
+};
+
+class Cache
+{
+public:
+  // Load a cache file. Fails if missing, corrupt, or built with a different config key or filter
+  // rules hash (0 for scans without an editor ID filter).
+  bool Load(const std::filesystem::path& path, uint32_t configKey, uint64_t rulesHash);
+
+  // Queue the cache file for the given fingerprint on the AsyncFileWriter (temp file + rename)
+  bool Save(const std::filesystem::path& path, uint32_t configKey, uint64_t rulesHash,
+            const LoadOrderFingerprint& fingerprint) const;
+
+  // True if the cache was built against exactly this load order
+  bool Matches(const LoadOrderFingerprint& fingerprint) const;
+
+  // Plugins that were added, removed, reordered or modified since the cache was written
+  std::unordered_set<std::string> GetChangedPlugins(const LoadOrderFingerprint& fingerprint) const;
+
+  // Cached entry for a form, or nullptr if the form must be rescanned.
+  // An entry is only reusable when its source plugins are identical and unchanged.
+  const CachedForm* FindReusable(RE::FormID formId, const std::vector<std::string>& sources,
+                                 const std::unordered_set<std::string>& changedPlugins) const;
+
+  // Entries in original scan order (for replaying a full cache hit)
+  const std::vector<RE::FormID>& GetOrder() const { return m_order; }
+  const CachedForm* Find(RE::FormID formId) const;
+
+  void Store(RE::FormID formId, CachedForm entry);
+  void Clear();
+  size_t Size() const { return m_forms.size(); }
+
+private:
+  LoadOrderFingerprint m_fingerprint;
+  std::unordered_map<RE::FormID, CachedForm> m_forms;
+  std::vector<RE::FormID> m_order;
+};
+
+// Cache file locations (alongside spell_scan_output.json)
+std::filesystem::path GetSpellCachePath();
+std::filesystem::path GetTomeCachePath();
+}  // namespace ScanCache
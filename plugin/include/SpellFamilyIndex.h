@@ -0,0 +1,31 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// SpellFamilyIndex
+// =============================================================================
+// Detects spell variant families ("Locust I", "Locust II", "Greater Locust")
+// so the LLM prompt and the procedural builders get pre-computed groups instead
+// of having to infer them from names.
+//
+// Names are normalized (roman numerals, rank words, numbers and bracketed
+// suffixes removed). Spells with the same normalized name form a family;
+// near-identical names (character trigram MinHash, LSH banding) join a family
+// when they also share at least one magic effect. Runs in O(n log n).
+// =============================================================================
+
+namespace SpellFamilyIndex
+{
+struct SpellEntry
+{
+  std::string name;
+  std::vector<RE::FormID> effects;  // Base effect FormIDs
+};
+
+// "Greater Locust Swarm III [Staff]" -> "locust swarm"
+std::string NormalizeName(std::string_view name);
+
+// Family id per entry (the family's normalized name), empty for spells without variants
+std::vector<std::string> BuildFamilies(const std::vector<SpellEntry>& spells);
+}  // namespace SpellFamilyIndex
@@ -2,6 +2,8 @@
 
 #include "PCH.h"
 
+class JsonWriter;
+
 namespace SpellScanner
 {
 // Field output configuration
@@ -24,6 +26,8 @@ struct ScanConfig
 {
   FieldConfig fields;
   std::string treeRulesPrompt;
+  bool useCache          = true;  // Reuse spell_scan_cache.bin when the load order allows it
+  uint32_t workerThreads = 0;     // Scan worker threads (0 = one per hardware thread)
 };
 
 // Parse scan config from JSON string (includes fields and treeRulesPrompt)
@@ -32,6 +36,26 @@ ScanConfig ParseScanConfig(const std::string& jsonConfig);
 // Parse field config from JSON string (legacy support)
 FieldConfig ParseFieldConfig(const std::string& jsonConfig);
 
+// Scanned spell records, each a compact serialized JSON object in form order
+struct ScanResult
+{
+  std::vector<std::string> records;
+  std::vector<RE::FormID> formIds;     // Scanned form per record (the tome for tome scans)
+  std::vector<std::string> familyIds;  // Variant family per record, empty when the spell has no variants
+  std::string scanMode;                // Empty for a full spell scan
+};
+
+// Build spell records without assembling the output document
+ScanResult ScanSpellRecords(const ScanConfig& config);
+ScanResult ScanSpellTomeRecords(const ScanConfig& config);
+
+// Stream the scan output document (timestamp, spells, llmPrompt) into a writer
+void WriteScanOutput(JsonWriter& writer, const ScanResult& result, const ScanConfig& config);
+
+// Queue the pretty-printed scan output for writing to a file (AsyncFileWriter)
+bool SaveScanOutput(const ScanResult& result, const ScanConfig& config, const std::filesystem::path& path);
+std::filesystem::path GetScanOutputPath();
+
 // Scan all spells and return JSON output with spell data + prompts
 std::string ScanAllSpells(const ScanConfig& config);
 std::string ScanAllSpells(const FieldConfig& config = FieldConfig{});
@@ -46,6 +70,9 @@ std::string GetSystemInstructions();
 // Returns JSON with: formId, name, editorId, school, level, cost, type, effects, description
 std::string GetSpellInfoByFormId(const std::string& formIdStr);
 
+// The same as a json object (null when not found) - for batches, without a dump / parse round trip
+json GetSpellInfo(const std::string& formIdStr);
+
 // =========================================================================
 // PERSISTENT FORMID FUNCTIONS (Load Order Resilient)
 // =========================================================================
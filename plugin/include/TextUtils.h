@@ -0,0 +1,30 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// TextUtils
+// =============================================================================
+// Shared text helpers. SanitizeToUTF8 is used on everything that ends up in a
+// json value (spell/effect names, descriptions, prompts, LLM responses), since
+// nlohmann::json throws type_error.316 on invalid UTF-8 when dumping.
+// =============================================================================
+
+namespace TextUtils
+{
+/**
+ * Sanitize a string to valid UTF-8.
+ * Valid UTF-8 (including pure ASCII) is copied through unchanged in bulk. Only bytes that do not
+ * start a valid sequence are replaced: Windows-1252 punctuation (0x80-0x9F, common in mod text)
+ * with ASCII equivalents, anything else with '?'.
+ * Validation runs on 32-byte blocks with AVX2 when the CPU supports it, 16-byte SSE2 ASCII runs
+ * otherwise, and falls back to scalar code on other targets.
+ */
+std::string SanitizeToUTF8(std::string_view input);
+
+// Append the sanitized form of input to out (avoids a temporary when building larger strings)
+void AppendSanitizedUTF8(std::string& out, std::string_view input);
+
+// True if input is entirely valid UTF-8
+bool IsValidUTF8(std::string_view input);
+}  // namespace TextUtils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "PCH.h"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <stop_token>
+
+// =============================================================================
+// ThreadPool
+// =============================================================================
+// Shared workers for everything that should not run on the game or UI thread:
+// scanning, tree validation, JSON parsing and file I/O.
+//
+//   - Sized to the cores the game leaves spare (main and render threads).
+//   - Jobs submitted from a worker go to that worker's own deque and idle
+//     workers steal from the other end, so nested work (a scan splitting
+//     itself into chunks) stays local and still spreads out.
+//   - Priorities order the shared queue: High (the player is waiting on the
+//     panel) before a worker's own jobs, Normal, then Low.
+//   - A job whose stop token is triggered before it starts is dropped; running
+//     jobs check the token themselves.
+//   - SubmitThen() runs the second step on the game thread through
+//     SKSE::GetTaskInterface().
+//
+// Jobs that mostly wait (HTTP requests, child processes) would starve CPU work,
+// so SubmitBlocking() runs them on a separate lane of threads that are reused
+// while busy and retire after idling.
+// =============================================================================
+
+class ThreadPool
+{
+public:
+    enum class Priority : uint8_t
+    {
+        High,
+        Normal,
+        Low,
+
+        Count
+    };
+
+    using Job = std::function<void()>;
+
+    static ThreadPool* GetSingleton();
+
+    void Submit(Job job, Priority priority = Priority::Normal, std::stop_token stopToken = {});
+
+    // work() on a worker, then then(result) on the game thread - neither runs if stopped before the start
+    template <class Work, class Then>
+    void SubmitThen(Work work, Then then, Priority priority = Priority::Normal, std::stop_token stopToken = {})
+    {
+        Submit(
+            [work = std::move(work), then = std::move(then)]() mutable {
+                if constexpr (std::is_void_v<std::invoke_result_t<Work&>>) {
+                    work();
+                    RunOnGameThread(std::move(then));
+                } else {
+                    RunOnGameThread([then = std::move(then), result = work()]() mutable { then(std::move(result)); });
+                }
+            },
+            priority, std::move(stopToken));
+    }
+
+    // For jobs that block on I/O for a long time - never queued behind CPU work or each other
+    void SubmitBlocking(Job job);
+
+    // fn(i) for every i in [0, count) on up to maxParallelism threads (0 = all workers). The caller
+    // works through indices too and returns once all are done, so it is safe to call from a worker.
+    void ParallelFor(size_t count, size_t maxParallelism, const std::function<void(size_t)>& fn);
+
+    size_t GetWorkerCount() const { return m_workers.size(); }
+
+    static void RunOnGameThread(Job job);
+
+private:
+    ThreadPool();
+
+    struct Task
+    {
+        Job job;
+        std::stop_token stopToken;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> local;  // Owner pops the back, thieves take the front
+    };
+
+    void WorkerLoop(size_t index);
+    bool TryPop(size_t index, Task& task);
+    void BlockingLoop();
+
+    static void Run(Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_mutex;  // Shared queues and sleeping workers
+    std::condition_variable m_wake;
+    std::array<std::deque<Task>, static_cast<size_t>(Priority::Count)> m_queues;
+    std::atomic<size_t> m_pending{0};  // Queued tasks, shared and local
+
+    std::mutex m_blockingMutex;
+    std::condition_variable m_blockingWake;
+    std::deque<Job> m_blockingQueue;
+    size_t m_blockingIdle = 0;
+};
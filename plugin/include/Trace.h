@@ -0,0 +1,88 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// Trace
+// =============================================================================
+// Scoped trace zones for finding where time goes during load, tree import and
+// panel open:
+//
+//   void UIManager::ShowPanel()
+//   {
+//     SL_TRACE_SCOPE("UIManager::ShowPanel");
+//     ...
+//
+// While recording, every zone appends one event (name, start and end in
+// nanoseconds) to a buffer owned by the calling thread - no locks and no
+// allocation after the thread's first event. WriteChromeTrace() saves the
+// current session as a Chrome trace-event file for chrome://tracing or
+// ui.perfetto.dev. When not recording a zone costs one relaxed load and a
+// branch. Zone names must be string literals (only the pointer is stored).
+// =============================================================================
+
+namespace Trace
+{
+namespace detail
+{
+extern std::atomic<bool> g_recording;
+
+int64_t Now();
+void Record(const char* name, int64_t start, int64_t end);
+}  // namespace detail
+
+inline bool IsRecording()
+{
+  return detail::g_recording.load(std::memory_order_relaxed);
+}
+
+// Begin a new session (events of the previous one are discarded) / stop recording
+void Start();
+void Stop();
+
+// Label the calling thread in the trace (threads are numbered otherwise)
+void SetThreadName(std::string name);
+
+struct DumpResult
+{
+  bool success = false;
+  std::string error;
+  size_t events  = 0;
+  size_t dropped = 0;  // Zones lost because a thread's buffer was full
+  size_t threads = 0;
+};
+
+// Write the events of the current session recorded so far
+DumpResult WriteChromeTrace(const std::filesystem::path& path);
+
+std::filesystem::path GetTracePath();
+
+class Scope
+{
+public:
+  explicit Scope(const char* name) : m_name(IsRecording() ? name : nullptr)
+  {
+    if (m_name) {
+      m_start = detail::Now();
+    }
+  }
+
+  ~Scope()
+  {
+    if (m_name) {
+      detail::Record(m_name, m_start, detail::Now());
+    }
+  }
+
+  Scope(const Scope&)            = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* m_name;
+  int64_t m_start = 0;
+};
+}  // namespace Trace
+
+#define SL_TRACE_CONCAT_INNER(a, b) a##b
+#define SL_TRACE_CONCAT(a, b)       SL_TRACE_CONCAT_INNER(a, b)
+#define SL_TRACE_SCOPE(name)        Trace::Scope SL_TRACE_CONCAT(slTraceScope, __LINE__)(name)
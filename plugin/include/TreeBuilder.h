@@ -0,0 +1,39 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// TreeBuilder
+// =============================================================================
+// Native procedural spell tree generator (replaces SpellTreeBuilder/build_tree.py).
+// Spells are grouped by school, ordered by skill tier and linked to the most
+// similar already-placed spell (TF-IDF over name, effect and keyword tokens),
+// within the max-children / max-prerequisite limits from the tree rules.
+// Spells sharing a scan familyId (SpellFamilyIndex) are placed as siblings.
+//
+// Output has the same shape as the LLM and Python trees:
+//   { version, generator, schools: { School: { root, layoutStyle, nodes: [...] } },
+//     school_configs, [fuzzy_relationships, similarity_scores, fuzzy_groups, spell_themes] }
+// =============================================================================
+
+namespace TreeBuilder
+{
+struct BuildConfig
+{
+  int maxChildrenPerNode  = 3;  // "max 3 children per node" tree rule
+  int maxPrerequisites    = 2;  // Parent + at most one convergence prerequisite
+  int topThemesPerSchool  = 8;
+  int convergenceAtTier   = 3;  // Tier index (0 = Novice) from which convergence is allowed
+  float convergenceChance = 0.4f;
+  bool preferVanillaRoots = true;
+  bool returnFuzzyData    = false;  // Include similarity data for the visual-first builder
+  uint64_t seed           = 0;      // 0 = random
+  json schoolConfig;                // Shape/density/etc. echoed back in school_configs
+};
+
+// Read the procedural config sent by the panel (same keys the Python tool used)
+BuildConfig ParseBuildConfig(const json& config);
+
+// Build trees for every school present in spells (array of scan records)
+json BuildTrees(const json& spells, const BuildConfig& config);
+}  // namespace TreeBuilder
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// TreeRepair
+// =============================================================================
+// Targeted repair of an LLM-generated school tree. Instead of sending the whole
+// tree back for regeneration, Analyze() finds the minimal invalid region:
+//
+//   - cycle members   (strongly connected components of the prerequisite graph)
+//   - orphans         (non-root spells without prerequisites)
+//   - dangling links  (prerequisites naming spells that are not in the tree)
+//   - missing spells  (scanned spells the response left out)
+//
+// Every other unreachable spell only depends on one of these and becomes
+// reachable once they are fixed. The repair prompt lists just the region plus
+// the reachable spells around it as attachment points, and Splice() writes the
+// returned prerequisites back into the full tree. Prompt and response size
+// scale with the number of defects, not with the size of the school.
+//
+// Unlock semantics match TreeParser in the panel: a spell unlocks once ALL of
+// its prerequisites are unlocked, starting from the root.
+// =============================================================================
+
+namespace TreeRepair
+{
+struct TreeNode
+{
+  std::string formId;  // Canonical
+  std::string name;
+  int tier = 0;
+  std::vector<std::string> prerequisites;  // From prerequisites and the parents' children lists
+  json data;                               // Node as returned by the LLM
+};
+
+struct RegionNode
+{
+  std::string formId;
+  std::string problem;  // "cycle", "orphan", "dangling" or "missing"
+};
+
+struct Analysis
+{
+  std::string school;
+  std::string root;
+  json document;  // Parsed response, the school's nodes are replaced on splice
+
+  std::vector<TreeNode> nodes;                     // In response order
+  std::unordered_map<std::string, size_t> index;   // formId -> nodes
+  std::unordered_map<std::string, json> expected;  // Scanned spells by formId
+
+  std::vector<std::vector<std::string>> cycles;  // One entry per strongly connected component
+  std::vector<RegionNode> region;                // Minimal set to repair
+  std::vector<std::string> downstream;           // Unreachable only because of the region
+  std::vector<std::string> neighborhood;         // Reachable spells offered as prerequisites
+  size_t reachableCount = 0;
+
+  bool Valid() const { return region.empty(); }
+  json ToJson() const;
+};
+
+// Parse the school's tree response and find the invalid region. spellData is the
+// panel's spell array for the school (may be empty - then no spell counts as missing).
+bool Analyze(const std::string& school, const std::string& treeResponse, const std::string& spellData,
+             Analysis& analysis, std::string& error);
+
+// System and user prompt of the repair request
+const char* GetSystemPrompt();
+std::string BuildRepairPrompt(const Analysis& analysis, const std::string& promptRules);
+
+struct SpliceResult
+{
+  bool success = false;
+  std::string error;
+  std::string tree;        // Full tree with the repairs applied, in the generation response format
+  size_t repaired    = 0;  // Region spells that received new prerequisites
+  size_t added       = 0;  // Missing spells added to the tree
+  size_t rejected    = 0;  // Returned prerequisites that were unusable
+  size_t remaining   = 0;  // Region size of the spliced tree
+  size_t unreachable = 0;  // Unreachable spells left in the spliced tree
+
+  json ToJson() const;
+};
+
+// Apply the repair response ({"nodes":[{"formId","prerequisites"}]}) to the analysed tree
+SpliceResult Splice(const Analysis& analysis, const std::string& repairResponse);
+}  // namespace TreeRepair
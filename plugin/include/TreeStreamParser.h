@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PCH.h"
+
+// =============================================================================
+// TreeStreamParser
+// =============================================================================
+// Incremental scanner for an LLM tree response that is still being generated:
+//   { "schools": { "Destruction": { "root": ..., "nodes": [ {...}, {...}, ...
+// Every object that completes inside a "nodes" array is reported together
+// with its school while the rest of the document is still arriving, so the
+// panel can show nodes long before the full completion is done.
+//
+// Text before the first '{' (e.g. a ```json fence) is skipped. Only the
+// structure is tracked; each reported node is parsed on its own.
+// =============================================================================
+
+class TreeStreamParser
+{
+public:
+    struct Node
+    {
+        std::string school;
+        json data;
+    };
+
+    // Feed the next piece of model output; completed nodes are appended to completed
+    void Feed(std::string_view text, std::vector<Node>& completed);
+
+    size_t NodeCount() const { return m_nodeCount; }
+
+private:
+    struct Frame
+    {
+        bool isObject = false;
+        bool expectingKey = false;  // Objects only: next string is a member name
+        std::string key;            // Member name this container is the value of
+    };
+
+    void OnContainerOpen(bool isObject);
+    void OnContainerClose(std::vector<Node>& completed);
+
+    // True if the innermost frame is an object directly inside a "nodes" array
+    bool InNodeObject() const;
+
+    std::vector<Frame> m_stack;
+    std::string m_pendingKey;   // Last member name, applies to the next value
+    std::string m_string;       // Current string (member names only, capped)
+    std::string m_capture;      // Text of the node object being received
+    bool m_started = false;
+    bool m_inString = false;
+    bool m_escape = false;
+    bool m_stringIsKey = false;
+    size_t m_nodeCount = 0;
+};
@@ -3,6 +3,8 @@
 #include "PCH.h"
 #include "PrismaUI_API.h"
 
+#include <stop_token>
+
 class UIManager
 {
 public:
@@ -96,6 +98,9 @@ private:
     static void OnGetPlayerKnownSpells(const char* argument);
     static void OnSetHotkey(const char* argument);
     static void OnSetPauseGameOnFocus(const char* argument);
+    static void OnSetLogLevels(const char* argument);
+    static void OnSetTraceRecording(const char* argument);
+    static void OnGetHookStats(const char* argument);
     static void OnSetTreePrerequisites(const char* argument);
     
     // Settings callbacks (legacy)
@@ -118,8 +123,12 @@ private:
     static void OnSaveLLMConfig(const char* argument);
     static void OnLogMessage(const char* argument);
     
-    // Procedural tree generation (Python)
+    // Procedural tree generation (native TreeBuilder, Python addon for LLM options)
     static void OnProceduralPythonGenerate(const char* argument);
+    static void OnProceduralPythonCancel(const char* argument);
+    static std::filesystem::path FindPythonTreeBuilder();
+    static std::string RunPythonTreeBuilder(const nlohmann::json& spells, const nlohmann::json& config,
+                                            std::stop_token stopToken);
     
     // Panel control callbacks
     static void OnHidePanel(const char* argument);
@@ -132,6 +141,10 @@ private:
     bool m_hasFocus = false;  // Track if we have focus (for main menu → game fix)
     bool m_pauseGameOnFocus = false;  // Default false to avoid input conflicts with menu mods in heavy modlists
 
+    // Cancels the running procedural build (Python process)
+    std::mutex m_treeBuildMutex;
+    std::stop_source m_treeBuildStop;
+
     // Helper for focus retry logic (HIRCINE bug fix)
     void ScheduleFocusRetry(bool pauseGame, int attempt);
     
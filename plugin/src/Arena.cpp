@@ -0,0 +1,41 @@
+#include "Arena.h"
+#include "Logging.h"
+#include "Metrics.h"
+
+Arena::Arena(const char* operation, size_t initialSize) :
+    m_operation(operation), m_start(std::chrono::steady_clock::now()), m_buffer(initialSize, &m_upstream)
+{}
+
+Arena::~Arena()
+{
+  Metrics::GetCounter("spelllearning_arena_allocations", "Allocations served from per-operation arenas",
+                      {{"operation", m_operation}})
+      .Add(m_allocations);
+  Metrics::GetCounter("spelllearning_arena_heap_blocks", "Heap blocks taken by per-operation arenas",
+                      {{"operation", m_operation}})
+      .Add(m_upstream.GetBlockCount());
+
+  auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+  SL_LOG_DEBUG(Core, "Arena {}: {} allocations ({} KB) from {} heap blocks ({} KB), released after {:.1f} ms",
+               m_operation, m_allocations, m_bytes / 1024, m_upstream.GetBlockCount(), m_upstream.GetBytes() / 1024,
+               elapsedMs);
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+  m_allocations++;
+  m_bytes += bytes;
+  return m_buffer.allocate(bytes, alignment);
+}
+
+void* Arena::Upstream::do_allocate(size_t bytes, size_t alignment)
+{
+  m_blocks++;
+  m_bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void Arena::Upstream::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
@@ -0,0 +1,165 @@
+#include "AsyncFileWriter.h"
+#include "Logging.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace
+{
+// Saves of the same file closer together than this are written once
+constexpr auto kDebounceWindow = 250ms;
+}  // namespace
+
+AsyncFileWriter* AsyncFileWriter::GetSingleton()
+{
+  // Never destroyed - a writer job on the pool may still be waiting on it at process exit
+  static AsyncFileWriter* singleton = new AsyncFileWriter();
+  return singleton;
+}
+
+std::shared_future<bool> AsyncFileWriter::Write(std::filesystem::path path, std::string content, Callback onWritten)
+{
+  std::shared_future<bool> future;
+  {
+    std::lock_guard lock(m_mutex);
+    auto [it, inserted] = m_pending.try_emplace(std::move(path));
+    auto& pending       = it->second;
+    if (inserted) {
+      pending.future = pending.promise.get_future().share();
+      pending.due    = std::chrono::steady_clock::now() + kDebounceWindow;
+    } else {
+      SL_LOG_DEBUG(Core, "AsyncFileWriter: Replaced queued write of {}", it->first.filename().string());
+    }
+    pending.content = std::move(content);
+    if (onWritten) {
+      pending.callbacks.push_back(std::move(onWritten));
+    }
+    future = pending.future;
+
+    // One writer job at a time; it ends once nothing is queued
+    if (!m_writerRunning) {
+      m_writerRunning = true;
+      ThreadPool::GetSingleton()->SubmitBlocking([this]() { WriterLoop(); });
+    }
+  }
+  m_wake.notify_one();
+  return future;
+}
+
+void AsyncFileWriter::Flush(const std::filesystem::path& path)
+{
+  std::shared_future<bool> future;
+  {
+    std::lock_guard lock(m_mutex);
+    auto it = m_pending.find(path);
+    if (it != m_pending.end()) {
+      it->second.due = std::chrono::steady_clock::now();
+      future         = it->second.future;
+    } else if (m_writingFuture.valid() && m_writingPath == path) {
+      future = m_writingFuture;
+    }
+  }
+  if (future.valid()) {
+    m_wake.notify_one();
+    future.wait();
+  }
+}
+
+void AsyncFileWriter::Expedite()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+    for (auto& [path, pending] : m_pending) {
+      pending.due = now;
+    }
+  }
+  m_wake.notify_one();
+}
+
+void AsyncFileWriter::WriterLoop()
+{
+  std::unique_lock lock(m_mutex);
+  while (!m_pending.empty()) {
+    auto next = std::min_element(m_pending.begin(), m_pending.end(),
+                                 [](const auto& a, const auto& b) { return a.second.due < b.second.due; });
+    if (std::chrono::steady_clock::now() < next->second.due) {
+      // Woken early by a new, replaced or expedited write - pick the next due one again
+      m_wake.wait_until(lock, next->second.due);
+      continue;
+    }
+
+    auto path    = next->first;
+    auto pending = std::move(next->second);
+    m_pending.erase(next);
+    m_writingPath   = path;
+    m_writingFuture = pending.future;
+    lock.unlock();
+
+    bool success = WriteFile(path, pending.content);
+    pending.promise.set_value(success);
+    for (auto& callback : pending.callbacks) {
+      ThreadPool::RunOnGameThread([callback = std::move(callback), success]() { callback(success); });
+    }
+
+    lock.lock();
+    m_writingPath.clear();
+    m_writingFuture = {};
+  }
+  m_writerRunning = false;
+}
+
+bool AsyncFileWriter::WriteFile(const std::filesystem::path& path, const std::string& content)
+{
+  SL_TRACE_SCOPE("AsyncFileWriter::WriteFile");
+
+  std::error_code ec;
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+
+  auto tempPath = path;
+  tempPath += ".tmp";
+
+#ifdef _WIN32
+  FILE* file = _wfopen(tempPath.c_str(), L"wb");
+#else
+  FILE* file = std::fopen(tempPath.c_str(), "wb");
+#endif
+  if (!file) {
+    logger::error("AsyncFileWriter: Could not open {} for writing", tempPath.string());
+    return false;
+  }
+
+  // Data has to be on disk before the rename, or a crash can leave an empty file under the real name
+  bool written = std::fwrite(content.data(), 1, content.size(), file) == content.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+  written = written && _commit(_fileno(file)) == 0;
+#else
+  written = written && fsync(fileno(file)) == 0;
+#endif
+  written = std::fclose(file) == 0 && written;
+
+  if (!written) {
+    logger::error("AsyncFileWriter: Failed to write {}", tempPath.string());
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    logger::error("AsyncFileWriter: Failed to replace {}: {}", path.string(), ec.message());
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  SL_LOG_DEBUG(Core, "AsyncFileWriter: Wrote {} ({} bytes)", path.filename().string(), content.size());
+  return true;
+}
@@ -0,0 +1,112 @@
+#include "ConfigWatcher.h"
+#include "Logging.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace ConfigWatcher
+{
+namespace
+{
+constexpr uint64_t kFNVOffset = 14695981039346656037ull;
+constexpr uint64_t kFNVPrime  = 1099511628211ull;
+
+constexpr auto kPollInterval = 1s;
+
+struct FileStamp
+{
+  bool exists = false;
+  std::filesystem::file_time_type writeTime;
+  uintmax_t size = 0;
+
+  bool operator==(const FileStamp&) const = default;
+};
+
+struct WatchedFiles
+{
+  std::vector<std::filesystem::path> paths;
+  std::vector<FileStamp> stamps;
+  std::function<void()> onChanged;
+  bool changing = false;  // Changed on the last poll, waiting for it to settle
+};
+
+// Never destroyed - the detached poll thread may still be using it at process exit
+struct WatchState
+{
+  std::mutex lock;
+  std::vector<WatchedFiles> watches;
+  bool started = false;
+};
+WatchState& s_watch = *new WatchState;
+
+FileStamp ReadStamp(const std::filesystem::path& path)
+{
+  FileStamp stamp;
+  std::error_code ec;
+  stamp.writeTime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return stamp;
+  }
+  stamp.size   = std::filesystem::file_size(path, ec);
+  stamp.exists = !ec;
+  return stamp;
+}
+
+void PollLoop()
+{
+  Trace::SetThreadName("Config Watcher");
+
+  while (true) {
+    std::this_thread::sleep_for(kPollInterval);
+
+    std::lock_guard lock(s_watch.lock);
+    for (auto& watch : s_watch.watches) {
+      bool changed = false;
+      for (size_t i = 0; i < watch.paths.size(); ++i) {
+        auto stamp = ReadStamp(watch.paths[i]);
+        if (stamp != watch.stamps[i]) {
+          watch.stamps[i] = stamp;
+          changed         = true;
+        }
+      }
+
+      if (changed) {
+        watch.changing = true;
+      } else if (watch.changing) {
+        watch.changing = false;
+        SL_LOG_DEBUG(Core, "ConfigWatcher: {} changed on disk", watch.paths.front().filename().string());
+        ThreadPool::RunOnGameThread(watch.onChanged);
+      }
+    }
+  }
+}
+}  // namespace
+
+uint64_t Hash(const json& value)
+{
+  uint64_t hash = kFNVOffset;
+  for (unsigned char c : value.dump(-1, ' ', false, json::error_handler_t::replace)) {
+    hash ^= c;
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+
+void Watch(std::vector<std::filesystem::path> paths, std::function<void()> onChanged)
+{
+  WatchedFiles watch;
+  watch.stamps.reserve(paths.size());
+  for (const auto& path : paths) {
+    watch.stamps.push_back(ReadStamp(path));
+  }
+  watch.paths     = std::move(paths);
+  watch.onChanged = std::move(onChanged);
+
+  std::lock_guard lock(s_watch.lock);
+  logger::info("ConfigWatcher: Watching {} for changes", watch.paths.front().string());
+  s_watch.watches.push_back(std::move(watch));
+  if (!s_watch.started) {
+    s_watch.started = true;
+    std::thread(PollLoop).detach();
+  }
+}
+}  // namespace ConfigWatcher
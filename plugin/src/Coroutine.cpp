@@ -0,0 +1,58 @@
+#include "Coroutine.h"
+
+namespace Coroutine
+{
+namespace
+{
+// The thread SKSE runs queued tasks on, recorded by the first one we queue
+std::atomic<std::thread::id> s_gameThread;
+
+void ResumeOnGameThread(std::coroutine_handle<> handle)
+{
+  ThreadPool::RunOnGameThread([handle]() {
+    s_gameThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    handle.resume();
+  });
+}
+}  // namespace
+
+void Task::promise_type::unhandled_exception() noexcept
+{
+  try {
+    throw;
+  } catch (const std::exception& e) {
+    logger::error("Coroutine: Task failed with exception: {}", e.what());
+  } catch (...) {
+    logger::error("Coroutine: Task failed with an unknown exception");
+  }
+}
+
+void OnWorker::await_suspend(std::coroutine_handle<> handle) const
+{
+  // The coroutine may resume (and finish) on a worker before Submit returns - nothing here touches
+  // the awaiter afterwards
+  ThreadPool::GetSingleton()->Submit([handle]() { handle.resume(); }, m_priority);
+}
+
+bool OnGameThread::await_ready() const noexcept
+{
+  return IsGameThread();
+}
+
+void OnGameThread::await_suspend(std::coroutine_handle<> handle) const
+{
+  ResumeOnGameThread(handle);
+}
+
+void NextFrame::await_suspend(std::coroutine_handle<> handle) const
+{
+  // SKSE keeps running queued tasks until its queue is empty, so a task queued from a task still runs
+  // this frame. Going through the UI task queue first puts the resume into the next frame's batch.
+  SKSE::GetTaskInterface()->AddUITask([handle]() { ResumeOnGameThread(handle); });
+}
+
+bool IsGameThread()
+{
+  return s_gameThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+}  // namespace Coroutine
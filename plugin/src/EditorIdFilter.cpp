@@ -0,0 +1,357 @@
+#include "EditorIdFilter.h"
+
+#include <limits>
+#include <map>
+
+namespace
+{
+// Built-in rules - keep in sync with SKSE/Plugins/SpellLearning/spell_filter_rules.json
+constexpr const char* kDefaultRulesJson = R"({
+  "rules": [
+    { "kind": "contains", "match": "trap",                  "reason": "Trap spells" },
+    { "kind": "prefix",   "match": "cr",                    "reason": "Creature abilities" },
+    { "kind": "contains", "match": "altar",                 "reason": "Altar blessings" },
+    { "kind": "contains", "match": "shrine",                "reason": "Shrine blessings" },
+    { "kind": "contains", "match": ["blessing", "spell"],   "reason": "Blessing spells" },
+    { "kind": "prefix",   "match": "dun",                   "reason": "Dungeon-specific spells" },
+    { "kind": "prefix",   "match": "perk",                  "reason": "Perk-related spells" },
+    { "kind": "contains", "match": "hazard",                "reason": "Hazard effects" },
+    { "kind": "prefix",   "match": "power",                 "reason": "NPC powers" },
+    { "kind": "prefix",   "match": "test",                  "reason": "Test spells" },
+    { "kind": "pattern",  "match": "mg##*",                 "reason": "College quest spells" },
+    { "kind": "prefix",   "match": "mgr",                   "reason": "MGR prefix spells" },
+    { "kind": "contains", "match": "voice",                 "reason": "Dragon shout variants" },
+    { "kind": "contains", "match": ["teleport", "pet"],     "reason": "Pet teleport spells" },
+    { "kind": "contains", "match": "lefthand",              "reason": "Hand-specific variant" },
+    { "kind": "contains", "match": "righthand",             "reason": "Hand-specific variant" },
+    { "kind": "contains", "match": "copy",                  "reason": "Copy variants" }
+  ]
+})";
+
+constexpr uint32_t kNoState = std::numeric_limits<uint32_t>::max();
+
+char FoldCase(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string ToLower(std::string_view s)
+{
+  std::string out(s);
+  std::transform(out.begin(), out.end(), out.begin(), FoldCase);
+  return out;
+}
+
+bool IsGlobChar(char c)
+{
+  return c == '#' || c == '?' || c == '*';
+}
+
+bool GlobCharMatches(char p, char c)
+{
+  if (p == '#')
+    return c >= '0' && c <= '9';
+  if (p == '?')
+    return true;
+  return p == FoldCase(c);
+}
+
+// Whole-string glob match ('#' digit, '?' any char, '*' any run). Pattern is lowercase.
+bool GlobMatch(std::string_view pattern, std::string_view text)
+{
+  size_t p = 0, t = 0;
+  size_t starP = std::string_view::npos, starT = 0;
+
+  while (t < text.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      starP = p++;
+      starT = t;
+    } else if (p < pattern.size() && GlobCharMatches(pattern[p], text[t])) {
+      ++p;
+      ++t;
+    } else if (starP != std::string_view::npos) {
+      p = starP + 1;
+      t = ++starT;
+    } else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+// Longest literal run of a glob - used as the automaton anchor for the pattern
+std::string GetGlobAnchor(const std::string& pattern)
+{
+  std::string best, current;
+  for (char c : pattern) {
+    if (IsGlobChar(c)) {
+      if (current.size() > best.size())
+        best = current;
+      current.clear();
+    } else {
+      current += c;
+    }
+  }
+  return current.size() > best.size() ? current : best;
+}
+}  // namespace
+
+// =============================================================================
+// RULE LOADING
+// =============================================================================
+
+std::filesystem::path EditorIdFilter::GetRulesPath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/spell_filter_rules.json";
+}
+
+EditorIdFilter EditorIdFilter::CreateDefault()
+{
+  return EditorIdFilter(ParseRules(json::parse(kDefaultRulesJson)));
+}
+
+EditorIdFilter EditorIdFilter::LoadFromFile(const std::filesystem::path& path)
+{
+  if (!std::filesystem::exists(path)) {
+    logger::info("EditorIdFilter: {} not found, using built-in rules", path.filename().string());
+    return CreateDefault();
+  }
+
+  try {
+    std::ifstream file(path);
+    json j = json::parse(file);
+
+    auto rules = ParseRules(j);
+    logger::info("EditorIdFilter: Loaded {} filter rules from {}", rules.size(), path.filename().string());
+    return EditorIdFilter(std::move(rules));
+  } catch (const std::exception& e) {
+    logger::warn("EditorIdFilter: Failed to load {}: {} - using built-in rules", path.filename().string(), e.what());
+    return CreateDefault();
+  }
+}
+
+std::vector<EditorIdFilter::Rule> EditorIdFilter::ParseRules(const json& j)
+{
+  std::vector<Rule> rules;
+
+  for (const auto& r : j.value("rules", json::array())) {
+    if (!r.value("enabled", true)) {
+      continue;
+    }
+
+    Rule rule;
+    std::string kind = r.value("kind", "contains");
+    if (kind == "prefix") {
+      rule.kind = RuleKind::kPrefix;
+    } else if (kind == "contains") {
+      rule.kind = RuleKind::kContains;
+    } else if (kind == "pattern") {
+      rule.kind = RuleKind::kPattern;
+    } else {
+      logger::warn("EditorIdFilter: Unknown rule kind '{}', skipping", kind);
+      continue;
+    }
+
+    const auto& match = r.contains("match") ? r["match"] : json();
+    if (match.is_string()) {
+      rule.terms.push_back(ToLower(match.get<std::string>()));
+    } else if (match.is_array()) {
+      for (const auto& term : match) {
+        if (term.is_string()) {
+          rule.terms.push_back(ToLower(term.get<std::string>()));
+        }
+      }
+    }
+
+    rule.terms.erase(std::remove(rule.terms.begin(), rule.terms.end(), std::string()), rule.terms.end());
+    if (rule.terms.empty() || (rule.kind != RuleKind::kContains && rule.terms.size() != 1)) {
+      logger::warn("EditorIdFilter: Rule '{}' needs {} match term, skipping", r.value("reason", kind),
+                   rule.kind == RuleKind::kContains ? "at least one" : "exactly one");
+      continue;
+    }
+
+    rule.reason = r.value("reason", "");
+    rules.push_back(std::move(rule));
+  }
+
+  return rules;
+}
+
+// =============================================================================
+// AUTOMATON
+// =============================================================================
+
+EditorIdFilter::EditorIdFilter(std::vector<Rule> rules) : m_rules(std::move(rules))
+{
+  Compile();
+}
+
+void EditorIdFilter::Compile()
+{
+  // Conditions, deduplicated by (kind, term)
+  std::map<std::pair<RuleKind, std::string>, uint32_t> conditionIds;
+  std::vector<std::string> conditionTerms;
+
+  auto addCondition = [&](RuleKind kind, const std::string& term) -> uint32_t {
+    auto [it, inserted] = conditionIds.try_emplace({kind, term}, static_cast<uint32_t>(m_conditions.size()));
+    if (inserted) {
+      m_conditions.push_back({kind, static_cast<uint32_t>(term.size())});
+      conditionTerms.push_back(term);
+    }
+    return it->second;
+  };
+
+  m_ruleConditions.resize(m_rules.size());
+  for (size_t i = 0; i < m_rules.size(); ++i) {
+    const auto& rule = m_rules[i];
+    if (rule.kind == RuleKind::kPattern) {
+      std::string anchor = GetGlobAnchor(rule.terms[0]);
+      int anchorId       = anchor.empty() ? -1 : static_cast<int>(addCondition(RuleKind::kContains, anchor));
+      m_patterns.push_back({i, anchorId});
+    } else {
+      for (const auto& term : rule.terms) {
+        m_ruleConditions[i].push_back(addCondition(rule.kind, term));
+      }
+    }
+  }
+
+  // Compacted, case-folded alphabet
+  m_charClass.fill(0);
+  m_classCount = 1;
+  for (const auto& term : conditionTerms) {
+    for (char c : term) {
+      auto u = static_cast<uint8_t>(c);
+      if (m_charClass[u] == 0) {
+        m_charClass[u] = static_cast<uint8_t>(m_classCount++);
+        if (c >= 'a' && c <= 'z') {
+          m_charClass[static_cast<uint8_t>(c - 'a' + 'A')] = m_charClass[u];
+        }
+      }
+    }
+  }
+
+  // Trie
+  m_transitions.assign(m_classCount, kNoState);
+  m_stateOutputs.assign(1, {});
+
+  for (uint32_t id = 0; id < conditionTerms.size(); ++id) {
+    uint32_t state = 0;
+    for (char c : conditionTerms[id]) {
+      uint32_t cls   = m_charClass[static_cast<uint8_t>(c)];
+      uint32_t& next = m_transitions[state * m_classCount + cls];
+      if (next == kNoState) {
+        next = static_cast<uint32_t>(m_stateOutputs.size());
+        m_stateOutputs.emplace_back();
+        m_transitions.resize(m_stateOutputs.size() * m_classCount, kNoState);
+      }
+      state = m_transitions[state * m_classCount + cls];
+    }
+    m_stateOutputs[state].push_back(id);
+  }
+
+  // Failure links (BFS), folded into a full DFA so matching never backtracks
+  std::vector<uint32_t> fail(m_stateOutputs.size(), 0);
+  std::vector<uint32_t> queue;
+
+  for (uint32_t cls = 0; cls < m_classCount; ++cls) {
+    uint32_t& next = m_transitions[cls];
+    if (next == kNoState) {
+      next = 0;
+    } else {
+      fail[next] = 0;
+      queue.push_back(next);
+    }
+  }
+
+  for (size_t head = 0; head < queue.size(); ++head) {
+    uint32_t state = queue[head];
+
+    // Inherit outputs of the longest proper suffix that is also a term prefix
+    const auto& inherited = m_stateOutputs[fail[state]];
+    m_stateOutputs[state].insert(m_stateOutputs[state].end(), inherited.begin(), inherited.end());
+
+    for (uint32_t cls = 0; cls < m_classCount; ++cls) {
+      uint32_t& next = m_transitions[state * m_classCount + cls];
+      if (next == kNoState) {
+        next = m_transitions[fail[state] * m_classCount + cls];
+      } else {
+        fail[next] = m_transitions[fail[state] * m_classCount + cls];
+        queue.push_back(next);
+      }
+    }
+  }
+
+  // Rule set hash (FNV-1a)
+  m_rulesHash = 14695981039346656037ull;
+  auto hashByte = [this](uint8_t b) {
+    m_rulesHash ^= b;
+    m_rulesHash *= 1099511628211ull;
+  };
+  for (const auto& rule : m_rules) {
+    hashByte(static_cast<uint8_t>(rule.kind));
+    for (const auto& term : rule.terms) {
+      for (char c : term) {
+        hashByte(static_cast<uint8_t>(c));
+      }
+      hashByte(0);
+    }
+    hashByte(0xFF);
+  }
+}
+
+const EditorIdFilter::Rule* EditorIdFilter::Match(std::string_view editorId) const
+{
+  if (m_rules.empty()) {
+    return nullptr;
+  }
+
+  // Scratch buffer per thread - scans classify editor IDs from several workers
+  thread_local std::vector<uint8_t> satisfied;
+  satisfied.assign(m_conditions.size(), 0);
+
+  uint32_t state = 0;
+  for (size_t i = 0; i < editorId.size(); ++i) {
+    state = m_transitions[state * m_classCount + m_charClass[static_cast<uint8_t>(editorId[i])]];
+    for (uint32_t id : m_stateOutputs[state]) {
+      const auto& condition = m_conditions[id];
+      if (condition.kind != RuleKind::kPrefix || i + 1 == condition.termLength) {
+        satisfied[id] = 1;
+      }
+    }
+  }
+
+  const Rule* firstMatch = nullptr;
+  size_t firstIndex      = m_rules.size();
+
+  for (size_t i = 0; i < m_rules.size(); ++i) {
+    if (m_rules[i].kind == RuleKind::kPattern || m_ruleConditions[i].empty()) {
+      continue;
+    }
+    bool all = std::all_of(m_ruleConditions[i].begin(), m_ruleConditions[i].end(),
+                           [&](uint32_t id) { return satisfied[id] != 0; });
+    if (all) {
+      firstMatch = &m_rules[i];
+      firstIndex = i;
+      break;
+    }
+  }
+
+  // Pattern rules are only verified when their literal anchor was seen
+  for (const auto& pattern : m_patterns) {
+    if (pattern.ruleIndex >= firstIndex) {
+      break;
+    }
+    if (pattern.anchorCondition >= 0 && !satisfied[pattern.anchorCondition]) {
+      continue;
+    }
+    if (GlobMatch(m_rules[pattern.ruleIndex].terms[0], editorId)) {
+      return &m_rules[pattern.ruleIndex];
+    }
+  }
+
+  return firstMatch;
+}
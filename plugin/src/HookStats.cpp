@@ -0,0 +1,261 @@
+#include "HookStats.h"
+
+#include <bit>
+
+namespace HookStats
+{
+namespace
+{
+constexpr size_t kHookCount = static_cast<size_t>(Hook::Count);
+
+// Log-linear buckets: values below 8 get their own bucket, above that each power of two is split
+// into 8 linear steps (3 mantissa bits), so a bucket is at most 1/8 of its value wide.
+constexpr uint32_t kSubBits    = 3;
+constexpr uint32_t kSubBuckets = 1u << kSubBits;
+constexpr size_t kBuckets      = (64 - kSubBits + 1) * kSubBuckets;
+
+constexpr size_t BucketFor(uint64_t value)
+{
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  uint32_t msb = 63 - static_cast<uint32_t>(std::countl_zero(value));
+  uint32_t sub = static_cast<uint32_t>(value >> (msb - kSubBits)) & (kSubBuckets - 1);
+  return (msb - kSubBits + 1) * kSubBuckets + sub;
+}
+
+// Midpoint of the values that land in a bucket
+constexpr double BucketMidpoint(size_t index)
+{
+  if (index < kSubBuckets) {
+    return static_cast<double>(index);
+  }
+  uint32_t msb   = static_cast<uint32_t>(index / kSubBuckets) + kSubBits - 1;
+  uint64_t width = 1ull << (msb - kSubBits);
+  uint64_t lower = (kSubBuckets + index % kSubBuckets) * width;
+  return static_cast<double>(lower) + static_cast<double>(width - 1) / 2.0;
+}
+
+static_assert(BucketFor(7) == 7 && BucketFor(8) == 8 && BucketFor(15) == 15 && BucketFor(16) == 16);
+static_assert(BucketFor(~0ull) == kBuckets - 1);
+
+// Only the owning thread writes, so increments are a plain load + store. Collect() reads the
+// atomics from another thread and may see a call counted in `calls` but not yet in its bucket.
+struct HookCounters
+{
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> cycles{0};
+  std::atomic<uint64_t> max{0};
+  std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+};
+
+struct alignas(64) ThreadStats
+{
+  std::array<HookCounters, kHookCount> hooks;
+};
+
+// Merged view - also used as the baseline that Reset() subtracts
+struct Totals
+{
+  uint64_t calls  = 0;
+  uint64_t cycles = 0;
+  std::array<uint64_t, kBuckets> buckets{};
+};
+
+std::mutex s_lock;                                    // Thread list and baseline
+std::vector<std::unique_ptr<ThreadStats>> s_threads;  // Kept after threads exit so totals never shrink
+std::array<Totals, kHookCount> s_baseline;
+
+struct Clock
+{
+  uint64_t tsc;
+  std::chrono::steady_clock::time_point time;
+};
+const Clock s_start{detail::ReadTsc(), std::chrono::steady_clock::now()};
+auto s_windowStart = s_start.time;  // Guarded by s_lock
+
+thread_local ThreadStats* t_stats = nullptr;
+
+ThreadStats* GetThreadStats()
+{
+  if (!t_stats) {
+    std::lock_guard lock(s_lock);
+    s_threads.push_back(std::make_unique<ThreadStats>());
+    t_stats = s_threads.back().get();
+  }
+  return t_stats;
+}
+
+void Bump(std::atomic<uint64_t>& counter, uint64_t amount = 1)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// TSC ticks per microsecond, measured against steady_clock over the plugin's lifetime so far
+double TicksPerMicrosecond()
+{
+  uint64_t tsc = detail::ReadTsc();
+  auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s_start.time).count();
+  if (elapsed < 1000.0 || tsc <= s_start.tsc) {
+    return 0.0;
+  }
+  return static_cast<double>(tsc - s_start.tsc) / elapsed;
+}
+
+// Caller holds s_lock
+Totals Merge(size_t hook, uint64_t& max)
+{
+  Totals totals;
+  for (const auto& thread : s_threads) {
+    const auto& counters = thread->hooks[hook];
+    totals.calls += counters.calls.load(std::memory_order_relaxed);
+    totals.cycles += counters.cycles.load(std::memory_order_relaxed);
+    max = (std::max)(max, counters.max.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < kBuckets; ++i) {
+      totals.buckets[i] += counters.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  return totals;
+}
+
+double Percentile(const Totals& totals, uint64_t bucketed, double quantile)
+{
+  if (bucketed == 0) {
+    return 0.0;
+  }
+  auto rank     = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(bucketed)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += totals.buckets[i];
+    if (seen >= rank) {
+      return BucketMidpoint(i);
+    }
+  }
+  return BucketMidpoint(kBuckets - 1);
+}
+}  // namespace
+
+const char* GetName(Hook hook)
+{
+  switch (hook) {
+    case Hook::AdjustForPerks:
+      return "AdjustForPerks";
+    case Hook::SpellName:
+      return "SpellName";
+    case Hook::MagicMenuUI:
+      return "MagicMenuUI";
+    case Hook::SpellTomeRead:
+      return "SpellTomeRead";
+    case Hook::SpellCastEvent:
+      return "SpellCastEvent";
+    case Hook::InputEvent:
+      return "InputEvent";
+    default:
+      return "Unknown";
+  }
+}
+
+namespace detail
+{
+void Record(Hook hook, uint64_t cycles)
+{
+  auto& counters = GetThreadStats()->hooks[static_cast<size_t>(hook)];
+  Bump(counters.calls);
+  Bump(counters.cycles, cycles);
+  Bump(counters.buckets[BucketFor(cycles)]);
+  if (cycles > counters.max.load(std::memory_order_relaxed)) {
+    counters.max.store(cycles, std::memory_order_relaxed);
+  }
+}
+}  // namespace detail
+
+std::vector<Summary> Collect()
+{
+  std::vector<Summary> summaries;
+  summaries.reserve(kHookCount);
+
+  double ticksPerUs = TicksPerMicrosecond();
+  double window     = GetWindowSeconds();
+
+  std::lock_guard lock(s_lock);
+  for (size_t hook = 0; hook < kHookCount; ++hook) {
+    uint64_t max  = 0;
+    Totals totals = Merge(hook, max);
+
+    const Totals& baseline = s_baseline[hook];
+    uint64_t bucketed      = 0;
+    totals.calls -= baseline.calls;
+    totals.cycles -= baseline.cycles;
+    for (size_t i = 0; i < kBuckets; ++i) {
+      totals.buckets[i] -= baseline.buckets[i];
+      bucketed += totals.buckets[i];
+    }
+
+    Summary summary;
+    summary.name        = GetName(static_cast<Hook>(hook));
+    summary.calls       = totals.calls;
+    summary.callsPerSec = window > 0.0 ? static_cast<double>(totals.calls) / window : 0.0;
+    if (ticksPerUs > 0.0 && totals.calls > 0) {
+      summary.meanUs = static_cast<double>(totals.cycles) / static_cast<double>(totals.calls) / ticksPerUs;
+      summary.p50Us  = Percentile(totals, bucketed, 0.50) / ticksPerUs;
+      summary.p99Us  = Percentile(totals, bucketed, 0.99) / ticksPerUs;
+      summary.maxUs  = static_cast<double>(max) / ticksPerUs;
+    }
+    summaries.push_back(summary);
+  }
+  return summaries;
+}
+
+double GetWindowSeconds()
+{
+  std::lock_guard lock(s_lock);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_windowStart).count();
+}
+
+void Reset()
+{
+  std::lock_guard lock(s_lock);
+  for (size_t hook = 0; hook < kHookCount; ++hook) {
+    uint64_t max     = 0;
+    s_baseline[hook] = Merge(hook, max);
+
+    // Max can't be subtracted - clear it in place. A call finishing on another thread at the
+    // same moment may put its old max back, which only overstates the new window's max.
+    for (auto& thread : s_threads) {
+      thread->hooks[hook].max.store(0, std::memory_order_relaxed);
+    }
+  }
+  s_windowStart = std::chrono::steady_clock::now();
+  logger::info("HookStats: Counters reset");
+}
+
+json ToJson(const std::vector<Summary>& summaries)
+{
+  json result;
+  result["windowSeconds"] = GetWindowSeconds();
+  result["hooks"]         = json::array();
+  for (const auto& summary : summaries) {
+    result["hooks"].push_back({{"name", summary.name},
+                               {"calls", summary.calls},
+                               {"callsPerSec", summary.callsPerSec},
+                               {"meanUs", summary.meanUs},
+                               {"p50Us", summary.p50Us},
+                               {"p99Us", summary.p99Us},
+                               {"maxUs", summary.maxUs}});
+  }
+  return result;
+}
+
+void LogSummary(const std::vector<Summary>& summaries)
+{
+  logger::info("HookStats: Hook latency over the last {:.1f}s", GetWindowSeconds());
+  for (const auto& summary : summaries) {
+    if (summary.calls == 0) {
+      continue;
+    }
+    logger::info("HookStats:   {:<15} {:>9} calls {:>9.1f}/s  mean {:.2f}us  p50 {:.2f}us  p99 {:.2f}us  max {:.2f}us",
+                 summary.name, summary.calls, summary.callsPerSec, summary.meanUs, summary.p50Us, summary.p99Us,
+                 summary.maxUs);
+  }
+}
+}  // namespace HookStats
@@ -0,0 +1,761 @@
+#ifdef _WIN32
+// WinHTTP needs Windows types - must come before CommonLibSSE
+// (which uses WIN32_LEAN_AND_MEAN)
+#  define NOMINMAX
+#  include <windows.h>
+#  include <winhttp.h>
+#endif
+
+#include "HttpClient.h"
+
+#include <charconv>
+#include <optional>
+
+#ifdef _WIN32
+#  pragma comment(lib, "winhttp.lib")
+#else
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <sys/socket.h>
+#  include <sys/uio.h>
+#  include <sys/time.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <cstring>
+#endif
+
+namespace HttpClient
+{
+namespace
+{
+bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+std::string_view Trim(std::string_view text)
+{
+  auto first = text.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  auto last = text.find_last_not_of(" \t\r");
+  return text.substr(first, last - first + 1);
+}
+
+std::string ConnectionKey(const Request& request)
+{
+  return std::format("{}:{}", request.host, request.port);
+}
+
+// Routes body bytes of a successful response to Request::onBody, everything else into Response::body
+class BodyReceiver
+{
+public:
+  BodyReceiver(const Request& request, Response& response) :
+      m_request(request), m_response(response),
+      m_streaming(request.onBody && response.status >= 200 && response.status < 300)
+  {}
+
+  bool Streaming() const { return m_streaming; }
+  bool Aborted() const { return m_aborted; }
+
+  // False once the stream callback asked to stop
+  bool Deliver(std::string_view data)
+  {
+    if (!m_streaming) {
+      m_response.body.append(data);
+      return true;
+    }
+    if (!m_aborted && !data.empty() && !m_request.onBody(data)) {
+      m_aborted = true;
+    }
+    return !m_aborted;
+  }
+
+private:
+  const Request& m_request;
+  Response& m_response;
+  bool m_streaming;
+  bool m_aborted = false;
+};
+
+#ifdef _WIN32
+// =============================================================================
+// WINHTTP TRANSPORT
+// =============================================================================
+
+std::wstring ToWide(std::string_view text)
+{
+  if (text.empty()) {
+    return {};
+  }
+  int size = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+  std::wstring wide(static_cast<size_t>(size), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), size);
+  return wide;
+}
+
+class InternetHandle
+{
+public:
+  explicit InternetHandle(HINTERNET handle = nullptr) : m_handle(handle) {}
+  ~InternetHandle()
+  {
+    if (m_handle) {
+      WinHttpCloseHandle(m_handle);
+    }
+  }
+  InternetHandle(const InternetHandle&)            = delete;
+  InternetHandle& operator=(const InternetHandle&) = delete;
+
+  HINTERNET Get() const { return m_handle; }
+  explicit operator bool() const { return m_handle != nullptr; }
+
+private:
+  HINTERNET m_handle;
+};
+
+class WinHttpTransport final : public ITransport
+{
+public:
+  explicit WinHttpTransport(const TransportOptions& options) :
+      m_session(WinHttpOpen(ToWide(options.userAgent).c_str(), WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                            WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0))
+  {
+    if (!m_session) {
+      logger::error("HttpClient: WinHttpOpen failed: {}", GetLastError());
+      return;
+    }
+
+    int connectMs = static_cast<int>(options.connectTimeout.count());
+    int receiveMs = static_cast<int>(options.receiveTimeout.count());
+    WinHttpSetTimeouts(m_session.Get(), connectMs, connectMs, connectMs, receiveMs);
+
+#  ifdef WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL
+    // HTTP/2 multiplexes concurrent requests over one connection (Windows 10 1607+, ignored elsewhere)
+    DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+    WinHttpSetOption(m_session.Get(), WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols));
+#  endif
+  }
+
+  ~WinHttpTransport() override
+  {
+    // Connection handles must close before the session
+    m_connections.clear();
+  }
+
+  std::string_view Name() const override { return "WinHTTP"; }
+
+  Response Send(const Request& request) override
+  {
+    Response response;
+    if (!m_session) {
+      response.error = "WinHTTP session unavailable";
+      return response;
+    }
+
+    HINTERNET connection = GetConnection(request);
+    if (!connection) {
+      response.error = std::format("WinHttpConnect failed: {}", GetLastError());
+      return response;
+    }
+
+    InternetHandle handle(WinHttpOpenRequest(connection, ToWide(request.method).c_str(),
+                                             ToWide(request.path).c_str(), nullptr, WINHTTP_NO_REFERER,
+                                             WINHTTP_DEFAULT_ACCEPT_TYPES, request.secure ? WINHTTP_FLAG_SECURE : 0));
+    if (!handle) {
+      response.error = std::format("WinHttpOpenRequest failed: {}", GetLastError());
+      return response;
+    }
+
+    std::string headers;
+    for (const auto& [name, value] : request.headers) {
+      headers += name;
+      headers += ": ";
+      headers += value;
+      headers += "\r\n";
+    }
+    std::wstring wideHeaders = ToWide(headers);
+
+    auto bodySize = static_cast<DWORD>(request.body.size());
+    if (!WinHttpSendRequest(handle.Get(), wideHeaders.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : wideHeaders.c_str(),
+                            static_cast<DWORD>(-1), const_cast<char*>(request.body.data()), bodySize, bodySize, 0)) {
+      response.error = std::format("WinHttpSendRequest failed: {}", GetLastError());
+      return response;
+    }
+    if (!WinHttpReceiveResponse(handle.Get(), nullptr)) {
+      response.error = std::format("WinHttpReceiveResponse failed: {}", GetLastError());
+      return response;
+    }
+
+    DWORD status     = 0;
+    DWORD headerSize = sizeof(status);
+    WinHttpQueryHeaders(handle.Get(), WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                        WINHTTP_HEADER_NAME_BY_INDEX, &status, &headerSize, WINHTTP_NO_HEADER_INDEX);
+    response.status = static_cast<int>(status);
+
+    BodyReceiver receiver(request, response);
+    DWORD contentLength = 0;
+    headerSize          = sizeof(contentLength);
+    if (!receiver.Streaming() &&
+        WinHttpQueryHeaders(handle.Get(), WINHTTP_QUERY_CONTENT_LENGTH | WINHTTP_QUERY_FLAG_NUMBER,
+                            WINHTTP_HEADER_NAME_BY_INDEX, &contentLength, &headerSize, WINHTTP_NO_HEADER_INDEX)) {
+      response.body.reserve(contentLength);
+    }
+
+    // Read straight into the growing body (or one reused chunk buffer when streaming) - no per-chunk allocations
+    std::string chunk;
+    while (true) {
+      DWORD available = 0;
+      if (!WinHttpQueryDataAvailable(handle.Get(), &available)) {
+        response.error = std::format("WinHttpQueryDataAvailable failed: {}", GetLastError());
+        break;
+      }
+      if (available == 0) {
+        break;
+      }
+
+      std::string& target = receiver.Streaming() ? chunk : response.body;
+      if (receiver.Streaming()) {
+        chunk.clear();
+      }
+      size_t offset = target.size();
+      if (target.capacity() < offset + available) {
+        target.reserve(std::max(target.capacity() * 2, offset + available));
+      }
+      target.resize(offset + available);
+
+      DWORD bytesRead = 0;
+      if (!WinHttpReadData(handle.Get(), target.data() + offset, available, &bytesRead)) {
+        target.resize(offset);
+        response.error = std::format("WinHttpReadData failed: {}", GetLastError());
+        break;
+      }
+      target.resize(offset + bytesRead);
+
+      if (receiver.Streaming() && !receiver.Deliver(chunk)) {
+        response.error = "aborted by receiver";
+        break;
+      }
+    }
+    return response;
+  }
+
+private:
+  // Connect handles are cheap but keep the host binding - one per host:port, shared by all requests
+  HINTERNET GetConnection(const Request& request)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& connection = m_connections[ConnectionKey(request)];
+    if (!connection) {
+      HINTERNET handle = WinHttpConnect(m_session.Get(), ToWide(request.host).c_str(), request.port, 0);
+      connection       = std::make_unique<InternetHandle>(handle);
+      if (!*connection) {
+        connection.reset();
+        return nullptr;
+      }
+    }
+    return connection->Get();
+  }
+
+  InternetHandle m_session;
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::unique_ptr<InternetHandle>> m_connections;
+};
+
+#else
+// =============================================================================
+// SOCKET TRANSPORT
+// =============================================================================
+
+class SocketTransport final : public ITransport
+{
+public:
+  explicit SocketTransport(const TransportOptions& options) : m_options(options) {}
+
+  ~SocketTransport() override
+  {
+    for (auto& [key, connections] : m_idle) {
+      for (auto& connection : connections) {
+        close(connection->fd);
+      }
+    }
+  }
+
+  std::string_view Name() const override { return "Socket"; }
+
+  Response Send(const Request& request) override
+  {
+    Response response;
+    if (request.secure) {
+      response.error = "socket transport does not support TLS";
+      return response;
+    }
+
+    std::string head = BuildRequestHead(request);
+
+    // A pooled connection may have been closed by the server meanwhile - retry once on a fresh one
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      auto connection = TakeIdle(request);
+      bool reused     = connection != nullptr;
+      if (!connection) {
+        connection = Connect(request, response.error);
+        if (!connection) {
+          return response;
+        }
+      }
+
+      response                  = {};
+      response.reusedConnection = reused;
+
+      bool keepAlive = false;
+      auto outcome   = Exchange(*connection, head, request, response, keepAlive);
+      if (outcome == Outcome::Stale && reused) {
+        close(connection->fd);
+        continue;
+      }
+
+      if (outcome == Outcome::Ok && keepAlive) {
+        ReturnIdle(request, std::move(connection));
+      } else {
+        close(connection->fd);
+      }
+      if (outcome == Outcome::Stale && response.error.empty()) {
+        response.error = "connection closed before response";
+      }
+      return response;
+    }
+    return response;
+  }
+
+private:
+  struct Connection
+  {
+    int fd = -1;
+    std::string buffer;  // Receive buffer, reused for every response on this connection
+    size_t bufferStart = 0;
+
+    std::string_view Pending() const { return std::string_view(buffer).substr(bufferStart); }
+    void Consume(size_t count)
+    {
+      bufferStart += count;
+      if (bufferStart == buffer.size()) {
+        buffer.clear();
+        bufferStart = 0;
+      }
+    }
+  };
+
+  enum class Outcome
+  {
+    Ok,
+    Stale,  // Nothing received - the server dropped an idle connection
+    Failed
+  };
+
+  static std::string BuildRequestHead(const Request& request)
+  {
+    std::string head = std::format("{} {} HTTP/1.1\r\nHost: {}", request.method, request.path, request.host);
+    if (request.port != 80) {
+      head += std::format(":{}", request.port);
+    }
+    head += std::format("\r\nContent-Length: {}\r\nConnection: keep-alive\r\n", request.body.size());
+    for (const auto& [name, value] : request.headers) {
+      head += std::format("{}: {}\r\n", name, value);
+    }
+    head += "\r\n";
+    return head;
+  }
+
+  std::unique_ptr<Connection> TakeIdle(const Request& request)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_idle.find(ConnectionKey(request));
+    if (it == m_idle.end() || it->second.empty()) {
+      return nullptr;
+    }
+    auto connection = std::move(it->second.back());
+    it->second.pop_back();
+    return connection;
+  }
+
+  void ReturnIdle(const Request& request, std::unique_ptr<Connection> connection)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& idle = m_idle[ConnectionKey(request)];
+    if (idle.size() >= m_options.maxIdleConnectionsPerHost) {
+      close(connection->fd);
+      return;
+    }
+    idle.push_back(std::move(connection));
+  }
+
+  std::unique_ptr<Connection> Connect(const Request& request, std::string& error)
+  {
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    std::string port    = std::to_string(request.port);
+    if (int result = getaddrinfo(request.host.c_str(), port.c_str(), &hints, &addresses); result != 0) {
+      error = std::format("cannot resolve {}: {}", request.host, gai_strerror(result));
+      return nullptr;
+    }
+
+    int fd = -1;
+    for (auto* address = addresses; address && fd < 0; address = address->ai_next) {
+      fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+      if (fd < 0)
+        continue;
+
+      SetTimeout(fd, SO_SNDTIMEO, m_options.connectTimeout);
+      if (connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+        error = std::format("cannot connect to {}:{}: {}", request.host, request.port, std::strerror(errno));
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+      return nullptr;
+    }
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    SetTimeout(fd, SO_RCVTIMEO, m_options.receiveTimeout);
+
+    auto connection = std::make_unique<Connection>();
+    connection->fd  = fd;
+    error.clear();
+    return connection;
+  }
+
+  static void SetTimeout(int fd, int option, std::chrono::milliseconds timeout)
+  {
+    timeval value{};
+    value.tv_sec  = static_cast<time_t>(timeout.count() / 1000);
+    value.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    setsockopt(fd, SOL_SOCKET, option, &value, sizeof(value));
+  }
+
+  // Head and body leave in one gather write - no separate small packet for the head
+  static bool SendAll(int fd, std::string_view head, std::string_view body)
+  {
+#  ifdef MSG_NOSIGNAL
+    constexpr int kFlags = MSG_NOSIGNAL;
+#  else
+    constexpr int kFlags = 0;
+#  endif
+    while (!head.empty() || !body.empty()) {
+      iovec parts[2] = {{const_cast<char*>(head.data()), head.size()}, {const_cast<char*>(body.data()), body.size()}};
+      msghdr message{};
+      message.msg_iov    = head.empty() ? parts + 1 : parts;
+      message.msg_iovlen = head.empty() ? 1 : 2;
+
+      ssize_t sent = sendmsg(fd, &message, kFlags);
+      if (sent < 0 && errno == EINTR)
+        continue;
+      if (sent <= 0) {
+        return false;
+      }
+
+      auto fromHead = std::min(static_cast<size_t>(sent), head.size());
+      head.remove_prefix(fromHead);
+      body.remove_prefix(static_cast<size_t>(sent) - fromHead);
+    }
+    return true;
+  }
+
+  // Append at least one more byte to the connection buffer; false on EOF / error
+  static bool Receive(Connection& connection)
+  {
+    constexpr size_t kChunk = 16 * 1024;
+    if (connection.bufferStart > 0 && connection.bufferStart == connection.buffer.size()) {
+      connection.buffer.clear();
+      connection.bufferStart = 0;
+    }
+    size_t offset = connection.buffer.size();
+    connection.buffer.resize(offset + kChunk);
+
+    ssize_t received;
+    do {
+      received = recv(connection.fd, connection.buffer.data() + offset, kChunk, 0);
+    } while (received < 0 && errno == EINTR);
+
+    connection.buffer.resize(offset + static_cast<size_t>(std::max<ssize_t>(received, 0)));
+    return received > 0;
+  }
+
+  // Read exactly count body bytes; collected bodies are received straight into the response
+  static bool ReadBody(Connection& connection, size_t count, BodyReceiver& receiver, std::string& body)
+  {
+    while (receiver.Streaming() && count > 0) {
+      if (connection.Pending().empty() && !Receive(connection)) {
+        return false;
+      }
+      // Deliver before Consume - consuming the last pending byte clears the buffer the view points into
+      auto pending = connection.Pending().substr(0, count);
+      bool more    = receiver.Deliver(pending);
+      connection.Consume(pending.size());
+      count -= pending.size();
+      if (!more) {
+        return false;
+      }
+    }
+
+    auto pending = connection.Pending();
+    size_t take  = std::min(count, pending.size());
+    body.append(pending.substr(0, take));
+    connection.Consume(take);
+    count -= take;
+
+    size_t offset = body.size();
+    body.resize(offset + count);
+    while (count > 0) {
+      ssize_t received = recv(connection.fd, body.data() + offset, count, 0);
+      if (received < 0 && errno == EINTR)
+        continue;
+      if (received <= 0) {
+        body.resize(offset);
+        return false;
+      }
+      offset += static_cast<size_t>(received);
+      count -= static_cast<size_t>(received);
+    }
+    return true;
+  }
+
+  // Next CRLF-terminated line from the connection (without the CRLF)
+  static bool ReadLine(Connection& connection, std::string& line)
+  {
+    while (true) {
+      auto pending = connection.Pending();
+      auto end     = pending.find("\r\n");
+      if (end != std::string_view::npos) {
+        line.assign(pending.substr(0, end));
+        connection.Consume(end + 2);
+        return true;
+      }
+      if (!Receive(connection)) {
+        return false;
+      }
+    }
+  }
+
+  Outcome Exchange(Connection& connection, const std::string& head, const Request& request, Response& response,
+                   bool& keepAlive)
+  {
+    if (!SendAll(connection.fd, head, request.body)) {
+      response.error = std::format("send failed: {}", std::strerror(errno));
+      return Outcome::Stale;
+    }
+
+    // Status line + headers
+    if (connection.Pending().empty() && !Receive(connection)) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        response.error = "timed out waiting for response";
+        return Outcome::Failed;
+      }
+      return Outcome::Stale;
+    }
+
+    std::string line;
+    if (!ReadLine(connection, line) || !line.starts_with("HTTP/1.")) {
+      response.error = "malformed status line";
+      return Outcome::Failed;
+    }
+    keepAlive       = line.starts_with("HTTP/1.1");
+    auto statusText = std::string_view(line).substr(std::min<size_t>(9, line.size()));
+    std::from_chars(statusText.data(), statusText.data() + statusText.size(), response.status);
+
+    std::optional<size_t> contentLength;
+    bool chunked = false;
+    while (true) {
+      if (!ReadLine(connection, line)) {
+        response.error = "connection closed in headers";
+        return Outcome::Failed;
+      }
+      if (line.empty())
+        break;
+
+      auto colon = line.find(':');
+      if (colon == std::string::npos)
+        continue;
+      auto name  = Trim(std::string_view(line).substr(0, colon));
+      auto value = Trim(std::string_view(line).substr(colon + 1));
+      if (EqualsIgnoreCase(name, "content-length")) {
+        size_t length = 0;
+        std::from_chars(value.data(), value.data() + value.size(), length);
+        contentLength = length;
+      } else if (EqualsIgnoreCase(name, "transfer-encoding")) {
+        chunked = EqualsIgnoreCase(value, "chunked");
+      } else if (EqualsIgnoreCase(name, "connection")) {
+        keepAlive = EqualsIgnoreCase(value, "keep-alive") || (keepAlive && !EqualsIgnoreCase(value, "close"));
+      }
+    }
+
+    // Body
+    BodyReceiver receiver(request, response);
+    if (chunked) {
+      while (true) {
+        if (!ReadLine(connection, line)) {
+          response.error = "connection closed in chunk header";
+          return Outcome::Failed;
+        }
+        size_t size = 0;
+        std::from_chars(line.data(), line.data() + line.size(), size, 16);
+        if (size == 0)
+          break;
+        if (!ReadBody(connection, size, receiver, response.body) || !ReadLine(connection, line)) {
+          response.error = receiver.Aborted() ? "aborted by receiver" : "connection closed in chunk";
+          return Outcome::Failed;
+        }
+      }
+      // Trailers up to the empty line
+      do {
+        if (!ReadLine(connection, line)) {
+          keepAlive = false;
+          break;
+        }
+      } while (!line.empty());
+    } else if (contentLength) {
+      if (!ReadBody(connection, *contentLength, receiver, response.body)) {
+        response.error = receiver.Aborted() ? "aborted by receiver" : "connection closed in body";
+        return Outcome::Failed;
+      }
+    } else if (response.status >= 200 && response.status != 204 && response.status != 304) {
+      // Body ends with the connection
+      keepAlive = false;
+      do {
+        auto pending = connection.Pending();
+        bool more    = receiver.Deliver(pending);
+        connection.Consume(pending.size());
+        if (!more) {
+          response.error = "aborted by receiver";
+          return Outcome::Failed;
+        }
+      } while (Receive(connection));
+    }
+    return Outcome::Ok;
+  }
+
+  TransportOptions m_options;
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::vector<std::unique_ptr<Connection>>> m_idle;
+};
+#endif
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool ParseUrl(std::string_view url, Request& request)
+{
+  auto schemeEnd = url.find("://");
+  if (schemeEnd == std::string_view::npos) {
+    return false;
+  }
+  auto scheme = url.substr(0, schemeEnd);
+  if (EqualsIgnoreCase(scheme, "https")) {
+    request.secure = true;
+    request.port   = 443;
+  } else if (EqualsIgnoreCase(scheme, "http")) {
+    request.secure = false;
+    request.port   = 80;
+  } else {
+    return false;
+  }
+
+  auto rest      = url.substr(schemeEnd + 3);
+  auto pathStart = rest.find('/');
+  auto authority = rest.substr(0, pathStart);
+  request.path   = pathStart == std::string_view::npos ? "/" : std::string(rest.substr(pathStart));
+
+  auto colon = authority.rfind(':');
+  if (colon != std::string_view::npos && authority.find(']') == std::string_view::npos) {
+    auto portText = authority.substr(colon + 1);
+    uint16_t port = 0;
+    auto result   = std::from_chars(portText.data(), portText.data() + portText.size(), port);
+    if (result.ec != std::errc() || port == 0) {
+      return false;
+    }
+    request.port = port;
+    authority    = authority.substr(0, colon);
+  }
+  request.host = std::string(authority);
+  return !request.host.empty();
+}
+
+bool SseParser::Feed(std::string_view chunk, const std::function<bool(std::string_view)>& onData)
+{
+  while (!chunk.empty()) {
+    auto newline = chunk.find('\n');
+    if (newline == std::string_view::npos) {
+      m_line.append(chunk);
+      return true;
+    }
+    m_line.append(chunk.substr(0, newline));
+    chunk.remove_prefix(newline + 1);
+
+    std::string_view line = m_line;
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+
+    if (line.empty()) {
+      // Blank line dispatches the event
+      if (m_hasData) {
+        bool keepGoing = onData(m_data);
+        m_data.clear();
+        m_hasData = false;
+        if (!keepGoing) {
+          m_line.clear();
+          return false;
+        }
+      }
+    } else if (line.starts_with("data:")) {
+      line.remove_prefix(5);
+      if (line.starts_with(' ')) {
+        line.remove_prefix(1);
+      }
+      if (m_hasData) {
+        m_data.push_back('\n');
+      }
+      m_data.append(line);
+      m_hasData = true;
+    }
+    // Comments (": keep-alive") and event/id/retry fields are not used
+
+    m_line.clear();
+  }
+  return true;
+}
+
+#ifdef _WIN32
+std::unique_ptr<ITransport> CreateWinHttpTransport(const TransportOptions& options)
+{
+  return std::make_unique<WinHttpTransport>(options);
+}
+#else
+std::unique_ptr<ITransport> CreateSocketTransport(const TransportOptions& options)
+{
+  return std::make_unique<SocketTransport>(options);
+}
+#endif
+
+std::unique_ptr<ITransport> CreateDefaultTransport(const TransportOptions& options)
+{
+#ifdef _WIN32
+  return CreateWinHttpTransport(options);
+#else
+  return CreateSocketTransport(options);
+#endif
+}
+}  // namespace HttpClient
@@ -1,6 +1,7 @@
 #include "ISLIntegration.h"
 #include "ProgressionManager.h"
 #include "SpellEffectivenessHook.h"
+#include "SpellScanner.h"
 #include "UIManager.h"
 
 
@@ -155,6 +156,8 @@ bool OnSpellTomeRead(RE::TESObjectBOOK *book, RE::SpellItem *spell,
 
   // Grant XP - this will trigger early spell granting at threshold
   pm->AddXP(formIdStr, xpToGrant);
+  ProgressionManager::CountXPEvent(
+      "dest_tome", SpellScanner::GetSchoolName(spell->GetAssociatedSkill()));
 
   // =========================================================================
   // AUTO-SET AS LEARNING TARGET
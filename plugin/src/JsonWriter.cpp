@@ -0,0 +1,306 @@
+#include "JsonWriter.h"
+#include "TextUtils.h"
+
+#include <charconv>
+
+namespace
+{
+// Stream sinks are written in chunks of this size
+constexpr size_t kFlushThreshold = 64 * 1024;
+
+// Characters that need escaping inside a JSON string (quote, backslash, control characters)
+constexpr bool NeedsEscape(unsigned char c)
+{
+  return c < 0x20 || c == '"' || c == '\\';
+}
+
+void AppendEscape(std::string& out, unsigned char c)
+{
+  switch (c) {
+  case '"':
+    out += "\\\"";
+    break;
+  case '\\':
+    out += "\\\\";
+    break;
+  case '\b':
+    out += "\\b";
+    break;
+  case '\f':
+    out += "\\f";
+    break;
+  case '\n':
+    out += "\\n";
+    break;
+  case '\r':
+    out += "\\r";
+    break;
+  case '\t':
+    out += "\\t";
+    break;
+  default:
+    {
+      static constexpr char kHex[] = "0123456789abcdef";
+      char escaped[6]              = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+      out.append(escaped, sizeof(escaped));
+      break;
+    }
+  }
+}
+}  // namespace
+
+// =============================================================================
+// CONSTRUCTION
+// =============================================================================
+
+JsonWriter::JsonWriter(std::string& buffer, bool pretty) :
+    m_out(&buffer), m_baseSize(buffer.size()), m_pretty(pretty)
+{}
+
+JsonWriter::JsonWriter(std::ostream& stream, bool pretty) : m_out(&m_chunk), m_stream(&stream), m_pretty(pretty)
+{
+  m_chunk.reserve(kFlushThreshold + 4096);
+}
+
+JsonWriter::~JsonWriter()
+{
+  Flush();
+}
+
+void JsonWriter::Flush()
+{
+  if (m_stream && !m_chunk.empty()) {
+    m_stream->write(m_chunk.data(), static_cast<std::streamsize>(m_chunk.size()));
+    m_flushed += m_chunk.size();
+    m_chunk.clear();
+  }
+}
+
+void JsonWriter::MaybeFlush()
+{
+  if (m_stream && m_chunk.size() >= kFlushThreshold) {
+    Flush();
+  }
+}
+
+// =============================================================================
+// STRUCTURE
+// =============================================================================
+
+void JsonWriter::Newline(size_t depth)
+{
+  m_out->push_back('\n');
+  m_out->append(depth * 2, ' ');
+}
+
+void JsonWriter::BeforeValue()
+{
+  if (m_afterKey) {
+    m_afterKey = false;
+    return;
+  }
+  if (m_levels.empty()) {
+    return;
+  }
+
+  auto& level = m_levels.back();
+  if (level.hasElements) {
+    m_out->push_back(',');
+  }
+  level.hasElements = true;
+
+  if (m_pretty) {
+    Newline(m_levels.size());
+  }
+}
+
+JsonWriter& JsonWriter::BeginObject()
+{
+  BeforeValue();
+  m_out->push_back('{');
+  m_levels.push_back({true, false});
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndObject()
+{
+  bool hasElements = !m_levels.empty() && m_levels.back().hasElements;
+  if (!m_levels.empty()) {
+    m_levels.pop_back();
+  }
+  if (m_pretty && hasElements) {
+    Newline(m_levels.size());
+  }
+  m_out->push_back('}');
+  MaybeFlush();
+  return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray()
+{
+  BeforeValue();
+  m_out->push_back('[');
+  m_levels.push_back({false, false});
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndArray()
+{
+  bool hasElements = !m_levels.empty() && m_levels.back().hasElements;
+  if (!m_levels.empty()) {
+    m_levels.pop_back();
+  }
+  if (m_pretty && hasElements) {
+    Newline(m_levels.size());
+  }
+  m_out->push_back(']');
+  MaybeFlush();
+  return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key)
+{
+  BeforeValue();
+  WriteEscaped(key);
+  m_out->append(m_pretty ? ": " : ":");
+  m_afterKey = true;
+  return *this;
+}
+
+// =============================================================================
+// VALUES
+// =============================================================================
+
+void JsonWriter::WriteEscaped(std::string_view value)
+{
+  std::string sanitized;
+  if (!TextUtils::IsValidUTF8(value)) {
+    sanitized = TextUtils::SanitizeToUTF8(value);
+    value     = sanitized;
+  }
+
+  m_out->reserve(m_out->size() + value.size() + 2);
+  m_out->push_back('"');
+
+  // Copy runs that need no escaping in one go
+  size_t runStart = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    auto c = static_cast<unsigned char>(value[i]);
+    if (NeedsEscape(c)) {
+      m_out->append(value.data() + runStart, i - runStart);
+      AppendEscape(*m_out, c);
+      runStart = i + 1;
+    }
+  }
+  m_out->append(value.data() + runStart, value.size() - runStart);
+
+  m_out->push_back('"');
+}
+
+JsonWriter& JsonWriter::String(std::string_view value)
+{
+  BeforeValue();
+  WriteEscaped(value);
+  MaybeFlush();
+  return *this;
+}
+
+JsonWriter& JsonWriter::Int(int64_t value)
+{
+  BeforeValue();
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  m_out->append(buffer, result.ptr);
+  return *this;
+}
+
+JsonWriter& JsonWriter::UInt(uint64_t value)
+{
+  BeforeValue();
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  m_out->append(buffer, result.ptr);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Double(double value)
+{
+  // Same conventions as json::dump - non-finite values become null, integral values keep ".0"
+  if (!std::isfinite(value)) {
+    return Null();
+  }
+
+  BeforeValue();
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  std::string_view text(buffer, static_cast<size_t>(result.ptr - buffer));
+  m_out->append(text);
+  if (text.find_first_of(".e") == std::string_view::npos) {
+    m_out->append(".0");
+  }
+  return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value)
+{
+  BeforeValue();
+  m_out->append(value ? "true" : "false");
+  return *this;
+}
+
+JsonWriter& JsonWriter::Null()
+{
+  BeforeValue();
+  m_out->append("null");
+  return *this;
+}
+
+JsonWriter& JsonWriter::RawValue(std::string_view serialized)
+{
+  BeforeValue();
+  m_out->append(serialized);
+  MaybeFlush();
+  return *this;
+}
+
+JsonWriter& JsonWriter::BeginRawObject(std::string_view serializedObject)
+{
+  // Everything up to the closing brace; members written next continue the object
+  auto body = serializedObject.substr(0, serializedObject.rfind('}'));
+
+  BeforeValue();
+  m_out->append(body);
+  m_levels.push_back({true, body.find_first_not_of(" \t\r\n{") != std::string_view::npos});
+  return *this;
+}
+
+JsonWriter& JsonWriter::Value(const json& value)
+{
+  switch (value.type()) {
+  case json::value_t::object:
+    BeginObject();
+    for (const auto& [key, item] : value.items()) {
+      Key(key);
+      Value(item);
+    }
+    return EndObject();
+  case json::value_t::array:
+    BeginArray();
+    for (const auto& item : value) {
+      Value(item);
+    }
+    return EndArray();
+  case json::value_t::string:
+    return String(value.get_ref<const std::string&>());
+  case json::value_t::boolean:
+    return Bool(value.get<bool>());
+  case json::value_t::number_integer:
+    return Int(value.get<int64_t>());
+  case json::value_t::number_unsigned:
+    return UInt(value.get<uint64_t>());
+  case json::value_t::number_float:
+    return Double(value.get<double>());
+  default:
+    return Null();
+  }
+}
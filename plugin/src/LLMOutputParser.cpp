@@ -0,0 +1,478 @@
+#include "LLMOutputParser.h"
+
+#include "PromptBuilder.h"
+
+namespace LLMOutputParser
+{
+namespace
+{
+enum class Token
+{
+  None,
+  Open,   // '{' or '['
+  Comma,  // Held back until the next value shows it was not trailing
+  Colon,
+  Key,
+  Value
+};
+
+struct RepairCounts
+{
+  bool fence           = false;
+  bool leadingText     = false;
+  bool trailingText    = false;
+  size_t comments      = 0;
+  size_t strayCommas   = 0;
+  size_t missingCommas = 0;
+  size_t controlChars  = 0;
+  size_t mismatched    = 0;
+  size_t literals      = 0;  // Python-style True/False/None
+  size_t skipped       = 0;  // Characters that cannot start a value
+  size_t closed        = 0;  // Containers closed after truncation
+  size_t droppedBytes  = 0;
+  bool truncated       = false;
+};
+
+// Anything left besides whitespace and markdown fences
+bool HasText(std::string_view text)
+{
+  size_t fence;
+  while ((fence = text.find("```")) != std::string_view::npos) {
+    if (!HasText(text.substr(0, fence))) {
+      // Skip the fence and its language tag
+      text.remove_prefix(fence + 3);
+      while (!text.empty() && std::isalpha(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+      }
+      continue;
+    }
+    return true;
+  }
+  return std::any_of(text.begin(), text.end(), [](char c) { return !std::isspace(static_cast<unsigned char>(c)); });
+}
+
+bool IsLiteralChar(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.';
+}
+
+void AppendControlChar(std::string& out, char c)
+{
+  switch (c) {
+  case '\n':
+    out += "\\n";
+    break;
+  case '\r':
+    out += "\\r";
+    break;
+  case '\t':
+    out += "\\t";
+    break;
+  default:
+    out += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+    break;
+  }
+}
+
+// Single pass over the payload, writing the repaired JSON to out
+bool RepairPayload(std::string_view in, std::string& out, RepairCounts& counts)
+{
+  size_t start = in.find_first_of("{[");
+  if (start == std::string_view::npos) {
+    return false;
+  }
+  counts.fence       = in.find("```") != std::string_view::npos;
+  counts.leadingText = HasText(in.substr(0, start));
+
+  out.reserve(in.size() + 16);
+  std::string stack;          // Open containers, '{' or '['
+  std::vector<bool> isNodes;  // Parallel to stack: a "nodes" array
+  size_t nodesDepth = 0;      // Open "nodes" arrays
+  std::string lastKey;
+  size_t keyStart = 0;
+  Token last        = Token::None;
+  bool inString     = false;
+  bool escaped      = false;
+  bool stringIsKey  = false;
+  bool pendingComma = false;
+  size_t end        = in.size();
+
+  // Last point where everything written so far is complete, and the containers open there. Inside a "nodes"
+  // array only whole nodes count - a truncated node would otherwise survive without its links and show up as
+  // an orphan.
+  size_t safeSize = 0;
+  std::string safeStack;
+  auto markSafeAlways = [&]() {
+    safeSize  = out.size();
+    safeStack = stack;
+  };
+  auto markSafe = [&]() {
+    if (nodesDepth == 0) {
+      markSafeAlways();
+    }
+  };
+
+  auto beginValue = [&]() {
+    if (last == Token::Value) {
+      counts.missingCommas++;
+      pendingComma = true;
+    }
+    if (pendingComma) {
+      out.push_back(',');
+      pendingComma = false;
+    }
+  };
+
+  for (size_t i = start; i < in.size(); ++i) {
+    char c = in[i];
+
+    if (inString) {
+      if (escaped) {
+        escaped = false;
+        out.push_back(c);
+      } else if (c == '\\') {
+        escaped = true;
+        out.push_back(c);
+      } else if (c == '"') {
+        inString = false;
+        if (stringIsKey) {
+          lastKey.assign(out, keyStart, out.size() - keyStart);
+        }
+        out.push_back(c);
+        last = stringIsKey ? Token::Key : Token::Value;
+        if (!stringIsKey) {
+          markSafe();
+        }
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        counts.controlChars++;
+        AppendControlChar(out, c);
+      } else {
+        out.push_back(c);
+      }
+      continue;
+    }
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      continue;
+    }
+
+    if (c == '/' && i + 1 < in.size() && (in[i + 1] == '/' || in[i + 1] == '*')) {
+      counts.comments++;
+      if (in[i + 1] == '/') {
+        size_t lineEnd = in.find('\n', i);
+        i              = lineEnd == std::string_view::npos ? in.size() : lineEnd;
+      } else {
+        size_t commentEnd = in.find("*/", i + 2);
+        i                 = commentEnd == std::string_view::npos ? in.size() : commentEnd + 1;
+      }
+      continue;
+    }
+
+    switch (c) {
+    case ',':
+      if (last == Token::Value) {
+        pendingComma = true;
+        last         = Token::Comma;
+      } else {
+        counts.strayCommas++;
+      }
+      break;
+
+    case ':':
+      out.push_back(':');
+      last = Token::Colon;
+      break;
+
+    case '}':
+    case ']': {
+      if (stack.empty()) {
+        end = i;
+        break;
+      }
+      if (pendingComma) {
+        counts.strayCommas++;
+        pendingComma = false;
+      }
+      char closer = stack.back() == '{' ? '}' : ']';
+      if (c != closer) {
+        counts.mismatched++;
+      }
+      if (last == Token::Colon || last == Token::Key) {
+        out += last == Token::Key ? ":null" : "null";  // Member without a value
+      }
+      out.push_back(closer);
+      stack.pop_back();
+      if (isNodes.back()) {
+        nodesDepth--;
+      }
+      isNodes.pop_back();
+      last = Token::Value;
+      if (stack.empty()) {
+        end = i + 1;
+      } else if (closer == '}' && isNodes.back()) {
+        markSafeAlways();  // A complete node
+      } else {
+        markSafe();
+      }
+      break;
+    }
+
+    case '{':
+    case '[': {
+      bool nodesArray = c == '[' && !stack.empty() && stack.back() == '{' && last == Token::Colon && lastKey == "nodes";
+      beginValue();
+      stack.push_back(c);
+      isNodes.push_back(nodesArray);
+      out.push_back(c);
+      last = Token::Open;
+      if (nodesArray) {
+        nodesDepth++;
+        markSafeAlways();  // An empty node list
+      } else {
+        markSafe();
+      }
+      break;
+    }
+
+    case '"':
+      stringIsKey = !stack.empty() && stack.back() == '{' && last != Token::Colon;
+      beginValue();
+      inString = true;
+      out.push_back('"');
+      keyStart = out.size();
+      break;
+
+    default: {
+      if (!IsLiteralChar(c)) {
+        counts.skipped++;
+        break;
+      }
+      size_t tokenEnd = i;
+      while (tokenEnd < in.size() && IsLiteralChar(in[tokenEnd])) {
+        tokenEnd++;
+      }
+      std::string_view literal = in.substr(i, tokenEnd - i);
+      i                        = tokenEnd - 1;
+      if (tokenEnd == in.size()) {
+        break;  // Cut off mid-token - dropped with the rest of the truncated value
+      }
+
+      beginValue();
+      if (literal == "True" || literal == "False" || literal == "None") {
+        counts.literals++;
+        out += literal == "True" ? "true" : (literal == "False" ? "false" : "null");
+      } else {
+        out += literal;
+      }
+      last = Token::Value;
+      markSafe();
+      break;
+    }
+    }
+
+    if (end != in.size()) {
+      break;
+    }
+  }
+
+  if (inString || !stack.empty()) {
+    counts.truncated    = true;
+    counts.droppedBytes = out.size() - safeSize;
+    counts.closed       = safeStack.size();
+    out.resize(safeSize);
+    for (auto it = safeStack.rbegin(); it != safeStack.rend(); ++it) {
+      out.push_back(*it == '{' ? '}' : ']');
+    }
+  } else {
+    counts.trailingText = HasText(in.substr(end));
+  }
+  return true;
+}
+
+void ReportRepairs(const RepairCounts& counts, std::vector<std::string>& defects)
+{
+  if (counts.fence) {
+    defects.push_back("Removed markdown code fence");
+  }
+  if (counts.leadingText) {
+    defects.push_back("Removed text before the JSON");
+  }
+  if (counts.trailingText) {
+    defects.push_back("Removed text after the JSON");
+  }
+  if (counts.comments > 0) {
+    defects.push_back(std::format("Removed {} comment(s)", counts.comments));
+  }
+  if (counts.strayCommas > 0) {
+    defects.push_back(std::format("Removed {} trailing or stray comma(s)", counts.strayCommas));
+  }
+  if (counts.missingCommas > 0) {
+    defects.push_back(std::format("Inserted {} missing comma(s)", counts.missingCommas));
+  }
+  if (counts.controlChars > 0) {
+    defects.push_back(std::format("Escaped {} control character(s) in strings", counts.controlChars));
+  }
+  if (counts.mismatched > 0) {
+    defects.push_back(std::format("Fixed {} mismatched bracket(s)", counts.mismatched));
+  }
+  if (counts.literals > 0) {
+    defects.push_back(std::format("Replaced {} True/False/None literal(s)", counts.literals));
+  }
+  if (counts.skipped > 0) {
+    defects.push_back(std::format("Skipped {} unexpected character(s)", counts.skipped));
+  }
+  if (counts.truncated) {
+    defects.push_back(std::format("Response was truncated - dropped {} byte(s) of the last incomplete value, "
+                                  "closed {} open bracket(s)",
+                                  counts.droppedBytes, counts.closed));
+  }
+}
+
+std::string FormIdOf(const json& value)
+{
+  return value.is_string() ? PromptBuilder::CanonicalFormId(value.get<std::string>()) : std::string();
+}
+}  // namespace
+
+Result RepairJson(std::string_view response)
+{
+  Result result;
+  std::string repaired;
+  RepairCounts counts;
+  if (!RepairPayload(response, repaired, counts)) {
+    result.error = "No JSON in response";
+    return result;
+  }
+
+  result.document = json::parse(repaired, nullptr, false);
+  if (result.document.is_discarded()) {
+    result.error = "Response is not repairable JSON";
+    return result;
+  }
+  ReportRepairs(counts, result.defects);
+  result.success = true;
+  return result;
+}
+
+Result ParseTree(std::string_view response, const std::string& school,
+                 const std::unordered_set<std::string>* knownFormIds)
+{
+  Result result = RepairJson(response);
+  if (!result.success) {
+    return result;
+  }
+  json& doc = result.document;
+  if (!doc.is_object()) {
+    result.success = false;
+    result.error   = "Response is not a JSON object";
+    return result;
+  }
+
+  // Accept a bare school object and a renamed school key
+  if (!doc.contains("schools") && doc.contains("nodes")) {
+    doc = {{"version", "1.0"}, {"schools", {{school, std::move(doc)}}}};
+    result.defects.push_back("Wrapped bare school object");
+  }
+  auto schools = doc.find("schools");
+  if (schools == doc.end() || !schools->is_object() || schools->empty()) {
+    result.success = false;
+    result.error   = "Response has no schools";
+    return result;
+  }
+  if (!schools->contains(school) && schools->size() == 1) {
+    std::string renamed = schools->begin().key();
+    json schoolData     = std::move(schools->begin().value());
+    *schools            = {{school, std::move(schoolData)}};
+    result.defects.push_back("Renamed school \"" + renamed + "\" to \"" + school + "\"");
+  }
+  json& schoolData = (*schools)[school];
+  if (!schoolData.is_object() || !schoolData.contains("nodes") || !schoolData["nodes"].is_array()) {
+    result.success = false;
+    result.error   = "Response has no nodes for " + school;
+    return result;
+  }
+  if (!doc.contains("version")) {
+    doc["version"] = "1.0";
+  }
+
+  // Nodes: canonical formIds, scanned spells only, first occurrence wins
+  size_t invalid = 0, recased = 0, unknown = 0, duplicates = 0, dangling = 0;
+  json kept      = json::array();
+  std::unordered_set<std::string> seen;
+  for (auto& node : schoolData["nodes"]) {
+    auto formIdIt = node.is_object() ? node.find("formId") : node.end();
+    if (!node.is_object() || formIdIt == node.end() || !formIdIt->is_string()) {
+      invalid++;
+      continue;
+    }
+    std::string formId = FormIdOf(*formIdIt);
+    if (formId != formIdIt->get_ref<const std::string&>()) {
+      recased++;
+      *formIdIt = formId;
+    }
+    if (knownFormIds && !knownFormIds->contains(formId)) {
+      unknown++;
+      continue;
+    }
+    if (!seen.insert(formId).second) {
+      duplicates++;
+      continue;
+    }
+    kept.push_back(std::move(node));
+  }
+
+  // Links only to kept spells
+  for (auto& node : kept) {
+    const std::string& formId = node["formId"].get_ref<const std::string&>();
+    for (const char* key : {"prerequisites", "children"}) {
+      std::vector<std::string> links;
+      if (auto it = node.find(key); it != node.end() && it->is_array()) {
+        for (const auto& link : *it) {
+          std::string id = FormIdOf(link);
+          if (!seen.contains(id) || id == formId) {
+            dangling++;
+          } else if (std::find(links.begin(), links.end(), id) == links.end()) {
+            links.push_back(std::move(id));
+          }
+        }
+      }
+      node[key] = std::move(links);
+    }
+  }
+
+  if (kept.empty()) {
+    result.success = false;
+    result.error   = "Response has no valid nodes for " + school;
+    return result;
+  }
+
+  std::string root = FormIdOf(schoolData.value("root", json()));
+  if (!seen.contains(root)) {
+    auto first = std::find_if(kept.begin(), kept.end(), [](const json& node) { return node["prerequisites"].empty(); });
+    std::string chosen = (first != kept.end() ? *first : kept.front())["formId"].get<std::string>();
+    result.defects.push_back(root.empty() ? "Missing root - using " + chosen
+                                          : "Root " + root + " is not a valid node - using " + chosen);
+    root = chosen;
+  }
+  schoolData["root"]  = root;
+  schoolData["nodes"] = std::move(kept);
+  result.nodeCount    = seen.size();
+
+  if (invalid > 0) {
+    result.defects.push_back(std::format("Dropped {} node(s) without a formId", invalid));
+  }
+  if (recased > 0) {
+    result.defects.push_back(std::format("Normalized {} formId(s)", recased));
+  }
+  if (unknown > 0) {
+    result.defects.push_back(std::format("Dropped {} node(s) with formIds not in the scanned spells", unknown));
+  }
+  if (duplicates > 0) {
+    result.defects.push_back(std::format("Dropped {} duplicate node(s)", duplicates));
+  }
+  if (dangling > 0) {
+    result.defects.push_back(std::format("Removed {} link(s) to spells not in the tree", dangling));
+  }
+  return result;
+}
+}  // namespace LLMOutputParser
@@ -0,0 +1,303 @@
+#include "LLMResponseCache.h"
+#include "PromptBuilder.h"
+
+#include <fstream>
+
+namespace LLMResponseCache
+{
+namespace
+{
+constexpr int kEntryVersion       = 1;
+constexpr uint64_t kDefaultMaxMiB = 64;
+
+constexpr uint64_t kFNVOffset = 14695981039346656037ull;
+constexpr uint64_t kFNVPrime  = 1099511628211ull;
+
+// Second FNV-1a lane starts from a different basis - together they form a 128-bit key
+constexpr uint64_t kFNVOffsetAlt = kFNVOffset ^ 0x9E3779B97F4A7C15ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= kFNVPrime;
+  }
+}
+
+// Length-prefixed so ("ab", "c") and ("a", "bc") hash differently
+void HashField(uint64_t& hash, std::string_view field)
+{
+  uint64_t length = field.size();
+  HashBytes(hash, &length, sizeof(length));
+  HashBytes(hash, field.data(), field.size());
+}
+
+struct IndexEntry
+{
+  uint64_t size = 0;
+  std::filesystem::file_time_type lastUse;
+};
+
+struct CacheState
+{
+  std::mutex mutex;
+  bool loaded = false;
+  std::unordered_map<std::string, IndexEntry> index;
+  uint64_t totalBytes = 0;
+  uint64_t maxBytes   = kDefaultMaxMiB * 1024 * 1024;
+
+  Stats stats;
+  double hitMsTotal  = 0;
+  double liveMsTotal = 0;
+};
+
+CacheState& GetState()
+{
+  static CacheState state;
+  return state;
+}
+
+std::filesystem::path GetEntryPath(const std::string& key)
+{
+  return GetCacheDirectory() / (key + ".json");
+}
+
+// Scan the cache directory once (state.mutex held)
+void EnsureLoadedLocked(CacheState& state)
+{
+  if (state.loaded) {
+    return;
+  }
+  state.loaded = true;
+
+  std::error_code ec;
+  std::filesystem::create_directories(GetCacheDirectory(), ec);
+
+  for (const auto& file : std::filesystem::directory_iterator(GetCacheDirectory(), ec)) {
+    if (!file.is_regular_file(ec) || file.path().extension() != ".json") {
+      continue;
+    }
+    IndexEntry entry;
+    entry.size    = file.file_size(ec);
+    entry.lastUse = file.last_write_time(ec);
+    state.totalBytes += entry.size;
+    state.index[file.path().stem().string()] = entry;
+  }
+
+  logger::info("LLMResponseCache: {} cached responses, {:.1f} MB", state.index.size(),
+               static_cast<double>(state.totalBytes) / (1024.0 * 1024.0));
+}
+
+void RemoveLocked(CacheState& state, const std::string& key)
+{
+  auto it = state.index.find(key);
+  if (it == state.index.end()) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::remove(GetEntryPath(key), ec);
+  state.totalBytes -= std::min(state.totalBytes, it->second.size);
+  state.index.erase(it);
+}
+
+// Delete least recently used entries until the cache fits its limit (state.mutex held)
+void EvictLocked(CacheState& state)
+{
+  if (state.totalBytes <= state.maxBytes) {
+    return;
+  }
+
+  std::vector<std::pair<std::filesystem::file_time_type, std::string>> byAge;
+  byAge.reserve(state.index.size());
+  for (const auto& [key, entry] : state.index) {
+    byAge.emplace_back(entry.lastUse, key);
+  }
+  std::sort(byAge.begin(), byAge.end());
+
+  for (const auto& [lastUse, key] : byAge) {
+    if (state.totalBytes <= state.maxBytes) {
+      break;
+    }
+    RemoveLocked(state, key);
+    state.stats.evictions++;
+  }
+  logger::info("LLMResponseCache: Evicted down to {:.1f} MB ({} entries)",
+               static_cast<double>(state.totalBytes) / (1024.0 * 1024.0), state.index.size());
+}
+
+void LogHitRate(const CacheState& state)
+{
+  const auto& stats = state.stats;
+  logger::info("LLMResponseCache: hit rate {}/{} ({:.0f}%), cached avg {:.1f} ms vs live avg {:.0f} ms", stats.hits,
+               stats.hits + stats.misses, stats.HitRate() * 100.0,
+               stats.hits ? state.hitMsTotal / static_cast<double>(stats.hits) : 0.0,
+               stats.stores ? state.liveMsTotal / static_cast<double>(stats.stores) : 0.0);
+}
+}  // namespace
+
+std::string MakeKey(std::string_view model, std::string_view systemPrompt, std::string_view userPrompt, int maxTokens)
+{
+  uint64_t lanes[2] = {kFNVOffset, kFNVOffsetAlt};
+  for (auto& hash : lanes) {
+    HashField(hash, model);
+    HashField(hash, systemPrompt);
+    HashField(hash, userPrompt);
+    HashBytes(hash, &maxTokens, sizeof(maxTokens));
+  }
+  return std::format("{:016x}{:016x}", lanes[0], lanes[1]);
+}
+
+std::optional<Entry> Lookup(const std::string& key)
+{
+  auto& state = GetState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  EnsureLoadedLocked(state);
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  auto it = state.index.find(key);
+  if (it == state.index.end()) {
+    state.stats.misses++;
+    LogHitRate(state);
+    return std::nullopt;
+  }
+
+  std::optional<Entry> entry;
+  try {
+    std::ifstream file(GetEntryPath(key), std::ios::binary);
+    json j = json::parse(file);
+    if (j.value("version", 0) == kEntryVersion && j.contains("content")) {
+      entry.emplace();
+      entry->content          = j["content"].get<std::string>();
+      entry->liveMs           = j.value("liveMs", int64_t{0});
+      entry->promptTokens     = j.value("promptTokens", 0);
+      entry->completionTokens = j.value("completionTokens", 0);
+    }
+  } catch (const std::exception& e) {
+    logger::warn("LLMResponseCache: Failed to read entry {}: {}", key, e.what());
+  }
+
+  if (!entry) {
+    RemoveLocked(state, key);
+    state.stats.misses++;
+    LogHitRate(state);
+    return std::nullopt;
+  }
+
+  // Touch - the write time is the LRU stamp
+  std::error_code ec;
+  it->second.lastUse = std::filesystem::file_time_type::clock::now();
+  std::filesystem::last_write_time(GetEntryPath(key), it->second.lastUse, ec);
+
+  auto lookupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+  state.stats.hits++;
+  state.hitMsTotal += lookupMs;
+  logger::info("LLMResponseCache: Hit {} ({} bytes, {:.1f} ms, live request took {} ms)", key, entry->content.size(),
+               lookupMs, entry->liveMs);
+  LogHitRate(state);
+  return entry;
+}
+
+void Store(const std::string& key, std::string_view model, int maxTokens, const Entry& entry)
+{
+  // Truncated responses would be replayed forever. Checked like the parsers read it: a markdown fence or a
+  // sentence around the JSON is fine, the content is stored as received.
+  if (!json::accept(PromptBuilder::JsonBody(entry.content))) {
+    logger::info("LLMResponseCache: Not caching {} - response has no valid JSON body", key);
+    return;
+  }
+
+  json j;
+  j["version"]          = kEntryVersion;
+  j["model"]            = model;
+  j["maxTokens"]        = maxTokens;
+  j["liveMs"]           = entry.liveMs;
+  j["promptTokens"]     = entry.promptTokens;
+  j["completionTokens"] = entry.completionTokens;
+  j["content"]          = entry.content;
+  std::string data      = j.dump();
+
+  auto& state = GetState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  EnsureLoadedLocked(state);
+
+  // Write next to the entry and rename, a crash never leaves a half-written entry behind
+  auto path    = GetEntryPath(key);
+  auto tmpPath = path;
+  tmpPath += ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+      logger::error("LLMResponseCache: Failed to write {}", tmpPath.string());
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    logger::error("LLMResponseCache: Failed to store {}: {}", key, ec.message());
+    std::filesystem::remove(tmpPath, ec);
+    return;
+  }
+
+  auto& indexEntry = state.index[key];  // Replaces the entry if the key was stored before
+  state.totalBytes -= std::min(state.totalBytes, indexEntry.size);
+  indexEntry = {data.size(), std::filesystem::file_time_type::clock::now()};
+  state.totalBytes += data.size();
+  state.stats.stores++;
+  state.liveMsTotal += static_cast<double>(entry.liveMs);
+  logger::info("LLMResponseCache: Stored {} ({} bytes, live {} ms)", key, data.size(), entry.liveMs);
+
+  EvictLocked(state);
+}
+
+void SetMaxBytes(uint64_t maxBytes)
+{
+  auto& state = GetState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.maxBytes == maxBytes) {
+    return;
+  }
+  state.maxBytes = maxBytes;
+  if (state.loaded) {
+    EvictLocked(state);
+  }
+}
+
+void Clear()
+{
+  auto& state = GetState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  EnsureLoadedLocked(state);
+
+  std::vector<std::string> keys;
+  for (const auto& [key, entry] : state.index) {
+    keys.push_back(key);
+  }
+  for (const auto& key : keys) {
+    RemoveLocked(state, key);
+  }
+  logger::info("LLMResponseCache: Cleared {} entries", keys.size());
+}
+
+Stats GetStats()
+{
+  auto& state = GetState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  EnsureLoadedLocked(state);
+
+  Stats stats   = state.stats;
+  stats.entries = state.index.size();
+  stats.bytes   = state.totalBytes;
+  stats.hitMs   = stats.hits ? state.hitMsTotal / static_cast<double>(stats.hits) : 0.0;
+  stats.liveMs  = stats.stores ? state.liveMsTotal / static_cast<double>(stats.stores) : 0.0;
+  return stats;
+}
+
+std::filesystem::path GetCacheDirectory()
+{
+  return "Data/SKSE/Plugins/SpellLearning/llm_cache";
+}
+}  // namespace LLMResponseCache
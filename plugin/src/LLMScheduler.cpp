@@ -0,0 +1,306 @@
+#include "LLMScheduler.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+
+#include <random>
+
+namespace
+{
+constexpr auto kBaseBackoff = 2s;
+constexpr auto kMaxBackoff  = 60s;
+
+int64_t ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+// Rate limits, timeouts and server errors are worth another attempt
+bool IsRetryable(int httpStatus)
+{
+  return httpStatus == 408 || httpStatus == 429 || httpStatus >= 500;
+}
+
+// 2s, 4s, 8s ... capped, randomized to [delay/2, delay] so parallel requests do not retry in lockstep
+std::chrono::milliseconds BackoffDelay(int attempt)
+{
+  thread_local std::mt19937 rng{std::random_device{}()};
+
+  auto delay = std::chrono::milliseconds(kBaseBackoff) * (int64_t{1} << std::min(attempt - 1, 10));
+  delay      = std::min<std::chrono::milliseconds>(delay, kMaxBackoff);
+
+  std::uniform_int_distribution<int64_t> jitter(delay.count() / 2, delay.count());
+  return std::chrono::milliseconds(jitter(rng));
+}
+
+OpenRouterAPI::Response CancelledResponse()
+{
+  OpenRouterAPI::Response response;
+  response.cancelled = true;
+  response.error     = "Request cancelled";
+  return response;
+}
+}
+
+json LLMScheduler::Metrics::ToJson() const
+{
+  json j;
+  j["id"]               = id;
+  j["tag"]              = tag;
+  j["model"]            = model;
+  j["attempts"]         = attempts;
+  j["queuedMs"]         = queuedMs;
+  j["firstTokenMs"]     = firstTokenMs;
+  j["totalMs"]          = totalMs;
+  j["promptTokens"]     = promptTokens;
+  j["completionTokens"] = completionTokens;
+  return j;
+}
+
+LLMScheduler* LLMScheduler::GetSingleton()
+{
+  static LLMScheduler singleton;
+  return &singleton;
+}
+
+uint64_t LLMScheduler::Submit(Request request, Callback onComplete, RetryCallback onRetry)
+{
+  auto job        = std::make_unique<Job>();
+  job->request    = std::move(request);
+  job->onComplete = std::move(onComplete);
+  job->onRetry    = std::move(onRetry);
+  job->submitTime = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  job->id        = m_nextId++;
+  job->stopToken = m_stopSource.get_token();
+
+  logger::info("LLMScheduler: Queued request #{} ({}), {} queued, {}/{} running", job->id, job->request.tag,
+               m_queue.size() + 1, m_running, m_limit);
+
+  uint64_t id = job->id;
+  m_queue.push_back(std::move(job));
+  StartWorkersLocked();
+  return id;
+}
+
+void LLMScheduler::SetConcurrencyLimit(size_t limit)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  limit = std::max<size_t>(limit, 1);
+  if (limit != m_limit) {
+    logger::info("LLMScheduler: Concurrency limit {} -> {}", m_limit, limit);
+    m_limit = limit;
+    StartWorkersLocked();
+  }
+}
+
+size_t LLMScheduler::GetConcurrencyLimit() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_limit;
+}
+
+void LLMScheduler::CancelAll()
+{
+  std::deque<std::unique_ptr<Job>> dropped;
+  size_t running;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopSource.request_stop();
+    m_stopSource = std::stop_source();
+    dropped.swap(m_queue);
+    running = m_running;
+  }
+
+  if (dropped.empty() && running == 0) {
+    return;
+  }
+  logger::info("LLMScheduler: Cancelling {} queued and {} running request(s)", dropped.size(), running);
+
+  auto now = std::chrono::steady_clock::now();
+  for (auto& job : dropped) {
+    Metrics metrics;
+    metrics.id       = job->id;
+    metrics.tag      = job->request.tag;
+    metrics.model    = job->request.config.model;
+    metrics.queuedMs = ElapsedMs(job->submitTime, now);
+    metrics.totalMs  = metrics.queuedMs;
+    Complete(*job, CancelledResponse(), std::move(metrics));
+  }
+}
+
+size_t LLMScheduler::QueuedCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_queue.size();
+}
+
+size_t LLMScheduler::RunningCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_running;
+}
+
+void LLMScheduler::StartWorkersLocked()
+{
+  // Workers that have not picked up a job yet count as idle
+  while (m_workers < m_limit && m_workers - m_running < m_queue.size()) {
+    m_workers++;
+    ThreadPool::GetSingleton()->SubmitBlocking([this]() { WorkerLoop(); });
+  }
+}
+
+void LLMScheduler::WorkerLoop()
+{
+  while (true) {
+    std::unique_ptr<Job> job;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      // Surplus workers after the limit was lowered exit as well
+      if (m_queue.empty() || m_workers > m_limit) {
+        m_workers--;
+        return;
+      }
+      job = std::move(m_queue.front());
+      m_queue.pop_front();
+      m_running++;
+    }
+
+    try {
+      Execute(*job);
+    } catch (const std::exception& e) {
+      logger::error("LLMScheduler: Request #{} failed with exception: {}", job->id, e.what());
+
+      // The caller still gets an answer - it may be waiting on this job to finish a batch
+      OpenRouterAPI::Response response;
+      response.success = false;
+      response.error   = e.what();
+
+      Metrics metrics;
+      metrics.id      = job->id;
+      metrics.tag     = job->request.tag;
+      metrics.model   = job->request.config.model;
+      metrics.totalMs = ElapsedMs(job->submitTime, std::chrono::steady_clock::now());
+      Complete(*job, std::move(response), std::move(metrics));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running--;
+  }
+}
+
+void LLMScheduler::Execute(Job& job)
+{
+  const Request& request = job.request;
+
+  Metrics metrics;
+  metrics.id    = job.id;
+  metrics.tag   = request.tag;
+  metrics.model = request.config.model;
+
+  auto startTime   = std::chrono::steady_clock::now();
+  metrics.queuedMs = ElapsedMs(job.submitTime, startTime);
+
+  int maxAttempts = 1 + std::max(request.config.maxRetries, 0);
+  OpenRouterAPI::Response response;
+
+  if (job.stopToken.stop_requested()) {
+    response = CancelledResponse();
+  }
+
+  for (int attempt = 1; !response.cancelled; attempt++) {
+    metrics.attempts = attempt;
+
+    // Once text reached the caller a retry would deliver it twice
+    auto attemptStart = std::chrono::steady_clock::now();
+    bool streamed     = false;
+    OpenRouterAPI::DeltaCallback onDelta;
+    if (request.onDelta) {
+      onDelta = [&](std::string_view delta) {
+        if (!streamed) {
+          streamed             = true;
+          metrics.firstTokenMs = ElapsedMs(attemptStart, std::chrono::steady_clock::now());
+        }
+        request.onDelta(delta);
+      };
+    }
+
+    // A race only returns once a response is complete - nothing streams to the caller
+    if (request.config.raceModels.empty()) {
+      response = OpenRouterAPI::SendPrompt(request.config, request.systemPrompt, request.userPrompt, onDelta,
+                                           job.stopToken);
+    } else {
+      response = OpenRouterAPI::SendPromptRace(request.config, request.systemPrompt, request.userPrompt,
+                                               request.accept, job.stopToken);
+    }
+
+    if (response.success || response.cancelled || streamed || !IsRetryable(response.httpStatus) ||
+        attempt >= maxAttempts) {
+      break;
+    }
+
+    auto delay = BackoffDelay(attempt);
+    logger::warn("LLMScheduler: Request #{} ({}) got status {}, retrying in {} ms (attempt {}/{})", job.id,
+                 request.tag, response.httpStatus, delay.count(), attempt + 1, maxAttempts);
+
+    if (job.onRetry) {
+      SKSE::GetTaskInterface()->AddTask(
+          [onRetry = job.onRetry, attempt, status = response.httpStatus, delay]() { onRetry(attempt, status, delay); });
+    }
+
+    if (!WaitBackoff(job.stopToken, delay)) {
+      response = CancelledResponse();
+    }
+  }
+
+  if (!response.model.empty()) {
+    metrics.model = response.model;  // The winner when racing
+  }
+  metrics.promptTokens     = response.promptTokens;
+  metrics.completionTokens = response.completionTokens;
+  metrics.totalMs          = ElapsedMs(job.submitTime, std::chrono::steady_clock::now());
+
+  logger::info("LLMScheduler: Request #{} ({}) {} - attempts: {}, queued: {} ms, first token: {} ms, total: {} ms, "
+               "tokens: {} in / {} out",
+               job.id, request.tag, response.success ? "done" : (response.cancelled ? "cancelled" : "failed"),
+               metrics.attempts, metrics.queuedMs, metrics.firstTokenMs, metrics.totalMs, metrics.promptTokens,
+               metrics.completionTokens);
+
+  // LLMScheduler::Metrics hides the namespace inside the class
+  const char* outcome = response.success ? "success" : (response.cancelled ? "cancelled" : "failure");
+  ::Metrics::GetHistogram("spelllearning_llm_request_seconds", "LLM request latency from submit to completion",
+                          {1, 2, 5, 10, 20, 30, 60, 120, 300}, {{"outcome", outcome}})
+      .Observe(static_cast<double>(metrics.totalMs) / 1000.0);
+  ::Metrics::GetCounter("spelllearning_llm_tokens", "LLM tokens by direction", {{"direction", "prompt"}})
+      .Add(static_cast<uint64_t>((std::max)(metrics.promptTokens, 0)));
+  ::Metrics::GetCounter("spelllearning_llm_tokens", "LLM tokens by direction", {{"direction", "completion"}})
+      .Add(static_cast<uint64_t>((std::max)(metrics.completionTokens, 0)));
+
+  Complete(job, std::move(response), std::move(metrics));
+}
+
+bool LLMScheduler::WaitBackoff(std::stop_token stopToken, std::chrono::milliseconds delay)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_backoffWake.wait_for(lock, stopToken, delay, []() { return false; });
+  return !stopToken.stop_requested();
+}
+
+void LLMScheduler::Complete(Job& job, OpenRouterAPI::Response response, Metrics metrics)
+{
+  // Taken out of the job so it runs at most once, even when completing throws
+  auto onComplete = std::exchange(job.onComplete, nullptr);
+  if (!onComplete) {
+    return;
+  }
+
+  // Callback on the game thread via SKSE task
+  auto* taskInterface = SKSE::GetTaskInterface();
+  if (taskInterface) {
+    taskInterface->AddTask([onComplete = std::move(onComplete), response = std::move(response),
+                            metrics = std::move(metrics)]() { onComplete(response, metrics); });
+  } else {
+    logger::error("LLMScheduler: SKSE task interface is null! Calling callback directly (may cause issues)");
+    onComplete(response, metrics);
+  }
+}
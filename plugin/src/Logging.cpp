@@ -0,0 +1,122 @@
+#include "Logging.h"
+
+#include <spdlog/async.h>
+#include <spdlog/pattern_formatter.h>
+
+namespace Logging
+{
+namespace
+{
+constexpr size_t kQueueSize     = 8192;  // Lines buffered before the oldest are overwritten
+constexpr auto kFlushInterval   = std::chrono::seconds(1);
+constexpr const char* kCoreName = "global log";
+constexpr const char* kPattern  = "[%Y-%m-%d %H:%M:%S.%e] [%l] %*%v";
+
+constexpr const char* kNames[] = {"core", "ui", "progression", "hooks", "scanner", "llm"};
+static_assert(std::size(kNames) == static_cast<size_t>(Subsystem::Count));
+
+std::shared_ptr<spdlog::logger> s_loggers[static_cast<size_t>(Subsystem::Count)];
+
+// %* - "[subsystem] " for subsystem loggers, nothing for the core logger so its lines look as before.
+// All loggers share one sink and with it one formatter, so the name has to be resolved per message.
+class SubsystemFlag : public spdlog::custom_flag_formatter
+{
+public:
+  void format(const spdlog::details::log_msg& msg, const std::tm&, spdlog::memory_buf_t& dest) override
+  {
+    std::string_view name(msg.logger_name.data(), msg.logger_name.size());
+    if (name == kCoreName) {
+      return;
+    }
+    dest.push_back('[');
+    dest.append(name.data(), name.data() + name.size());
+    dest.push_back(']');
+    dest.push_back(' ');
+  }
+
+  std::unique_ptr<custom_flag_formatter> clone() const override { return std::make_unique<SubsystemFlag>(); }
+};
+}  // namespace
+
+void Setup()
+{
+  auto path = logger::log_directory();
+  if (!path) {
+    return;
+  }
+
+  *path /= std::string(SKSE::GetPluginName()) + ".log";
+
+  spdlog::init_thread_pool(kQueueSize, 1);
+  auto formatter = std::make_unique<spdlog::pattern_formatter>();
+  formatter->add_flag<SubsystemFlag>('*').set_pattern(kPattern);
+  auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
+  sink->set_formatter(std::move(formatter));
+
+  for (size_t i = 0; i < std::size(kNames); ++i) {
+    // The core logger keeps its old name - it is the default logger behind logger::
+    std::string name = i == 0 ? kCoreName : kNames[i];
+    auto log         = std::make_shared<spdlog::async_logger>(std::move(name), sink, spdlog::thread_pool(),
+                                                              spdlog::async_overflow_policy::overrun_oldest);
+    log->set_level(spdlog::level::info);
+    log->flush_on(spdlog::level::warn);
+    s_loggers[i] = log;
+
+    if (i == 0) {
+      spdlog::set_default_logger(std::move(log));
+    } else {
+      spdlog::register_logger(std::move(log));
+    }
+  }
+
+  spdlog::flush_every(kFlushInterval);
+}
+
+spdlog::logger* Get(Subsystem subsystem)
+{
+  auto& log = s_loggers[static_cast<size_t>(subsystem)];
+  return log ? log.get() : spdlog::default_logger_raw();
+}
+
+const char* GetName(Subsystem subsystem)
+{
+  return kNames[static_cast<size_t>(subsystem)];
+}
+
+void SetLevels(const json& levels)
+{
+  if (!levels.is_object()) {
+    return;
+  }
+
+  for (size_t i = 0; i < std::size(kNames); ++i) {
+    auto it = levels.find(kNames[i]);
+    if (it == levels.end() || !it->is_string() || !s_loggers[i]) {
+      continue;
+    }
+    // from_str() maps unknown names to off - only accept real level names
+    auto name  = it->get<std::string>();
+    auto level = spdlog::level::from_str(name);
+    if (level == spdlog::level::off && name != "off") {
+      logger::warn("Logging: Unknown level '{}' for {}", name, kNames[i]);
+      continue;
+    }
+    if (s_loggers[i]->level() != level) {
+      s_loggers[i]->set_level(level);
+      logger::info("Logging: {} level set to {}", kNames[i], name);
+    }
+  }
+}
+
+json GetLevels()
+{
+  json levels = json::object();
+  for (size_t i = 0; i < std::size(kNames); ++i) {
+    auto level = s_loggers[i] ? s_loggers[i]->level() : spdlog::level::info;
+    auto name  = spdlog::level::to_string_view(level);
+
+    levels[kNames[i]] = std::string(name.data(), name.size());
+  }
+  return levels;
+}
+}  // namespace Logging
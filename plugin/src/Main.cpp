@@ -1,4 +1,7 @@
+#include "HookStats.h"
 #include "ISLIntegration.h"
+#include "Logging.h"
+#include "Metrics.h"
 #include "PCH.h"
 #include "PapyrusAPI.h"
 #include "ProgressionManager.h"
@@ -9,32 +12,10 @@
 #include "SpellEffectivenessHook.h"
 #include "SpellScanner.h"
 #include "SpellTomeHook.h"
+#include "Trace.h"
 #include "UIManager.h"
 #include "XPSource.h"
 
-// =============================================================================
-// LOGGING SETUP
-// =============================================================================
-
-void SetupLog()
-{
-  auto path = logger::log_directory();
-  if (!path) {
-    return;
-  }
-
-  *path /= std::string(SKSE::GetPluginName()) + ".log";
-
-  auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
-  auto log  = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
-
-  log->set_level(spdlog::level::info);
-  log->flush_on(spdlog::level::info);
-
-  spdlog::set_default_logger(std::move(log));
-  spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] %v");
-}
-
 // =============================================================================
 // INPUT HANDLER - Configurable Hotkey
 // =============================================================================
@@ -67,6 +48,7 @@ public:
 
   RE::BSEventNotifyControl ProcessEvent(RE::InputEvent* const* a_event, RE::BSTEventSource<RE::InputEvent*>*) override
   {
+    SL_HOOK_TIMER(InputEvent);
     if (!a_event) {
       return RE::BSEventNotifyControl::kContinue;
     }
@@ -129,6 +111,7 @@ constexpr uint32_t kSerializationUniqueID = 'SPLL';  // Spell Learning
 
 void OnGameSaved(SKSE::SerializationInterface* a_intfc)
 {
+  SL_TRACE_SCOPE("OnGameSaved");
   logger::info("SKSE Serialization: Game saved");
   ProgressionManager::GetSingleton()->OnGameSaved(a_intfc);
   SpellEffectivenessHook::GetSingleton()->OnGameSaved(a_intfc);
@@ -136,6 +119,7 @@ void OnGameSaved(SKSE::SerializationInterface* a_intfc)
 
 void OnGameLoaded(SKSE::SerializationInterface* a_intfc)
 {
+  SL_TRACE_SCOPE("OnGameLoaded");
   logger::info("SKSE Serialization: Game loaded");
   ProgressionManager::GetSingleton()->OnGameLoaded(a_intfc);
   SpellEffectivenessHook::GetSingleton()->OnGameLoaded(a_intfc);
@@ -154,6 +138,7 @@ void OnRevert(SKSE::SerializationInterface* a_intfc)
 
 void OnDataLoaded()
 {
+  SL_TRACE_SCOPE("OnDataLoaded");
   logger::info("Data loaded (main menu) - initializing systems");
 
   // Initialize UI Manager (connects to PrismaUI)
@@ -198,6 +183,7 @@ void OnNewGame()
 
 void OnPostLoadGame()
 {
+  SL_TRACE_SCOPE("OnPostLoadGame");
   logger::info("Save game loaded - notifying UI to refresh player data");
   // Progress is automatically loaded by OnGameLoaded serialization callback
 
@@ -248,10 +234,29 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 // SKSE PLUGIN LOAD
 // =============================================================================
 
+// Settings > Debug Options - the panel config is only read once the panel has loaded, so the
+// diagnostics that must cover data and save game loading read their settings directly
+json ReadStartupConfig()
+{
+  std::ifstream file("Data/SKSE/Plugins/SpellLearning/config.json");
+  json config = json::parse(file, nullptr, false);
+  return config.is_object() ? config : json::object();
+}
+
 SKSEPluginLoad(const SKSE::LoadInterface* skse)
 {
   SKSE::Init(skse);
-  SetupLog();
+  Logging::Setup();
+
+  Trace::SetThreadName("Main");
+  json startupConfig = ReadStartupConfig();
+  if (startupConfig.contains("traceOnStartup") && startupConfig["traceOnStartup"].is_boolean() &&
+      startupConfig["traceOnStartup"].get<bool>()) {
+    Trace::Start();
+  }
+  if (startupConfig.contains("metricsExportSeconds") && startupConfig["metricsExportSeconds"].is_number_unsigned()) {
+    Metrics::SetExportInterval(startupConfig["metricsExportSeconds"].get<uint32_t>());
+  }
 
   logger::info("{} v{} by {} loading...", SKSE::GetPluginName(), SKSE::GetPluginVersion(), SKSE::GetPluginAuthor());
 
@@ -0,0 +1,338 @@
+#include "Metrics.h"
+
+#include <cmath>
+#include <condition_variable>
+#include <shared_mutex>
+
+namespace Metrics
+{
+namespace
+{
+enum class Type
+{
+  Counter,
+  Gauge,
+  Histogram
+};
+
+const char* GetTypeName(Type type)
+{
+  switch (type) {
+    case Type::Counter:
+      return "counter";
+    case Type::Gauge:
+      return "gauge";
+    default:
+      return "histogram";
+  }
+}
+
+struct Family
+{
+  Type type;
+  std::string help;
+  std::map<std::string, std::unique_ptr<Metric>> series;  // Keyed by the rendered label set
+};
+
+std::shared_mutex s_lock;
+std::map<std::string, Family, std::less<>> s_families;
+std::vector<std::unique_ptr<Metric>> s_orphans;  // Handed out on a type clash so callers still get a valid series
+
+// Never destroyed - the detached export thread may still be waiting on it at process exit
+struct ExportState
+{
+  std::mutex lock;
+  std::condition_variable wake;
+  uint32_t interval = 0;
+  bool started      = false;
+};
+ExportState& s_export = *new ExportState;
+
+// OpenMetrics numbers: integral values keep a ".0" so bucket bounds render as le="1.0"
+std::string FormatNumber(double value)
+{
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  if (std::isnan(value)) {
+    return "NaN";
+  }
+  if (value == std::floor(value) && std::abs(value) < 1e15) {
+    return std::format("{:.1f}", value);
+  }
+  return std::format("{}", value);
+}
+
+std::string FormatLabels(const Labels& labels)
+{
+  std::string out;
+  for (const auto& [key, value] : labels) {
+    if (!out.empty()) {
+      out += ',';
+    }
+    out += key;
+    out += "=\"";
+    for (char c : value) {
+      switch (c) {
+        case '\\':
+          out += "\\\\";
+          break;
+        case '"':
+          out += "\\\"";
+          break;
+        case '\n':
+          out += "\\n";
+          break;
+        default:
+          out += c;
+      }
+    }
+    out += '"';
+  }
+  return out;
+}
+
+void AppendSample(std::string& out, const std::string& name, std::string_view suffix, const std::string& labels,
+                  std::string_view extraLabel, const std::string& value)
+{
+  out += name;
+  out += suffix;
+  if (!labels.empty() || !extraLabel.empty()) {
+    out += '{';
+    out += labels;
+    if (!labels.empty() && !extraLabel.empty()) {
+      out += ',';
+    }
+    out += extraLabel;
+    out += '}';
+  }
+  out += ' ';
+  out += value;
+  out += '\n';
+}
+
+template <class T, class Make>
+T& GetOrCreate(Type type, std::string_view name, std::string_view help, const Labels& labels, Make make)
+{
+  std::string key = FormatLabels(labels);
+
+  {
+    std::shared_lock lock(s_lock);
+    auto family = s_families.find(name);
+    if (family != s_families.end() && family->second.type == type) {
+      auto series = family->second.series.find(key);
+      if (series != family->second.series.end()) {
+        return static_cast<T&>(*series->second);
+      }
+    }
+  }
+
+  std::unique_lock lock(s_lock);
+  auto family = s_families.find(name);
+  if (family == s_families.end()) {
+    family = s_families.emplace(std::string(name), Family{type, std::string(help), {}}).first;
+  } else if (family->second.type != type) {
+    logger::error("Metrics: {} is already registered as a {} - not exported as a {}", name,
+                  GetTypeName(family->second.type), GetTypeName(type));
+    s_orphans.push_back(make());
+    return static_cast<T&>(*s_orphans.back());
+  }
+
+  auto& series = family->second.series[key];
+  if (!series) {
+    series = make();
+  }
+  return static_cast<T&>(*series);
+}
+
+// Export thread - writes a snapshot every interval, sleeps while exporting is off
+void WriteSnapshot(bool& historyStarted)
+{
+  try {
+    std::string snapshot = Render();
+    auto path            = GetExportPath();
+    std::filesystem::create_directories(path.parent_path());
+
+    // Latest snapshot replaces the file in one step so readers never see half of it
+    auto tempPath = path;
+    tempPath += ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      file << snapshot;
+    }
+    std::filesystem::rename(tempPath, path);
+
+    // History - the same snapshot with every sample stamped with the export time, appended as its own block
+    auto timestamp = std::format(
+        " {:.3f}",
+        std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+    std::string stamped;
+    stamped.reserve(snapshot.size() * 2);
+    size_t start = 0;
+    while (start < snapshot.size()) {
+      size_t end = snapshot.find('\n', start);
+      std::string_view line(snapshot.data() + start, end - start);
+      stamped += line;
+      if (!line.starts_with('#')) {
+        stamped += timestamp;
+      }
+      stamped += '\n';
+      start = end + 1;
+    }
+
+    std::ofstream history(GetHistoryPath(),
+                          std::ios::binary | (historyStarted ? std::ios::app : std::ios::trunc));
+    history << stamped;
+    historyStarted = true;
+  } catch (const std::exception& e) {
+    logger::warn("Metrics: Export failed: {}", e.what());
+  }
+}
+
+void ExportLoop()
+{
+  bool historyStarted = false;
+  std::unique_lock lock(s_export.lock);
+  while (true) {
+    s_export.wake.wait(lock, []() { return s_export.interval > 0; });
+
+    // A changed interval restarts the wait
+    uint32_t interval = s_export.interval;
+    if (s_export.wake.wait_for(lock, std::chrono::seconds(interval),
+                               [interval]() { return s_export.interval != interval; })) {
+      continue;
+    }
+
+    lock.unlock();
+    WriteSnapshot(historyStarted);
+    lock.lock();
+  }
+}
+}  // namespace
+
+// =============================================================================
+// SERIES
+// =============================================================================
+
+void Counter::Render(std::string& out, const std::string& name, const std::string& labels) const
+{
+  AppendSample(out, name, "_total", labels, {}, std::to_string(Get()));
+}
+
+void Gauge::Render(std::string& out, const std::string& name, const std::string& labels) const
+{
+  AppendSample(out, name, {}, labels, {}, FormatNumber(Get()));
+}
+
+Histogram::Histogram(std::vector<double> bounds) :
+    m_bounds(std::move(bounds)), m_buckets(std::make_unique<std::atomic<uint64_t>[]>(m_bounds.size() + 1))
+{
+  std::sort(m_bounds.begin(), m_bounds.end());
+}
+
+void Histogram::Observe(double value)
+{
+  // Bucket i counts values <= m_bounds[i], the last one everything above
+  size_t index = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+  m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Histogram::Render(std::string& out, const std::string& name, const std::string& labels) const
+{
+  // Buckets are read one by one while other threads observe, so the cumulative counts can run a
+  // few samples behind _count - OpenMetrics wants +Inf == _count, so +Inf is taken from _count.
+  uint64_t count      = m_count.load(std::memory_order_relaxed);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < m_bounds.size(); ++i) {
+    cumulative += m_buckets[i].load(std::memory_order_relaxed);
+    cumulative = (std::min)(cumulative, count);
+    AppendSample(out, name, "_bucket", labels, "le=\"" + FormatNumber(m_bounds[i]) + "\"",
+                 std::to_string(cumulative));
+  }
+  AppendSample(out, name, "_bucket", labels, "le=\"+Inf\"", std::to_string(count));
+  AppendSample(out, name, "_count", labels, {}, std::to_string(count));
+  AppendSample(out, name, "_sum", labels, {}, FormatNumber(m_sum.load(std::memory_order_relaxed)));
+}
+
+// =============================================================================
+// REGISTRY
+// =============================================================================
+
+Counter& GetCounter(std::string_view name, std::string_view help, const Labels& labels)
+{
+  return GetOrCreate<Counter>(Type::Counter, name, help, labels, []() { return std::make_unique<Counter>(); });
+}
+
+Gauge& GetGauge(std::string_view name, std::string_view help, const Labels& labels)
+{
+  return GetOrCreate<Gauge>(Type::Gauge, name, help, labels, []() { return std::make_unique<Gauge>(); });
+}
+
+Histogram& GetHistogram(std::string_view name, std::string_view help, const std::vector<double>& bounds,
+                        const Labels& labels)
+{
+  return GetOrCreate<Histogram>(Type::Histogram, name, help, labels,
+                                [&bounds]() { return std::make_unique<Histogram>(bounds); });
+}
+
+std::string Render()
+{
+  std::string out;
+  std::shared_lock lock(s_lock);
+  for (const auto& [name, family] : s_families) {
+    out += std::format("# TYPE {} {}\n", name, GetTypeName(family.type));
+    out += std::format("# HELP {} {}\n", name, family.help);
+    for (const auto& [labels, series] : family.series) {
+      series->Render(out, name, labels);
+    }
+  }
+  out += "# EOF\n";
+  return out;
+}
+
+// =============================================================================
+// EXPORT
+// =============================================================================
+
+void SetExportInterval(uint32_t seconds)
+{
+  {
+    std::lock_guard lock(s_export.lock);
+    if (seconds == s_export.interval) {
+      return;
+    }
+    s_export.interval = seconds;
+
+    // Started on first use and kept - it only wakes when there is something to write
+    if (seconds > 0 && !s_export.started) {
+      s_export.started = true;
+      std::thread(ExportLoop).detach();
+    }
+  }
+  s_export.wake.notify_all();
+
+  if (seconds > 0) {
+    logger::info("Metrics: Exporting to {} every {}s", GetExportPath().string(), seconds);
+  } else {
+    logger::info("Metrics: Export stopped");
+  }
+}
+
+uint32_t GetExportInterval()
+{
+  std::lock_guard lock(s_export.lock);
+  return s_export.interval;
+}
+
+std::filesystem::path GetExportPath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/metrics.prom";
+}
+
+std::filesystem::path GetHistoryPath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/metrics_history.log";
+}
+}  // namespace Metrics
@@ -1,126 +1,19 @@
-// WinHTTP needs Windows types - must come before CommonLibSSE
-// (which uses WIN32_LEAN_AND_MEAN)
-#define NOMINMAX
-// #include <winsock2.h>
-#include <windows.h>
-#include <winhttp.h>
-
 #include "OpenRouterAPI.h"
+#include "AsyncFileWriter.h"
+#include "HttpClient.h"
+#include "JsonWriter.h"
+#include "LLMScheduler.h"
 #include "PCH.h"
+#include "TextUtils.h"
+#include "ThreadPool.h"
+#include <condition_variable>
 #include <fstream>
 #include <nlohmann/json.hpp>
-#include <thread>
-
-
-#pragma comment(lib, "winhttp.lib")
 
 using json = nlohmann::json;
 
 namespace OpenRouterAPI {
 
-// =============================================================================
-// UTF-8 SANITIZATION - Fixes invalid characters that crash JSON serialization
-// =============================================================================
-
-/**
- * Sanitize a string to valid UTF-8 by replacing invalid bytes with ASCII
- * equivalents. Windows-1252 characters (0x80-0x9F) and other invalid UTF-8
- * sequences break JSON parsing. This prevents crashes like:
- * [json.exception.type_error.316] invalid UTF-8 byte
- */
-static std::string SanitizeToUTF8(const std::string &input) {
-  std::string result;
-  result.reserve(input.size());
-
-  size_t i = 0;
-  while (i < input.size()) {
-    unsigned char c = static_cast<unsigned char>(input[i]);
-
-    if (c < 0x80) {
-      // ASCII (0x00-0x7F) - always valid
-      result += static_cast<char>(c);
-      i++;
-    } else if (c >= 0x80 && c <= 0x9F) {
-      // Windows-1252 control characters - replace with ASCII equivalents
-      switch (c) {
-      case 0x91:
-        result += '\'';
-        break; // Left single quote
-      case 0x92:
-        result += '\'';
-        break; // Right single quote
-      case 0x93:
-        result += '"';
-        break; // Left double quote
-      case 0x94:
-        result += '"';
-        break; // Right double quote
-      case 0x96:
-        result += '-';
-        break; // En dash
-      case 0x97:
-        result += '-';
-        break; // Em dash
-      case 0x85:
-        result += "...";
-        break; // Ellipsis
-      case 0x99:
-        result += "(TM)";
-        break; // Trademark
-      default:
-        result += '?';
-        break; // Unknown - replace with ?
-      }
-      i++;
-    } else if ((c & 0xE0) == 0xC0) {
-      // 2-byte UTF-8 sequence (110xxxxx 10xxxxxx)
-      if (i + 1 < input.size() &&
-          (static_cast<unsigned char>(input[i + 1]) & 0xC0) == 0x80) {
-        result += input[i];
-        result += input[i + 1];
-        i += 2;
-      } else {
-        result += '?'; // Invalid sequence
-        i++;
-      }
-    } else if ((c & 0xF0) == 0xE0) {
-      // 3-byte UTF-8 sequence (1110xxxx 10xxxxxx 10xxxxxx)
-      if (i + 2 < input.size() &&
-          (static_cast<unsigned char>(input[i + 1]) & 0xC0) == 0x80 &&
-          (static_cast<unsigned char>(input[i + 2]) & 0xC0) == 0x80) {
-        result += input[i];
-        result += input[i + 1];
-        result += input[i + 2];
-        i += 3;
-      } else {
-        result += '?'; // Invalid sequence
-        i++;
-      }
-    } else if ((c & 0xF8) == 0xF0) {
-      // 4-byte UTF-8 sequence (11110xxx 10xxxxxx 10xxxxxx 10xxxxxx)
-      if (i + 3 < input.size() &&
-          (static_cast<unsigned char>(input[i + 1]) & 0xC0) == 0x80 &&
-          (static_cast<unsigned char>(input[i + 2]) & 0xC0) == 0x80 &&
-          (static_cast<unsigned char>(input[i + 3]) & 0xC0) == 0x80) {
-        result += input[i];
-        result += input[i + 1];
-        result += input[i + 2];
-        result += input[i + 3];
-        i += 4;
-      } else {
-        result += '?'; // Invalid sequence
-        i++;
-      }
-    } else {
-      // Invalid UTF-8 lead byte or continuation byte in wrong position
-      result += '?';
-      i++;
-    }
-  }
-
-  return result;
-}
-
 static Config s_config;
 static bool s_initialized = false;
 static std::filesystem::path s_configPath =
@@ -143,6 +36,15 @@ bool Initialize() {
       s_config.apiKey = j.value("apiKey", "");
       s_config.model = j.value("model", "anthropic/claude-sonnet-4");
       s_config.maxTokens = j.value("maxTokens", 4096);
+      s_config.stream = j.value("stream", true);
+      s_config.maxConcurrentRequests = j.value("maxConcurrentRequests", 5);
+      s_config.maxRetries = j.value("maxRetries", 3);
+      s_config.responseCache = j.value("responseCache", true);
+      s_config.responseCacheMaxMB = j.value("responseCacheMaxMB", 64);
+      s_config.promptTokenBudget = j.value("promptTokenBudget", 30000);
+      s_config.endpoint = j.value("endpoint", Config().endpoint);
+      s_config.raceModels =
+          j.value("raceModels", std::vector<std::string>());
 
       logger::info("OpenRouterAPI: Loaded config, key length: {}",
                    s_config.apiKey.length());
@@ -168,9 +70,16 @@ void SaveConfig() {
     j["apiKey"] = s_config.apiKey;
     j["model"] = s_config.model;
     j["maxTokens"] = s_config.maxTokens;
+    j["stream"] = s_config.stream;
+    j["maxConcurrentRequests"] = s_config.maxConcurrentRequests;
+    j["maxRetries"] = s_config.maxRetries;
+    j["responseCache"] = s_config.responseCache;
+    j["responseCacheMaxMB"] = s_config.responseCacheMaxMB;
+    j["promptTokenBudget"] = s_config.promptTokenBudget;
+    j["endpoint"] = s_config.endpoint;
+    j["raceModels"] = s_config.raceModels;
 
-    std::ofstream file(s_configPath);
-    file << j.dump(2);
+    AsyncFileWriter::GetSingleton()->Write(s_configPath, j.dump(2));
 
     logger::info("OpenRouterAPI: Saved config");
   } catch (const std::exception &e) {
@@ -178,163 +87,207 @@ void SaveConfig() {
   }
 }
 
-// Internal HTTP POST function
-static std::string HttpPost(const std::string &host, const std::string &path,
-                            const std::string &body,
-                            const std::string &authHeader) {
-  std::string result;
-
-  HINTERNET hSession =
-      WinHttpOpen(L"SpellLearning/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                  WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-
-  if (!hSession) {
-    logger::error("OpenRouterAPI: WinHttpOpen failed: {}", GetLastError());
-    return "";
-  }
+// One transport for the plugin lifetime - keeps the TLS connection to
+// OpenRouter alive between the per-school and correction requests
+static HttpClient::ITransport &GetTransport() {
+  static auto transport = HttpClient::CreateDefaultTransport();
+  return *transport;
+}
 
-  // Convert host to wide string
-  std::wstring wHost(host.begin(), host.end());
+// Token counts of an OpenRouter "usage" object (non-streamed responses and
+// the final event of a stream)
+static void ReadUsage(const json &j, Response &response) {
+  auto it = j.find("usage");
+  if (it == j.end() || !it->is_object())
+    return;
+  response.promptTokens = it->value("prompt_tokens", 0);
+  response.completionTokens = it->value("completion_tokens", 0);
+}
 
-  HINTERNET hConnect =
-      WinHttpConnect(hSession, wHost.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
-  if (!hConnect) {
-    logger::error("OpenRouterAPI: WinHttpConnect failed: {}", GetLastError());
-    WinHttpCloseHandle(hSession);
-    return "";
-  }
+// API errors carry a numeric "code" (HTTP status semantics, e.g. 429)
+static int ReadErrorCode(const json &error, int fallback) {
+  auto it = error.find("code");
+  if (it != error.end() && it->is_number_integer())
+    return it->get<int>();
+  return fallback;
+}
 
-  // Convert path to wide string
-  std::wstring wPath(path.begin(), path.end());
+Response SendPrompt(const std::string &systemPrompt,
+                    const std::string &userPrompt,
+                    const DeltaCallback &onDelta) {
+  return SendPrompt(s_config, systemPrompt, userPrompt, onDelta);
+}
 
-  HINTERNET hRequest = WinHttpOpenRequest(
-      hConnect, L"POST", wPath.c_str(), NULL, WINHTTP_NO_REFERER,
-      WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
+Response SendPrompt(const Config &config, const std::string &systemPrompt,
+                    const std::string &userPrompt, const DeltaCallback &onDelta,
+                    std::stop_token stopToken) {
+  Response response;
+  response.model = config.model;
+  bool streaming = onDelta && config.stream;
 
-  if (!hRequest) {
-    logger::error("OpenRouterAPI: WinHttpOpenRequest failed: {}",
-                  GetLastError());
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
-    return "";
+  if (config.apiKey.empty()) {
+    response.error = "API key not configured";
+    logger::error("OpenRouterAPI: {}", response.error);
+    return response;
   }
 
-  // Set headers
-  std::wstring headers = L"Content-Type: application/json\r\n";
-  headers += L"Authorization: Bearer ";
-  headers += std::wstring(authHeader.begin(), authHeader.end());
-  headers += L"\r\n";
-  headers += L"HTTP-Referer: https://github.com/SpellLearning\r\n";
-  headers += L"X-Title: SpellLearning\r\n";
-
-  BOOL bResults =
-      WinHttpSendRequest(hRequest, headers.c_str(), -1, (LPVOID)body.c_str(),
-                         (DWORD)body.length(), (DWORD)body.length(), 0);
-
-  if (!bResults) {
-    logger::error("OpenRouterAPI: WinHttpSendRequest failed: {}",
-                  GetLastError());
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
-    return "";
+  // Build request body - streamed straight into the buffer, the prompts are
+  // too large to copy through a json DOM
+  std::string body;
+  body.reserve(systemPrompt.size() + userPrompt.size() + 256);
+  {
+    JsonWriter writer(body);
+    writer.BeginObject();
+    writer.Member("model", config.model);
+    writer.Member("max_tokens", config.maxTokens);
+    if (streaming) {
+      writer.Member("stream", true);
+    }
+    // Token counts in the response (last event when streaming)
+    writer.Key("usage").BeginObject().Member("include", true).EndObject();
+    writer.Key("messages").BeginArray();
+    writer.BeginObject()
+        .Member("role", "system")
+        .Member("content", systemPrompt)
+        .EndObject();
+    writer.BeginObject()
+        .Member("role", "user")
+        .Member("content", userPrompt)
+        .EndObject();
+    writer.EndArray();
+    writer.EndObject();
   }
+  logger::info("OpenRouterAPI: Sending request, model: {}, body length: {}",
+               config.model, body.length());
 
-  bResults = WinHttpReceiveResponse(hRequest, NULL);
-  if (!bResults) {
-    logger::error("OpenRouterAPI: WinHttpReceiveResponse failed: {}",
-                  GetLastError());
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
-    return "";
+  // Make HTTP request
+  HttpClient::Request request;
+  if (!HttpClient::ParseUrl(config.endpoint, request)) {
+    response.error = "Invalid endpoint: " + config.endpoint;
+    logger::error("OpenRouterAPI: {}", response.error);
+    return response;
   }
-
-  // Read response
-  DWORD dwSize = 0;
-  DWORD dwDownloaded = 0;
-
-  do {
-    dwSize = 0;
-    if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) {
-      logger::error("OpenRouterAPI: WinHttpQueryDataAvailable failed: {}",
-                    GetLastError());
-      break;
+  request.headers = {{"Content-Type", "application/json"},
+                     {"Authorization", "Bearer " + config.apiKey},
+                     {"HTTP-Referer", "https://github.com/SpellLearning"},
+                     {"X-Title", "SpellLearning"}};
+  request.body = body;
+
+  // Streaming: completion arrives as server-sent events carrying
+  // {"choices":[{"delta":{"content":"..."}}]} until "data: [DONE]"
+  HttpClient::SseParser events;
+  std::string streamedContent;
+  std::string streamError;
+  int streamErrorCode = 0;
+  auto onEvent = [&](std::string_view data) {
+    if (data == "[DONE]")
+      return true;
+
+    json event = json::parse(data, nullptr, false);
+    if (event.is_discarded())
+      return true;
+
+    if (event.contains("error")) {
+      streamError = event["error"].value("message", "Unknown API error");
+      streamErrorCode = ReadErrorCode(event["error"], 0);
+      return false;
     }
-
-    if (dwSize == 0)
-      break;
-
-    char *buffer = new char[dwSize + 1];
-    ZeroMemory(buffer, dwSize + 1);
-
-    if (WinHttpReadData(hRequest, buffer, dwSize, &dwDownloaded)) {
-      result.append(buffer, dwDownloaded);
+    ReadUsage(event, response);
+    // Role-only and finish chunks carry "content": null
+    static const auto kDeltaPointer = "/choices/0/delta/content"_json_pointer;
+    if (!event.contains(kDeltaPointer) || !event[kDeltaPointer].is_string())
+      return true;
+    const auto &delta = event[kDeltaPointer].get_ref<const std::string &>();
+    if (!delta.empty()) {
+      streamedContent += delta;
+      onDelta(delta);
     }
+    return true;
+  };
+
+  // A non-streamed body is received through onBody as well when the caller
+  // can cancel, so a stop request does not wait for the whole completion
+  std::string receivedBody;
+  if (streaming) {
+    request.onBody = [&](std::string_view chunk) {
+      return !stopToken.stop_requested() && events.Feed(chunk, onEvent);
+    };
+  } else if (stopToken.stop_possible()) {
+    request.onBody = [&](std::string_view chunk) {
+      receivedBody += chunk;
+      return !stopToken.stop_requested();
+    };
+  }
 
-    delete[] buffer;
-  } while (dwSize > 0);
-
-  WinHttpCloseHandle(hRequest);
-  WinHttpCloseHandle(hConnect);
-  WinHttpCloseHandle(hSession);
-
-  return result;
-}
-
-Response SendPrompt(const std::string &systemPrompt,
-                    const std::string &userPrompt) {
-  Response response;
-
-  if (s_config.apiKey.empty()) {
-    response.error = "API key not configured";
-    logger::error("OpenRouterAPI: {}", response.error);
+  auto startTime = std::chrono::steady_clock::now();
+  HttpClient::Response httpResponse = GetTransport().Send(request);
+  auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - startTime)
+                       .count();
+  response.httpStatus = httpResponse.status;
+
+  if (stopToken.stop_requested()) {
+    response.cancelled = true;
+    response.error = "Request cancelled";
+    logger::info("OpenRouterAPI: Request cancelled after {} ms", elapsedMs);
     return response;
   }
 
-  // Build request body
-  json requestBody;
-  requestBody["model"] = s_config.model;
-  requestBody["max_tokens"] = s_config.maxTokens;
-  requestBody["messages"] =
-      json::array({{{"role", "system"}, {"content", systemPrompt}},
-                   {{"role", "user"}, {"content", userPrompt}}});
-
-  std::string body = requestBody.dump();
-  logger::info("OpenRouterAPI: Sending request, body length: {}",
-               body.length());
+  if ((streaming && httpResponse.Ok()) || !streamError.empty()) {
+    if (!streamError.empty()) {
+      response.error = TextUtils::SanitizeToUTF8(streamError);
+      if (streamErrorCode != 0) {
+        response.httpStatus = streamErrorCode;
+      }
+      logger::error("OpenRouterAPI: API error: {}", response.error);
+      return response;
+    }
+    response.content = TextUtils::SanitizeToUTF8(streamedContent);
+    response.success = true;
+    logger::info("OpenRouterAPI: Streamed response, content length: {}, "
+                 "{} ms",
+                 response.content.length(), elapsedMs);
+    return response;
+  }
 
-  // Make HTTP request
-  std::string httpResponse = HttpPost(
-      "openrouter.ai", "/api/v1/chat/completions", body, s_config.apiKey);
+  const std::string &responseBody =
+      httpResponse.Ok() && request.onBody ? receivedBody : httpResponse.body;
 
-  if (httpResponse.empty()) {
+  if (!httpResponse.error.empty() || responseBody.empty()) {
     response.error = "HTTP request failed";
+    if (!httpResponse.error.empty()) {
+      response.error += ": " + httpResponse.error;
+    } else if (httpResponse.status != 0) {
+      response.error += ": status " + std::to_string(httpResponse.status);
+    }
+    logger::error("OpenRouterAPI: {}", response.error);
     return response;
   }
 
-  logger::info("OpenRouterAPI: Got response, length: {}",
-               httpResponse.length());
+  logger::info("OpenRouterAPI: Got response, status: {}, length: {}, {} ms",
+               httpResponse.status, responseBody.length(), elapsedMs);
 
   // Parse response
   try {
-    json j = json::parse(httpResponse);
+    json j = json::parse(responseBody);
 
     if (j.contains("error")) {
       // Sanitize error message too in case it contains invalid UTF-8
       response.error =
-          SanitizeToUTF8(j["error"].value("message", "Unknown API error"));
+          TextUtils::SanitizeToUTF8(j["error"].value("message", "Unknown API error"));
+      response.httpStatus = ReadErrorCode(j["error"], response.httpStatus);
       logger::error("OpenRouterAPI: API error: {}", response.error);
       return response;
     }
 
+    ReadUsage(j, response);
     if (j.contains("choices") && j["choices"].is_array() &&
         !j["choices"].empty()) {
       // Sanitize LLM response to valid UTF-8 before storing
       // This prevents JSON serialization crashes from invalid byte sequences
       std::string rawContent =
           j["choices"][0]["message"]["content"].get<std::string>();
-      response.content = SanitizeToUTF8(rawContent);
+      response.content = TextUtils::SanitizeToUTF8(rawContent);
       response.success = true;
       logger::info(
           "OpenRouterAPI: Success, content length: {} (sanitized from {})",
@@ -351,36 +304,205 @@ Response SendPrompt(const std::string &systemPrompt,
   return response;
 }
 
+// =============================================================================
+// MODEL RACING
+// =============================================================================
+
+// The configured model plus at most this many race models
+static constexpr size_t kMaxRaceContenders = 3;
+static constexpr size_t kRaceLatencyHistory = 200;
+
+// Outcome of past races per model, for tuning the default model choice
+struct RaceModelStats {
+  int races = 0;
+  int wins = 0;
+  int failures = 0; // Errors and responses the validator rejected
+  std::vector<int64_t> latenciesMs; // Completed successful responses
+};
+
+static std::mutex s_raceStatsMutex;
+static std::unordered_map<std::string, RaceModelStats> s_raceStats;
+
+struct RaceState {
+  std::mutex mutex;
+  std::condition_variable_any done;
+  std::vector<std::stop_source> stops;
+  std::vector<Response> responses;
+  std::vector<int64_t> latenciesMs; // -1 while still running
+  std::vector<bool> accepted;
+  std::vector<size_t> finishOrder;
+  int winner = -1;
+};
+
+static int64_t Percentile(std::vector<int64_t> values, int percent) {
+  if (values.empty())
+    return -1;
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) * percent / 100];
+}
+
+// Record the race in the per-model stats and log the outcome and the latency
+// distribution so far
+static void RecordRace(const std::vector<std::string> &models,
+                       const RaceState &race) {
+  std::string outcome;
+  for (size_t i = 0; i < models.size(); ++i) {
+    std::string result;
+    if (race.latenciesMs[i] < 0)
+      result = "cancelled";
+    else if (race.accepted[i])
+      result = std::format("{} ms", race.latenciesMs[i]);
+    else if (race.responses[i].success)
+      result = std::format("rejected after {} ms", race.latenciesMs[i]);
+    else
+      result = std::format("failed after {} ms (status {})",
+                           race.latenciesMs[i], race.responses[i].httpStatus);
+    outcome += std::format("{}{}{}: {}", outcome.empty() ? "" : ", ",
+                           static_cast<int>(i) == race.winner ? "*" : "",
+                           models[i], result);
+  }
+  logger::info("OpenRouterAPI: Race {} - {}",
+               race.winner >= 0 ? "won by " + models[race.winner]
+                                : std::string("without a valid response"),
+               outcome);
+
+  std::lock_guard<std::mutex> lock(s_raceStatsMutex);
+  for (size_t i = 0; i < models.size(); ++i) {
+    auto &stats = s_raceStats[models[i]];
+    stats.races++;
+    if (static_cast<int>(i) == race.winner)
+      stats.wins++;
+    if (race.latenciesMs[i] >= 0 && !race.accepted[i])
+      stats.failures++;
+    if (race.latenciesMs[i] >= 0 && race.responses[i].success) {
+      stats.latenciesMs.push_back(race.latenciesMs[i]);
+      if (stats.latenciesMs.size() > kRaceLatencyHistory)
+        stats.latenciesMs.erase(stats.latenciesMs.begin());
+    }
+    logger::info("OpenRouterAPI: Race stats {}: {}/{} wins, {} failed, "
+                 "latency p50 {} ms / p90 {} ms / max {} ms ({} samples)",
+                 models[i], stats.wins, stats.races, stats.failures,
+                 Percentile(stats.latenciesMs, 50),
+                 Percentile(stats.latenciesMs, 90),
+                 Percentile(stats.latenciesMs, 100), stats.latenciesMs.size());
+  }
+}
+
+Response SendPromptRace(const Config &config, const std::string &systemPrompt,
+                        const std::string &userPrompt,
+                        const ResponseValidator &accept,
+                        std::stop_token stopToken) {
+  std::vector<std::string> models = {config.model};
+  for (const auto &model : config.raceModels) {
+    if (models.size() < kMaxRaceContenders && !model.empty() &&
+        std::find(models.begin(), models.end(), model) == models.end())
+      models.push_back(model);
+  }
+  if (models.size() == 1)
+    return SendPrompt(config, systemPrompt, userPrompt, {}, stopToken);
+
+  logger::info("OpenRouterAPI: Racing {} models", models.size());
+
+  // Contenders are not waited for - the loser of a race may still be waiting
+  // for response headers when the winner returns, so all state is shared
+  auto race = std::make_shared<RaceState>();
+  race->stops.resize(models.size());
+  race->responses.resize(models.size());
+  race->latenciesMs.assign(models.size(), -1);
+  race->accepted.assign(models.size(), false);
+  auto prompts =
+      std::make_shared<const std::pair<std::string, std::string>>(
+          systemPrompt, userPrompt);
+  auto startTime = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < models.size(); ++i) {
+    Config contender = config;
+    contender.model = models[i];
+    contender.raceModels.clear();
+
+    auto *pool = ThreadPool::GetSingleton();
+    pool->SubmitBlocking([race, prompts, contender = std::move(contender), i,
+                          accept, startTime,
+                          stop = race->stops[i].get_token()]() {
+      Response response = SendPrompt(contender, prompts->first,
+                                     prompts->second, {}, stop);
+      bool accepted = false;
+      try {
+        accepted = response.success && (!accept || accept(response));
+      } catch (const std::exception &e) {
+        logger::error("OpenRouterAPI: Race validator failed: {}", e.what());
+      }
+
+      std::lock_guard<std::mutex> lock(race->mutex);
+      race->latenciesMs[i] =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - startTime)
+              .count();
+      if (response.cancelled)
+        race->latenciesMs[i] = -1;
+      race->accepted[i] = accepted;
+      race->responses[i] = std::move(response);
+      race->finishOrder.push_back(i);
+      if (accepted && race->winner < 0) {
+        race->winner = static_cast<int>(i);
+        for (size_t j = 0; j < race->stops.size(); ++j) {
+          if (j != i)
+            race->stops[j].request_stop();
+        }
+      }
+      race->done.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(race->mutex);
+  bool finished = race->done.wait(lock, stopToken, [&]() {
+    return race->winner >= 0 || race->finishOrder.size() == models.size();
+  });
+
+  if (!finished) {
+    for (auto &stop : race->stops)
+      stop.request_stop();
+    Response response;
+    response.cancelled = true;
+    response.error = "Request cancelled";
+    return response;
+  }
+
+  // Losers still running are cancelled by the winner; without a winner the
+  // first successful (or else the first) response is returned for the
+  // caller's own validation and retry handling
+  size_t result = race->finishOrder.front();
+  if (race->winner >= 0) {
+    result = static_cast<size_t>(race->winner);
+  } else {
+    for (size_t i : race->finishOrder) {
+      if (race->responses[i].success) {
+        result = i;
+        break;
+      }
+    }
+  }
+  RecordRace(models, *race);
+  return race->responses[result];
+}
+
 void SendPromptAsync(const std::string &systemPrompt,
                      const std::string &userPrompt,
-                     std::function<void(const Response &)> callback) {
-  logger::info("OpenRouterAPI: Starting async request thread");
-
-  std::thread([systemPrompt, userPrompt, callback]() {
-    logger::info("OpenRouterAPI: Thread started, calling SendPrompt");
-    Response response = SendPrompt(systemPrompt, userPrompt);
-
-    logger::info("OpenRouterAPI: SendPrompt returned, success={}, "
-                 "content_len={}, error={}",
-                 response.success, response.content.length(), response.error);
-
-    // Call callback on main thread via SKSE task
-    auto *taskInterface = SKSE::GetTaskInterface();
-    if (taskInterface) {
-      logger::info("OpenRouterAPI: Adding task to SKSE task interface");
-      taskInterface->AddTask([callback, response]() {
-        logger::info("OpenRouterAPI: SKSE task executing callback");
+                     std::function<void(const Response &)> callback,
+                     DeltaCallback onDelta) {
+  LLMScheduler::Request request;
+  request.tag = "prompt";
+  request.config = s_config;
+  request.systemPrompt = systemPrompt;
+  request.userPrompt = userPrompt;
+  request.onDelta = std::move(onDelta);
+
+  LLMScheduler::GetSingleton()->Submit(
+      std::move(request),
+      [callback = std::move(callback)](const Response &response,
+                                       const LLMScheduler::Metrics &) {
         callback(response);
-        logger::info("OpenRouterAPI: Callback completed");
       });
-    } else {
-      logger::error("OpenRouterAPI: SKSE task interface is null! Calling "
-                    "callback directly (may cause issues)");
-      callback(response);
-    }
-  }).detach();
-
-  logger::info("OpenRouterAPI: Thread detached");
 }
 
 } // namespace OpenRouterAPI
@@ -0,0 +1,657 @@
+#include "ProcessRunner.h"
+#include "ThreadPool.h"
+
+#include <latch>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <pthread.h>
+#  include <signal.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <cstring>
+#endif
+
+namespace ProcessRunner
+{
+namespace
+{
+// How often the runner checks for cancellation / timeout while the process is quiet
+constexpr auto kPollInterval = 50ms;
+
+// Time a terminated process gets to exit before it is killed (POSIX only)
+constexpr auto kTerminateGrace = 2s;
+
+constexpr size_t kReadChunk = 64 * 1024;
+
+// =============================================================================
+// OUTPUT HANDLING
+// =============================================================================
+
+// Splits stdout into lines; progress lines go to the callback, the rest is collected verbatim
+class OutputCollector
+{
+public:
+  OutputCollector(const Options& options, std::string& output) : m_options(options), m_output(output) {}
+
+  void Append(const char* data, size_t size)
+  {
+    m_pending.append(data, size);
+
+    size_t start = 0;
+    size_t newline;
+    while ((newline = m_pending.find('\n', start)) != std::string::npos) {
+      HandleLine(std::string_view(m_pending).substr(start, newline - start + 1));
+      start = newline + 1;
+    }
+    m_pending.erase(0, start);
+  }
+
+  // Output that did not end with a newline
+  void Finish()
+  {
+    if (!m_pending.empty()) {
+      HandleLine(m_pending);
+      m_pending.clear();
+    }
+  }
+
+private:
+  void HandleLine(std::string_view line)
+  {
+    const auto& prefix = m_options.progressPrefix;
+    if (prefix.empty() || !line.starts_with(prefix)) {
+      m_output.append(line);
+      return;
+    }
+
+    auto text  = line.substr(prefix.size());
+    auto first = text.find_first_not_of(" \t");
+    auto last  = text.find_last_not_of(" \t\r\n");
+    text       = first == std::string_view::npos ? std::string_view{} : text.substr(first, last - first + 1);
+
+    if (m_options.onProgress) {
+      try {
+        m_options.onProgress(text);
+      } catch (const std::exception& e) {
+        logger::warn("ProcessRunner: Progress callback failed: {}", e.what());
+      }
+    }
+  }
+
+  const Options& m_options;
+  std::string& m_output;
+  std::string m_pending;
+};
+
+// Keep only the tail of stderr - a chatty helper must not grow memory without bound
+void AppendErrorOutput(std::string& errorOutput, const char* data, size_t size)
+{
+  errorOutput.append(data, size);
+  if (errorOutput.size() > 2 * kMaxErrorOutput) {
+    errorOutput.erase(0, errorOutput.size() - kMaxErrorOutput);
+  }
+}
+
+// Deadline helper - a zero timeout never expires
+class Deadline
+{
+public:
+  explicit Deadline(std::chrono::milliseconds timeout) :
+      m_enabled(timeout.count() > 0), m_end(std::chrono::steady_clock::now() + timeout)
+  {}
+
+  bool Expired() const { return m_enabled && std::chrono::steady_clock::now() >= m_end; }
+
+private:
+  bool m_enabled;
+  std::chrono::steady_clock::time_point m_end;
+};
+
+#ifdef _WIN32
+// =============================================================================
+// WINDOWS IMPLEMENTATION
+// =============================================================================
+
+std::wstring ToWide(std::string_view text)
+{
+  if (text.empty()) {
+    return {};
+  }
+  int size = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+  std::wstring wide(static_cast<size_t>(size), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), size);
+  return wide;
+}
+
+// Quote one argument so CommandLineToArgvW / the MSVC runtime parse it back unchanged
+void AppendQuotedArgument(std::wstring& commandLine, const std::wstring& arg)
+{
+  if (!commandLine.empty()) {
+    commandLine.push_back(L' ');
+  }
+  if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos) {
+    commandLine += arg;
+    return;
+  }
+
+  commandLine.push_back(L'"');
+  size_t backslashes = 0;
+  for (wchar_t c : arg) {
+    if (c == L'\\') {
+      backslashes++;
+      continue;
+    }
+    if (c == L'"') {
+      // Backslashes before a quote are doubled, the quote itself escaped
+      commandLine.append(backslashes * 2 + 1, L'\\');
+    } else {
+      commandLine.append(backslashes, L'\\');
+    }
+    backslashes = 0;
+    commandLine.push_back(c);
+  }
+  // Backslashes before the closing quote are doubled
+  commandLine.append(backslashes * 2, L'\\');
+  commandLine.push_back(L'"');
+}
+
+std::string LastErrorMessage(const char* what)
+{
+  return std::format("{} (error {})", what, GetLastError());
+}
+
+class Handle
+{
+public:
+  Handle() = default;
+  explicit Handle(HANDLE handle) : m_handle(handle) {}
+  ~Handle() { Close(); }
+  Handle(const Handle&)            = delete;
+  Handle& operator=(const Handle&) = delete;
+
+  HANDLE Get() const { return m_handle; }
+  HANDLE* Put()
+  {
+    Close();
+    return &m_handle;
+  }
+
+  void Close()
+  {
+    if (m_handle && m_handle != INVALID_HANDLE_VALUE) {
+      CloseHandle(m_handle);
+    }
+    m_handle = nullptr;
+  }
+
+private:
+  HANDLE m_handle = nullptr;
+};
+
+// Pipe whose parent end is not inherited by the child
+bool CreateChildPipe(Handle& readEnd, Handle& writeEnd, bool childReads)
+{
+  SECURITY_ATTRIBUTES attributes{};
+  attributes.nLength        = sizeof(attributes);
+  attributes.bInheritHandle = TRUE;
+
+  if (!CreatePipe(readEnd.Put(), writeEnd.Put(), &attributes, 0)) {
+    return false;
+  }
+  HANDLE parentEnd = childReads ? writeEnd.Get() : readEnd.Get();
+  return SetHandleInformation(parentEnd, HANDLE_FLAG_INHERIT, 0) != FALSE;
+}
+
+void RunPlatform(const Options& options, std::stop_token stopToken, Result& result)
+{
+  Handle stdinRead, stdinWrite, stdoutRead, stdoutWrite, stderrRead, stderrWrite;
+  if (!CreateChildPipe(stdinRead, stdinWrite, true) || !CreateChildPipe(stdoutRead, stdoutWrite, false) ||
+      !CreateChildPipe(stderrRead, stderrWrite, false)) {
+    result.error = LastErrorMessage("CreatePipe failed");
+    return;
+  }
+
+  std::wstring commandLine;
+  for (const auto& arg : options.args) {
+    AppendQuotedArgument(commandLine, ToWide(arg));
+  }
+
+  // Only the three pipe ends are inherited, not every inheritable handle in the game process
+  HANDLE inherited[] = {stdinRead.Get(), stdoutWrite.Get(), stderrWrite.Get()};
+  SIZE_T attributeSize = 0;
+  InitializeProcThreadAttributeList(nullptr, 1, 0, &attributeSize);
+  std::vector<char> attributeBuffer(attributeSize);
+  auto* attributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeBuffer.data());
+  if (!InitializeProcThreadAttributeList(attributeList, 1, 0, &attributeSize)) {
+    result.error = LastErrorMessage("InitializeProcThreadAttributeList failed");
+    return;
+  }
+  UpdateProcThreadAttribute(attributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, inherited, sizeof(inherited),
+                            nullptr, nullptr);
+
+  STARTUPINFOEXW startupInfo{};
+  startupInfo.StartupInfo.cb         = sizeof(startupInfo);
+  startupInfo.StartupInfo.dwFlags    = STARTF_USESTDHANDLES;
+  startupInfo.StartupInfo.hStdInput  = stdinRead.Get();
+  startupInfo.StartupInfo.hStdOutput = stdoutWrite.Get();
+  startupInfo.StartupInfo.hStdError  = stderrWrite.Get();
+  startupInfo.lpAttributeList        = attributeList;
+
+  std::wstring workingDirectory = options.workingDirectory.wstring();
+
+  PROCESS_INFORMATION processInfo{};
+  BOOL created =
+      CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, TRUE,
+                     CREATE_NO_WINDOW | CREATE_SUSPENDED | EXTENDED_STARTUPINFO_PRESENT, nullptr,
+                     workingDirectory.empty() ? nullptr : workingDirectory.c_str(), &startupInfo.StartupInfo,
+                     &processInfo);
+  DeleteProcThreadAttributeList(attributeList);
+  if (!created) {
+    result.error = LastErrorMessage("CreateProcess failed");
+    return;
+  }
+
+  Handle process(processInfo.hProcess);
+  Handle thread(processInfo.hThread);
+
+  // Job object so a timeout / cancel also ends anything the helper started
+  Handle job(CreateJobObjectW(nullptr, nullptr));
+  if (job.Get()) {
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits{};
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    SetInformationJobObject(job.Get(), JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+    AssignProcessToJobObject(job.Get(), process.Get());
+  }
+  ResumeThread(thread.Get());
+
+  // The child holds its own copies now - closing ours lets reads end when it exits
+  stdinRead.Close();
+  stdoutWrite.Close();
+  stderrWrite.Close();
+
+  // Anonymous pipes have no overlapped I/O, so each stream gets a blocking-lane thread
+  auto* pool = ThreadPool::GetSingleton();
+  std::latch streamsDone(3);
+  pool->SubmitBlocking([&]() {
+    size_t offset = 0;
+    while (offset < options.input.size()) {
+      DWORD chunk   = static_cast<DWORD>(std::min(options.input.size() - offset, kReadChunk));
+      DWORD written = 0;
+      if (!WriteFile(stdinWrite.Get(), options.input.data() + offset, chunk, &written, nullptr)) {
+        break;
+      }
+      offset += written;
+    }
+    stdinWrite.Close();
+    streamsDone.count_down();
+  });
+
+  pool->SubmitBlocking([&]() {
+    OutputCollector collector(options, result.output);
+    std::vector<char> buffer(kReadChunk);
+    DWORD bytesRead = 0;
+    while (ReadFile(stdoutRead.Get(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, nullptr) &&
+           bytesRead > 0) {
+      collector.Append(buffer.data(), bytesRead);
+    }
+    collector.Finish();
+    streamsDone.count_down();
+  });
+
+  pool->SubmitBlocking([&]() {
+    std::vector<char> buffer(kReadChunk);
+    DWORD bytesRead = 0;
+    while (ReadFile(stderrRead.Get(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, nullptr) &&
+           bytesRead > 0) {
+      AppendErrorOutput(result.errorOutput, buffer.data(), bytesRead);
+    }
+    streamsDone.count_down();
+  });
+
+  Deadline deadline(options.timeout);
+  result.status = Status::Exited;
+  while (WaitForSingleObject(process.Get(), static_cast<DWORD>(kPollInterval.count())) == WAIT_TIMEOUT) {
+    if (stopToken.stop_requested() || deadline.Expired()) {
+      result.status = stopToken.stop_requested() ? Status::Cancelled : Status::TimedOut;
+      if (!job.Get() || !TerminateJobObject(job.Get(), 1)) {
+        TerminateProcess(process.Get(), 1);
+      }
+      WaitForSingleObject(process.Get(), INFINITE);
+      break;
+    }
+  }
+
+  // Leftover grandchildren would keep the pipes open forever
+  if (job.Get()) {
+    TerminateJobObject(job.Get(), 1);
+  }
+
+  streamsDone.wait();
+
+  DWORD exitCode = 0;
+  GetExitCodeProcess(process.Get(), &exitCode);
+  result.exitCode = static_cast<int>(exitCode);
+}
+
+#else
+// =============================================================================
+// POSIX IMPLEMENTATION
+// =============================================================================
+
+class FileDescriptor
+{
+public:
+  FileDescriptor() = default;
+  ~FileDescriptor() { Close(); }
+  FileDescriptor(const FileDescriptor&)            = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int Get() const { return m_fd; }
+  void Reset(int fd)
+  {
+    Close();
+    m_fd = fd;
+  }
+  void Close()
+  {
+    if (m_fd >= 0) {
+      close(m_fd);
+    }
+    m_fd = -1;
+  }
+
+private:
+  int m_fd = -1;
+};
+
+// Pipe with both ends close-on-exec (the child dup2()s its ends onto 0/1/2)
+bool CreatePipe(FileDescriptor& readEnd, FileDescriptor& writeEnd)
+{
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  readEnd.Reset(fds[0]);
+  writeEnd.Reset(fds[1]);
+  return fcntl(fds[0], F_SETFD, FD_CLOEXEC) == 0 && fcntl(fds[1], F_SETFD, FD_CLOEXEC) == 0;
+}
+
+bool SetNonBlocking(int fd)
+{
+  int flags = fcntl(fd, F_GETFL);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Writing to a pipe the child closed raises SIGPIPE - keep it blocked on this thread only
+class ScopedBlockSigpipe
+{
+public:
+  ScopedBlockSigpipe()
+  {
+    sigemptyset(&m_set);
+    sigaddset(&m_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &m_set, &m_previous);
+  }
+
+  ~ScopedBlockSigpipe()
+  {
+    // Consume a SIGPIPE raised by our writes before unblocking
+    timespec noWait{};
+    while (sigtimedwait(&m_set, nullptr, &noWait) > 0) {}
+    pthread_sigmask(SIG_SETMASK, &m_previous, nullptr);
+  }
+
+private:
+  sigset_t m_set;
+  sigset_t m_previous;
+};
+
+void RunPlatform(const Options& options, std::stop_token stopToken, Result& result)
+{
+  FileDescriptor stdinRead, stdinWrite, stdoutRead, stdoutWrite, stderrRead, stderrWrite, execRead, execWrite;
+  if (!CreatePipe(stdinRead, stdinWrite) || !CreatePipe(stdoutRead, stdoutWrite) ||
+      !CreatePipe(stderrRead, stderrWrite) || !CreatePipe(execRead, execWrite)) {
+    result.error = std::format("pipe failed: {}", std::strerror(errno));
+    return;
+  }
+
+  // Everything the child needs is prepared before fork - only async-signal-safe calls after it
+  std::vector<char*> argv;
+  for (const auto& arg : options.args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  std::string workingDirectory = options.workingDirectory.string();
+
+  ScopedBlockSigpipe blockSigpipe;
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    result.error = std::format("fork failed: {}", std::strerror(errno));
+    return;
+  }
+
+  if (pid == 0) {
+    // Own process group so a timeout / cancel also ends anything the helper started
+    setpgid(0, 0);
+    sigset_t empty;
+    sigemptyset(&empty);
+    sigprocmask(SIG_SETMASK, &empty, nullptr);
+
+    if (dup2(stdinRead.Get(), STDIN_FILENO) >= 0 && dup2(stdoutWrite.Get(), STDOUT_FILENO) >= 0 &&
+        dup2(stderrWrite.Get(), STDERR_FILENO) >= 0 &&
+        (workingDirectory.empty() || chdir(workingDirectory.c_str()) == 0)) {
+      execvp(argv[0], argv.data());
+    }
+    // Report why exec failed through the close-on-exec pipe
+    int error = errno;
+    ssize_t ignored = write(execWrite.Get(), &error, sizeof(error));
+    (void)ignored;
+    _exit(127);
+  }
+
+  stdinRead.Close();
+  stdoutWrite.Close();
+  stderrWrite.Close();
+  execWrite.Close();
+
+  // Closed on successful exec, otherwise carries errno
+  int execError = 0;
+  ssize_t execBytes;
+  do {
+    execBytes = read(execRead.Get(), &execError, sizeof(execError));
+  } while (execBytes < 0 && errno == EINTR);
+  if (execBytes == sizeof(execError)) {
+    waitpid(pid, nullptr, 0);
+    result.error = std::format("cannot execute '{}': {}", options.args[0], std::strerror(execError));
+    return;
+  }
+
+  SetNonBlocking(stdinWrite.Get());
+  SetNonBlocking(stdoutRead.Get());
+  SetNonBlocking(stderrRead.Get());
+
+  if (options.input.empty()) {
+    stdinWrite.Close();
+  }
+
+  OutputCollector collector(options, result.output);
+  std::vector<char> buffer(kReadChunk);
+  size_t inputOffset = 0;
+
+  Deadline deadline(options.timeout);
+  bool terminating = false;
+  bool killed      = false;
+  std::chrono::steady_clock::time_point killTime;
+  int waitStatus = 0;
+  bool exited    = false;
+  result.status  = Status::Exited;
+
+  // Returns false once the stream reached end of file
+  auto drain = [&](FileDescriptor& fd, bool isStdout) {
+    while (true) {
+      ssize_t bytesRead = read(fd.Get(), buffer.data(), buffer.size());
+      if (bytesRead > 0) {
+        if (isStdout) {
+          collector.Append(buffer.data(), static_cast<size_t>(bytesRead));
+        } else {
+          AppendErrorOutput(result.errorOutput, buffer.data(), static_cast<size_t>(bytesRead));
+        }
+        continue;
+      }
+      if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+      }
+      fd.Close();
+      return;
+    }
+  };
+
+  while (!exited || stdoutRead.Get() >= 0 || stderrRead.Get() >= 0) {
+    pollfd fds[3];
+    nfds_t count = 0;
+    if (stdinWrite.Get() >= 0) {
+      fds[count++] = {stdinWrite.Get(), POLLOUT, 0};
+    }
+    if (stdoutRead.Get() >= 0) {
+      fds[count++] = {stdoutRead.Get(), POLLIN, 0};
+    }
+    if (stderrRead.Get() >= 0) {
+      fds[count++] = {stderrRead.Get(), POLLIN, 0};
+    }
+
+    if (count > 0) {
+      poll(fds, count, static_cast<int>(kPollInterval.count()));
+    } else {
+      std::this_thread::sleep_for(kPollInterval);
+    }
+
+    for (nfds_t i = 0; i < count; ++i) {
+      if (fds[i].revents == 0)
+        continue;
+
+      if (fds[i].fd == stdinWrite.Get()) {
+        ssize_t written =
+            write(stdinWrite.Get(), options.input.data() + inputOffset, options.input.size() - inputOffset);
+        if (written > 0) {
+          inputOffset += static_cast<size_t>(written);
+        }
+        // Done, or the child closed its stdin (EPIPE)
+        if (inputOffset >= options.input.size() || (written < 0 && errno != EAGAIN && errno != EINTR)) {
+          stdinWrite.Close();
+        }
+      } else if (fds[i].fd == stdoutRead.Get()) {
+        drain(stdoutRead, true);
+      } else if (fds[i].fd == stderrRead.Get()) {
+        drain(stderrRead, false);
+      }
+    }
+
+    if (!exited && waitpid(pid, &waitStatus, WNOHANG) == pid) {
+      exited = true;
+      stdinWrite.Close();
+      // Leftover grandchildren would keep the pipes open forever
+      kill(-pid, SIGKILL);
+    }
+
+    if (!terminating && (stopToken.stop_requested() || deadline.Expired())) {
+      result.status = stopToken.stop_requested() ? Status::Cancelled : Status::TimedOut;
+      terminating   = true;
+      killTime      = std::chrono::steady_clock::now() + kTerminateGrace;
+      kill(-pid, SIGTERM);
+      stdinWrite.Close();
+    } else if (terminating && !killed && std::chrono::steady_clock::now() >= killTime) {
+      // Ignored SIGTERM - force it
+      kill(-pid, SIGKILL);
+      killed = true;
+    }
+  }
+
+  collector.Finish();
+
+  if (WIFEXITED(waitStatus)) {
+    result.exitCode = WEXITSTATUS(waitStatus);
+  } else if (WIFSIGNALED(waitStatus)) {
+    result.exitCode = 128 + WTERMSIG(waitStatus);
+  }
+}
+#endif
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+std::string Result::Describe() const
+{
+  switch (status) {
+  case Status::LaunchFailed:
+    return "failed to start: " + error;
+  case Status::TimedOut:
+    return "timed out";
+  case Status::Cancelled:
+    return "cancelled";
+  case Status::Exited:
+    break;
+  }
+  if (exitCode == 0) {
+    return "completed";
+  }
+
+  // Last non-empty stderr line usually names the actual problem (Python traceback)
+  std::string_view tail = errorOutput;
+  auto end              = tail.find_last_not_of(" \t\r\n");
+  if (end == std::string_view::npos) {
+    return std::format("exited with code {}", exitCode);
+  }
+  tail       = tail.substr(0, end + 1);
+  auto start = tail.find_last_of('\n');
+  return std::format("exited with code {}: {}", exitCode,
+                     start == std::string_view::npos ? tail : tail.substr(start + 1));
+}
+
+Result Run(const Options& options, std::stop_token stopToken)
+{
+  Result result;
+  if (options.args.empty()) {
+    result.error = "no program given";
+    return result;
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+  try {
+    RunPlatform(options, stopToken, result);
+  } catch (const std::exception& e) {
+    result.status = Status::LaunchFailed;
+    result.error  = e.what();
+  }
+  if (result.errorOutput.size() > kMaxErrorOutput) {
+    result.errorOutput.erase(0, result.errorOutput.size() - kMaxErrorOutput);
+  }
+
+  auto elapsedMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+  logger::info("ProcessRunner: '{}' {} after {} ms ({} bytes output)", options.args[0], result.Describe(), elapsedMs,
+               result.output.size());
+  return result;
+}
+
+std::stop_source RunAsync(Options options, std::function<void(Result)> onComplete)
+{
+  std::stop_source stopSource;
+  ThreadPool::GetSingleton()->SubmitBlocking(
+      [options = std::move(options), onComplete = std::move(onComplete), stopToken = stopSource.get_token()]() {
+        auto result = Run(options, stopToken);
+        if (onComplete) {
+          onComplete(std::move(result));
+        }
+      });
+  return stopSource;
+}
+}  // namespace ProcessRunner
@@ -1,6 +1,9 @@
 #include "ProgressionManager.h"
+#include "Logging.h"
+#include "Metrics.h"
 #include "SpellEffectivenessHook.h"
 #include "SpellTomeHook.h"
+#include "Trace.h"
 #include "UIManager.h"
 #include <fstream>
 #include <nlohmann/json.hpp>
@@ -117,10 +120,11 @@ void ProgressionManager::SetPrereqRequirements(RE::FormID spellId,
     m_prereqRequirements.erase(spellId);
   } else {
     m_prereqRequirements[spellId] = reqs;
-    logger::trace("ProgressionManager: Set prereqs for {:08X}: {} hard, {} "
-                  "soft (need {})",
-                  spellId, reqs.hardPrereqs.size(), reqs.softPrereqs.size(),
-                  reqs.softNeeded);
+    SL_LOG_TRACE(Progression,
+                 "ProgressionManager: Set prereqs for {:08X}: {} hard, {} "
+                 "soft (need {})",
+                 spellId, reqs.hardPrereqs.size(), reqs.softPrereqs.size(),
+                 reqs.softNeeded);
   }
 }
 
@@ -388,6 +392,8 @@ void ProgressionManager::SetSpellXP(RE::FormID formId, float xp) {
 
 void ProgressionManager::OnSpellCast(const std::string &school,
                                      RE::FormID castSpellId, float baseXP) {
+  SL_TRACE_SCOPE("ProgressionManager::OnSpellCast");
+
   // Apply global multiplier first
   float adjustedBaseXP = baseXP * m_xpSettings.globalMultiplier;
 
@@ -416,7 +422,8 @@ void ProgressionManager::OnSpellCast(const std::string &school,
         currentProgress >= earlySettings.selfCastRequiredAt) {
       // After selfCastRequiredAt threshold, ONLY self-casting grants XP
       if (!isCastingLearningTarget) {
-        logger::trace(
+        SL_LOG_TRACE(
+            Progression,
             "ProgressionManager: Progress {:.0f}% >= selfCastRequiredAt "
             "{:.0f}% - "
             "only self-casting grants XP (cast spell {:08X} != target {:08X})",
@@ -441,10 +448,11 @@ void ProgressionManager::OnSpellCast(const std::string &school,
         if (effectivenessHook->IsEarlyLearnedSpell(targetId)) {
           multiplier = m_xpSettings.multiplierDirect *
                        earlySettings.selfCastXPMultiplier;
-          logger::trace("ProgressionManager: Self-casting early-learned spell "
-                        "- multiplier {:.0f}% x {:.1f} = {:.0f}%",
-                        m_xpSettings.multiplierDirect * 100,
-                        earlySettings.selfCastXPMultiplier, multiplier * 100);
+          SL_LOG_TRACE(Progression,
+                       "ProgressionManager: Self-casting early-learned spell "
+                       "- multiplier {:.0f}% x {:.1f} = {:.0f}%",
+                       m_xpSettings.multiplierDirect * 100,
+                       earlySettings.selfCastXPMultiplier, multiplier * 100);
         } else {
           // Spell not yet early-unlocked - use direct multiplier
           multiplier = m_xpSettings.multiplierDirect;
@@ -458,24 +466,27 @@ void ProgressionManager::OnSpellCast(const std::string &school,
         // Cast spell is a direct prerequisite of the target
         source = XPSource::Direct;
         multiplier = m_xpSettings.multiplierDirect;
-        logger::trace("ProgressionManager: Direct prereq cast {:08X} for "
-                      "target {:08X} - using direct multiplier {:.0f}%",
-                      castSpellId, targetId, multiplier * 100);
+        SL_LOG_TRACE(Progression,
+                     "ProgressionManager: Direct prereq cast {:08X} for "
+                     "target {:08X} - using direct multiplier {:.0f}%",
+                     castSpellId, targetId, multiplier * 100);
       } else {
         // Same school but not a direct prereq
         source = XPSource::School;
         multiplier = m_xpSettings.multiplierSchool;
-        logger::trace("ProgressionManager: Same school cast - using school "
-                      "multiplier {:.0f}%",
-                      multiplier * 100);
+        SL_LOG_TRACE(Progression,
+                     "ProgressionManager: Same school cast - using school "
+                     "multiplier {:.0f}%",
+                     multiplier * 100);
       }
     } else {
       // Different school - ANY source
       source = XPSource::Any;
       multiplier = m_xpSettings.multiplierAny;
-      logger::trace("ProgressionManager: Different school cast - using any "
-                    "multiplier {:.0f}%",
-                    multiplier * 100);
+      SL_LOG_TRACE(Progression,
+                   "ProgressionManager: Different school cast - using any "
+                   "multiplier {:.0f}%",
+                   multiplier * 100);
     }
 
     // Skip if multiplier is 0
@@ -493,9 +504,10 @@ void ProgressionManager::OnSpellCast(const std::string &school,
       float tomeBoost = tomeHook->GetXPMultiplier(targetId);
       if (tomeBoost > 1.0f) {
         xpGain *= tomeBoost;
-        logger::trace("ProgressionManager: Tome inventory boost applied to "
-                      "{:08X}, xpGain = {:.1f}",
-                      targetId, xpGain);
+        SL_LOG_TRACE(Progression,
+                     "ProgressionManager: Tome inventory boost applied to "
+                     "{:08X}, xpGain = {:.1f}",
+                     targetId, xpGain);
       }
     }
 
@@ -529,21 +541,27 @@ void ProgressionManager::OnSpellCast(const std::string &school,
     // Clamp XP gain to not exceed cap
     float remainingCap = maxXPFromSource - currentXPFromSource;
     if (remainingCap <= 0.0f) {
-      logger::trace("ProgressionManager: Source cap reached for {:08X} "
-                    "(source: {}, cap: {:.1f}%)",
-                    targetId,
-                    source == XPSource::Any      ? "any"
-                    : source == XPSource::School ? "school"
-                    : source == XPSource::Direct ? "direct"
-                                                 : "self",
-                    source == XPSource::Any      ? m_xpSettings.capAny
-                    : source == XPSource::School ? m_xpSettings.capSchool
-                    : source == XPSource::Direct ? m_xpSettings.capDirect
-                                                 : 100.0f);
+      SL_LOG_TRACE(Progression,
+                   "ProgressionManager: Source cap reached for {:08X} "
+                   "(source: {}, cap: {:.1f}%)",
+                   targetId,
+                   source == XPSource::Any      ? "any"
+                   : source == XPSource::School ? "school"
+                   : source == XPSource::Direct ? "direct"
+                                                : "self",
+                   source == XPSource::Any      ? m_xpSettings.capAny
+                   : source == XPSource::School ? m_xpSettings.capSchool
+                   : source == XPSource::Direct ? m_xpSettings.capDirect
+                                                : 100.0f);
       continue; // Skip this target, cap reached
     }
 
     float actualXPGain = (std::min)(xpGain, remainingCap);
+    CountXPEvent(source == XPSource::Any      ? "cast_any"
+                 : source == XPSource::School ? "cast_school"
+                 : source == XPSource::Direct ? "cast_direct"
+                                              : "cast_self",
+                 targetSchool);
 
     // Track XP by source
     switch (source) {
@@ -566,24 +584,26 @@ void ProgressionManager::OnSpellCast(const std::string &school,
     if (m_xpSettings.learningMode == "single") {
       // Only process the first active learning target
       AddXP(targetId, actualXPGain);
-      logger::trace("ProgressionManager: Cast {:08X} granted {:.1f} XP (capped "
-                    "from {:.1f}) to target {:08X} (single mode, source: {})",
-                    castSpellId, actualXPGain, xpGain, targetId,
-                    source == XPSource::Any      ? "any"
-                    : source == XPSource::School ? "school"
-                    : source == XPSource::Direct ? "direct"
-                                                 : "self");
+      SL_LOG_TRACE(Progression,
+                   "ProgressionManager: Cast {:08X} granted {:.1f} XP (capped "
+                   "from {:.1f}) to target {:08X} (single mode, source: {})",
+                   castSpellId, actualXPGain, xpGain, targetId,
+                   source == XPSource::Any      ? "any"
+                   : source == XPSource::School ? "school"
+                   : source == XPSource::Direct ? "direct"
+                                                : "self");
       return; // Only one target in single mode
     } else {
       // Per-school mode - each school's target gets XP
       AddXP(targetId, actualXPGain);
-      logger::trace("ProgressionManager: Cast {:08X} granted {:.1f} XP (capped "
-                    "from {:.1f}) to target {:08X} (school: {}, source: {})",
-                    castSpellId, actualXPGain, xpGain, targetId, targetSchool,
-                    source == XPSource::Any      ? "any"
-                    : source == XPSource::School ? "school"
-                    : source == XPSource::Direct ? "direct"
-                                                 : "self");
+      SL_LOG_TRACE(Progression,
+                   "ProgressionManager: Cast {:08X} granted {:.1f} XP (capped "
+                   "from {:.1f}) to target {:08X} (school: {}, source: {})",
+                   castSpellId, actualXPGain, xpGain, targetId, targetSchool,
+                   source == XPSource::Any      ? "any"
+                   : source == XPSource::School ? "school"
+                   : source == XPSource::Direct ? "direct"
+                                                : "self");
     }
   }
 }
@@ -611,10 +631,11 @@ void ProgressionManager::AddXP(RE::FormID targetSpellId, float amount) {
 
   // PERFORMANCE: Use trace for frequent XP updates (only visible with verbose
   // logging)
-  logger::trace("ProgressionManager: Spell {:08X} XP: {:.1f} -> {:.1f} / "
-                "{:.1f} ({:.1f}%)",
-                targetSpellId, oldXP, newXP, progress.requiredXP,
-                progress.progressPercent * 100.0f);
+  SL_LOG_TRACE(Progression,
+               "ProgressionManager: Spell {:08X} XP: {:.1f} -> {:.1f} / "
+               "{:.1f} ({:.1f}%)",
+               targetSpellId, oldXP, newXP, progress.requiredXP,
+               progress.progressPercent * 100.0f);
 
   // =========================================================================
   // EARLY SPELL LEARNING - Grant spell at threshold, master at 100%
@@ -702,6 +723,15 @@ void ProgressionManager::AddXP(RE::FormID targetSpellId, float amount) {
                                                   progress.requiredXP);
 }
 
+void ProgressionManager::CountXPEvent(std::string_view source,
+                                      std::string_view school) {
+  Metrics::GetCounter("spelllearning_xp_events",
+                      "XP grants by source and target spell school",
+                      {{"source", std::string(source)},
+                       {"school", std::string(school)}})
+      .Add();
+}
+
 void ProgressionManager::AddXP(const std::string &formIdStr, float amount) {
   // Parse hex string to FormID (supports "0x" prefix)
   RE::FormID formId = 0;
@@ -1015,6 +1045,7 @@ void ProgressionManager::ClearAllProgress() {
 }
 
 void ProgressionManager::OnGameSaved(SKSE::SerializationInterface *a_intfc) {
+  SL_TRACE_SCOPE("ProgressionManager::OnGameSaved");
   logger::info("ProgressionManager: Saving to co-save...");
 
   // Write learning targets record
@@ -1027,6 +1058,7 @@ void ProgressionManager::OnGameSaved(SKSE::SerializationInterface *a_intfc) {
   // Write number of targets
   uint32_t numTargets = static_cast<uint32_t>(m_learningTargets.size());
   a_intfc->WriteRecordData(&numTargets, sizeof(numTargets));
+  size_t targetsBytes = sizeof(numTargets);
 
   // Write each target: school string length, school string, formId
   for (auto &[school, formId] : m_learningTargets) {
@@ -1034,7 +1066,12 @@ void ProgressionManager::OnGameSaved(SKSE::SerializationInterface *a_intfc) {
     a_intfc->WriteRecordData(&schoolLen, sizeof(schoolLen));
     a_intfc->WriteRecordData(school.c_str(), schoolLen);
     a_intfc->WriteRecordData(&formId, sizeof(formId));
+    targetsBytes += sizeof(schoolLen) + schoolLen + sizeof(formId);
   }
+  Metrics::GetGauge("spelllearning_cosave_bytes",
+                    "Bytes written to the co-save by record at the last save",
+                    {{"record", "targets"}})
+      .Set(static_cast<double>(targetsBytes));
 
   logger::info("ProgressionManager: Saved {} learning targets", numTargets);
 
@@ -1057,6 +1094,13 @@ void ProgressionManager::OnGameSaved(SKSE::SerializationInterface *a_intfc) {
     uint8_t unlocked = progress.unlocked ? 1 : 0;
     a_intfc->WriteRecordData(&unlocked, sizeof(unlocked));
   }
+  constexpr size_t kProgressEntryBytes =
+      sizeof(RE::FormID) + sizeof(float) + sizeof(uint8_t);
+  Metrics::GetGauge("spelllearning_cosave_bytes",
+                    "Bytes written to the co-save by record at the last save",
+                    {{"record", "progress"}})
+      .Set(static_cast<double>(sizeof(numProgress) +
+                               numProgress * kProgressEntryBytes));
 
   logger::info("ProgressionManager: Saved {} spell progress entries to co-save",
                numProgress);
@@ -1064,6 +1108,7 @@ void ProgressionManager::OnGameSaved(SKSE::SerializationInterface *a_intfc) {
 }
 
 void ProgressionManager::OnGameLoaded(SKSE::SerializationInterface *a_intfc) {
+  SL_TRACE_SCOPE("ProgressionManager::OnGameLoaded");
   logger::info("ProgressionManager: Loading from co-save...");
 
   // Clear existing data first
@@ -1137,7 +1182,8 @@ void ProgressionManager::OnGameLoaded(SKSE::SerializationInterface *a_intfc) {
           // requiredXP will be set from tree data later
           m_spellProgress[resolvedId] = progress;
 
-          logger::info(
+          SL_LOG_DEBUG(
+              Progression,
               "ProgressionManager: Loaded progress {:08X} -> {:.1f}% {}",
               resolvedId, progressPercent * 100.0f,
               unlocked ? "(unlocked)" : "");
@@ -1189,7 +1235,8 @@ void ProgressionManager::LoadProgress(const std::string &saveName) {
 void ProgressionManager::SaveProgress() {
   // This is now a no-op - progress is saved to co-save automatically
   // Kept for backwards compatibility
-  logger::trace(
+  SL_LOG_TRACE(
+      Progression,
       "ProgressionManager: SaveProgress called (legacy) - using co-save");
 }
 
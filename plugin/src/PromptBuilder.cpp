@@ -0,0 +1,614 @@
+#include "PromptBuilder.h"
+#include "TreeRepair.h"
+
+#include <set>
+
+namespace PromptBuilder
+{
+namespace
+{
+// Response tokens of one node ({"formId", "children", "prerequisites", "tier"})
+constexpr size_t kOutputTokensPerSpell = 48;
+
+// Earlier-part spells listed as attachment points in a later part
+constexpr size_t kMaxAnchors = 80;
+
+// Column order of the table; keys not listed here follow alphabetically
+constexpr std::array kColumnOrder = {"formId",   "name",        "skillLevel",  "minimumSkill", "familyId",
+                                     "editorId", "magickaCost", "castingType", "delivery",     "chargeTime",
+                                     "plugin",   "tomeName",    "effects",     "effectNames"};
+
+// Same for every spell of a school, or only meaningful to the load order
+bool IsDroppedColumn(std::string_view key)
+{
+  return key == "school" || key == "persistentId" || key == "tomeFormId";
+}
+
+int TierFromSkillLevel(std::string_view skillLevel)
+{
+  static constexpr std::array kLevels = {"Novice", "Apprentice", "Adept", "Expert", "Master"};
+  for (size_t i = 0; i < kLevels.size(); ++i) {
+    if (skillLevel == kLevels[i]) {
+      return static_cast<int>(i) + 1;
+    }
+  }
+  return 0;
+}
+
+// String member, empty if missing or not a string
+std::string_view StringField(const json& object, const char* key)
+{
+  auto it = object.find(key);
+  return it != object.end() && it->is_string() ? std::string_view(it->get_ref<const std::string&>())
+                                               : std::string_view();
+}
+
+std::string FormIdOf(const json& value)
+{
+  return value.is_string() ? CanonicalFormId(value.get<std::string>()) : std::string();
+}
+
+// Cell text never contains the separator or line breaks
+void AppendEscaped(std::string& out, std::string_view text)
+{
+  for (char c : text) {
+    switch (c) {
+    case '|':
+      out.push_back('/');
+      break;
+    case '\n':
+    case '\r':
+    case '\t':
+      out.push_back(' ');
+      break;
+    default:
+      out.push_back(c);
+      break;
+    }
+  }
+}
+
+void AppendScalar(std::string& out, const json& value)
+{
+  if (value.is_string()) {
+    AppendEscaped(out, value.get_ref<const std::string&>());
+  } else if (value.is_boolean()) {
+    out.push_back(value.get<bool>() ? '1' : '0');
+  } else if (value.is_number_float()) {
+    out += std::format("{:.4g}", value.get<double>());
+  } else if (value.is_number()) {
+    out += value.dump();
+  } else if (!value.is_null()) {
+    AppendEscaped(out, value.dump());
+  }
+}
+
+// effects: "Name[magnitude/duration/area] description; ..."
+void AppendEffects(std::string& out, const json& effects)
+{
+  bool first = true;
+  for (const auto& effect : effects) {
+    if (!first) {
+      out += "; ";
+    }
+    first = false;
+
+    if (!effect.is_object()) {
+      AppendScalar(out, effect);
+      continue;
+    }
+    AppendScalar(out, effect.value("name", json()));
+    out.push_back('[');
+    AppendScalar(out, effect.value("magnitude", json(0)));
+    out.push_back('/');
+    AppendScalar(out, effect.value("duration", json(0)));
+    out.push_back('/');
+    AppendScalar(out, effect.value("area", json(0)));
+    out.push_back(']');
+    if (auto description = StringField(effect, "description"); !description.empty()) {
+      out.push_back(' ');
+      AppendEscaped(out, description);
+    }
+  }
+}
+
+void AppendCell(std::string& out, const std::string& column, const json& spell)
+{
+  auto it = spell.find(column);
+  if (it == spell.end()) {
+    return;
+  }
+  if (!it->is_array()) {
+    AppendScalar(out, *it);
+  } else if (column == "effects") {
+    AppendEffects(out, *it);
+  } else {
+    bool first = true;
+    for (const auto& item : *it) {
+      if (!first) {
+        out += ", ";
+      }
+      first = false;
+      AppendScalar(out, item);
+    }
+  }
+}
+
+std::vector<std::string> CollectColumns(const json& spells)
+{
+  std::set<std::string> present;
+  for (const auto& spell : spells) {
+    if (!spell.is_object()) {
+      continue;
+    }
+    for (const auto& [key, value] : spell.items()) {
+      if (!IsDroppedColumn(key) && !value.is_null()) {
+        present.insert(key);
+      }
+    }
+  }
+
+  std::vector<std::string> columns;
+  for (const char* column : kColumnOrder) {
+    if (present.erase(column)) {
+      columns.emplace_back(column);
+    }
+  }
+  columns.insert(columns.end(), present.begin(), present.end());  // std::set - already sorted
+  return columns;
+}
+
+std::string JoinColumns(const std::vector<std::string>& columns)
+{
+  std::string header;
+  for (const auto& column : columns) {
+    if (!header.empty()) {
+      header.push_back('|');
+    }
+    header += column;
+  }
+  return header;
+}
+
+struct MergedNode
+{
+  std::string formId;  // Canonical
+  json data;           // Node as returned, formId/children/prerequisites are rewritten
+  std::vector<std::string> prerequisites;
+  size_t part = 0;
+};
+}  // namespace
+
+std::string CanonicalFormId(std::string_view formId)
+{
+  while (!formId.empty() && std::isspace(static_cast<unsigned char>(formId.front()))) {
+    formId.remove_prefix(1);
+  }
+  while (!formId.empty() && std::isspace(static_cast<unsigned char>(formId.back()))) {
+    formId.remove_suffix(1);
+  }
+  std::string result;
+  if (formId.size() > 2 && formId[0] == '0' && (formId[1] == 'x' || formId[1] == 'X')) {
+    result = "0x";
+    formId.remove_prefix(2);
+  }
+  for (char c : formId) {
+    result.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+  }
+  return result;
+}
+
+int SpellTier(const json& spell)
+{
+  if (int tier = TierFromSkillLevel(StringField(spell, "skillLevel")); tier > 0) {
+    return tier;
+  }
+  auto minimumSkill = spell.find("minimumSkill");
+  if (minimumSkill != spell.end() && minimumSkill->is_number()) {
+    return std::clamp(minimumSkill->get<int>() / 25 + 1, 1, 5);
+  }
+  return 1;
+}
+
+std::string_view JsonBody(std::string_view response)
+{
+  auto begin = response.find('{');
+  auto end   = response.rfind('}');
+  if (begin == std::string_view::npos || end == std::string_view::npos || end < begin) {
+    return {};
+  }
+  return response.substr(begin, end - begin + 1);
+}
+
+json Plan::StatsToJson() const
+{
+  json j;
+  j["spells"]        = SpellCount();
+  j["parts"]         = parts.size();
+  j["jsonBytes"]     = jsonBytes;
+  j["compactBytes"]  = compactBytes;
+  j["jsonTokens"]    = jsonTokens;
+  j["compactTokens"] = compactTokens;
+  return j;
+}
+
+size_t EstimateTokens(std::string_view text)
+{
+  size_t tokens = 0;
+  size_t run    = 0;
+  for (char c : text) {
+    auto uc = static_cast<unsigned char>(c);
+    if (std::isalnum(uc) || uc >= 0x80) {
+      run++;
+      continue;
+    }
+    tokens += (run + 3) / 4;
+    run = 0;
+    if (!std::isspace(uc)) {
+      tokens++;
+    }
+  }
+  return tokens + (run + 3) / 4;
+}
+
+bool BuildPlan(const std::string& school, const std::string& spellData, const Limits& limits, Plan& plan)
+{
+  json spells = json::parse(spellData, nullptr, false);
+  if (spells.is_discarded() || !spells.is_array() || spells.empty()) {
+    return false;
+  }
+
+  plan        = Plan();
+  plan.school = school;
+
+  std::vector<std::string> columns = CollectColumns(spells);
+  std::string header               = JoinColumns(columns);
+  size_t headerTokens              = EstimateTokens(header) + 1;
+
+  // One row per spell, grouped by variant family so families stay in one part
+  struct Group
+  {
+    int tier = 0;
+    std::vector<size_t> rows;
+    size_t tokens = 0;
+  };
+  std::vector<std::string> rows;
+  std::vector<std::string> rowFormIds;
+  std::vector<std::string> rowNames;
+  std::vector<Group> groups;
+  std::unordered_map<std::string, size_t> groupByFamily;
+
+  for (const auto& spell : spells) {
+    if (!spell.is_object()) {
+      continue;
+    }
+    std::string formId = FormIdOf(spell.value("formId", json()));
+    if (formId.empty() || plan.tiers.contains(formId)) {
+      continue;
+    }
+
+    std::string row;
+    for (size_t c = 0; c < columns.size(); ++c) {
+      if (c > 0) {
+        row.push_back('|');
+      }
+      AppendCell(row, columns[c], spell);
+    }
+
+    int tier           = SpellTier(spell);
+    plan.tiers[formId] = tier;
+
+    std::string family  = std::string(StringField(spell, "familyId"));
+    std::string key     = family.empty() ? "#" + formId : family;
+    auto [it, inserted] = groupByFamily.try_emplace(key, groups.size());
+    if (inserted) {
+      groups.push_back({tier, {}, 0});
+    }
+    Group& group = groups[it->second];
+    group.tier   = std::min(group.tier, tier);
+    group.rows.push_back(rows.size());
+    group.tokens += EstimateTokens(row) + 1;
+
+    rows.push_back(std::move(row));
+    rowFormIds.push_back(std::move(formId));
+    rowNames.emplace_back(StringField(spell, "name"));
+  }
+
+  if (rows.empty()) {
+    return false;
+  }
+
+  // Tier bands: lowest tier first, scan order within a tier
+  std::stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.tier < b.tier; });
+
+  size_t tokenBudget = limits.tokenBudget > headerTokens ? limits.tokenBudget - headerTokens : 1;
+  size_t maxSpells =
+      std::max<size_t>(8, static_cast<size_t>(std::max(limits.maxOutputTokens, 0)) * 8 / 10 / kOutputTokensPerSpell);
+
+  Part* part = nullptr;
+  for (const auto& group : groups) {
+    if (!part || (!part->formIds.empty() && (part->estimatedTokens + group.tokens > tokenBudget ||
+                                             part->formIds.size() + group.rows.size() > maxSpells))) {
+      part                  = &plan.parts.emplace_back();
+      part->table           = header;
+      part->estimatedTokens = 0;
+    }
+    for (size_t row : group.rows) {
+      part->table.push_back('\n');
+      part->table += rows[row];
+      part->formIds.push_back(rowFormIds[row]);
+      part->names.push_back(rowNames[row]);
+    }
+    part->estimatedTokens += group.tokens;
+  }
+
+  plan.jsonBytes  = spellData.size();
+  plan.jsonTokens = EstimateTokens(spellData);
+  for (auto& p : plan.parts) {
+    p.estimatedTokens += headerTokens;
+    plan.compactBytes += p.table.size();
+    plan.compactTokens += p.estimatedTokens;
+  }
+  return true;
+}
+
+std::string BuildUserPrompt(const Plan& plan, size_t partIndex, const std::string& promptRules)
+{
+  const size_t partCount = plan.parts.size();
+  const Part& part       = plan.parts.at(partIndex);
+
+  std::string prompt = "Create a spell learning tree for the " + plan.school + " school of magic.\n\n";
+
+  if (partCount > 1) {
+    prompt += std::format("## PART {} OF {}\n", partIndex + 1, partCount);
+    prompt += "This school is too large for one response and is split into parts by tier. ";
+    if (partIndex == 0) {
+      prompt += "This part contains the lowest-tier spells and the root of the school. Build the tree for these "
+                "spells only - later parts will attach their spells to yours.\n\n";
+    } else {
+      prompt += "The root and the lower-tier spells were placed in earlier parts. Build the tree for the spells of "
+                "this part only and do NOT output spells from earlier parts. Every spell of this part needs a "
+                "prerequisite within this part or from SPELLS FROM EARLIER PARTS. Set \"root\" to the earlier-part "
+                "spell that the lowest spells of this part attach to.\n\n";
+    }
+  }
+
+  if (!promptRules.empty()) {
+    prompt += "## USER RULES\n" + promptRules + "\n\n";
+  }
+
+  prompt += "## SPELL DATA FOR " + plan.school + "\n";
+  prompt += "One spell per line, columns separated by |. The first line names the columns.";
+  if (part.table.find("|effects") != std::string::npos) {
+    prompt += " effects: name[magnitude/duration/area] description, separated by ;";
+  }
+  prompt += "\n\n" + part.table;
+
+  if (partIndex > 0) {
+    // Highest-tier spells of the earlier parts are the natural attachment points
+    std::vector<std::pair<const Part*, size_t>> anchors;
+    for (size_t p = partIndex; p-- > 0 && anchors.size() < kMaxAnchors;) {
+      const Part& earlier = plan.parts[p];
+      for (size_t i = earlier.formIds.size(); i-- > 0 && anchors.size() < kMaxAnchors;) {
+        anchors.emplace_back(&earlier, i);
+      }
+    }
+
+    prompt += "\n\n## SPELLS FROM EARLIER PARTS\nformId|name|tier\n";
+    for (auto it = anchors.rbegin(); it != anchors.rend(); ++it) {
+      const auto& formId = it->first->formIds[it->second];
+      prompt += formId + "|";
+      AppendEscaped(prompt, it->first->names[it->second]);
+      prompt += std::format("|{}\n", plan.tiers.at(formId));
+    }
+  }
+  return prompt;
+}
+
+MergeResult MergeParts(const Plan& plan, const std::vector<std::string>& responses)
+{
+  MergeResult result;
+  if (responses.size() != plan.parts.size()) {
+    result.error = std::format("Expected {} part responses, got {}", plan.parts.size(), responses.size());
+    return result;
+  }
+
+  std::vector<MergedNode> nodes;
+  std::unordered_map<std::string, size_t> placed;  // formId -> index in nodes
+  std::vector<std::string> partRoots(responses.size());
+  std::string layoutStyle = "radial";
+  size_t unknown = 0, duplicates = 0, droppedPrereqs = 0, attached = 0;
+
+  for (size_t p = 0; p < responses.size(); ++p) {
+    json doc = json::parse(JsonBody(responses[p]), nullptr, false);
+    if (doc.is_discarded() || !doc.is_object()) {
+      result.error = std::format("Part {} of {} is not valid JSON", p + 1, responses.size());
+      return result;
+    }
+
+    // The school object, also when the model renamed the school key
+    const json* schoolData = nullptr;
+    if (auto schools = doc.find("schools"); schools != doc.end() && schools->is_object()) {
+      if (auto it = schools->find(plan.school); it != schools->end()) {
+        schoolData = &*it;
+      } else if (schools->size() == 1) {
+        schoolData = &schools->begin().value();
+      }
+    }
+    if (!schoolData || !schoolData->is_object() || !schoolData->contains("nodes") ||
+        !(*schoolData)["nodes"].is_array()) {
+      result.error = std::format("Part {} of {} has no nodes for {}", p + 1, responses.size(), plan.school);
+      return result;
+    }
+
+    partRoots[p] = FormIdOf(schoolData->value("root", json()));
+    if (p == 0) {
+      if (auto style = StringField(*schoolData, "layoutStyle"); !style.empty()) {
+        layoutStyle = style;
+      }
+    }
+
+    for (const auto& node : (*schoolData)["nodes"]) {
+      std::string formId = node.is_object() ? FormIdOf(node.value("formId", json())) : std::string();
+      if (!plan.tiers.contains(formId)) {
+        unknown++;
+        continue;
+      }
+      if (placed.contains(formId)) {
+        duplicates++;
+        continue;
+      }
+
+      MergedNode merged;
+      merged.formId = formId;
+      merged.data   = node;
+      merged.part   = p;
+      if (auto prereqs = node.find("prerequisites"); prereqs != node.end() && prereqs->is_array()) {
+        for (const auto& prereq : *prereqs) {
+          std::string id = FormIdOf(prereq);
+          if (!id.empty() && id != formId &&
+              std::find(merged.prerequisites.begin(), merged.prerequisites.end(), id) == merged.prerequisites.end()) {
+            merged.prerequisites.push_back(std::move(id));
+          }
+        }
+      }
+      placed[formId] = nodes.size();
+      nodes.push_back(std::move(merged));
+    }
+  }
+
+  if (nodes.empty()) {
+    result.error = "No usable nodes in any part";
+    return result;
+  }
+
+  // Root from part 1, else its first node without prerequisites
+  std::string root = partRoots[0];
+  if (!placed.contains(root) || nodes[placed[root]].part != 0) {
+    root.clear();
+    for (const auto& node : nodes) {
+      if (node.part == 0 && node.prerequisites.empty()) {
+        root = node.formId;
+        break;
+      }
+    }
+    if (root.empty()) {
+      root = nodes.front().formId;
+    }
+    result.issues.push_back("Root of part 1 was missing - using " + root);
+  }
+
+  for (auto& node : nodes) {
+    if (node.formId == root) {
+      node.prerequisites.clear();
+      continue;
+    }
+
+    size_t before = node.prerequisites.size();
+    std::erase_if(node.prerequisites, [&](const std::string& id) { return !placed.contains(id); });
+    droppedPrereqs += before - node.prerequisites.size();
+
+    // Parentless spells hang off their part's declared attachment point, or the root
+    if (node.prerequisites.empty()) {
+      const std::string& anchor = partRoots[node.part];
+      bool useAnchor = node.part > 0 && placed.contains(anchor) && nodes[placed[anchor]].part < node.part;
+      node.prerequisites.push_back(useAnchor ? anchor : root);
+      attached++;
+    }
+  }
+
+  // Children are rebuilt from prerequisites so both directions agree across parts
+  auto buildTree = [&]() {
+    std::unordered_map<std::string, std::vector<std::string>> children;
+    for (const auto& node : nodes) {
+      for (const auto& prereq : node.prerequisites) {
+        children[prereq].push_back(node.formId);
+      }
+    }
+
+    json nodeArray = json::array();
+    for (const auto& node : nodes) {
+      json data             = node.data;
+      data["formId"]        = node.formId;
+      data["prerequisites"] = node.prerequisites;
+      data["children"]      = children[node.formId];
+      if (!data.contains("tier")) {
+        data["tier"] = plan.tiers.at(node.formId);
+      }
+      nodeArray.push_back(std::move(data));
+    }
+
+    json schoolData;
+    schoolData["root"]        = root;
+    schoolData["layoutStyle"] = layoutStyle;
+    schoolData["nodes"]       = std::move(nodeArray);
+
+    json tree;
+    tree["version"]              = "1.0";
+    tree["schools"][plan.school] = std::move(schoolData);
+    return tree;
+  };
+  json tree = buildTree();
+
+  // Each part is checked on its own; prerequisites across parts can still close a cycle
+  TreeRepair::Analysis analysis;
+  std::string analysisError;
+  bool analyzed = TreeRepair::Analyze(plan.school, tree.dump(), {}, analysis, analysisError);
+  if (analyzed && !analysis.cycles.empty()) {
+    // Inside a cycle, links to spells placed later (later part, or later in the same response) are dropped -
+    // merge order is a total order, so what is left is acyclic. Members left without prerequisites hang off the root.
+    std::unordered_map<std::string, size_t> component;
+    for (size_t c = 0; c < analysis.cycles.size(); ++c) {
+      for (const auto& formId : analysis.cycles[c]) {
+        component[formId] = c;
+      }
+    }
+    size_t cut = 0;
+    for (auto& node : nodes) {
+      auto own = component.find(node.formId);
+      if (own == component.end())
+        continue;
+      size_t before = node.prerequisites.size();
+      std::erase_if(node.prerequisites, [&](const std::string& id) {
+        auto other = component.find(id);
+        return other != component.end() && other->second == own->second && placed[id] > placed[node.formId];
+      });
+      cut += before - node.prerequisites.size();
+      if (node.prerequisites.empty()) {
+        node.prerequisites.push_back(root);
+      }
+    }
+    result.issues.push_back(std::format("Broke {} prerequisite cycle(s) across parts ({} link(s) removed)",
+                                        analysis.cycles.size(), cut));
+
+    tree     = buildTree();
+    analyzed = TreeRepair::Analyze(plan.school, tree.dump(), {}, analysis, analysisError);
+  }
+  if (!analyzed) {
+    result.issues.push_back("Merged tree could not be checked: " + analysisError);
+  } else if (size_t unreachable = analysis.nodes.size() - analysis.reachableCount; unreachable > 0) {
+    result.issues.push_back(std::format("{} spell(s) unreachable from the root after merging", unreachable));
+  }
+
+  if (unknown > 0) {
+    result.issues.push_back(std::format("Dropped {} unknown spell(s)", unknown));
+  }
+  if (duplicates > 0) {
+    result.issues.push_back(std::format("Dropped {} duplicate spell(s)", duplicates));
+  }
+  if (droppedPrereqs > 0) {
+    result.issues.push_back(std::format("Removed {} prerequisite(s) to spells not in the tree", droppedPrereqs));
+  }
+  if (attached > 0) {
+    result.issues.push_back(std::format("Attached {} parentless spell(s) across parts", attached));
+  }
+  if (size_t missing = plan.SpellCount() - placed.size(); missing > 0) {
+    result.issues.push_back(std::format("{} spell(s) missing from the responses", missing));
+  }
+
+  result.nodeCount = placed.size();
+  result.tree      = tree.dump();
+  result.success   = true;
+  return result;
+}
+}  // namespace PromptBuilder
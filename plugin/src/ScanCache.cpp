@@ -0,0 +1,293 @@
+#include "ScanCache.h"
+#include "AsyncFileWriter.h"
+
+namespace ScanCache
+{
+namespace
+{
+constexpr uint32_t kCacheMagic   = 0x43534C53;  // "SLSC" - Spell Learning Scan Cache
+constexpr uint32_t kCacheVersion = 3;
+
+constexpr uint64_t kFNVOffset = 14695981039346656037ull;
+constexpr uint64_t kFNVPrime  = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= kFNVPrime;
+  }
+}
+
+uint64_t HashStamps(const std::vector<PluginStamp>& plugins)
+{
+  uint64_t hash = kFNVOffset;
+  for (const auto& stamp : plugins) {
+    HashBytes(hash, stamp.name.data(), stamp.name.size());
+    HashBytes(hash, &stamp.loadIndex, sizeof(stamp.loadIndex));
+    HashBytes(hash, &stamp.fileSize, sizeof(stamp.fileSize));
+    HashBytes(hash, &stamp.writeTime, sizeof(stamp.writeTime));
+  }
+  return hash;
+}
+}  // namespace
+
+// =============================================================================
+// LOAD ORDER FINGERPRINT
+// =============================================================================
+
+LoadOrderFingerprint BuildLoadOrderFingerprint()
+{
+  LoadOrderFingerprint fingerprint;
+
+  auto* dataHandler = RE::TESDataHandler::GetSingleton();
+  if (!dataHandler) {
+    return fingerprint;
+  }
+
+  const std::filesystem::path dataDir = "Data";
+
+  for (auto* file : dataHandler->files) {
+    if (!file || !file->fileName) {
+      continue;
+    }
+
+    if (file->GetCompileIndex() == 0xFF) {
+      continue;  // Not active
+    }
+
+    PluginStamp stamp;
+    stamp.name      = file->fileName;
+    stamp.loadIndex = file->IsLight() ? (0xFE000 | file->GetPartialIndex()) : file->GetCompileIndex();
+
+    std::error_code ec;
+    auto pluginPath = dataDir / stamp.name;
+    auto fileSize   = std::filesystem::file_size(pluginPath, ec);
+    stamp.fileSize  = ec ? 0 : static_cast<uint64_t>(fileSize);
+    auto writeTime  = std::filesystem::last_write_time(pluginPath, ec);
+    stamp.writeTime = ec ? 0 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+    fingerprint.plugins.push_back(std::move(stamp));
+  }
+
+  fingerprint.hash = HashStamps(fingerprint.plugins);
+  return fingerprint;
+}
+
+std::vector<std::string> GetFormSourceFiles(const RE::TESForm* form)
+{
+  std::vector<std::string> sources;
+  if (!form || !form->sourceFiles.array) {
+    return sources;
+  }
+
+  for (auto* file : *form->sourceFiles.array) {
+    if (file && file->fileName) {
+      sources.emplace_back(file->fileName);
+    }
+  }
+  return sources;
+}
+
+// =============================================================================
+// CACHE FILE
+// =============================================================================
+
+bool Cache::Load(const std::filesystem::path& path, uint32_t configKey, uint64_t rulesHash)
+{
+  Clear();
+
+  // A save of this session may still be queued
+  AsyncFileWriter::GetSingleton()->Flush(path);
+
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+
+  try {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    uint32_t header[3] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || header[0] != kCacheMagic || header[1] != kCacheVersion) {
+      logger::info("ScanCache: Ignoring {} (unknown format)", path.filename().string());
+      return false;
+    }
+    if (header[2] != configKey) {
+      logger::info("ScanCache: Ignoring {} (scan fields changed)", path.filename().string());
+      return false;
+    }
+    uint64_t cachedRulesHash = 0;
+    file.read(reinterpret_cast<char*>(&cachedRulesHash), sizeof(cachedRulesHash));
+    if (!file || cachedRulesHash != rulesHash) {
+      logger::info("ScanCache: Ignoring {} (filter rules changed)", path.filename().string());
+      return false;
+    }
+
+    std::vector<uint8_t> payload((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    json data = json::from_msgpack(payload);
+
+    for (const auto& p : data["plugins"]) {
+      PluginStamp stamp;
+      stamp.name      = p[0].get<std::string>();
+      stamp.loadIndex = p[1].get<uint32_t>();
+      stamp.fileSize  = p[2].get<uint64_t>();
+      stamp.writeTime = p[3].get<int64_t>();
+      m_fingerprint.plugins.push_back(std::move(stamp));
+    }
+    m_fingerprint.hash = HashStamps(m_fingerprint.plugins);
+
+    for (const auto& f : data["forms"]) {
+      CachedForm entry;
+      auto formId   = f[0].get<RE::FormID>();
+      entry.verdict = f[1].get<uint8_t>();
+      for (const auto& idx : f[2]) {
+        auto i = idx.get<size_t>();
+        if (i < m_fingerprint.plugins.size()) {
+          entry.sources.push_back(m_fingerprint.plugins[i].name);
+        }
+      }
+      entry.record = f[3].get<std::string>();
+      Store(formId, std::move(entry));
+    }
+
+    logger::info("ScanCache: Loaded {} cached forms from {}", m_forms.size(), path.filename().string());
+    return true;
+  } catch (const std::exception& e) {
+    logger::warn("ScanCache: Failed to read {}: {}", path.filename().string(), e.what());
+    Clear();
+    return false;
+  }
+}
+
+bool Cache::Save(const std::filesystem::path& path, uint32_t configKey, uint64_t rulesHash,
+                 const LoadOrderFingerprint& fingerprint) const
+{
+  try {
+    std::unordered_map<std::string, size_t> pluginIndex;
+    json plugins = json::array();
+    for (size_t i = 0; i < fingerprint.plugins.size(); ++i) {
+      const auto& stamp = fingerprint.plugins[i];
+      plugins.push_back(json::array({stamp.name, stamp.loadIndex, stamp.fileSize, stamp.writeTime}));
+      pluginIndex[stamp.name] = i;
+    }
+
+    json forms = json::array();
+    for (RE::FormID formId : m_order) {
+      const auto& entry = m_forms.at(formId);
+      json sources      = json::array();
+      for (const auto& name : entry.sources) {
+        auto it = pluginIndex.find(name);
+        if (it != pluginIndex.end()) {
+          sources.push_back(it->second);
+        }
+      }
+      forms.push_back(json::array({formId, entry.verdict, std::move(sources), entry.record}));
+    }
+
+    json data;
+    data["plugins"] = std::move(plugins);
+    data["forms"]   = std::move(forms);
+
+    std::vector<uint8_t> payload = json::to_msgpack(data);
+
+    const uint32_t header[3] = {kCacheMagic, kCacheVersion, configKey};
+    std::string content;
+    content.reserve(sizeof(header) + sizeof(rulesHash) + payload.size());
+    content.append(reinterpret_cast<const char*>(header), sizeof(header));
+    content.append(reinterpret_cast<const char*>(&rulesHash), sizeof(rulesHash));
+    content.append(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+    // Temp file + rename - a crash mid-write leaves the previous cache instead of a corrupt one
+    logger::info("ScanCache: Saving {} forms to {} ({} bytes)", m_order.size(), path.filename().string(),
+                 content.size());
+    AsyncFileWriter::GetSingleton()->Write(path, std::move(content));
+    return true;
+  } catch (const std::exception& e) {
+    logger::warn("ScanCache: Failed to save {}: {}", path.string(), e.what());
+    return false;
+  }
+}
+
+bool Cache::Matches(const LoadOrderFingerprint& fingerprint) const
+{
+  return !m_order.empty() && m_fingerprint.hash == fingerprint.hash && m_fingerprint.plugins == fingerprint.plugins;
+}
+
+std::unordered_set<std::string> Cache::GetChangedPlugins(const LoadOrderFingerprint& fingerprint) const
+{
+  std::unordered_map<std::string, const PluginStamp*> previous;
+  for (const auto& stamp : m_fingerprint.plugins) {
+    previous[stamp.name] = &stamp;
+  }
+
+  std::unordered_set<std::string> changed;
+  for (const auto& stamp : fingerprint.plugins) {
+    auto it = previous.find(stamp.name);
+    if (it == previous.end() || !(*it->second == stamp)) {
+      changed.insert(stamp.name);
+    }
+    if (it != previous.end()) {
+      previous.erase(it);
+    }
+  }
+
+  // Removed plugins - forms they used to override must be rebuilt too
+  for (const auto& [name, stamp] : previous) {
+    changed.insert(name);
+  }
+
+  return changed;
+}
+
+const CachedForm* Cache::FindReusable(RE::FormID formId, const std::vector<std::string>& sources,
+                                      const std::unordered_set<std::string>& changedPlugins) const
+{
+  auto it = m_forms.find(formId);
+  if (it == m_forms.end() || it->second.sources != sources) {
+    return nullptr;
+  }
+
+  for (const auto& name : sources) {
+    if (changedPlugins.contains(name)) {
+      return nullptr;
+    }
+  }
+  return &it->second;
+}
+
+const CachedForm* Cache::Find(RE::FormID formId) const
+{
+  auto it = m_forms.find(formId);
+  return it != m_forms.end() ? &it->second : nullptr;
+}
+
+void Cache::Store(RE::FormID formId, CachedForm entry)
+{
+  auto [it, inserted] = m_forms.insert_or_assign(formId, std::move(entry));
+  if (inserted) {
+    m_order.push_back(formId);
+  }
+}
+
+void Cache::Clear()
+{
+  m_fingerprint = {};
+  m_forms.clear();
+  m_order.clear();
+}
+
+std::filesystem::path GetSpellCachePath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/spell_scan_cache.bin";
+}
+
+std::filesystem::path GetTomeCachePath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/spell_tome_scan_cache.bin";
+}
+}  // namespace ScanCache
@@ -1,4 +1,6 @@
 #include "SpellCastHandler.h"
+#include "HookStats.h"
+#include "Logging.h"
 #include "ProgressionManager.h"
 #include "RE/S/SendHUDMessage.h"
 #include "SpellEffectivenessHook.h"
@@ -42,6 +44,7 @@ void SpellCastHandler::Unregister()
 RE::BSEventNotifyControl SpellCastHandler::ProcessEvent(const RE::TESSpellCastEvent* a_event,
                                                         RE::BSTEventSource<RE::TESSpellCastEvent>*)
 {
+  SL_HOOK_TIMER(SpellCastEvent);
   if (!a_event) {
     return RE::BSEventNotifyControl::kContinue;
   }
@@ -105,9 +108,10 @@ RE::BSEventNotifyControl SpellCastHandler::ProcessEvent(const RE::TESSpellCastEv
 
   // PERFORMANCE: Use trace level for frequent events (only visible with verbose
   // logging)
-  logger::trace("SpellCastHandler: Player cast {} ({:08X}) - school: {}, cost: "
-                "{:.1f}, XP: {:.1f}",
-                spell->GetName(), spell->GetFormID(), schoolName, magickaCost, xpGain);
+  SL_LOG_TRACE(Hooks,
+               "SpellCastHandler: Player cast {} ({:08X}) - school: {}, cost: "
+               "{:.1f}, XP: {:.1f}",
+               spell->GetName(), spell->GetFormID(), schoolName, magickaCost, xpGain);
 
   // Grant XP to learning targets in this school
   ProgressionManager::GetSingleton()->OnSpellCast(schoolName, spell->GetFormID(), xpGain);
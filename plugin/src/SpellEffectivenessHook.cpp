@@ -1,8 +1,12 @@
 #include "SpellEffectivenessHook.h"
+#include "HookStats.h"
+#include "Logging.h"
+#include "Metrics.h"
 #include "ProgressionManager.h"
 #include "RE/G/GFxValue.h"
 #include "RE/M/MagicMenu.h"
 #include "RE/T/TESDescription.h"
+#include "Trace.h"
 #include "UIManager.h"
 #include <chrono>
 #include <iomanip>
@@ -40,6 +44,7 @@ struct AdjustForPerksHook {
                     RE::MagicTarget *a_target) {
     // Call original first to let perks apply
     func(a_effect, a_caster, a_target);
+    SL_HOOK_TIMER(AdjustForPerks);
 
     // PERFORMANCE: Early exit for non-player casters BEFORE any other checks
     // This is the most common case (NPC spells) - exit as fast as possible
@@ -114,6 +119,7 @@ struct SpellNameHook {
   static const char *thunk(RE::TESFullName *a_fullName) {
     // Call original first - ALWAYS call this to get base behavior
     const char *originalName = func(a_fullName);
+    SL_HOOK_TIMER(SpellName);
 
     // Early exit for invalid pointers
     if (!a_fullName) {
@@ -162,8 +168,8 @@ struct SpellNameHook {
     g_modifiedName = hook->GetModifiedSpellName(spell);
     if (!g_modifiedName.empty()) {
       // PERFORMANCE: Use trace level for hot path logging
-      logger::trace("SpellNameHook: Returning modified name for {:08X}",
-                    spellId);
+      SL_LOG_TRACE(Hooks, "SpellNameHook: Returning modified name for {:08X}",
+                   spellId);
       return g_modifiedName.c_str();
     }
 
@@ -215,6 +221,7 @@ struct MagicMenuUIHook {
   static void thunk(RE::MagicMenu *a_menu) {
     // Call original first
     func(a_menu);
+    SL_HOOK_TIMER(MagicMenuUI);
 
     // Only modify if menu is valid and display modification is enabled
     if (!a_menu) {
@@ -557,8 +564,9 @@ void SpellEffectivenessHook::ApplyEffectivenessScalingFast(
                               100.0f;
       if (progressPercent < m_settings.binaryEffectThreshold) {
         a_effect->magnitude = 0.0f;
-        logger::trace("SpellEffectivenessHook: Binary effect {:08X} blocked",
-                      spellId);
+        SL_LOG_TRACE(Hooks,
+                     "SpellEffectivenessHook: Binary effect {:08X} blocked",
+                     spellId);
         return;
       }
     }
@@ -570,8 +578,8 @@ void SpellEffectivenessHook::ApplyEffectivenessScalingFast(
 
   // Use trace level logging to reduce overhead (only visible with verbose
   // logging)
-  logger::trace("SpellEffectivenessHook: Scaled {:08X} to {}%", spellId,
-                static_cast<int>(effectiveness * 100));
+  SL_LOG_TRACE(Hooks, "SpellEffectivenessHook: Scaled {:08X} to {}%", spellId,
+               static_cast<int>(effectiveness * 100));
 }
 
 // Legacy version for compatibility (calls fast version after player check)
@@ -781,9 +789,10 @@ void SpellEffectivenessHook::GrantEarlySpell(RE::SpellItem *spell) {
     UIManager::GetSingleton()->UpdateSpellState(std::format("0x{:08X}", formId),
                                                 "weakened");
   } else {
-    logger::trace("SpellEffectivenessHook: Spell {} ({:08X}) already tracked "
-                  "as early-learned",
-                  spell->GetName(), formId);
+    SL_LOG_TRACE(Hooks,
+                 "SpellEffectivenessHook: Spell {} ({:08X}) already tracked "
+                 "as early-learned",
+                 spell->GetName(), formId);
   }
 }
 
@@ -926,16 +935,25 @@ std::string SpellEffectivenessHook::GetModifiedSpellName(RE::SpellItem *spell) {
     return spell->GetName();
   }
 
+  static auto &cacheHits = Metrics::GetCounter(
+      "spelllearning_spell_display_cache_lookups",
+      "Modified spell name lookups by cache result", {{"result", "hit"}});
+  static auto &cacheMisses = Metrics::GetCounter(
+      "spelllearning_spell_display_cache_lookups",
+      "Modified spell name lookups by cache result", {{"result", "miss"}});
+
   // Check cache (read-only)
   {
     std::shared_lock<std::shared_mutex> lock(m_mutex);
     auto it = m_displayCache.find(spellId);
     if (it != m_displayCache.end() && !it->second.modifiedName.empty()) {
+      cacheHits.Add();
       return it->second.modifiedName;
     }
   }
 
   // Build modified name - update cache
+  cacheMisses.Add();
   UpdateSpellDisplayCache(spellId, spell);
 
   std::shared_lock<std::shared_mutex> lock(m_mutex);
@@ -1050,6 +1068,7 @@ bool SpellEffectivenessHook::CheckAndUpdatePowerStep(RE::FormID spellFormId) {
 }
 
 void SpellEffectivenessHook::RefreshAllSpellDisplays() {
+  SL_TRACE_SCOPE("SpellEffectivenessHook::RefreshAllSpellDisplays");
   logger::info(
       "SpellEffectivenessHook: Refreshing all spell displays after load...");
 
@@ -1552,6 +1571,7 @@ SpellEffectivenessHook::GetScaledSpellDescription(RE::SpellItem *spell) const {
 
 void SpellEffectivenessHook::OnGameSaved(
     SKSE::SerializationInterface *a_intfc) {
+  SL_TRACE_SCOPE("SpellEffectivenessHook::OnGameSaved");
   std::shared_lock<std::shared_mutex> lock(m_mutex);
 
   if (!a_intfc->OpenRecord(kEarlyLearnedRecord, 1)) {
@@ -1568,12 +1588,17 @@ void SpellEffectivenessHook::OnGameSaved(
   for (RE::FormID formId : m_earlyLearnedSpells) {
     a_intfc->WriteRecordData(&formId, sizeof(formId));
   }
+  Metrics::GetGauge("spelllearning_cosave_bytes",
+                    "Bytes written to the co-save by record at the last save",
+                    {{"record", "early_learned"}})
+      .Set(static_cast<double>(sizeof(count) + count * sizeof(RE::FormID)));
 
   logger::info("SpellEffectivenessHook: Saved {} early-learned spells", count);
 }
 
 void SpellEffectivenessHook::OnGameLoaded(
     SKSE::SerializationInterface *a_intfc) {
+  SL_TRACE_SCOPE("SpellEffectivenessHook::OnGameLoaded");
   {
     std::unique_lock<std::shared_mutex> lock(m_mutex);
 
@@ -0,0 +1,297 @@
+#include "SpellFamilyIndex.h"
+
+namespace SpellFamilyIndex
+{
+namespace
+{
+// =============================================================================
+// NAME NORMALIZATION
+// =============================================================================
+
+// Rank words dropped anywhere in the name ("Lesser Ward", "Fireball Expert")
+constexpr std::string_view kRankWords[] = {"lesser", "greater", "minor",  "major",  "improved", "superior",
+                                           "rank",   "level",   "lvl",    "tier",   "novice",   "apprentice",
+                                           "adept",  "expert",  "master", "advanced"};
+
+bool IsRankWord(std::string_view word)
+{
+  return std::find(std::begin(kRankWords), std::end(kRankWords), word) != std::end(kRankWords);
+}
+
+bool IsNumber(std::string_view word)
+{
+  return !word.empty() && std::all_of(word.begin(), word.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// i .. xxxix
+bool IsRomanNumeral(std::string_view word)
+{
+  if (word.empty())
+    return false;
+
+  size_t i = 0;
+  while (i < word.size() && i < 3 && word[i] == 'x') {
+    ++i;
+  }
+  std::string_view units = word.substr(i);
+  constexpr std::string_view kUnits[] = {"", "i", "ii", "iii", "iv", "v", "vi", "vii", "viii", "ix"};
+  return std::find(std::begin(kUnits), std::end(kUnits), units) != std::end(kUnits);
+}
+
+// =============================================================================
+// MINHASH / LSH
+// =============================================================================
+
+constexpr size_t kBands        = 8;
+constexpr size_t kRowsPerBand  = 3;
+constexpr size_t kSignatureLen = kBands * kRowsPerBand;
+
+// Near-duplicate names (trigram Jaccard) still need a shared effect to be variants
+constexpr float kNameSimilarityThreshold = 0.7f;
+
+uint64_t Mix(uint64_t x)
+{
+  // splitmix64 finalizer
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+uint64_t HashString(std::string_view text)
+{
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (char c : text) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Sorted, unique character trigram hashes of " name "
+std::vector<uint64_t> GetShingles(const std::string& normalized)
+{
+  std::string padded = " " + normalized + " ";
+  std::vector<uint64_t> shingles;
+  for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+    shingles.push_back(HashString(std::string_view(padded).substr(i, 3)));
+  }
+  std::sort(shingles.begin(), shingles.end());
+  shingles.erase(std::unique(shingles.begin(), shingles.end()), shingles.end());
+  return shingles;
+}
+
+float Jaccard(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+{
+  size_t shared = 0;
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (a[i] > b[j]) {
+      ++j;
+    } else {
+      ++shared;
+      ++i;
+      ++j;
+    }
+  }
+  size_t total = a.size() + b.size() - shared;
+  return total > 0 ? static_cast<float>(shared) / total : 0.0f;
+}
+
+bool ShareEffect(const std::vector<RE::FormID>& a, const std::vector<RE::FormID>& b)
+{
+  for (RE::FormID effect : a) {
+    if (std::find(b.begin(), b.end(), effect) != b.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class UnionFind
+{
+public:
+  explicit UnionFind(size_t count) : m_parent(count)
+  {
+    for (size_t i = 0; i < count; ++i) {
+      m_parent[i] = i;
+    }
+  }
+
+  size_t Find(size_t x)
+  {
+    while (m_parent[x] != x) {
+      m_parent[x] = m_parent[m_parent[x]];
+      x           = m_parent[x];
+    }
+    return x;
+  }
+
+  // The lower index stays root so family ids follow scan order
+  void Union(size_t a, size_t b)
+  {
+    a = Find(a);
+    b = Find(b);
+    if (a != b) {
+      m_parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+private:
+  std::vector<size_t> m_parent;
+};
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+std::string NormalizeName(std::string_view name)
+{
+  // Lowercase words, bracketed suffixes ("(Left Hand)", "[Staff]") dropped
+  std::vector<std::string> words;
+  std::string word;
+  int bracketDepth = 0;
+  for (char c : name) {
+    if (c == '(' || c == '[' || c == '{') {
+      bracketDepth++;
+    } else if ((c == ')' || c == ']' || c == '}') && bracketDepth > 0) {
+      bracketDepth--;
+    } else if (bracketDepth == 0 && std::isalnum(static_cast<unsigned char>(c))) {
+      word.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+      continue;
+    }
+    if (!word.empty()) {
+      words.push_back(std::move(word));
+      word.clear();
+    }
+  }
+  if (!word.empty()) {
+    words.push_back(std::move(word));
+  }
+
+  // Trailing numerals / numbers ("Locust III", "Fireball 2")
+  while (words.size() > 1 && (IsRomanNumeral(words.back()) || IsNumber(words.back()))) {
+    words.pop_back();
+  }
+
+  std::string result;
+  for (const auto& w : words) {
+    if (IsRankWord(w) || IsNumber(w))
+      continue;
+    if (!result.empty()) {
+      result.push_back(' ');
+    }
+    result += w;
+  }
+
+  // Nothing left ("Master", "II") - keep the original words
+  if (result.empty()) {
+    for (const auto& w : words) {
+      if (!result.empty()) {
+        result.push_back(' ');
+      }
+      result += w;
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> BuildFamilies(const std::vector<SpellEntry>& spells)
+{
+  const size_t count = spells.size();
+  std::vector<std::string> normalized(count);
+  for (size_t i = 0; i < count; ++i) {
+    normalized[i] = NormalizeName(spells[i].name);
+  }
+
+  UnionFind families(count);
+
+  // Same normalized name - always one family
+  {
+    std::vector<std::pair<std::string_view, size_t>> byName;
+    byName.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      if (!normalized[i].empty()) {
+        byName.emplace_back(normalized[i], i);
+      }
+    }
+    std::sort(byName.begin(), byName.end());
+    for (size_t i = 1; i < byName.size(); ++i) {
+      if (byName[i].first == byName[i - 1].first) {
+        families.Union(byName[i - 1].second, byName[i].second);
+      }
+    }
+  }
+
+  // Near-identical names - MinHash signatures bucketed per band, candidates verified exactly
+  std::vector<std::vector<uint64_t>> shingles(count);
+  std::vector<std::pair<uint64_t, size_t>> buckets;
+  buckets.reserve(count * kBands);
+
+  for (size_t i = 0; i < count; ++i) {
+    if (normalized[i].empty())
+      continue;
+    shingles[i] = GetShingles(normalized[i]);
+
+    uint64_t signature[kSignatureLen];
+    for (size_t k = 0; k < kSignatureLen; ++k) {
+      signature[k] = UINT64_MAX;
+      for (uint64_t shingle : shingles[i]) {
+        signature[k] = std::min(signature[k], Mix(shingle ^ (k * 0x9E3779B97F4A7C15ull)));
+      }
+    }
+    for (size_t band = 0; band < kBands; ++band) {
+      uint64_t key = Mix(band);
+      for (size_t row = 0; row < kRowsPerBand; ++row) {
+        key = Mix(key ^ signature[band * kRowsPerBand + row]);
+      }
+      buckets.emplace_back(key, i);
+    }
+  }
+  std::sort(buckets.begin(), buckets.end());
+
+  size_t comparisons = 0;
+  for (size_t start = 0; start < buckets.size();) {
+    size_t end = start + 1;
+    while (end < buckets.size() && buckets[end].first == buckets[start].first) {
+      ++end;
+    }
+    // Compare each member with the bucket's first and previous member (union-find covers the rest)
+    for (size_t j = start + 1; j < end; ++j) {
+      for (size_t other : {buckets[start].second, buckets[j - 1].second}) {
+        size_t a = buckets[j].second;
+        if (families.Find(a) == families.Find(other))
+          continue;
+        comparisons++;
+        if (Jaccard(shingles[a], shingles[other]) >= kNameSimilarityThreshold &&
+            ShareEffect(spells[a].effects, spells[other].effects)) {
+          families.Union(a, other);
+        }
+      }
+    }
+    start = end;
+  }
+
+  // Families of one are not families
+  std::vector<size_t> familySize(count, 0);
+  for (size_t i = 0; i < count; ++i) {
+    familySize[families.Find(i)]++;
+  }
+
+  std::vector<std::string> familyIds(count);
+  size_t familyCount = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size_t root = families.Find(i);
+    if (familySize[root] > 1) {
+      familyIds[i] = normalized[root];
+      familyCount += root == i ? 1 : 0;
+    }
+  }
+
+  logger::info("SpellFamilyIndex: {} spells -> {} variant families ({} candidate comparisons)", count, familyCount,
+               comparisons);
+  return familyIds;
+}
+}  // namespace SpellFamilyIndex
@@ -1,153 +1,22 @@
 #include "SpellScanner.h"
 #include "PCH.h"
+#include "Arena.h"
+#include "AsyncFileWriter.h"
+#include "EditorIdFilter.h"
+#include "JsonWriter.h"
+#include "Logging.h"
+#include "ScanCache.h"
+#include "SpellFamilyIndex.h"
 #include "SpellEffectivenessHook.h"
+#include "TextUtils.h"
+#include "ThreadPool.h"
+#include "Trace.h"
 
-namespace SpellScanner
-{
-// =============================================================================
-// UTF-8 SANITIZATION - Fixes invalid characters from Windows-1252 encoded names
-// =============================================================================
-
-/**
- * Sanitize a string to valid UTF-8 by replacing invalid bytes with ASCII equivalents.
- * Windows-1252 characters (0x80-0x9F) are common in mod text and break JSON parsing.
- */
-std::string SanitizeToUTF8_Old(const std::string& input)
-{
-  std::string result;
-  result.reserve(input.size());
-
-  for (unsigned char c : input) {
-    if (c < 0x80) {
-      // ASCII - always valid
-      result += static_cast<char>(c);
-    } else if (c >= 0x80 && c <= 0x9F) {
-      // Windows-1252 control characters - replace with ASCII equivalents
-      switch (c) {
-      case 0x91:
-        result += '\'';
-        break;  // Left single quote
-      case 0x92:
-        result += '\'';
-        break;  // Right single quote
-      case 0x93:
-        result += '"';
-        break;  // Left double quote
-      case 0x94:
-        result += '"';
-        break;  // Right double quote
-      case 0x96:
-        result += '-';
-        break;  // En dash
-      case 0x97:
-        result += '-';
-        break;  // Em dash
-      case 0x85:
-        result += "...";
-        break;  // Ellipsis
-      case 0x99:
-        result += "(TM)";
-        break;  // Trademark
-      default:
-        result += '?';
-        break;  // Unknown - replace with ?
-      }
-    } else {
-      // Extended ASCII (0xA0-0xFF) or valid UTF-8 continuation bytes
-      // These are usually safe, but let's be conservative
-      result += static_cast<char>(c);
-    }
-  }
+#include <charconv>
+#include <set>
 
-  return result;
-}
-
-std::string SanitizeToUTF8(const std::string& input)
+namespace SpellScanner
 {
-  std::string result;
-  result.reserve(input.size());
-
-  size_t i = 0;
-  while (i < input.size()) {
-    unsigned char c = static_cast<unsigned char>(input[i]);
-    if (c < 0x80) {
-      // ASCII
-      result += c;
-      ++i;
-    } else if (c >= 0xC2 && c <= 0xDF && i + 1 < input.size()) {
-      // 2-byte UTF-8
-      unsigned char c2 = static_cast<unsigned char>(input[i + 1]);
-      if (c2 >= 0x80 && c2 <= 0xBF) {
-        result += c;
-        result += c2;
-        i += 2;
-      } else {
-        result += '?';
-        ++i;
-      }
-    } else if (c >= 0xE0 && c <= 0xEF && i + 2 < input.size()) {
-      // 3-byte UTF-8
-      unsigned char c2 = static_cast<unsigned char>(input[i + 1]);
-      unsigned char c3 = static_cast<unsigned char>(input[i + 2]);
-      if (c2 >= 0x80 && c2 <= 0xBF && c3 >= 0x80 && c3 <= 0xBF) {
-        result += c;
-        result += c2;
-        result += c3;
-        i += 3;
-      } else {
-        result += '?';
-        ++i;
-      }
-    } else if (c >= 0xF0 && c <= 0xF4 && i + 3 < input.size()) {
-      // 4-byte UTF-8
-      unsigned char c2 = static_cast<unsigned char>(input[i + 1]);
-      unsigned char c3 = static_cast<unsigned char>(input[i + 2]);
-      unsigned char c4 = static_cast<unsigned char>(input[i + 3]);
-      if (c2 >= 0x80 && c2 <= 0xBF && c3 >= 0x80 && c3 <= 0xBF && c4 >= 0x80 && c4 <= 0xBF) {
-        result += c;
-        result += c2;
-        result += c3;
-        result += c4;
-        i += 4;
-      } else {
-        result += '?';
-        ++i;
-      }
-    } else if (c >= 0x80 && c <= 0x9F) {
-      // Windows-1252 control characters
-      switch (c) {
-      case 0x91:
-      case 0x92:
-        result += '\'';
-        break;
-      case 0x93:
-      case 0x94:
-        result += '"';
-        break;
-      case 0x96:
-      case 0x97:
-        result += '-';
-        break;
-      case 0x85:
-        result += "...";
-        break;
-      case 0x99:
-        result += "(TM)";
-        break;
-      default:
-        result += '?';
-        break;
-      }
-      ++i;
-    } else {
-      // Invalid byte, replace
-      result += '?';
-      ++i;
-    }
-  }
-  return result;
-}
-
 // =============================================================================
 // SYSTEM INSTRUCTIONS (Hidden from user - defines output format)
 // =============================================================================
@@ -245,6 +114,13 @@ ScanConfig ParseScanConfig(const std::string& jsonConfig)
       config.treeRulesPrompt = j["treeRulesPrompt"].get<std::string>();
     }
 
+    if (j.contains("useCache")) {
+      config.useCache = j["useCache"].get<bool>();
+    }
+    if (j.contains("workerThreads")) {
+      config.workerThreads = j["workerThreads"].get<uint32_t>();
+    }
+
     logger::info("SpellScanner: ScanConfig parsed - editorId:{}, treeRulesPrompt length:{}", config.fields.editorId,
                  config.treeRulesPrompt.length());
   } catch (const std::exception& e) {
@@ -391,6 +267,19 @@ std::string GetPluginName(RE::FormID formId)
 // PERSISTENT FORMID FUNCTIONS (Load Order Resilient)
 // =============================================================================
 
+namespace
+{
+// "0x00012FCC" or "00012FCC" - parsed in place, tree validation runs this for every node
+bool ParseHexFormId(std::string_view text, RE::FormID& formId)
+{
+  if (text.starts_with("0x") || text.starts_with("0X")) {
+    text.remove_prefix(2);
+  }
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), formId, 16);
+  return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+}  // namespace
+
 std::string GetPersistentFormId(RE::FormID formId)
 {
   auto* dataHandler = RE::TESDataHandler::GetSingleton();
@@ -424,22 +313,16 @@ RE::FormID ResolvePersistentFormId(const std::string& persistentId)
   // Parse "PluginName.esp|0x123456" format
   auto pipePos = persistentId.find('|');
   if (pipePos == std::string::npos || pipePos == 0) {
-    logger::trace("SpellScanner: Invalid persistent ID format (no pipe): {}", persistentId);
+    SL_LOG_TRACE(Scanner, "SpellScanner: Invalid persistent ID format (no pipe): {}", persistentId);
     return 0;
   }
 
-  std::string pluginName = persistentId.substr(0, pipePos);
-  std::string localIdStr = persistentId.substr(pipePos + 1);
+  std::string_view pluginName = std::string_view(persistentId).substr(0, pipePos);
 
   // Parse local FormID
   uint32_t localFormId = 0;
-  try {
-    if (localIdStr.length() >= 2 && (localIdStr.substr(0, 2) == "0x" || localIdStr.substr(0, 2) == "0X")) {
-      localIdStr = localIdStr.substr(2);
-    }
-    localFormId = std::stoul(localIdStr, nullptr, 16);
-  } catch (const std::exception& e) {
-    logger::warn("SpellScanner: Invalid local FormID in persistent ID: {} ({})", persistentId, e.what());
+  if (!ParseHexFormId(std::string_view(persistentId).substr(pipePos + 1), localFormId)) {
+    logger::warn("SpellScanner: Invalid local FormID in persistent ID: {}", persistentId);
     return 0;
   }
 
@@ -450,7 +333,7 @@ RE::FormID ResolvePersistentFormId(const std::string& persistentId)
 
   const RE::TESFile* plugin = dataHandler->LookupModByName(pluginName);
   if (!plugin) {
-    logger::trace("SpellScanner: Plugin not loaded: {}", pluginName);
+    SL_LOG_TRACE(Scanner, "SpellScanner: Plugin not loaded: {}", pluginName);
     return 0;
   }
 
@@ -476,28 +359,25 @@ bool IsFormIdValid(RE::FormID formId)
 
 bool IsFormIdValid(const std::string& formIdStr)
 {
-  if (formIdStr.empty())
-    return false;
-
   RE::FormID formId = 0;
-  try {
-    std::string cleanId = formIdStr;
-    if (cleanId.length() >= 2 && (cleanId.substr(0, 2) == "0x" || cleanId.substr(0, 2) == "0X")) {
-      cleanId = cleanId.substr(2);
-    }
-    formId = std::stoul(cleanId, nullptr, 16);
-  } catch (...) {
-    return false;
-  }
-
-  return IsFormIdValid(formId);
+  return ParseHexFormId(formIdStr, formId) && IsFormIdValid(formId);
 }
 
 TreeValidationResult ValidateAndFixTree(json& treeData)
 {
+  SL_TRACE_SCOPE("SpellScanner::ValidateAndFixTree");
   TreeValidationResult result;
-  std::set<std::string> missingPluginsSet;
-  std::set<std::string> invalidFormIdsSet;
+
+  // Lookup sets and removal flags only live for this call. Node fields are read in place - no copies
+  // of every formId, child and prerequisite string.
+  Arena arena("ValidateTree");
+  std::pmr::set<std::pmr::string, std::less<>> missingPluginsSet(&arena);
+  std::pmr::set<std::pmr::string, std::less<>> invalidFormIdsSet(&arena);
+
+  auto isInvalidReference = [&invalidFormIdsSet](const json& reference) {
+    return reference.is_string() &&
+           invalidFormIdsSet.contains(std::string_view(reference.get_ref<const std::string&>()));
+  };
 
   if (!treeData.contains("schools")) {
     logger::warn("SpellScanner: Tree has no schools key");
@@ -509,38 +389,38 @@ TreeValidationResult ValidateAndFixTree(json& treeData)
       continue;
     }
 
-    auto& nodes = schoolData["nodes"];
-    std::vector<size_t> nodesToRemove;
+    auto& nodes = schoolData["nodes"].get_ref<json::array_t&>();
+    std::pmr::vector<bool> keepNode(&arena);
+    keepNode.reserve(nodes.size());
 
-    for (size_t i = 0; i < nodes.size(); ++i) {
-      auto& node = nodes[i];
+    for (auto& node : nodes) {
       result.totalNodes++;
 
       if (!node.contains("formId")) {
-        nodesToRemove.push_back(i);
+        keepNode.push_back(false);
         result.invalidNodes++;
         continue;
       }
 
-      std::string formIdStr = node["formId"].get<std::string>();
+      const auto& formIdStr = node["formId"].get_ref<const std::string&>();
       bool isValid          = IsFormIdValid(formIdStr);
 
       if (!isValid && node.contains("persistentId")) {
         // Try to resolve from persistent ID
-        std::string persistentId = node["persistentId"].get<std::string>();
+        const auto& persistentId = node["persistentId"].get_ref<const std::string&>();
         RE::FormID resolvedId    = ResolvePersistentFormId(persistentId);
 
         if (resolvedId != 0 && IsFormIdValid(resolvedId)) {
-          // Update formId with resolved value
+          // Update formId with resolved value (formIdStr refers to the old value until then)
+          logger::info("SpellScanner: Resolved {} -> 0x{:08X} from persistent ID", formIdStr, resolvedId);
           node["formId"] = std::format("0x{:08X}", resolvedId);
           isValid        = true;
           result.resolvedFromPersistent++;
-          logger::info("SpellScanner: Resolved {} -> 0x{:08X} from persistent ID", formIdStr, resolvedId);
         } else {
           // Extract plugin name from persistent ID for error reporting
           auto pipePos = persistentId.find('|');
           if (pipePos != std::string::npos) {
-            missingPluginsSet.insert(persistentId.substr(0, pipePos));
+            missingPluginsSet.emplace(std::string_view(persistentId).substr(0, pipePos));
           }
         }
       }
@@ -548,54 +428,54 @@ TreeValidationResult ValidateAndFixTree(json& treeData)
       if (isValid) {
         result.validNodes++;
       } else {
-        nodesToRemove.push_back(i);
         result.invalidNodes++;
-        invalidFormIdsSet.insert(formIdStr);
+        invalidFormIdsSet.emplace(std::string_view(formIdStr));
         logger::warn("SpellScanner: Invalid FormID in tree: {}", formIdStr);
       }
+      keepNode.push_back(isValid);
     }
 
-    // Remove invalid nodes (reverse order to preserve indices)
-    for (auto it = nodesToRemove.rbegin(); it != nodesToRemove.rend(); ++it) {
-      nodes.erase(nodes.begin() + *it);
+    // Remove invalid nodes in one pass, moving the kept ones forward
+    size_t kept = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (keepNode[i]) {
+        if (kept != i) {
+          nodes[kept] = std::move(nodes[i]);
+        }
+        kept++;
+      }
     }
+    nodes.resize(kept);
 
     // Clean up children/prerequisites that reference removed nodes
-    for (auto& node : nodes) {
-      if (node.contains("children") && node["children"].is_array()) {
-        auto& children = node["children"];
-        children.erase(std::remove_if(children.begin(), children.end(),
-                                      [&invalidFormIdsSet](const json& child) {
-                                        return invalidFormIdsSet.count(child.get<std::string>()) > 0;
-                                      }),
-                       children.end());
-      }
-      if (node.contains("prerequisites") && node["prerequisites"].is_array()) {
-        auto& prereqs = node["prerequisites"];
-        prereqs.erase(std::remove_if(prereqs.begin(), prereqs.end(),
-                                     [&invalidFormIdsSet](const json& prereq) {
-                                       return invalidFormIdsSet.count(prereq.get<std::string>()) > 0;
-                                     }),
-                      prereqs.end());
+    if (!invalidFormIdsSet.empty()) {
+      for (auto& node : nodes) {
+        for (const char* key : {"children", "prerequisites"}) {
+          auto references = node.find(key);
+          if (references != node.end() && references->is_array()) {
+            std::erase_if(references->get_ref<json::array_t&>(), isInvalidReference);
+          }
+        }
       }
     }
 
     // Update root if it was invalid
-    if (schoolData.contains("root")) {
-      std::string rootId = schoolData["root"].get<std::string>();
-      if (invalidFormIdsSet.count(rootId) > 0) {
-        // Find first remaining node as new root
-        if (!nodes.empty() && nodes[0].contains("formId")) {
-          schoolData["root"] = nodes[0]["formId"];
-          logger::info("SpellScanner: Updated {} root to {}", schoolName, nodes[0]["formId"].dump());
-        }
+    if (schoolData.contains("root") && isInvalidReference(schoolData["root"])) {
+      // Find first remaining node as new root
+      if (!nodes.empty() && nodes[0].contains("formId")) {
+        schoolData["root"] = nodes[0]["formId"];
+        logger::info("SpellScanner: Updated {} root to {}", schoolName, nodes[0]["formId"].dump());
       }
     }
   }
 
   // Convert sets to vectors
-  result.missingPlugins.assign(missingPluginsSet.begin(), missingPluginsSet.end());
-  result.invalidFormIds.assign(invalidFormIdsSet.begin(), invalidFormIdsSet.end());
+  for (const auto& plugin : missingPluginsSet) {
+    result.missingPlugins.emplace_back(plugin);
+  }
+  for (const auto& formId : invalidFormIdsSet) {
+    result.invalidFormIds.emplace_back(formId);
+  }
 
   logger::info("SpellScanner: Tree validation complete - {}/{} valid, {} resolved from persistent, {} invalid",
                result.validNodes, result.totalNodes, result.resolvedFromPersistent, result.invalidNodes);
@@ -607,291 +487,387 @@ TreeValidationResult ValidateAndFixTree(json& treeData)
 // SPELL SCANNING
 // =============================================================================
 
-json ScanSpellsToJson(const FieldConfig& fields)
+namespace
 {
-  auto* dataHandler = RE::TESDataHandler::GetSingleton();
-  if (!dataHandler) {
-    logger::error("SpellScanner: Failed to get TESDataHandler");
-    return json::array();
-  }
-
-  const auto& allSpells = dataHandler->GetFormArray<RE::SpellItem>();
-  logger::info("SpellScanner: Found {} total spell forms", allSpells.size());
+// Outcome of evaluating one form during a scan (persisted in the scan cache)
+enum class ScanVerdict : uint8_t
+{
+  kIncluded = 0,
+  kSkipped  = 1,  // Not a spell, missing data, or no magic school
+  kFiltered = 2   // Non-player / broken spell
+};
 
-  json spellArray   = json::array();
-  int scannedCount  = 0;
-  int skippedCount  = 0;
-  int filteredCount = 0;
+// Get school and minimum skill from the first effect
+void GetSchoolAndSkill(RE::SpellItem* spell, RE::ActorValue& school, uint32_t& minimumSkill)
+{
+  school       = RE::ActorValue::kNone;
+  minimumSkill = 0;
 
-  // Helper function to check if editorId indicates a non-player spell
-  auto isNonPlayerSpell = [](const std::string& editorId) -> bool {
-    // Lowercase for comparison
-    std::string lower = editorId;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-
-    // Skip trap spells
-    if (lower.find("trap") != std::string::npos)
-      return true;
-
-    // Skip creature abilities (start with "cr")
-    if (lower.substr(0, 2) == "cr")
-      return true;
-
-    // Skip shrine/altar blessings
-    if (lower.find("altar") != std::string::npos)
-      return true;
-    if (lower.find("shrine") != std::string::npos)
-      return true;
-    if (lower.find("blessing") != std::string::npos && lower.find("spell") != std::string::npos)
-      return true;
-
-    // Skip dungeon-specific spells (usually not learnable)
-    if (lower.substr(0, 3) == "dun")
-      return true;
-
-    // Skip perk-related spells
-    if (lower.substr(0, 4) == "perk")
-      return true;
-
-    // Skip hazard effects
-    if (lower.find("hazard") != std::string::npos)
-      return true;
-
-    // Skip NPC powers
-    if (lower.substr(0, 5) == "power")
-      return true;
-
-    // Skip test spells
-    if (lower.substr(0, 4) == "test")
-      return true;
-
-    // Skip quest-specific spells (MGxx pattern for college quests)
-    if (lower.length() >= 4 && lower.substr(0, 2) == "mg" && std::isdigit(lower[2]) && std::isdigit(lower[3]))
-      return true;
-
-    // Skip specific NPC abilities
-    if (lower.find("mgr") == 0)
-      return true;  // MGR prefix spells
-    if (lower.find("voice") != std::string::npos)
-      return true;  // Dragon shout variants
-    if (lower.find("teleport") != std::string::npos && lower.find("pet") != std::string::npos)
-      return true;
-
-    // Skip hand-specific variants (keep only base spell to avoid duplicates)
-    // e.g., FlamesLeftHand, FlamesRightHand -> keep only Flames
-    if (lower.find("lefthand") != std::string::npos)
-      return true;
-    if (lower.find("righthand") != std::string::npos)
-      return true;
-
-    // Skip _Copy variants
-    if (lower.find("copy") != std::string::npos)
-      return true;
-
-    // Skip DLC-specific reused base game spells (usually have DLC1/DLC2 prefix + same name)
-    // These are often duplicates for DLC NPCs
+  if (spell->effects.size() > 0) {
+    auto* firstEffect = spell->effects[0];
+    if (firstEffect && firstEffect->baseEffect) {
+      school       = firstEffect->baseEffect->GetMagickSkill();
+      minimumSkill = firstEffect->baseEffect->GetMinimumSkillLevel();
+    }
+  }
+}
 
-    return false;
-  };
+// Optional fields, effects and keywords (same format for spell and tome scans)
+void WriteOptionalFields(JsonWriter& writer, RE::SpellItem* spell, const char* editorId, uint32_t minimumSkill,
+                         const FieldConfig& fields)
+{
+  RE::FormID formId = spell->GetFormID();
 
-  for (auto* spell : allSpells) {
-    if (!spell)
-      continue;
+  if (fields.editorId && editorId) {
+    writer.Member("editorId", editorId);
+  }
+  if (fields.magickaCost) {
+    writer.Member("magickaCost", spell->CalculateMagickaCost(nullptr));
+  }
+  if (fields.minimumSkill) {
+    writer.Member("minimumSkill", minimumSkill);
+  }
+  if (fields.castingType) {
+    writer.Member("castingType", GetCastingTypeName(spell->data.castingType));
+  }
+  if (fields.delivery) {
+    writer.Member("delivery", GetDeliveryName(spell->data.delivery));
+  }
+  if (fields.chargeTime) {
+    writer.Member("chargeTime", spell->data.chargeTime);
+  }
+  if (fields.plugin) {
+    writer.Member("plugin", GetPluginName(formId));
+  }
 
-    if (spell->data.spellType != RE::MagicSystem::SpellType::kSpell) {
-      skippedCount++;
-      continue;
-    }
+  // Effects (names/descriptions are sanitized to UTF-8 by the writer)
+  if (fields.effects) {
+    writer.Key("effects").BeginArray();
+    for (auto* effect : spell->effects) {
+      if (!effect || !effect->baseEffect)
+        continue;
 
-    const char* editorId = spell->GetFormEditorID();
-    std::string name     = spell->GetFullName();
-    RE::FormID formId    = spell->GetFormID();
+      writer.BeginObject();
+      writer.Member("name", effect->baseEffect->GetFullName());
+      writer.Member("magnitude", effect->effectItem.magnitude);
+      writer.Member("duration", effect->effectItem.duration);
+      writer.Member("area", effect->effectItem.area);
 
-    if (name.empty() || !editorId || strlen(editorId) == 0) {
-      skippedCount++;
-      continue;
+      const char* description = effect->baseEffect->magicItemDescription.c_str();
+      if (description && strlen(description) > 0) {
+        writer.Member("description", description);
+      }
+      writer.EndObject();
     }
-
-    // Filter out spells where name looks like a FormID (broken/missing data)
-    // These show up as "0x000A26FF" or similar hex strings
-    if (name.length() >= 2 && (name.substr(0, 2) == "0x" || name.substr(0, 2) == "0X")) {
-      logger::info("SpellScanner: Filtering FormID-named spell: {}", name);
-      filteredCount++;
-      continue;
+    writer.EndArray();
+  } else if (fields.effectNames) {
+    writer.Key("effectNames").BeginArray();
+    for (auto* effect : spell->effects) {
+      if (effect && effect->baseEffect) {
+        writer.String(effect->baseEffect->GetFullName());
+      }
     }
+    writer.EndArray();
+  }
 
-    // Also filter if name is all digits/hex (no actual name)
-    bool allHex = true;
-    for (char c : name) {
-      if (!std::isxdigit(static_cast<unsigned char>(c)) && c != ' ') {
-        allHex = false;
-        break;
+  // Keywords
+  if (fields.keywords && spell->keywords) {
+    writer.Key("keywords").BeginArray();
+    for (uint32_t i = 0; i < spell->numKeywords; i++) {
+      if (spell->keywords[i]) {
+        const char* kwEditorId = spell->keywords[i]->GetFormEditorID();
+        if (kwEditorId && strlen(kwEditorId) > 0) {
+          writer.String(kwEditorId);
+        }
       }
     }
-    if (allHex && name.length() >= 6) {
-      logger::info("SpellScanner: Filtering hex-named spell: {}", name);
-      filteredCount++;
-      continue;
-    }
+    writer.EndArray();
+  }
+}
 
-    // Filter out non-player spells based on editorId patterns
-    std::string editorIdStr(editorId);
-    if (isNonPlayerSpell(editorIdStr)) {
-      filteredCount++;
-      continue;
-    }
+// Build the record (compact JSON object) for one spell of the all-spells scan
+ScanVerdict BuildSpellRecord(RE::SpellItem* spell, const FieldConfig& fields, const EditorIdFilter& filter,
+                             std::string& record)
+{
+  if (spell->data.spellType != RE::MagicSystem::SpellType::kSpell) {
+    return ScanVerdict::kSkipped;
+  }
 
-    RE::ActorValue school = RE::ActorValue::kNone;
-    uint32_t minimumSkill = 0;
+  // Checked in place - most forms are skipped or filtered, and nothing is copied for them
+  const char* editorId  = spell->GetFormEditorID();
+  std::string_view name = spell->GetFullName();
+  RE::FormID formId     = spell->GetFormID();
 
-    if (spell->effects.size() > 0) {
-      auto* firstEffect = spell->effects[0];
-      if (firstEffect && firstEffect->baseEffect) {
-        school       = firstEffect->baseEffect->GetMagickSkill();
-        minimumSkill = firstEffect->baseEffect->GetMinimumSkillLevel();
-      }
-    }
+  if (name.empty() || !editorId || editorId[0] == '\0') {
+    return ScanVerdict::kSkipped;
+  }
 
-    if (school == RE::ActorValue::kNone) {
-      skippedCount++;
-      continue;
-    }
+  // Filter out spells where name looks like a FormID (broken/missing data)
+  // These show up as "0x000A26FF" or similar hex strings
+  if (name.starts_with("0x") || name.starts_with("0X")) {
+    logger::info("SpellScanner: Filtering FormID-named spell: {}", name);
+    return ScanVerdict::kFiltered;
+  }
 
-    // Filter out spells with absurdly high magicka costs (usually NPC-only)
-    float magickaCost = spell->CalculateMagickaCost(nullptr);
-    if (magickaCost > 1000.0f) {
-      logger::info("SpellScanner: Filtering high-cost spell: {} ({} magicka)", editorIdStr, magickaCost);
-      filteredCount++;
-      continue;
+  // Also filter if name is all digits/hex (no actual name)
+  bool allHex = true;
+  for (char c : name) {
+    if (!std::isxdigit(static_cast<unsigned char>(c)) && c != ' ') {
+      allHex = false;
+      break;
     }
+  }
+  if (allHex && name.length() >= 6) {
+    logger::info("SpellScanner: Filtering hex-named spell: {}", name);
+    return ScanVerdict::kFiltered;
+  }
 
-    // Filter out spells with no effects or broken effect data
-    bool hasValidEffect = false;
-    for (auto* effect : spell->effects) {
-      if (effect && effect->baseEffect) {
-        std::string effectName = effect->baseEffect->GetFullName();
-        // Check effect has a real name (not empty or FormID-like)
-        if (!effectName.empty() && effectName.length() > 2 && effectName.substr(0, 2) != "0x" &&
-            effectName.substr(0, 2) != "0X") {
-          hasValidEffect = true;
-          break;
-        }
+  // Filter out non-player spells based on editorId rules (spell_filter_rules.json)
+  std::string_view editorIdStr(editorId);
+  if (filter.IsFiltered(editorIdStr)) {
+    return ScanVerdict::kFiltered;
+  }
+
+  RE::ActorValue school;
+  uint32_t minimumSkill;
+  GetSchoolAndSkill(spell, school, minimumSkill);
+
+  if (school == RE::ActorValue::kNone) {
+    return ScanVerdict::kSkipped;
+  }
+
+  // Filter out spells with absurdly high magicka costs (usually NPC-only)
+  float magickaCost = spell->CalculateMagickaCost(nullptr);
+  if (magickaCost > 1000.0f) {
+    logger::info("SpellScanner: Filtering high-cost spell: {} ({} magicka)", editorIdStr, magickaCost);
+    return ScanVerdict::kFiltered;
+  }
+
+  // Filter out spells with no effects or broken effect data
+  bool hasValidEffect = false;
+  for (auto* effect : spell->effects) {
+    if (effect && effect->baseEffect) {
+      std::string_view effectName = effect->baseEffect->GetFullName();
+      // Check effect has a real name (not empty or FormID-like)
+      if (effectName.length() > 2 && !effectName.starts_with("0x") && !effectName.starts_with("0X")) {
+        hasValidEffect = true;
+        break;
       }
     }
-    if (!hasValidEffect) {
-      logger::info("SpellScanner: Filtering spell with no valid effects: {}", name);
-      filteredCount++;
-      continue;
-    }
+  }
+  if (!hasValidEffect) {
+    logger::info("SpellScanner: Filtering spell with no valid effects: {}", name);
+    return ScanVerdict::kFiltered;
+  }
 
-    json spellJson;
+  JsonWriter writer(record);
+  writer.BeginObject();
 
-    // Essential fields (always included)
-    spellJson["formId"]       = std::format("0x{:08X}", formId);
-    spellJson["persistentId"] = GetPersistentFormId(formId);  // Load order resilient ID
-    spellJson["name"]         = SanitizeToUTF8(name);         // Sanitize for valid UTF-8 JSON
-    spellJson["school"]       = GetSchoolName(school);
-    spellJson["skillLevel"]   = GetSkillLevelName(minimumSkill);
+  // Essential fields (always included)
+  writer.Member("formId", std::format("0x{:08X}", formId));
+  writer.Member("persistentId", GetPersistentFormId(formId));  // Load order resilient ID
+  writer.Member("name", name);                                 // Sanitized to valid UTF-8 by the writer
+  writer.Member("school", GetSchoolName(school));
+  writer.Member("skillLevel", GetSkillLevelName(minimumSkill));
 
-    // Optional fields
-    if (fields.editorId) {
-      spellJson["editorId"] = editorId;
-    }
-    if (fields.magickaCost) {
-      spellJson["magickaCost"] = spell->CalculateMagickaCost(nullptr);
-    }
-    if (fields.minimumSkill) {
-      spellJson["minimumSkill"] = minimumSkill;
-    }
-    if (fields.castingType) {
-      spellJson["castingType"] = GetCastingTypeName(spell->data.castingType);
-    }
-    if (fields.delivery) {
-      spellJson["delivery"] = GetDeliveryName(spell->data.delivery);
-    }
-    if (fields.chargeTime) {
-      spellJson["chargeTime"] = spell->data.chargeTime;
-    }
-    if (fields.plugin) {
-      spellJson["plugin"] = GetPluginName(formId);
-    }
+  WriteOptionalFields(writer, spell, editorId, minimumSkill, fields);
+  writer.EndObject();
+  return ScanVerdict::kIncluded;
+}
 
-    // Effects
-    if (fields.effects) {
-      json effectsArray = json::array();
-      for (auto* effect : spell->effects) {
-        if (!effect || !effect->baseEffect)
-          continue;
-
-        json effectJson;
-        effectJson["name"]      = SanitizeToUTF8(effect->baseEffect->GetFullName());
-        effectJson["magnitude"] = effect->effectItem.magnitude;
-        effectJson["duration"]  = effect->effectItem.duration;
-        effectJson["area"]      = effect->effectItem.area;
-
-        const char* description = effect->baseEffect->magicItemDescription.c_str();
-        if (description && strlen(description) > 0) {
-          effectJson["description"] = SanitizeToUTF8(description);
-        }
-        effectsArray.push_back(effectJson);
-      }
-      spellJson["effects"] = effectsArray;
-    } else if (fields.effectNames) {
-      json effectNamesArray = json::array();
-      for (auto* effect : spell->effects) {
-        if (effect && effect->baseEffect) {
-          effectNamesArray.push_back(SanitizeToUTF8(effect->baseEffect->GetFullName()));
-        }
+// Build the record (compact JSON object) for one spell tome of the tome scan
+ScanVerdict BuildTomeRecord(RE::TESObjectBOOK* book, RE::SpellItem* spell, const FieldConfig& fields,
+                            std::string& record)
+{
+  const char* spellEditorId  = spell->GetFormEditorID();
+  std::string_view spellName = spell->GetFullName();
+  RE::FormID spellFormId     = spell->GetFormID();
+
+  if (spellName.empty())
+    return ScanVerdict::kSkipped;
+
+  RE::ActorValue school;
+  uint32_t minimumSkill;
+  GetSchoolAndSkill(spell, school, minimumSkill);
+
+  // Skip non-magic spells
+  if (school == RE::ActorValue::kNone)
+    return ScanVerdict::kSkipped;
+
+  JsonWriter writer(record);
+  writer.BeginObject();
+
+  // Essential fields (always included)
+  writer.Member("formId", std::format("0x{:08X}", spellFormId));
+  writer.Member("persistentId", GetPersistentFormId(spellFormId));  // Load order resilient ID
+  writer.Member("name", spellName);                                 // Sanitized to valid UTF-8 by the writer
+  writer.Member("school", GetSchoolName(school));
+  writer.Member("skillLevel", GetSkillLevelName(minimumSkill));
+
+  // Also include tome info for reference (mods like DynDOLOD can have invalid UTF-8 in book names)
+  writer.Member("tomeFormId", std::format("0x{:08X}", book->GetFormID()));
+  writer.Member("tomeName", book->GetFullName());
+
+  WriteOptionalFields(writer, spell, spellEditorId, minimumSkill, fields);
+  writer.EndObject();
+  return ScanVerdict::kIncluded;
+}
+
+// Plugins a record depends on: the spell, its magic effects and (for tomes) the book
+std::vector<std::string> GetRecordSources(RE::SpellItem* spell, RE::TESObjectBOOK* book = nullptr)
+{
+  std::vector<std::string> sources = ScanCache::GetFormSourceFiles(spell);
+
+  auto addUnique = [&sources](const RE::TESForm* form) {
+    for (auto& name : ScanCache::GetFormSourceFiles(form)) {
+      if (std::find(sources.begin(), sources.end(), name) == sources.end()) {
+        sources.push_back(std::move(name));
       }
-      spellJson["effectNames"] = effectNamesArray;
     }
+  };
 
-    // Keywords
-    if (fields.keywords && spell->keywords) {
-      json keywordsArray = json::array();
-      for (uint32_t i = 0; i < spell->numKeywords; i++) {
-        if (spell->keywords[i]) {
-          const char* kwEditorId = spell->keywords[i]->GetFormEditorID();
-          if (kwEditorId && strlen(kwEditorId) > 0) {
-            keywordsArray.push_back(kwEditorId);
-          }
-        }
-      }
-      spellJson["keywords"] = keywordsArray;
+  for (auto* effect : spell->effects) {
+    if (effect && effect->baseEffect) {
+      addUnique(effect->baseEffect);
     }
+  }
+  if (book) {
+    addUnique(book);
+  }
+  return sources;
+}
+
+// Cache key - cached records are only valid for the same set of output fields
+// (the spell cache also stores the editor ID filter rules hash next to it)
+uint32_t GetFieldConfigKey(const FieldConfig& fields)
+{
+  uint32_t key = 0;
+  key |= fields.editorId ? (1u << 0) : 0;
+  key |= fields.magickaCost ? (1u << 1) : 0;
+  key |= fields.minimumSkill ? (1u << 2) : 0;
+  key |= fields.castingType ? (1u << 3) : 0;
+  key |= fields.delivery ? (1u << 4) : 0;
+  key |= fields.chargeTime ? (1u << 5) : 0;
+  key |= fields.plugin ? (1u << 6) : 0;
+  key |= fields.effects ? (1u << 7) : 0;
+  key |= fields.effectNames ? (1u << 8) : 0;
+  key |= fields.keywords ? (1u << 9) : 0;
+  return key;
+}
+
+// Number of threads scanning at once (0 = every pool worker plus the calling thread)
+uint32_t ResolveWorkerCount(uint32_t requested, size_t workItems)
+{
+  // Not worth splitting a handful of forms
+  constexpr size_t kMinFormsPerThread = 256;
 
-    spellArray.push_back(spellJson);
-    scannedCount++;
+  uint32_t threads =
+      requested > 0 ? requested : static_cast<uint32_t>(ThreadPool::GetSingleton()->GetWorkerCount() + 1);
+  size_t maxUseful = std::max<size_t>(1, workItems / kMinFormsPerThread);
+  return static_cast<uint32_t>(std::min<size_t>(threads, maxUseful));
+}
+
+// Split [0, count) into chunks and run fn(buffer, begin, end) for each one on up to `threads` pool threads.
+// Chunks are claimed dynamically for load balancing, but every chunk owns its output buffer and the
+// buffers are returned in chunk order, so merging them does not depend on scheduling.
+template <class Chunk, class Fn>
+std::vector<Chunk> ParallelChunks(size_t count, uint32_t threads, Fn&& fn)
+{
+  constexpr size_t kMinChunkSize = 64;
+
+  size_t chunkSize  = std::max(kMinChunkSize, (count + threads * 8 - 1) / (threads * 8));
+  size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+  std::vector<Chunk> buffers(chunkCount);
+  ThreadPool::GetSingleton()->ParallelFor(chunkCount, threads, [&](size_t chunk) {
+    SL_TRACE_SCOPE("SpellScanner::ScanChunk");
+    size_t begin = chunk * chunkSize;
+    fn(buffers[chunk], begin, std::min(begin + chunkSize, count));
+  });
+  return buffers;
+}
+
+// Build one cache entry, reusing the previous scan's record when its source plugins are unchanged
+template <class BuildFn>
+ScanCache::CachedForm ResolveEntry(RE::FormID key, std::vector<std::string> sources, const ScanCache::Cache* previous,
+                                   const std::unordered_set<std::string>& changedPlugins, bool& reused, BuildFn&& build)
+{
+  ScanCache::CachedForm entry;
+  const auto* cached = previous ? previous->FindReusable(key, sources, changedPlugins) : nullptr;
+  if (cached) {
+    entry  = *cached;
+    reused = true;
+    return entry;
   }
 
-  logger::info("SpellScanner: Scanned {} player spells, skipped {} (non-spell), filtered {} (non-player)", scannedCount,
-               skippedCount, filteredCount);
-  return spellArray;
+  reused = false;
+  try {
+    entry.verdict = static_cast<uint8_t>(build(entry.record));
+  } catch (const std::exception& e) {
+    logger::warn("SpellScanner: Failed to scan form 0x{:08X}: {}", key, e.what());
+    entry.verdict = static_cast<uint8_t>(ScanVerdict::kSkipped);
+    entry.record.clear();
+  }
+  entry.sources = std::move(sources);
+  return entry;
 }
 
-// =============================================================================
-// MAIN SCAN FUNCTIONS
-// =============================================================================
+// Per-chunk output of a parallel scan (merged in chunk order)
+struct ScanChunk
+{
+  std::vector<std::pair<RE::FormID, ScanCache::CachedForm>> entries;
+  int reused = 0;
+};
 
-std::string ScanAllSpells(const ScanConfig& config)
+void LogScanThroughput(const char* what, size_t rebuilt, uint32_t threads, size_t chunks,
+                       std::chrono::steady_clock::time_point start)
 {
-  logger::info("SpellScanner: Starting spell scan with ScanConfig...");
+  auto elapsedUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  double perSecond = elapsedUs > 0 ? static_cast<double>(rebuilt) * 1000000.0 / static_cast<double>(elapsedUs) : 0.0;
+  logger::info("SpellScanner: Built {} {} on {} threads ({} chunks) in {:.1f} ms - {:.0f} forms/sec", rebuilt, what,
+               threads, chunks, elapsedUs / 1000.0, perSecond);
+}
+
+// Variant families over the scanned spells, from the live forms (tome scans resolve the taught spell)
+void AssignSpellFamilies(ScanResult& result)
+{
+  std::vector<SpellFamilyIndex::SpellEntry> entries(result.formIds.size());
+  for (size_t i = 0; i < result.formIds.size(); ++i) {
+    auto* form           = RE::TESForm::LookupByID(result.formIds[i]);
+    RE::SpellItem* spell = form ? form->As<RE::SpellItem>() : nullptr;
+    if (!spell && form) {
+      if (auto* book = form->As<RE::TESObjectBOOK>()) {
+        spell = book->GetSpell();
+      }
+    }
+    if (!spell)
+      continue;
 
-  json spellArray = ScanSpellsToJson(config.fields);
+    const char* name = spell->GetFullName();
+    entries[i].name  = name ? name : "";
+    for (auto* effect : spell->effects) {
+      if (effect && effect->baseEffect) {
+        entries[i].effects.push_back(effect->baseEffect->GetFormID());
+      }
+    }
+  }
+  result.familyIds = SpellFamilyIndex::BuildFamilies(entries);
+}
 
-  // Build timestamp
+// Scan timestamp in ISO 8601 (UTC)
+std::string GetScanTimestamp()
+{
   auto now  = std::chrono::system_clock::now();
   auto time = std::chrono::system_clock::to_time_t(now);
   std::stringstream ss;
   ss << std::put_time(std::gmtime(&time), "%Y-%m-%dT%H:%M:%SZ");
+  return ss.str();
+}
 
-  // Build output JSON
-  json output;
-  output["scanTimestamp"] = ss.str();
-  output["spellCount"]    = spellArray.size();
-  output["spells"]        = spellArray;
-
-  // Combine prompts: User's tree rules + System instructions + Spell data
+// Combine prompts: User's tree rules + System instructions
+std::string BuildCombinedPrompt(const ScanConfig& config)
+{
   std::string combinedPrompt;
 
   // Add user's tree rules prompt (visible/editable)
@@ -903,205 +879,333 @@ std::string ScanAllSpells(const ScanConfig& config)
 
   // Add system instructions (hidden from user)
   combinedPrompt += GetSystemInstructions();
-  output["llmPrompt"] = SanitizeToUTF8(combinedPrompt);
-
-  return output.dump(2);
+  return combinedPrompt;  // Sanitized by JsonWriter
 }
+}  // namespace
 
-std::string ScanAllSpells(const FieldConfig& config)
+ScanResult ScanSpellRecords(const ScanConfig& config)
 {
-  // Legacy function - create ScanConfig with empty tree rules
-  ScanConfig scanConfig;
-  scanConfig.fields          = config;
-  scanConfig.treeRulesPrompt = "";
+  SL_TRACE_SCOPE("SpellScanner::ScanSpellRecords");
+  ScanResult result;
 
-  return ScanAllSpells(scanConfig);
+  auto* dataHandler = RE::TESDataHandler::GetSingleton();
+  if (!dataHandler) {
+    logger::error("SpellScanner: Failed to get TESDataHandler");
+    return result;
+  }
+
+  const auto& allSpells = dataHandler->GetFormArray<RE::SpellItem>();
+  logger::info("SpellScanner: Found {} total spell forms", allSpells.size());
+
+  const auto startTime      = std::chrono::steady_clock::now();
+  const FieldConfig& fields = config.fields;
+  const auto filter         = EditorIdFilter::LoadFromFile(EditorIdFilter::GetRulesPath());
+  const uint32_t cacheKey   = GetFieldConfigKey(fields);
+  const uint64_t rulesHash  = filter.GetRulesHash();
+  auto fingerprint          = ScanCache::BuildLoadOrderFingerprint();
+
+  ScanCache::Cache previous;
+  bool cacheLoaded = config.useCache && previous.Load(ScanCache::GetSpellCachePath(), cacheKey, rulesHash);
+
+  int scannedCount  = 0;
+  int skippedCount  = 0;
+  int filteredCount = 0;
+
+  auto tally = [&](RE::FormID formId, const ScanCache::CachedForm& entry) {
+    switch (static_cast<ScanVerdict>(entry.verdict)) {
+    case ScanVerdict::kIncluded:
+      result.records.push_back(entry.record);
+      result.formIds.push_back(formId);
+      scannedCount++;
+      break;
+    case ScanVerdict::kFiltered:
+      filteredCount++;
+      break;
+    default:
+      skippedCount++;
+      break;
+    }
+  };
+
+  // Same load order as last time - serve the cached result without touching any forms
+  if (cacheLoaded && previous.Matches(fingerprint)) {
+    for (RE::FormID formId : previous.GetOrder()) {
+      tally(formId, *previous.Find(formId));
+    }
+    AssignSpellFamilies(result);
+
+    auto elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    logger::info("SpellScanner: Load order unchanged - served {} spells from scan cache in {} ms", scannedCount,
+                 elapsedMs);
+    return result;
+  }
+
+  std::unordered_set<std::string> changedPlugins;
+  if (cacheLoaded) {
+    changedPlugins = previous.GetChangedPlugins(fingerprint);
+    logger::info("SpellScanner: {} plugins changed since last scan - rescanning their forms", changedPlugins.size());
+  }
+
+  // Form data is read-only after kDataLoaded, so records can be built on worker threads.
+  // Each chunk fills its own buffer; buffers are merged in chunk order to keep the output in form order.
+  const size_t formCount = allSpells.size();
+  const uint32_t threads = ResolveWorkerCount(config.workerThreads, formCount);
+  const auto buildStart  = std::chrono::steady_clock::now();
+
+  auto chunks = ParallelChunks<ScanChunk>(formCount, threads, [&](ScanChunk& out, size_t begin, size_t end) {
+    out.entries.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      auto* spell = allSpells[static_cast<uint32_t>(i)];
+      if (!spell)
+        continue;
+
+      auto build = [&](std::string& record) { return BuildSpellRecord(spell, fields, filter, record); };
+
+      bool reused       = false;
+      RE::FormID formId = spell->GetFormID();
+      auto entry        = ResolveEntry(formId, GetRecordSources(spell), cacheLoaded ? &previous : nullptr,
+                                       changedPlugins, reused, build);
+      out.reused += reused ? 1 : 0;
+      out.entries.emplace_back(formId, std::move(entry));
+    }
+  });
+
+  ScanCache::Cache updated;
+  int reusedCount = 0;
+
+  for (auto& chunk : chunks) {
+    reusedCount += chunk.reused;
+    for (auto& [formId, entry] : chunk.entries) {
+      tally(formId, entry);
+      updated.Store(formId, std::move(entry));
+    }
+  }
+
+  LogScanThroughput("spell records", updated.Size() - reusedCount, threads, chunks.size(), buildStart);
+
+  updated.Save(ScanCache::GetSpellCachePath(), cacheKey, rulesHash, fingerprint);
+  AssignSpellFamilies(result);
+
+  auto elapsedMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+  logger::info("SpellScanner: Scanned {} player spells, skipped {} (non-spell), filtered {} (non-player) in {} ms "
+               "({} forms reused from cache)",
+               scannedCount, skippedCount, filteredCount, elapsedMs, reusedCount);
+  return result;
 }
 
 // =============================================================================
 // SCAN SPELL TOMES (Avoids duplicates - only learnable spells)
 // =============================================================================
 
-std::string ScanSpellTomes(const ScanConfig& config)
+ScanResult ScanSpellTomeRecords(const ScanConfig& config)
 {
+  SL_TRACE_SCOPE("SpellScanner::ScanSpellTomeRecords");
   logger::info("SpellScanner: Starting spell TOME scan...");
 
+  ScanResult result;
+  result.scanMode = "spell_tomes";
+
   auto* dataHandler = RE::TESDataHandler::GetSingleton();
   if (!dataHandler) {
     logger::error("SpellScanner: Failed to get TESDataHandler");
-    return "{}";
+    return result;
   }
 
   const auto& allBooks = dataHandler->GetFormArray<RE::TESObjectBOOK>();
   logger::info("SpellScanner: Found {} total book forms", allBooks.size());
 
-  json spellArray = json::array();
-  std::set<RE::FormID> seenSpellIds;  // Track unique spells
-  int tomeCount             = 0;
-  int skippedDuplicates     = 0;
+  const auto startTime      = std::chrono::steady_clock::now();
   const FieldConfig& fields = config.fields;
+  const uint32_t cacheKey   = GetFieldConfigKey(fields);
+  auto fingerprint          = ScanCache::BuildLoadOrderFingerprint();
 
-  for (auto* book : allBooks) {
-    if (!book)
-      continue;
+  ScanCache::Cache previous;
+  bool cacheLoaded  = config.useCache && previous.Load(ScanCache::GetTomeCachePath(), cacheKey, 0);  // Tomes: no filter
+  bool fullCacheHit = cacheLoaded && previous.Matches(fingerprint);
 
-    // Check if this book teaches a spell
-    if (!book->TeachesSpell())
-      continue;
-
-    RE::SpellItem* spell = book->GetSpell();
-    if (!spell)
-      continue;
+  std::unordered_set<std::string> changedPlugins;
+  if (cacheLoaded && !fullCacheHit) {
+    changedPlugins = previous.GetChangedPlugins(fingerprint);
+  }
 
-    // Skip if we've already seen this spell
-    RE::FormID spellFormId = spell->GetFormID();
-    if (seenSpellIds.count(spellFormId) > 0) {
-      skippedDuplicates++;
-      continue;
+  std::set<RE::FormID> seenSpellIds;  // Track unique spells
+  int skippedDuplicates = 0;
+  int reusedCount       = 0;
+
+  if (fullCacheHit) {
+    // Same load order as last time - replay cached tomes in their original order
+    for (RE::FormID bookId : previous.GetOrder()) {
+      const auto* entry = previous.Find(bookId);
+      if (static_cast<ScanVerdict>(entry->verdict) == ScanVerdict::kIncluded) {
+        result.records.push_back(entry->record);
+        result.formIds.push_back(bookId);
+      }
     }
-    seenSpellIds.insert(spellFormId);
+    reusedCount = static_cast<int>(result.records.size());
+  } else {
+    // Dedup pass stays sequential - the first tome that teaches a spell wins
+    std::vector<std::pair<RE::TESObjectBOOK*, RE::SpellItem*>> tomes;
 
-    // Get spell info
-    const char* spellEditorId = spell->GetFormEditorID();
-    std::string spellName     = spell->GetFullName();
+    for (auto* book : allBooks) {
+      if (!book)
+        continue;
 
-    if (spellName.empty())
-      continue;
+      // Check if this book teaches a spell
+      if (!book->TeachesSpell())
+        continue;
 
-    // Get school from first effect
-    RE::ActorValue school = RE::ActorValue::kNone;
-    uint32_t minimumSkill = 0;
+      RE::SpellItem* spell = book->GetSpell();
+      if (!spell)
+        continue;
 
-    if (spell->effects.size() > 0) {
-      auto* firstEffect = spell->effects[0];
-      if (firstEffect && firstEffect->baseEffect) {
-        school       = firstEffect->baseEffect->GetMagickSkill();
-        minimumSkill = firstEffect->baseEffect->GetMinimumSkillLevel();
+      // Skip if we've already seen this spell
+      RE::FormID spellFormId = spell->GetFormID();
+      if (seenSpellIds.count(spellFormId) > 0) {
+        skippedDuplicates++;
+        continue;
       }
+      seenSpellIds.insert(spellFormId);
+      tomes.emplace_back(book, spell);
     }
 
-    // Skip non-magic spells
-    if (school == RE::ActorValue::kNone)
-      continue;
+    // Build records on worker threads, merged back in tome order
+    const uint32_t threads = ResolveWorkerCount(config.workerThreads, tomes.size());
+    const auto buildStart  = std::chrono::steady_clock::now();
+
+    auto chunks = ParallelChunks<ScanChunk>(tomes.size(), threads, [&](ScanChunk& out, size_t begin, size_t end) {
+      out.entries.reserve(end - begin);
+      for (size_t i = begin; i < end; ++i) {
+        auto [book, spell] = tomes[i];
+        auto build         = [&](std::string& record) { return BuildTomeRecord(book, spell, fields, record); };
+
+        bool reused       = false;
+        RE::FormID bookId = book->GetFormID();
+        auto entry        = ResolveEntry(bookId, GetRecordSources(spell, book), cacheLoaded ? &previous : nullptr,
+                                         changedPlugins, reused, build);
+        out.reused += reused ? 1 : 0;
+        out.entries.emplace_back(bookId, std::move(entry));
+      }
+    });
 
-    // Build spell JSON (same format as ScanSpellsToJson)
-    json spellJson;
+    ScanCache::Cache updated;
 
-    // Essential fields (always included)
-    spellJson["formId"]       = std::format("0x{:08X}", spellFormId);
-    spellJson["persistentId"] = GetPersistentFormId(spellFormId);  // Load order resilient ID
-    spellJson["name"]         = SanitizeToUTF8(spellName);         // Sanitize for valid UTF-8 JSON
-    spellJson["school"]       = GetSchoolName(school);
-    spellJson["skillLevel"]   = GetSkillLevelName(minimumSkill);
+    for (auto& chunk : chunks) {
+      reusedCount += chunk.reused;
+      for (auto& [bookId, entry] : chunk.entries) {
+        if (static_cast<ScanVerdict>(entry.verdict) == ScanVerdict::kIncluded) {
+          result.records.push_back(entry.record);
+          result.formIds.push_back(bookId);
+        }
+        updated.Store(bookId, std::move(entry));
+      }
+    }
 
-    // Also include tome info for reference (sanitize - mods like DynDOLOD can have invalid UTF-8 in book names)
-    spellJson["tomeFormId"] = std::format("0x{:08X}", book->GetFormID());
-    spellJson["tomeName"]   = SanitizeToUTF8(book->GetFullName());
+    LogScanThroughput("tome records", updated.Size() - reusedCount, threads, chunks.size(), buildStart);
+    updated.Save(ScanCache::GetTomeCachePath(), cacheKey, 0, fingerprint);
+  }
 
-    // Optional fields
-    if (fields.editorId && spellEditorId) {
-      spellJson["editorId"] = spellEditorId;
-    }
-    if (fields.magickaCost) {
-      spellJson["magickaCost"] = spell->CalculateMagickaCost(nullptr);
-    }
-    if (fields.minimumSkill) {
-      spellJson["minimumSkill"] = minimumSkill;
-    }
-    if (fields.castingType) {
-      spellJson["castingType"] = GetCastingTypeName(spell->data.castingType);
-    }
-    if (fields.delivery) {
-      spellJson["delivery"] = GetDeliveryName(spell->data.delivery);
-    }
-    if (fields.chargeTime) {
-      spellJson["chargeTime"] = spell->data.chargeTime;
-    }
-    if (fields.plugin) {
-      spellJson["plugin"] = GetPluginName(spellFormId);
-    }
+  AssignSpellFamilies(result);
 
-    // Effects
-    if (fields.effects) {
-      json effectsArray = json::array();
-      for (auto* effect : spell->effects) {
-        if (!effect || !effect->baseEffect)
-          continue;
-
-        json effectJson;
-        effectJson["name"]      = SanitizeToUTF8(effect->baseEffect->GetFullName());
-        effectJson["magnitude"] = effect->effectItem.magnitude;
-        effectJson["duration"]  = effect->effectItem.duration;
-        effectJson["area"]      = effect->effectItem.area;
-
-        const char* description = effect->baseEffect->magicItemDescription.c_str();
-        if (description && strlen(description) > 0) {
-          effectJson["description"] = SanitizeToUTF8(description);
-        }
-        effectsArray.push_back(effectJson);
-      }
-      spellJson["effects"] = effectsArray;
-    } else if (fields.effectNames) {
-      json effectNamesArray = json::array();
-      for (auto* effect : spell->effects) {
-        if (effect && effect->baseEffect) {
-          effectNamesArray.push_back(SanitizeToUTF8(effect->baseEffect->GetFullName()));
-        }
-      }
-      spellJson["effectNames"] = effectNamesArray;
+  auto elapsedMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+  logger::info("SpellScanner: Found {} unique spells from tomes, skipped {} duplicates in {} ms ({} reused from cache)",
+               result.records.size(), skippedDuplicates, elapsedMs, reusedCount);
+  return result;
+}
+
+// =============================================================================
+// SCAN OUTPUT
+// =============================================================================
+
+void WriteScanOutput(JsonWriter& writer, const ScanResult& result, const ScanConfig& config)
+{
+  SL_TRACE_SCOPE("SpellScanner::WriteScanOutput");
+  writer.BeginObject();
+  writer.Member("scanTimestamp", GetScanTimestamp());
+  if (!result.scanMode.empty()) {
+    writer.Member("scanMode", result.scanMode);
+  }
+  writer.Member("spellCount", static_cast<uint64_t>(result.records.size()));
+
+  // Records are already serialized - copied straight into the output (one per line when pretty).
+  // Variant family ids are computed after the scan, so they are appended to the record.
+  writer.Key("spells").BeginArray();
+  for (size_t i = 0; i < result.records.size(); ++i) {
+    if (i < result.familyIds.size() && !result.familyIds[i].empty()) {
+      writer.BeginRawObject(result.records[i]).Member("familyId", result.familyIds[i]).EndObject();
+    } else {
+      writer.RawValue(result.records[i]);
     }
+  }
+  writer.EndArray();
 
-    // Keywords
-    if (fields.keywords && spell->keywords) {
-      json keywordsArray = json::array();
-      for (uint32_t i = 0; i < spell->numKeywords; i++) {
-        if (spell->keywords[i]) {
-          const char* kwEditorId = spell->keywords[i]->GetFormEditorID();
-          if (kwEditorId && strlen(kwEditorId) > 0) {
-            keywordsArray.push_back(kwEditorId);
-          }
-        }
-      }
-      spellJson["keywords"] = keywordsArray;
+  writer.Member("llmPrompt", BuildCombinedPrompt(config));
+  writer.EndObject();
+}
+
+bool SaveScanOutput(const ScanResult& result, const ScanConfig& config, const std::filesystem::path& path)
+{
+  try {
+    std::string content;
+    {
+      JsonWriter writer(content, true);
+      WriteScanOutput(writer, result, config);
+      writer.Flush();
     }
 
-    spellArray.push_back(spellJson);
-    tomeCount++;
+    logger::info("SpellScanner: Writing {} ({} bytes)", path.filename().string(), content.size());
+    AsyncFileWriter::GetSingleton()->Write(path, std::move(content));
+    return true;
+  } catch (const std::exception& e) {
+    logger::error("SpellScanner: Exception while writing {}: {}", path.string(), e.what());
+    return false;
   }
+}
 
-  logger::info("SpellScanner: Found {} unique spells from tomes, skipped {} duplicates", tomeCount, skippedDuplicates);
+std::filesystem::path GetScanOutputPath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/spell_scan_output.json";
+}
 
-  // Build timestamp
-  auto now  = std::chrono::system_clock::now();
-  auto time = std::chrono::system_clock::to_time_t(now);
-  std::stringstream ss;
-  ss << std::put_time(std::gmtime(&time), "%Y-%m-%dT%H:%M:%SZ");
+// =============================================================================
+// MAIN SCAN FUNCTIONS
+// =============================================================================
 
-  // Build output JSON
-  json output;
-  output["scanTimestamp"] = ss.str();
-  output["scanMode"]      = "spell_tomes";
-  output["spellCount"]    = spellArray.size();
-  output["spells"]        = spellArray;
+std::string ScanAllSpells(const ScanConfig& config)
+{
+  logger::info("SpellScanner: Starting spell scan with ScanConfig...");
 
-  // Combine prompts
-  std::string combinedPrompt;
-  if (!config.treeRulesPrompt.empty()) {
-    combinedPrompt += "## TREE CREATION RULES\n\n";
-    combinedPrompt += config.treeRulesPrompt;
-    combinedPrompt += "\n\n";
-  }
-  combinedPrompt += GetSystemInstructions();
-  output["llmPrompt"] = SanitizeToUTF8(combinedPrompt);
+  std::string output;
+  JsonWriter writer(output);
+  WriteScanOutput(writer, ScanSpellRecords(config), config);
+  return output;
+}
+
+std::string ScanAllSpells(const FieldConfig& config)
+{
+  // Legacy function - create ScanConfig with empty tree rules
+  ScanConfig scanConfig;
+  scanConfig.fields          = config;
+  scanConfig.treeRulesPrompt = "";
+
+  return ScanAllSpells(scanConfig);
+}
 
-  return output.dump(2);
+std::string ScanSpellTomes(const ScanConfig& config)
+{
+  std::string output;
+  JsonWriter writer(output);
+  WriteScanOutput(writer, ScanSpellTomeRecords(config), config);
+  return output;
 }
 
 // =============================================================================
 // GET SPELL INFO BY FORMID (For Tree Viewer)
 // =============================================================================
 
-std::string GetSpellInfoByFormId(const std::string& formIdStr)
+json GetSpellInfo(const std::string& formIdStr)
 {
   // Parse formId from hex string (e.g., "0x00012FCC" or "00012FCC")
   RE::FormID formId = 0;
@@ -1121,33 +1225,33 @@ std::string GetSpellInfoByFormId(const std::string& formIdStr)
     for (char c : cleanId) {
       if (!std::isxdigit(static_cast<unsigned char>(c))) {
         logger::error("SpellScanner: Invalid hex character in formId: {}", formIdStr);
-        return "";
+        return nullptr;
       }
     }
 
     formId = std::stoul(cleanId, nullptr, 16);
   } catch (const std::exception& e) {
     logger::error("SpellScanner: Invalid formId format: {} ({})", formIdStr, e.what());
-    return "";
+    return nullptr;
   }
 
   // Look up the spell form
   auto* form = RE::TESForm::LookupByID(formId);
   if (!form) {
     logger::warn("SpellScanner: Form not found for ID: {} (parsed: 0x{:08X})", formIdStr, formId);
-    return "";
+    return nullptr;
   }
 
   auto* spell = form->As<RE::SpellItem>();
   if (!spell) {
     logger::warn("SpellScanner: Form {} is not a spell", formIdStr);
-    return "";
+    return nullptr;
   }
 
   // Build spell info JSON
   json spellInfo;
   spellInfo["formId"] = formIdStr;
-  spellInfo["name"]   = SanitizeToUTF8(spell->GetFullName());  // Sanitize for valid UTF-8 JSON
+  spellInfo["name"]   = TextUtils::SanitizeToUTF8(spell->GetFullName());  // Sanitize for valid UTF-8 JSON
 
   const char* editorId  = spell->GetFormEditorID();
   spellInfo["editorId"] = editorId ? editorId : "";
@@ -1191,7 +1295,7 @@ std::string GetSpellInfoByFormId(const std::string& formIdStr)
     if (!effect || !effect->baseEffect)
       continue;
 
-    std::string effectName = SanitizeToUTF8(effect->baseEffect->GetFullName());
+    std::string effectName = TextUtils::SanitizeToUTF8(effect->baseEffect->GetFullName());
     effectNamesArray.push_back(effectName);
 
     json effectJson;
@@ -1202,7 +1306,7 @@ std::string GetSpellInfoByFormId(const std::string& formIdStr)
 
     const char* desc = effect->baseEffect->magicItemDescription.c_str();
     if (desc && strlen(desc) > 0) {
-      std::string descSanitized = SanitizeToUTF8(desc);
+      std::string descSanitized = TextUtils::SanitizeToUTF8(desc);
       effectJson["description"] = descSanitized;
       if (description.empty()) {
         description = descSanitized;  // Use first effect's description as spell description
@@ -1229,7 +1333,7 @@ std::string GetSpellInfoByFormId(const std::string& formIdStr)
         continue;
 
       json scaledEffect;
-      scaledEffect["name"]              = SanitizeToUTF8(effect->baseEffect->GetFullName());
+      scaledEffect["name"]              = TextUtils::SanitizeToUTF8(effect->baseEffect->GetFullName());
       scaledEffect["originalMagnitude"] = effect->effectItem.magnitude;
       scaledEffect["scaledMagnitude"]   = static_cast<int>(effect->effectItem.magnitude * effectiveness);
       scaledEffect["duration"]          = effect->effectItem.duration;
@@ -1241,6 +1345,12 @@ std::string GetSpellInfoByFormId(const std::string& formIdStr)
     spellInfo["effectiveness"] = 100;
   }
 
-  return spellInfo.dump();
+  return spellInfo;
+}
+
+std::string GetSpellInfoByFormId(const std::string& formIdStr)
+{
+  json spellInfo = GetSpellInfo(formIdStr);
+  return spellInfo.is_null() ? "" : spellInfo.dump();
 }
 }  // namespace SpellScanner
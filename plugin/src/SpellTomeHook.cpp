@@ -1,6 +1,9 @@
 #include "SpellTomeHook.h"
+#include "HookStats.h"
+#include "Logging.h"
 #include "ProgressionManager.h"
 #include "SpellEffectivenessHook.h"
+#include "SpellScanner.h"
 #include "UIManager.h"
 
 // Xbyak for assembly code generation
@@ -50,6 +53,7 @@ SpellTomeHook *SpellTomeHook::GetSingleton() {
 
 void SpellTomeHook::OnSpellTomeRead(RE::TESObjectBOOK *a_book,
                                     RE::SpellItem *a_spell) {
+  SL_HOOK_TIMER(SpellTomeRead);
   auto *hook = GetSingleton();
 
   if (!a_book || !a_spell) {
@@ -302,6 +306,8 @@ void SpellTomeHook::OnSpellTomeRead(RE::TESObjectBOOK *a_book,
   if (hook->m_settings.grantXPOnRead && !alreadyGrantedXP) {
     pm->AddXP(formIdStr, xpToGrant);
     hook->MarkTomeXPGranted(spellFormId);
+    ProgressionManager::CountXPEvent(
+        "tome", SpellScanner::GetSchoolName(a_spell->GetAssociatedSkill()));
 
     logger::info("SpellTomeHook: Granted {:.1f} XP ({:.0f}% of {:.1f} "
                  "required) for '{}'",
@@ -493,9 +499,10 @@ float SpellTomeHook::GetXPMultiplier(RE::FormID spellFormId) const {
   // Check if tome inventory boost is enabled and player has the tome
   if (m_settings.tomeInventoryBoost && PlayerHasSpellTome(spellFormId)) {
     multiplier += m_settings.tomeInventoryBoostPercent / 100.0f;
-    logger::trace("SpellTomeHook: Tome inventory boost active for {:08X}, "
-                  "multiplier = {:.2f}",
-                  spellFormId, multiplier);
+    SL_LOG_TRACE(Hooks,
+                 "SpellTomeHook: Tome inventory boost active for {:08X}, "
+                 "multiplier = {:.2f}",
+                 spellFormId, multiplier);
   }
 
   return multiplier;
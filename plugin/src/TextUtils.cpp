@@ -0,0 +1,376 @@
+#include "TextUtils.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#  define SL_TEXT_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define SL_TARGET_AVX2
+#  else
+#    define SL_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace TextUtils
+{
+namespace
+{
+// =============================================================================
+// SCALAR
+// =============================================================================
+
+bool IsContinuation(uint8_t c)
+{
+  return (c & 0xC0) == 0x80;
+}
+
+// Length of the valid UTF-8 sequence starting at p, or 0 if invalid (overlong forms,
+// surrogates and code points above U+10FFFF are rejected, matching nlohmann::json)
+size_t ValidSequenceLength(const uint8_t* p, size_t remaining)
+{
+  uint8_t c = p[0];
+  if (c < 0x80) {
+    return 1;
+  }
+  if (c >= 0xC2 && c <= 0xDF) {
+    return (remaining >= 2 && IsContinuation(p[1])) ? 2 : 0;
+  }
+  if (c >= 0xE0 && c <= 0xEF) {
+    if (remaining < 3 || !IsContinuation(p[1]) || !IsContinuation(p[2]))
+      return 0;
+    if (c == 0xE0 && p[1] < 0xA0)
+      return 0;  // Overlong
+    if (c == 0xED && p[1] > 0x9F)
+      return 0;  // Surrogate
+    return 3;
+  }
+  if (c >= 0xF0 && c <= 0xF4) {
+    if (remaining < 4 || !IsContinuation(p[1]) || !IsContinuation(p[2]) || !IsContinuation(p[3]))
+      return 0;
+    if (c == 0xF0 && p[1] < 0x90)
+      return 0;  // Overlong
+    if (c == 0xF4 && p[1] > 0x8F)
+      return 0;  // Above U+10FFFF
+    return 4;
+  }
+  return 0;
+}
+
+// Replacement for a byte that does not start a valid sequence
+void AppendSubstitution(std::string& out, uint8_t c)
+{
+  // Windows-1252 control characters - replace with ASCII equivalents
+  switch (c) {
+  case 0x91:  // Left single quote
+  case 0x92:  // Right single quote
+    out += '\'';
+    break;
+  case 0x93:  // Left double quote
+  case 0x94:  // Right double quote
+    out += '"';
+    break;
+  case 0x96:  // En dash
+  case 0x97:  // Em dash
+    out += '-';
+    break;
+  case 0x85:  // Ellipsis
+    out += "...";
+    break;
+  case 0x99:  // Trademark
+    out += "(TM)";
+    break;
+  default:  // Unknown - replace with ?
+    out += '?';
+    break;
+  }
+}
+
+// Skip ASCII 8 bytes at a time
+size_t SkipAsciiScalar(const uint8_t* data, size_t pos, size_t size)
+{
+  while (pos + 8 <= size) {
+    uint64_t word;
+    std::memcpy(&word, data + pos, sizeof(word));
+    if (word & 0x8080808080808080ull)
+      break;
+    pos += 8;
+  }
+  return pos;
+}
+
+// =============================================================================
+// SIMD
+// =============================================================================
+
+#ifdef SL_TEXT_X86
+// SSE2 is part of x64 - skip pure ASCII in 16-byte blocks
+size_t SkipAsciiSSE2(const uint8_t* data, size_t pos, size_t size)
+{
+  while (pos + 16 <= size) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+    pos += 16;
+  }
+  return pos;
+}
+
+// AVX2 UTF-8 validation of 32-byte blocks (lookup-table algorithm from Keiser & Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte"). Skips whole blocks of valid
+// UTF-8, ASCII or not, and stops at the first block with an error.
+constexpr uint8_t kTooShort     = 1 << 0;  // 11______ 0_______ / 11______ 11______
+constexpr uint8_t kTooLong      = 1 << 1;  // 0_______ 10______
+constexpr uint8_t kOverlong3    = 1 << 2;  // 11100000 100_____
+constexpr uint8_t kTooLarge     = 1 << 3;  // 11110100 1001____ / 11110100 101_____ / 11110101+
+constexpr uint8_t kSurrogate    = 1 << 4;  // 11101101 101_____
+constexpr uint8_t kOverlong2    = 1 << 5;  // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101+ 1000____
+constexpr uint8_t kOverlong4    = 1 << 6;  // 11110000 1000____
+constexpr uint8_t kTwoConts     = 1 << 7;  // 10______ 10______
+constexpr uint8_t kCarry        = kTooShort | kTooLong | kTwoConts;
+
+SL_TARGET_AVX2 __m256i Lookup16(__m256i index, const uint8_t (&table)[16])
+{
+  __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+  return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(t), index);
+}
+
+// Bytes of `input` shifted right by N across the 128-bit lane boundary, filled from `prev`
+template <int N>
+SL_TARGET_AVX2 __m256i Prev(__m256i input, __m256i prev)
+{
+  return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+SL_TARGET_AVX2 __m256i CheckBlock(__m256i input, __m256i prevInput)
+{
+  static constexpr uint8_t byte1High[16] = {
+      // 0_______ ________ <ASCII in byte 1>
+      kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+      // 10______ ________ <continuation in byte 1>
+      kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+      // 1100____ ________ <two byte lead in byte 1>
+      kTooShort | kOverlong2,
+      // 1101____ ________ <two byte lead in byte 1>
+      kTooShort,
+      // 1110____ ________ <three byte lead in byte 1>
+      kTooShort | kOverlong3 | kSurrogate,
+      // 1111____ ________ <four+ byte lead in byte 1>
+      kTooShort | kTooLarge | kTooLarge1000 | kOverlong4};
+
+  static constexpr uint8_t byte1Low[16] = {
+      // ____0000 ________
+      kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+      // ____0001 ________
+      kCarry | kOverlong2,
+      // ____001_ ________
+      kCarry, kCarry,
+      // ____0100 ________
+      kCarry | kTooLarge,
+      // ____0101 ________ and above
+      kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+      kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+      kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+      // ____1101 ________
+      kCarry | kTooLarge | kTooLarge1000 | kSurrogate, kCarry | kTooLarge | kTooLarge1000,
+      kCarry | kTooLarge | kTooLarge1000};
+
+  static constexpr uint8_t byte2High[16] = {
+      // ________ 0_______ <ASCII in byte 2>
+      kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+      // ________ 1000____
+      kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+      // ________ 1001____
+      kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+      // ________ 101_____
+      kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+      kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+      // ________ 11______
+      kTooShort, kTooShort, kTooShort, kTooShort};
+
+  const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+
+  __m256i prev1     = Prev<1>(input, prevInput);
+  __m256i prev1High = _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble);
+  __m256i prev1Low  = _mm256_and_si256(prev1, lowNibble);
+  __m256i inputHigh = _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble);
+
+  __m256i special = _mm256_and_si256(_mm256_and_si256(Lookup16(prev1High, byte1High), Lookup16(prev1Low, byte1Low)),
+                                     Lookup16(inputHigh, byte2High));
+
+  // Third and fourth bytes of 3/4-byte sequences must be continuations
+  __m256i prev2       = Prev<2>(input, prevInput);
+  __m256i prev3       = Prev<3>(input, prevInput);
+  __m256i isThird     = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+  __m256i isFourth    = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+  __m256i mustBeCont  = _mm256_and_si256(_mm256_or_si256(isThird, isFourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+  return _mm256_xor_si256(mustBeCont, special);
+}
+
+// Non-zero bytes where the block ends in the middle of a multi-byte sequence
+SL_TARGET_AVX2 __m256i IsIncomplete(__m256i input)
+{
+  const __m256i maxValue = _mm256_setr_epi8(
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF),
+      static_cast<char>(0xFF), static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+  return _mm256_subs_epu8(input, maxValue);
+}
+
+SL_TARGET_AVX2 size_t SkipValidAVX2(const uint8_t* data, size_t pos, size_t size)
+{
+  const size_t start = pos;
+
+  __m256i prevInput      = _mm256_setzero_si256();
+  __m256i prevIncomplete = _mm256_setzero_si256();
+
+  while (pos + 32 <= size) {
+    __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+
+    if (_mm256_movemask_epi8(input) == 0) {
+      // ASCII block - only an unfinished sequence from the previous block can be an error
+      if (!_mm256_testz_si256(prevIncomplete, prevIncomplete))
+        break;
+      prevIncomplete = _mm256_setzero_si256();
+    } else {
+      __m256i error = CheckBlock(input, prevInput);
+      if (!_mm256_testz_si256(error, error))
+        break;
+      prevIncomplete = IsIncomplete(input);
+    }
+
+    prevInput = input;
+    pos += 32;
+  }
+
+  // pos may sit inside a sequence that started in the last verified block - back up to its lead byte
+  bool sequenceOpen = false;
+  if (pos > start) {
+    for (size_t back = 1; back <= 3 && pos - back >= start; ++back) {
+      uint8_t c = data[pos - back];
+      if (IsContinuation(c))
+        continue;
+      size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+      if (back < length) {
+        pos -= back;
+        sequenceOpen = true;
+      }
+      break;
+    }
+  }
+
+  // Tail shorter than a block (short names/descriptions are mostly this) - skip ASCII in 16-byte steps
+  if (pos + 32 > size && !sequenceOpen) {
+    pos = SkipAsciiSSE2(data, pos, size);
+  }
+  return pos;
+}
+
+bool CpuHasAVX2()
+{
+#  if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx     = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    return false;
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#  else
+  return __builtin_cpu_supports("avx2");
+#  endif
+}
+#endif
+
+// Advance from a sequence boundary over bytes that are known to be valid. Returns a sequence boundary.
+using SkipValidFn = size_t (*)(const uint8_t*, size_t, size_t);
+
+SkipValidFn SelectSkipValid()
+{
+#ifdef SL_TEXT_X86
+  return CpuHasAVX2() ? SkipValidAVX2 : SkipAsciiSSE2;
+#else
+  return SkipAsciiScalar;
+#endif
+}
+
+const SkipValidFn g_skipValid = SelectSkipValid();
+
+// Bytes handled by the scalar loop before going back to the block scanner
+constexpr size_t kScalarStride = 32;
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void AppendSanitizedUTF8(std::string& out, std::string_view input)
+{
+  const auto* data  = reinterpret_cast<const uint8_t*>(input.data());
+  const size_t size = input.size();
+
+  // Valid text is copied in runs - output is only touched when an invalid byte is found
+  size_t runStart = 0;
+  size_t pos      = 0;
+
+  out.reserve(out.size() + size);
+
+  while (pos < size) {
+    pos = g_skipValid(data, pos, size);
+
+    const size_t scalarEnd = std::min(size, pos + kScalarStride);
+    while (pos < scalarEnd) {
+      size_t length = ValidSequenceLength(data + pos, size - pos);
+      if (length > 0) {
+        pos += length;
+        continue;
+      }
+
+      out.append(input.data() + runStart, pos - runStart);
+      AppendSubstitution(out, data[pos]);
+      runStart = ++pos;
+    }
+  }
+
+  out.append(input.data() + runStart, size - runStart);
+}
+
+std::string SanitizeToUTF8(std::string_view input)
+{
+  std::string result;
+  AppendSanitizedUTF8(result, input);
+  return result;
+}
+
+bool IsValidUTF8(std::string_view input)
+{
+  const auto* data  = reinterpret_cast<const uint8_t*>(input.data());
+  const size_t size = input.size();
+
+  size_t pos = 0;
+  while (pos < size) {
+    pos = g_skipValid(data, pos, size);
+
+    const size_t scalarEnd = std::min(size, pos + kScalarStride);
+    while (pos < scalarEnd) {
+      size_t length = ValidSequenceLength(data + pos, size - pos);
+      if (length == 0)
+        return false;
+      pos += length;
+    }
+  }
+  return true;
+}
+}  // namespace TextUtils
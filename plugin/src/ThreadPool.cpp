@@ -0,0 +1,222 @@
+#include "ThreadPool.h"
+
+#include "Trace.h"
+
+namespace
+{
+// Blocking-lane threads exit after idling this long
+constexpr auto kBlockingIdleTimeout = 30s;
+
+thread_local ThreadPool* t_pool  = nullptr;
+thread_local size_t t_workerIndex = 0;
+}  // namespace
+
+ThreadPool* ThreadPool::GetSingleton()
+{
+  // Never destroyed - the detached workers may still be waiting on it at process exit
+  static ThreadPool* singleton = new ThreadPool();
+  return singleton;
+}
+
+ThreadPool::ThreadPool()
+{
+  // Leave the game's main and render threads a core each
+  unsigned int cores = std::thread::hardware_concurrency();
+  size_t count       = cores > 4 ? cores - 2 : 2;
+
+  for (size_t i = 0; i < count; ++i) {
+    m_workers.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    std::thread([this, i]() { WorkerLoop(i); }).detach();
+  }
+  logger::info("ThreadPool: Started {} workers ({} hardware threads)", count, cores);
+}
+
+void ThreadPool::Submit(Job job, Priority priority, std::stop_token stopToken)
+{
+  Task task{std::move(job), std::move(stopToken)};
+
+  // From a worker: onto its own deque, where it stays unless someone steals it
+  if (t_pool == this && priority != Priority::High) {
+    auto& worker = *m_workers[t_workerIndex];
+    std::lock_guard lock(worker.mutex);
+    worker.local.push_back(std::move(task));
+  } else {
+    std::lock_guard lock(m_mutex);
+    m_queues[static_cast<size_t>(priority)].push_back(std::move(task));
+  }
+
+  m_pending.fetch_add(1, std::memory_order_release);
+  {
+    // Pairs with the predicate check in WorkerLoop so the wake-up can't slip in before the wait
+    std::lock_guard lock(m_mutex);
+  }
+  m_wake.notify_one();
+}
+
+void ThreadPool::SubmitBlocking(Job job)
+{
+  std::lock_guard lock(m_blockingMutex);
+  m_blockingQueue.push_back(std::move(job));
+
+  // Idle threads that were already woken still count as idle, so compare against the whole queue
+  if (m_blockingQueue.size() > m_blockingIdle) {
+    std::thread([this]() { BlockingLoop(); }).detach();
+  } else {
+    m_blockingWake.notify_one();
+  }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t maxParallelism, const std::function<void(size_t)>& fn)
+{
+  if (count == 0) {
+    return;
+  }
+
+  // Helpers that start after the last index was taken only touch this shared state, never fn
+  struct State
+  {
+    const std::function<void(size_t)>* fn = nullptr;
+    size_t count                          = 0;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+  };
+  auto state   = std::make_shared<State>();
+  state->fn    = &fn;
+  state->count = count;
+
+  auto drain = [state]() {
+    for (size_t i = state->next++; i < state->count; i = state->next++) {
+      try {
+        (*state->fn)(i);
+      } catch (...) {
+        std::lock_guard lock(state->mutex);
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+      }
+      if (++state->done == state->count) {
+        std::lock_guard lock(state->mutex);
+        state->finished.notify_all();
+      }
+    }
+  };
+
+  size_t threads = maxParallelism > 0 ? (std::min)(maxParallelism, m_workers.size() + 1) : m_workers.size() + 1;
+  threads        = (std::min)(threads, count);
+  for (size_t i = 1; i < threads; ++i) {
+    Submit(drain);
+  }
+  drain();
+
+  std::unique_lock lock(state->mutex);
+  state->finished.wait(lock, [&]() { return state->done == state->count; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+void ThreadPool::RunOnGameThread(Job job)
+{
+  SKSE::GetTaskInterface()->AddTask(std::move(job));
+}
+
+void ThreadPool::WorkerLoop(size_t index)
+{
+  t_pool        = this;
+  t_workerIndex = index;
+  Trace::SetThreadName(std::format("Worker {}", index + 1));
+
+  while (true) {
+    Task task;
+    if (TryPop(index, task)) {
+      Run(task);
+      continue;
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_wake.wait(lock, [this]() { return m_pending.load(std::memory_order_acquire) > 0; });
+  }
+}
+
+bool ThreadPool::TryPop(size_t index, Task& task)
+{
+  auto takeShared = [&](Priority priority) {
+    std::lock_guard lock(m_mutex);
+    auto& queue = m_queues[static_cast<size_t>(priority)];
+    if (queue.empty()) {
+      return false;
+    }
+    task = std::move(queue.front());
+    queue.pop_front();
+    return true;
+  };
+
+  auto takeLocal = [&](Worker& worker, bool own) {
+    std::lock_guard lock(worker.mutex);
+    if (worker.local.empty()) {
+      return false;
+    }
+    if (own) {
+      task = std::move(worker.local.back());
+      worker.local.pop_back();
+    } else {
+      task = std::move(worker.local.front());
+      worker.local.pop_front();
+    }
+    return true;
+  };
+
+  bool found = takeShared(Priority::High) || takeLocal(*m_workers[index], true) || takeShared(Priority::Normal);
+  for (size_t i = 1; !found && i < m_workers.size(); ++i) {
+    found = takeLocal(*m_workers[(index + i) % m_workers.size()], false);
+  }
+  found = found || takeShared(Priority::Low);
+
+  if (found) {
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return found;
+}
+
+void ThreadPool::BlockingLoop()
+{
+  Trace::SetThreadName("Blocking I/O");
+
+  std::unique_lock lock(m_blockingMutex);
+  while (true) {
+    if (m_blockingQueue.empty()) {
+      m_blockingIdle++;
+      bool woken =
+          m_blockingWake.wait_for(lock, kBlockingIdleTimeout, [this]() { return !m_blockingQueue.empty(); });
+      m_blockingIdle--;
+      if (!woken) {
+        return;
+      }
+    }
+
+    Task task{std::move(m_blockingQueue.front()), {}};
+    m_blockingQueue.pop_front();
+    lock.unlock();
+    Run(task);
+    lock.lock();
+  }
+}
+
+void ThreadPool::Run(Task& task)
+{
+  if (task.stopToken.stop_requested()) {
+    return;
+  }
+  try {
+    task.job();
+  } catch (const std::exception& e) {
+    logger::error("ThreadPool: Job failed with exception: {}", e.what());
+  } catch (...) {
+    logger::error("ThreadPool: Job failed with an unknown exception");
+  }
+}
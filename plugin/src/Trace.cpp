@@ -0,0 +1,207 @@
+#include "Trace.h"
+
+#include "JsonWriter.h"
+
+namespace Trace
+{
+namespace detail
+{
+std::atomic<bool> g_recording{false};
+}
+
+namespace
+{
+constexpr size_t kEventsPerThread = 32768;  // ~768 KB per thread that records - zones beyond are dropped
+
+struct Event
+{
+  const char* name;
+  int64_t start;
+  int64_t end;
+};
+
+// Written by its thread only. The dump reads events [0, count) - count is published after each event.
+struct ThreadBuffer
+{
+  uint32_t id = 0;
+  std::string name;      // Guarded by s_lock
+  bool retired = false;  // Thread has exited - guarded by s_lock
+  std::unique_ptr<Event[]> events = std::make_unique<Event[]>(kEventsPerThread);
+  std::atomic<size_t> count{0};
+  std::atomic<size_t> dropped{0};
+  std::atomic<uint64_t> session{0};
+};
+
+std::mutex s_lock;                                     // Buffer list, names and session control
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;  // Kept for the process lifetime
+std::atomic<uint64_t> s_session{0};
+std::atomic<int64_t> s_sessionStart{0};
+
+// Short-lived threads (scan workers) hand their buffer back on exit. It stays in the dump until
+// the next session and can then be taken over by a new thread, so the list grows with the number
+// of threads alive during one session rather than with every thread ever started.
+struct BufferHandle
+{
+  ThreadBuffer* buffer = nullptr;
+
+  ~BufferHandle()
+  {
+    if (buffer) {
+      std::lock_guard lock(s_lock);
+      buffer->retired = true;
+    }
+  }
+};
+thread_local BufferHandle t_handle;
+
+ThreadBuffer* GetThreadBuffer()
+{
+  if (t_handle.buffer) {
+    return t_handle.buffer;
+  }
+
+  std::lock_guard lock(s_lock);
+  uint64_t session = s_session.load(std::memory_order_relaxed);
+  for (auto& buffer : s_buffers) {
+    if (buffer->retired && buffer->session.load(std::memory_order_relaxed) != session) {
+      t_handle.buffer = buffer.get();
+      break;
+    }
+  }
+  if (!t_handle.buffer) {
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    s_buffers.back()->id = static_cast<uint32_t>(s_buffers.size());
+    t_handle.buffer      = s_buffers.back().get();
+  }
+  t_handle.buffer->retired = false;
+  t_handle.buffer->name    = "Thread " + std::to_string(t_handle.buffer->id);
+  return t_handle.buffer;
+}
+}  // namespace
+
+namespace detail
+{
+int64_t Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Record(const char* name, int64_t start, int64_t end)
+{
+  auto* buffer = GetThreadBuffer();
+
+  // First event of a new session - the buffer starts over
+  uint64_t session = s_session.load(std::memory_order_acquire);
+  if (buffer->session.load(std::memory_order_relaxed) != session) {
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    buffer->session.store(session, std::memory_order_release);
+  }
+
+  size_t index = buffer->count.load(std::memory_order_relaxed);
+  if (index >= kEventsPerThread) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[index] = {name, start, end};
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+}  // namespace detail
+
+void Start()
+{
+  std::lock_guard lock(s_lock);
+  s_sessionStart.store(detail::Now(), std::memory_order_relaxed);
+  s_session.fetch_add(1, std::memory_order_release);
+  detail::g_recording.store(true, std::memory_order_relaxed);
+  logger::info("Trace: Recording started");
+}
+
+void Stop()
+{
+  detail::g_recording.store(false, std::memory_order_relaxed);
+  logger::info("Trace: Recording stopped");
+}
+
+void SetThreadName(std::string name)
+{
+  auto* buffer = GetThreadBuffer();
+  std::lock_guard lock(s_lock);
+  buffer->name = std::move(name);
+}
+
+DumpResult WriteChromeTrace(const std::filesystem::path& path)
+{
+  DumpResult result;
+  std::lock_guard lock(s_lock);
+
+  uint64_t session = s_session.load(std::memory_order_acquire);
+  int64_t origin   = s_sessionStart.load(std::memory_order_relaxed);
+  if (session == 0) {
+    result.error = "Nothing recorded yet";
+    return result;
+  }
+
+  try {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      result.error = "Cannot open " + path.string();
+      return result;
+    }
+
+    // Trace event format: complete events ("X") in microseconds, one track per thread
+    JsonWriter writer(file);
+    writer.BeginObject();
+    writer.Member("displayTimeUnit", "ns");
+    writer.Key("traceEvents").BeginArray();
+    for (const auto& buffer : s_buffers) {
+      if (buffer->session.load(std::memory_order_acquire) != session) {
+        continue;
+      }
+      size_t count = buffer->count.load(std::memory_order_acquire);
+
+      writer.BeginObject()
+          .Member("name", "thread_name")
+          .Member("ph", "M")
+          .Member("pid", 1)
+          .Member("tid", buffer->id);
+      writer.Key("args").BeginObject().Member("name", buffer->name).EndObject();
+      writer.EndObject();
+
+      for (size_t i = 0; i < count; ++i) {
+        const Event& event = buffer->events[i];
+        writer.BeginObject()
+            .Member("name", event.name)
+            .Member("ph", "X")
+            .Member("ts", static_cast<double>(event.start - origin) / 1000.0)
+            .Member("dur", static_cast<double>(event.end - event.start) / 1000.0)
+            .Member("pid", 1)
+            .Member("tid", buffer->id)
+            .EndObject();
+      }
+
+      result.events += count;
+      result.dropped += buffer->dropped.load(std::memory_order_relaxed);
+      result.threads++;
+    }
+    writer.EndArray();
+    writer.EndObject();
+    writer.Flush();
+
+    result.success = true;
+    logger::info("Trace: Wrote {} event(s) from {} thread(s) to {}, {} dropped", result.events, result.threads,
+                 path.string(), result.dropped);
+  } catch (const std::exception& e) {
+    result.error = e.what();
+    logger::error("Trace: Failed to write {}: {}", path.string(), e.what());
+  }
+  return result;
+}
+
+std::filesystem::path GetTracePath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/trace.json";
+}
+}  // namespace Trace
@@ -0,0 +1,689 @@
+#include "TreeBuilder.h"
+
+#include <random>
+
+namespace TreeBuilder
+{
+namespace
+{
+// =============================================================================
+// CONSTANTS
+// =============================================================================
+
+constexpr std::string_view kTierOrder[] = {"Novice", "Apprentice", "Adept", "Expert", "Master"};
+constexpr int kUnknownTier              = static_cast<int>(std::size(kTierOrder));
+
+// Preferred roots (same list as the tree rules prompt)
+constexpr std::pair<std::string_view, std::string_view> kVanillaRoots[] = {
+    {"Destruction", "0x00012FCD"},  // Flames
+    {"Restoration", "0x00012FCC"},  // Healing
+    {"Alteration",  "0x0005AD5C"},  // Oakflesh
+    {"Conjuration", "0x000640B6"},  // Conjure Familiar
+    {"Illusion",    "0x00021143"},  // Clairvoyance
+};
+
+// Words that say nothing about what a spell does
+constexpr std::string_view kStopWords[] = {
+    "the", "and", "for", "with", "spell", "magic", "magical", "target", "targets", "effect", "effects",
+    "damage", "point", "points", "second", "seconds", "per", "does", "causes", "cast", "caster", "casting",
+    "level", "levels", "health", "magicka", "stamina", "restore", "restores", "mag", "dur",
+    "novice", "apprentice", "adept", "expert", "master"};
+
+// Parent scoring on top of cosine similarity
+constexpr float kSameThemeBonus = 0.25f;
+constexpr float kNextTierBonus  = 0.15f;  // Parent is exactly one skill tier below
+constexpr float kSameTierBonus  = 0.05f;  // Same-tier branching is allowed, slightly preferred over skips
+constexpr float kDepthPenalty   = 0.01f;  // Keeps similar spells from forming one long chain
+
+// Fuzzy relationship output (visual-first builder)
+constexpr float kMinRelatedSimilarity = 0.3f;
+constexpr size_t kMaxRelatedSpells    = 5;
+
+// =============================================================================
+// SPELL FEATURES
+// =============================================================================
+
+struct Term
+{
+  uint32_t token;
+  float weight;
+};
+
+struct SpellNode
+{
+  const json* spell = nullptr;
+  std::string formId;
+  std::string family;       // Variant family from the scan (SpellFamilyIndex), empty if none
+  int tier  = kUnknownTier;
+  int theme = -1;           // Index into the school's themes, -1 = unassigned
+  std::vector<Term> terms;  // Sorted by token, L2-normalized TF-IDF weights
+
+  // Tree state
+  int depth = -1;
+  std::vector<int> children;
+  std::vector<int> prerequisites;
+};
+
+int GetTierIndex(std::string_view skillLevel)
+{
+  for (int i = 0; i < kUnknownTier; ++i) {
+    if (kTierOrder[i] == skillLevel) {
+      return i;
+    }
+  }
+  return kUnknownTier;
+}
+
+bool IsStopWord(std::string_view word)
+{
+  return std::find(std::begin(kStopWords), std::end(kStopWords), word) != std::end(kStopWords);
+}
+
+std::string GetStringField(const json& spell, const char* key)
+{
+  auto it = spell.find(key);
+  return it != spell.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+// Lowercase words of 3+ letters, minus stop words
+void Tokenize(std::string_view text, std::vector<std::string>& out)
+{
+  std::string word;
+  auto flush = [&]() {
+    if (word.size() >= 3 && !IsStopWord(word)) {
+      out.push_back(word);
+    }
+    word.clear();
+  };
+
+  for (char c : text) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+      word.push_back(static_cast<char>(c | 0x20));
+    } else {
+      flush();
+    }
+  }
+  flush();
+}
+
+// "MagicDamageFire" -> "damage fire"
+void TokenizeKeyword(std::string_view keyword, std::vector<std::string>& out)
+{
+  if (keyword.starts_with("Magic")) {
+    keyword.remove_prefix(5);
+  }
+
+  std::string spaced;
+  spaced.reserve(keyword.size() * 2);
+  for (char c : keyword) {
+    if (c >= 'A' && c <= 'Z') {
+      spaced.push_back(' ');
+    }
+    spaced.push_back(c);
+  }
+  Tokenize(spaced, out);
+}
+
+// Name tokens are listed twice - the name is the strongest signal of what a spell is
+std::vector<std::string> ExtractTokens(const json& spell)
+{
+  std::vector<std::string> tokens;
+
+  std::string name = GetStringField(spell, "name");
+  Tokenize(name, tokens);
+  Tokenize(name, tokens);
+
+  if (auto it = spell.find("effectNames"); it != spell.end() && it->is_array()) {
+    for (const auto& effectName : *it) {
+      if (effectName.is_string()) {
+        Tokenize(effectName.get_ref<const std::string&>(), tokens);
+      }
+    }
+  }
+
+  if (auto it = spell.find("effects"); it != spell.end() && it->is_array()) {
+    for (const auto& effect : *it) {
+      if (effect.is_object()) {
+        Tokenize(GetStringField(effect, "name"), tokens);
+        Tokenize(GetStringField(effect, "description"), tokens);
+      }
+    }
+  }
+
+  if (auto it = spell.find("keywords"); it != spell.end() && it->is_array()) {
+    for (const auto& keyword : *it) {
+      if (keyword.is_string()) {
+        TokenizeKeyword(keyword.get_ref<const std::string&>(), tokens);
+      }
+    }
+  }
+
+  return tokens;
+}
+
+// =============================================================================
+// SCHOOL TREE
+// =============================================================================
+
+class SchoolTree
+{
+public:
+  SchoolTree(std::string schoolName, std::vector<const json*> spells, const BuildConfig& config, std::mt19937_64& rng) :
+      m_school(std::move(schoolName)), m_config(config), m_rng(rng)
+  {
+    m_nodes.reserve(spells.size());
+    for (const auto* spell : spells) {
+      SpellNode node;
+      node.spell  = spell;
+      node.formId = GetStringField(*spell, "formId");
+      node.family = GetStringField(*spell, "familyId");
+      node.tier   = GetTierIndex(GetStringField(*spell, "skillLevel"));
+      m_nodes.push_back(std::move(node));
+    }
+  }
+
+  void Build()
+  {
+    BuildFeatures();
+    DiscoverThemes();
+    LinkNodes();
+  }
+
+  json ToJson() const
+  {
+    json nodes = json::array();
+    for (const auto& node : m_nodes) {
+      json children      = json::array();
+      json prerequisites = json::array();
+      for (int child : node.children) {
+        children.push_back(m_nodes[child].formId);
+      }
+      for (int prereq : node.prerequisites) {
+        prerequisites.push_back(m_nodes[prereq].formId);
+      }
+
+      json entry;
+      entry["formId"]        = node.formId;
+      entry["children"]      = std::move(children);
+      entry["prerequisites"] = std::move(prerequisites);
+      entry["tier"]          = node.depth + 1;
+      nodes.push_back(std::move(entry));
+    }
+
+    json tree;
+    tree["root"]        = m_nodes[m_root].formId;
+    tree["layoutStyle"] = "radial";
+    tree["nodes"]       = std::move(nodes);
+    return tree;
+  }
+
+  // Top related spells per spell, plus the pair scores (visual-first builder input)
+  void AppendFuzzyData(json& relationships, json& similarityScores, json& groups, json& spellThemes) const
+  {
+    std::vector<float> scores(m_nodes.size(), 0.0f);
+    std::vector<int> touched;
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      AccumulateSimilarity(m_nodes[i], m_allPostings, scores, touched);
+
+      std::vector<std::pair<float, int>> related;
+      for (int j : touched) {
+        if (j != static_cast<int>(i) && scores[j] >= kMinRelatedSimilarity) {
+          related.emplace_back(scores[j], j);
+        }
+        scores[j] = 0.0f;
+      }
+      touched.clear();
+
+      size_t keep = std::min(related.size(), kMaxRelatedSpells);
+      std::partial_sort(related.begin(), related.begin() + keep, related.end(),
+                        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+      if (keep > 0) {
+        json& list = relationships[m_nodes[i].formId];
+        for (size_t k = 0; k < keep; ++k) {
+          const auto& other = m_nodes[related[k].second].formId;
+          list.push_back(other);
+          similarityScores[m_nodes[i].formId + ":" + other] = std::round(related[k].first * 1000.0f) / 1000.0f;
+        }
+      }
+
+      if (m_nodes[i].theme >= 0) {
+        const auto& theme = m_themes[m_nodes[i].theme];
+        groups[m_school + ":" + theme].push_back(m_nodes[i].formId);
+        spellThemes[m_nodes[i].formId] = json::array({theme});
+      }
+    }
+  }
+
+  size_t Size() const { return m_nodes.size(); }
+
+  int ConvergenceCount() const { return m_convergences; }
+
+private:
+  using Postings = std::vector<std::vector<std::pair<int, float>>>;
+
+  // TF-IDF vectors over a per-school vocabulary
+  void BuildFeatures()
+  {
+    std::unordered_map<std::string, uint32_t> vocabulary;
+    std::vector<std::vector<std::pair<uint32_t, int>>> counts(m_nodes.size());
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      std::unordered_map<uint32_t, int> tf;
+      for (auto& token : ExtractTokens(*m_nodes[i].spell)) {
+        auto [it, inserted] = vocabulary.try_emplace(std::move(token), static_cast<uint32_t>(vocabulary.size()));
+        if (inserted) {
+          m_tokens.push_back(it->first);
+        }
+        tf[it->second]++;
+      }
+      counts[i].assign(tf.begin(), tf.end());
+      std::sort(counts[i].begin(), counts[i].end());
+    }
+
+    m_docFrequency.assign(vocabulary.size(), 0);
+    m_termFrequency.assign(vocabulary.size(), 0);
+    for (const auto& spellCounts : counts) {
+      for (auto [token, count] : spellCounts) {
+        m_docFrequency[token]++;
+        m_termFrequency[token] += count;
+      }
+    }
+
+    const float docs = static_cast<float>(m_nodes.size());
+    m_allPostings.assign(vocabulary.size(), {});
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      auto& terms = m_nodes[i].terms;
+      float norm  = 0.0f;
+      for (auto [token, count] : counts[i]) {
+        float idf    = std::log((docs + 1.0f) / (m_docFrequency[token] + 1.0f)) + 1.0f;
+        float weight = (1.0f + std::log(static_cast<float>(count))) * idf;
+        terms.push_back({token, weight});
+        norm += weight * weight;
+      }
+      norm = norm > 0.0f ? 1.0f / std::sqrt(norm) : 0.0f;
+      for (auto& term : terms) {
+        term.weight *= norm;
+        m_allPostings[term.token].emplace_back(static_cast<int>(i), term.weight);
+      }
+    }
+  }
+
+  // Same scoring as the JS procedural builder: frequent but not universal words
+  void DiscoverThemes()
+  {
+    const float docs = static_cast<float>(m_nodes.size());
+    std::vector<std::pair<float, uint32_t>> scores;
+    for (uint32_t token = 0; token < m_tokens.size(); ++token) {
+      float df    = static_cast<float>(m_docFrequency[token]);
+      float score = m_termFrequency[token] * std::log((docs + 1.0f) / (df + 1.0f));
+      if (df >= 2.0f && df < docs * 0.8f) {
+        score *= 1.5f;
+      }
+      if (score > 0.0f) {
+        scores.emplace_back(score, token);
+      }
+    }
+
+    size_t keep = std::min(scores.size(), static_cast<size_t>(std::max(0, m_config.topThemesPerSchool)));
+    std::partial_sort(scores.begin(), scores.begin() + keep, scores.end(), [](const auto& a, const auto& b) {
+      return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+
+    std::unordered_map<uint32_t, int> themeIndex;
+    for (size_t i = 0; i < keep; ++i) {
+      themeIndex[scores[i].second] = static_cast<int>(i);
+      m_themes.push_back(m_tokens[scores[i].second]);
+    }
+
+    // Each spell joins the theme with the heaviest weight in its vector
+    for (auto& node : m_nodes) {
+      float best = 0.0f;
+      for (const auto& term : node.terms) {
+        auto it = themeIndex.find(term.token);
+        if (it != themeIndex.end() && term.weight > best) {
+          best       = term.weight;
+          node.theme = it->second;
+        }
+      }
+    }
+  }
+
+  int SelectRoot() const
+  {
+    if (m_config.preferVanillaRoots) {
+      for (const auto& [school, formId] : kVanillaRoots) {
+        if (school != m_school)
+          continue;
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+          if (m_nodes[i].formId == formId) {
+            return static_cast<int>(i);
+          }
+        }
+      }
+    }
+
+    // Vanilla novice spell, then any novice spell, then the lowest tier
+    int firstNovice = -1;
+    int lowest      = 0;
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      const auto& node = m_nodes[i];
+      if (node.tier == 0) {
+        if (node.formId.starts_with("0x00")) {
+          return static_cast<int>(i);
+        }
+        if (firstNovice < 0) {
+          firstNovice = static_cast<int>(i);
+        }
+      }
+      if (node.tier < m_nodes[lowest].tier) {
+        lowest = static_cast<int>(i);
+      }
+    }
+    return firstNovice >= 0 ? firstNovice : lowest;
+  }
+
+  // Sparse dot product of one spell against every spell in the postings
+  static void AccumulateSimilarity(const SpellNode& node, const Postings& postings, std::vector<float>& scores,
+                                   std::vector<int>& touched)
+  {
+    for (const auto& term : node.terms) {
+      for (auto [other, weight] : postings[term.token]) {
+        if (scores[other] == 0.0f) {
+          touched.push_back(other);
+        }
+        scores[other] += term.weight * weight;
+      }
+    }
+  }
+
+  bool HasFreeSlot(int index) const { return static_cast<int>(m_nodes[index].children.size()) < m_maxChildren; }
+
+  float ParentScore(const SpellNode& child, int parentIndex, float similarity) const
+  {
+    const auto& parent = m_nodes[parentIndex];
+    float score        = similarity - kDepthPenalty * parent.depth;
+    if (child.theme >= 0 && parent.theme == child.theme) {
+      score += kSameThemeBonus;
+    }
+    if (parent.tier == child.tier - 1) {
+      score += kNextTierBonus;
+    } else if (parent.tier == child.tier) {
+      score += kSameTierBonus;
+    }
+    return score;
+  }
+
+  void Link(int parent, int child)
+  {
+    m_nodes[parent].children.push_back(child);
+    m_nodes[child].prerequisites.push_back(parent);
+    if (m_nodes[child].depth < 0) {
+      m_nodes[child].depth = m_nodes[parent].depth + 1;
+    }
+  }
+
+  // Shallowest open node at or below the child's tier, same theme first (spells with nothing in common with the
+  // tree so far). The school root when no such node is open - a higher-tier parent would invert progression.
+  int FallbackParent(const SpellNode& child) const
+  {
+    int best     = -1;
+    auto ranking = [&](int index) {
+      const auto& node = m_nodes[index];
+      bool sameTheme   = child.theme >= 0 && node.theme == child.theme;
+      return std::make_tuple(!sameTheme, node.depth, node.children.size());
+    };
+    for (int index : m_open) {
+      if (!HasFreeSlot(index) || m_nodes[index].tier > child.tier)
+        continue;
+      if (best < 0 || ranking(index) < ranking(best)) {
+        best = index;
+      }
+    }
+    return best >= 0 ? best : m_root;
+  }
+
+  void LinkNodes()
+  {
+    m_maxChildren = std::max(1, m_config.maxChildrenPerNode);
+    m_root        = SelectRoot();
+
+    m_nodes[m_root].depth = 0;
+    m_open.push_back(m_root);
+
+    // Lower tiers first; within a tier keep themes together so each theme grows its own branch
+    std::vector<int> order;
+    order.reserve(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      if (static_cast<int>(i) != m_root) {
+        order.push_back(static_cast<int>(i));
+      }
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+      const auto& na = m_nodes[a];
+      const auto& nb = m_nodes[b];
+      return std::tie(na.tier, na.theme, na.formId) < std::tie(nb.tier, nb.theme, nb.formId);
+    });
+
+    Postings placed(m_tokens.size());
+    auto place = [&](int index) {
+      for (const auto& term : m_nodes[index].terms) {
+        placed[term.token].emplace_back(index, term.weight);
+      }
+    };
+    place(m_root);
+
+    std::vector<float> scores(m_nodes.size(), 0.0f);
+    std::vector<int> touched;
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    // Variants of one spell (Locust I, II, III) become siblings under a common parent instead of a chain
+    std::unordered_map<std::string, int> familyParent;
+
+    for (int index : order) {
+      auto& node = m_nodes[index];
+      AccumulateSimilarity(node, placed, scores, touched);
+
+      int parent        = -1;
+      float parentScore = 0.0f;
+      if (!node.family.empty()) {
+        auto it = familyParent.find(node.family);
+        if (it != familyParent.end() && HasFreeSlot(it->second) && m_nodes[it->second].tier <= node.tier) {
+          parent = it->second;
+        }
+      }
+      if (parent < 0) {
+        for (int candidate : touched) {
+          if (!HasFreeSlot(candidate) || m_nodes[candidate].tier > node.tier)
+            continue;
+          float score = ParentScore(node, candidate, scores[candidate]);
+          if (parent < 0 || score > parentScore) {
+            parent      = candidate;
+            parentScore = score;
+          }
+        }
+      }
+      if (parent < 0) {
+        parent = FallbackParent(node);
+      }
+      Link(parent, index);
+      if (!node.family.empty()) {
+        familyParent.try_emplace(node.family, parent);
+      }
+
+      // Convergence: a second prerequisite from a different theme at a lower tier and depth
+      bool canConverge = node.tier >= m_config.convergenceAtTier && node.tier < kUnknownTier &&
+                         static_cast<int>(node.prerequisites.size()) < m_config.maxPrerequisites;
+      if (canConverge && chance(m_rng) < m_config.convergenceChance) {
+        int extra        = -1;
+        float extraScore = 0.0f;
+        for (int candidate : touched) {
+          const auto& other = m_nodes[candidate];
+          if (candidate == parent || !HasFreeSlot(candidate) || other.tier >= node.tier || other.theme == node.theme ||
+              other.depth >= node.depth)
+            continue;
+          if (extra < 0 || scores[candidate] > extraScore) {
+            extra      = candidate;
+            extraScore = scores[candidate];
+          }
+        }
+        if (extra >= 0) {
+          Link(extra, index);
+          m_convergences++;
+        }
+      }
+
+      for (int candidate : touched) {
+        scores[candidate] = 0.0f;
+      }
+      touched.clear();
+
+      place(index);
+      m_open.push_back(index);
+      std::erase_if(m_open, [&](int open) { return !HasFreeSlot(open); });
+    }
+  }
+
+  std::string m_school;
+  const BuildConfig& m_config;
+  std::mt19937_64& m_rng;
+
+  std::vector<SpellNode> m_nodes;
+  std::vector<std::string> m_tokens;  // Token id -> word
+  std::vector<int> m_docFrequency;
+  std::vector<int> m_termFrequency;
+  std::vector<std::string> m_themes;
+  Postings m_allPostings;             // Every spell, for fuzzy relationships
+  std::vector<int> m_open;            // Placed nodes that may still take children
+  int m_root         = 0;
+  int m_maxChildren  = 3;
+  int m_convergences = 0;
+};
+
+std::string GetSchoolName(const json& spell)
+{
+  std::string school = GetStringField(spell, "school");
+  if (school.empty() || school == "null" || school == "undefined" || school == "None") {
+    return "Hedge Wizard";
+  }
+  return school;
+}
+
+uint64_t ParseSeed(const json& value)
+{
+  if (value.is_number_unsigned()) {
+    return value.get<uint64_t>();
+  }
+  if (value.is_number()) {
+    return static_cast<uint64_t>(std::llabs(value.get<int64_t>()));
+  }
+  if (value.is_string()) {
+    return std::hash<std::string>{}(value.get<std::string>());
+  }
+  return 0;
+}
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+BuildConfig ParseBuildConfig(const json& config)
+{
+  BuildConfig result;
+  if (!config.is_object()) {
+    return result;
+  }
+
+  try {
+    result.maxChildrenPerNode = config.value("max_children_per_node", result.maxChildrenPerNode);
+    result.maxPrerequisites   = config.value("max_prerequisites", result.maxPrerequisites);
+    result.topThemesPerSchool = config.value("top_themes_per_school", result.topThemesPerSchool);
+    result.convergenceChance  = config.value("convergence_chance", result.convergenceChance);
+    result.preferVanillaRoots = config.value("prefer_vanilla_roots", result.preferVanillaRoots);
+    result.returnFuzzyData    = config.value("return_fuzzy_data", false) || config.value("run_fuzzy_analysis", false);
+    if (config.contains("seed")) {
+      result.seed = ParseSeed(config["seed"]);
+    }
+
+    // Layout settings are only echoed back (applied by the panel)
+    for (const char* key : {"shape", "density", "symmetry", "flower_chance", "flower_type", "convergence_chance"}) {
+      if (config.contains(key)) {
+        result.schoolConfig[key] = config[key];
+      }
+    }
+  } catch (const std::exception& e) {
+    logger::warn("TreeBuilder: Invalid config value ({}), using defaults", e.what());
+  }
+
+  return result;
+}
+
+json BuildTrees(const json& spells, const BuildConfig& config)
+{
+  auto startTime = std::chrono::steady_clock::now();
+
+  // Group by school, keeping scan order within each school
+  std::vector<std::string> schoolOrder;
+  std::unordered_map<std::string, std::vector<const json*>> bySchool;
+  for (const auto& spell : spells) {
+    if (!spell.is_object() || GetStringField(spell, "formId").empty())
+      continue;
+    auto [it, inserted] = bySchool.try_emplace(GetSchoolName(spell));
+    if (inserted) {
+      schoolOrder.push_back(it->first);
+    }
+    it->second.push_back(&spell);
+  }
+
+  std::mt19937_64 rng(config.seed != 0 ? config.seed : std::random_device{}());
+
+  json output;
+  output["version"]        = "1.0";
+  output["generator"]      = "Procedural (C++)";
+  output["schools"]        = json::object();
+  output["school_configs"] = json::object();
+
+  json relationships    = json::object();
+  json similarityScores = json::object();
+  json groups           = json::object();
+  json spellThemes      = json::object();
+
+  size_t totalNodes = 0;
+  for (const auto& school : schoolOrder) {
+    auto schoolStart = std::chrono::steady_clock::now();
+
+    SchoolTree tree(school, std::move(bySchool[school]), config, rng);
+    tree.Build();
+    output["schools"][school] = tree.ToJson();
+
+    // No LLM auto-configure here - the panel's own settings are echoed back
+    json schoolConfig                = config.schoolConfig.is_object() ? config.schoolConfig : json::object();
+    schoolConfig["source"]           = "config";
+    output["school_configs"][school] = std::move(schoolConfig);
+
+    if (config.returnFuzzyData) {
+      tree.AppendFuzzyData(relationships, similarityScores, groups, spellThemes);
+    }
+
+    totalNodes += tree.Size();
+    auto elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - schoolStart).count();
+    logger::info("TreeBuilder: {} - {} spells, {} convergence links in {} ms", school, tree.Size(),
+                 tree.ConvergenceCount(), elapsedMs);
+  }
+
+  if (config.returnFuzzyData) {
+    output["fuzzy_relationships"] = std::move(relationships);
+    output["similarity_scores"]   = std::move(similarityScores);
+    output["fuzzy_groups"]        = std::move(groups);
+    output["spell_themes"]        = std::move(spellThemes);
+  }
+
+  auto elapsedMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+  logger::info("TreeBuilder: Built {} schools, {} nodes in {} ms", schoolOrder.size(), totalNodes, elapsedMs);
+  return output;
+}
+}  // namespace TreeBuilder
@@ -0,0 +1,553 @@
+#include "TreeRepair.h"
+
+#include "LLMOutputParser.h"
+#include "PromptBuilder.h"
+
+#include <limits>
+#include <unordered_set>
+
+namespace TreeRepair
+{
+namespace
+{
+// Reachable spells listed as attachment points in a repair prompt
+constexpr size_t kMaxNeighbors = 60;
+
+constexpr size_t kUnvisited = static_cast<size_t>(-1);
+
+std::string FormIdOf(const json& value)
+{
+  return value.is_string() ? PromptBuilder::CanonicalFormId(value.get<std::string>()) : std::string();
+}
+
+std::string NameOf(const json& object)
+{
+  auto it = object.find("name");
+  return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+// The school object of a response, also when the model renamed the school key
+json* FindSchool(json& document, const std::string& school)
+{
+  auto schools = document.find("schools");
+  if (schools == document.end() || !schools->is_object()) {
+    return nullptr;
+  }
+  if (auto it = schools->find(school); it != schools->end()) {
+    return &*it;
+  }
+  return schools->size() == 1 ? &schools->begin().value() : nullptr;
+}
+
+void AddUnique(std::vector<std::string>& list, std::string value)
+{
+  if (!value.empty() && std::find(list.begin(), list.end(), value) == list.end()) {
+    list.push_back(std::move(value));
+  }
+}
+
+// Tarjan's algorithm, iterative so deep prerequisite chains cannot overflow the stack.
+// edges[v] lists the prerequisites of v.
+std::vector<std::vector<size_t>> StronglyConnected(const std::vector<std::vector<size_t>>& edges)
+{
+  const size_t count = edges.size();
+  std::vector<size_t> order(count, kUnvisited);
+  std::vector<size_t> low(count, 0);
+  std::vector<bool> onStack(count, false);
+  std::vector<size_t> stack;
+  std::vector<std::pair<size_t, size_t>> callStack;  // Node, next edge to follow
+  std::vector<std::vector<size_t>> components;
+  size_t counter = 0;
+
+  auto visit = [&](size_t v) {
+    order[v] = low[v] = counter++;
+    stack.push_back(v);
+    onStack[v] = true;
+    callStack.emplace_back(v, 0);
+  };
+
+  for (size_t start = 0; start < count; ++start) {
+    if (order[start] != kUnvisited) {
+      continue;
+    }
+    visit(start);
+
+    while (!callStack.empty()) {
+      auto [v, next] = callStack.back();
+      if (next < edges[v].size()) {
+        callStack.back().second++;
+        size_t w = edges[v][next];
+        if (order[w] == kUnvisited) {
+          visit(w);
+        } else if (onStack[w]) {
+          low[v] = std::min(low[v], order[w]);
+        }
+        continue;
+      }
+
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        size_t parent = callStack.back().first;
+        low[parent]   = std::min(low[parent], low[v]);
+      }
+      if (low[v] == order[v]) {
+        std::vector<size_t> component;
+        size_t w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          onStack[w] = false;
+          component.push_back(w);
+        } while (w != v);
+        components.push_back(std::move(component));
+      }
+    }
+  }
+  return components;
+}
+
+// Fill cycles, region, downstream, neighborhood and reachableCount from nodes/index/expected/root
+void AnalyzeGraph(Analysis& analysis)
+{
+  const auto& nodes  = analysis.nodes;
+  const size_t count = nodes.size();
+
+  analysis.cycles.clear();
+  analysis.region.clear();
+  analysis.downstream.clear();
+  analysis.neighborhood.clear();
+
+  std::unordered_set<std::string> missing;
+  for (const auto& [formId, spell] : analysis.expected) {
+    if (!analysis.index.contains(formId)) {
+      missing.insert(formId);
+    }
+  }
+
+  // Prerequisite edges; a link to a spell outside the tree can never be satisfied
+  std::vector<std::vector<size_t>> edges(count);
+  std::vector<std::vector<size_t>> dependents(count);
+  std::vector<bool> dangling(count, false);  // Links to spells that do not exist at all
+  std::vector<bool> waitsForMissing(count, false);
+  for (size_t i = 0; i < count; ++i) {
+    for (const auto& prereq : nodes[i].prerequisites) {
+      if (auto it = analysis.index.find(prereq); it != analysis.index.end()) {
+        edges[i].push_back(it->second);
+        dependents[it->second].push_back(i);
+      } else if (missing.contains(prereq)) {
+        waitsForMissing[i] = true;
+      } else {
+        dangling[i] = true;
+      }
+    }
+  }
+
+  // Unlock simulation from the root - a spell unlocks once all its prerequisites have
+  std::vector<bool> reachable(count, false);
+  auto rootIt = analysis.index.find(analysis.root);
+  if (rootIt != analysis.index.end()) {
+    std::vector<size_t> remaining(count);
+    for (size_t i = 0; i < count; ++i) {
+      remaining[i] = edges[i].size() + (dangling[i] || waitsForMissing[i] ? 1 : 0);
+    }
+
+    std::vector<size_t> queue = {rootIt->second};
+    reachable[rootIt->second] = true;
+    for (size_t head = 0; head < queue.size(); ++head) {
+      for (size_t dependent : dependents[queue[head]]) {
+        if (!reachable[dependent] && --remaining[dependent] == 0) {
+          reachable[dependent] = true;
+          queue.push_back(dependent);
+        }
+      }
+    }
+  }
+  analysis.reachableCount = static_cast<size_t>(std::count(reachable.begin(), reachable.end(), true));
+
+  // Root causes: cycles, orphans and dangling links. Any other unreachable spell only
+  // waits on one of them (following its blocked prerequisites always ends in one).
+  std::vector<bool> inCycle(count, false);
+  for (auto& component : StronglyConnected(edges)) {
+    bool selfLoop = component.size() == 1 &&
+                    std::find(edges[component[0]].begin(), edges[component[0]].end(), component[0]) !=
+                        edges[component[0]].end();
+    if (component.size() < 2 && !selfLoop) {
+      continue;
+    }
+    std::vector<std::string> cycle;
+    for (size_t v : component) {
+      inCycle[v] = true;
+      cycle.push_back(nodes[v].formId);
+    }
+    analysis.cycles.push_back(std::move(cycle));
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    if (reachable[i]) {
+      continue;
+    }
+    const std::string& formId = nodes[i].formId;
+    if (inCycle[i]) {
+      analysis.region.push_back({formId, "cycle"});
+    } else if (dangling[i]) {
+      analysis.region.push_back({formId, "dangling"});
+    } else if (edges[i].empty() && !waitsForMissing[i]) {
+      analysis.region.push_back({formId, "orphan"});
+    } else {
+      analysis.downstream.push_back(formId);
+    }
+  }
+
+  // Sorted, so the same defects always produce the same prompt (and cache key)
+  std::vector<std::string> missingOrdered(missing.begin(), missing.end());
+  std::sort(missingOrdered.begin(), missingOrdered.end());
+  for (auto& formId : missingOrdered) {
+    analysis.region.push_back({std::move(formId), "missing"});
+  }
+
+  if (analysis.region.empty()) {
+    return;
+  }
+
+  // Neighborhood: the root, the reachable prerequisites the region already points at,
+  // then reachable spells closest in tier to the region
+  auto tierOf = [&](const std::string& formId) {
+    if (auto it = analysis.index.find(formId); it != analysis.index.end()) {
+      return nodes[it->second].tier;
+    }
+    auto spell = analysis.expected.find(formId);
+    return spell != analysis.expected.end() ? PromptBuilder::SpellTier(spell->second) : 1;
+  };
+
+  std::vector<int> regionTiers;
+  std::unordered_set<std::string> offered;
+  auto offer = [&](const std::string& formId) {
+    if (analysis.neighborhood.size() < kMaxNeighbors && offered.insert(formId).second) {
+      analysis.neighborhood.push_back(formId);
+    }
+  };
+
+  if (rootIt != analysis.index.end()) {
+    offer(analysis.root);
+  }
+  for (const auto& entry : analysis.region) {
+    regionTiers.push_back(tierOf(entry.formId));
+    if (auto it = analysis.index.find(entry.formId); it != analysis.index.end()) {
+      for (size_t prereq : edges[it->second]) {
+        if (reachable[prereq]) {
+          offer(nodes[prereq].formId);
+        }
+      }
+    }
+  }
+
+  int maxTier = *std::max_element(regionTiers.begin(), regionTiers.end());
+  std::vector<std::pair<int, size_t>> candidates;  // Tier distance, node
+  for (size_t i = 0; i < count; ++i) {
+    if (!reachable[i] || nodes[i].tier > maxTier) {
+      continue;
+    }
+    int distance = std::numeric_limits<int>::max();
+    for (int tier : regionTiers) {
+      if (tier >= nodes[i].tier) {
+        distance = std::min(distance, tier - nodes[i].tier);
+      }
+    }
+    candidates.emplace_back(distance, i);
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& [distance, i] : candidates) {
+    offer(nodes[i].formId);
+  }
+}
+
+// Table row "formId|name|tier" for the prompt
+std::string SpellRow(const Analysis& analysis, const std::string& formId)
+{
+  std::string name;
+  int tier = 1;
+  if (auto it = analysis.index.find(formId); it != analysis.index.end()) {
+    name = analysis.nodes[it->second].name;
+    tier = analysis.nodes[it->second].tier;
+  } else if (auto spell = analysis.expected.find(formId); spell != analysis.expected.end()) {
+    name = NameOf(spell->second);
+    tier = PromptBuilder::SpellTier(spell->second);
+  }
+  std::replace(name.begin(), name.end(), '|', '/');
+  return std::format("{}|{}|{}", formId, name, tier);
+}
+}  // namespace
+
+json Analysis::ToJson() const
+{
+  std::unordered_map<std::string, size_t> problems;
+  for (const auto& entry : region) {
+    problems[entry.problem]++;
+  }
+
+  json j;
+  j["nodes"]        = nodes.size();
+  j["reachable"]    = reachableCount;
+  j["region"]       = region.size();
+  j["cycles"]       = cycles.size();
+  j["cycleMembers"] = problems["cycle"];
+  j["orphans"]      = problems["orphan"];
+  j["dangling"]     = problems["dangling"];
+  j["missing"]      = problems["missing"];
+  j["downstream"]   = downstream.size();
+  j["neighborhood"] = neighborhood.size();
+  return j;
+}
+
+json SpliceResult::ToJson() const
+{
+  json j;
+  j["repaired"]    = repaired;
+  j["added"]       = added;
+  j["rejected"]    = rejected;
+  j["remaining"]   = remaining;
+  j["unreachable"] = unreachable;
+  return j;
+}
+
+bool Analyze(const std::string& school, const std::string& treeResponse, const std::string& spellData,
+             Analysis& analysis, std::string& error)
+{
+  analysis        = Analysis();
+  analysis.school = school;
+
+  auto parsed       = LLMOutputParser::RepairJson(treeResponse);
+  analysis.document = std::move(parsed.document);
+  if (!parsed.success || !analysis.document.is_object()) {
+    error = "Tree response is not valid JSON";
+    return false;
+  }
+  json* schoolData = FindSchool(analysis.document, school);
+  if (!schoolData || !schoolData->is_object() || !schoolData->contains("nodes") ||
+      !(*schoolData)["nodes"].is_array()) {
+    error = "Tree response has no nodes for " + school;
+    return false;
+  }
+
+  if (!spellData.empty()) {
+    json spells = json::parse(spellData, nullptr, false);
+    if (spells.is_array()) {
+      for (auto& spell : spells) {
+        if (std::string formId = spell.is_object() ? FormIdOf(spell.value("formId", json())) : std::string();
+            !formId.empty()) {
+          analysis.expected[formId] = std::move(spell);
+        }
+      }
+    }
+  }
+
+  for (const auto& node : (*schoolData)["nodes"]) {
+    std::string formId = node.is_object() ? FormIdOf(node.value("formId", json())) : std::string();
+    if (formId.empty() || analysis.index.contains(formId)) {
+      continue;  // Duplicates keep their first occurrence
+    }
+
+    TreeNode treeNode;
+    treeNode.formId = formId;
+    treeNode.data   = node;
+
+    auto spell    = analysis.expected.find(formId);
+    treeNode.name = spell != analysis.expected.end() ? NameOf(spell->second) : NameOf(node);
+    if (auto tier = node.find("tier"); tier != node.end() && tier->is_number_integer()) {
+      treeNode.tier = tier->get<int>();
+    } else {
+      treeNode.tier = spell != analysis.expected.end() ? PromptBuilder::SpellTier(spell->second) : 1;
+    }
+    if (auto prereqs = node.find("prerequisites"); prereqs != node.end() && prereqs->is_array()) {
+      for (const auto& prereq : *prereqs) {
+        AddUnique(treeNode.prerequisites, FormIdOf(prereq));
+      }
+    }
+
+    analysis.index[formId] = analysis.nodes.size();
+    analysis.nodes.push_back(std::move(treeNode));
+  }
+
+  // Children lists are prerequisite links too (TreeParser reads both directions)
+  for (const auto& node : analysis.nodes) {
+    if (auto children = node.data.find("children"); children != node.data.end() && children->is_array()) {
+      for (const auto& child : *children) {
+        if (auto it = analysis.index.find(FormIdOf(child)); it != analysis.index.end()) {
+          AddUnique(analysis.nodes[it->second].prerequisites, node.formId);
+        }
+      }
+    }
+  }
+
+  analysis.root = FormIdOf(schoolData->value("root", json()));
+  if (!analysis.index.contains(analysis.root)) {
+    auto first = std::find_if(analysis.nodes.begin(), analysis.nodes.end(),
+                              [](const TreeNode& node) { return node.prerequisites.empty(); });
+    if (first == analysis.nodes.end()) {
+      error = "Tree for " + school + " has no root";
+      return false;
+    }
+    analysis.root = first->formId;
+  }
+  // The root is unlocked from the start, whatever it lists
+  analysis.nodes[analysis.index[analysis.root]].prerequisites.clear();
+
+  AnalyzeGraph(analysis);
+  return true;
+}
+
+const char* GetSystemPrompt()
+{
+  return "You are a Skyrim spell tree architect repairing part of an existing spell learning tree. "
+         "Change only the spells you are asked to repair. Respond only with valid JSON - no explanations, "
+         "no markdown code blocks.";
+}
+
+std::string BuildRepairPrompt(const Analysis& analysis, const std::string& promptRules)
+{
+  std::string prompt = std::format("Repair part of the {} spell learning tree. The rest of the tree ({} spells) is "
+                                   "correct and stays unchanged.\n\n",
+                                   analysis.school, analysis.reachableCount);
+
+  prompt += "## SPELLS TO REPAIR\nformId|name|tier|problem|current prerequisites\n";
+  for (const auto& entry : analysis.region) {
+    std::string current;
+    if (auto it = analysis.index.find(entry.formId); it != analysis.index.end()) {
+      for (const auto& prereq : analysis.nodes[it->second].prerequisites) {
+        current += (current.empty() ? "" : ",") + prereq;
+      }
+    }
+    prompt += std::format("{}|{}|{}\n", SpellRow(analysis, entry.formId), entry.problem, current);
+  }
+  prompt += "\nProblems: cycle = part of a circular prerequisite chain, orphan = has no prerequisites, "
+            "dangling = a prerequisite is not in the tree, missing = not in the tree yet.\n\n";
+
+  prompt += "## AVAILABLE PREREQUISITES (already reachable from the root)\nformId|name|tier\n";
+  for (const auto& formId : analysis.neighborhood) {
+    prompt += SpellRow(analysis, formId) + "\n";
+  }
+
+  prompt += "\n## RULES\n"
+            "1. Give every spell to repair its complete new list of prerequisites (1-2 spells).\n"
+            "2. Prerequisites must come from AVAILABLE PREREQUISITES, or be other SPELLS TO REPAIR of a lower "
+            "tier.\n"
+            "3. Prefer prerequisites of the same or the previous tier with a related theme.\n"
+            "4. No prerequisite cycles.\n";
+  if (!promptRules.empty()) {
+    prompt += "\n## USER RULES\n" + promptRules + "\n";
+  }
+
+  prompt += "\n## OUTPUT\nReturn ONLY this JSON, one entry per spell to repair:\n"
+            "{\"nodes\": [{\"formId\": \"0xFORMID\", \"prerequisites\": [\"0xFORMID\"]}]}\n";
+  return prompt;
+}
+
+SpliceResult Splice(const Analysis& analysis, const std::string& repairResponse)
+{
+  SpliceResult result;
+
+  auto parsed   = LLMOutputParser::RepairJson(repairResponse);
+  json response = std::move(parsed.document);
+  if (!parsed.success || !response.is_object()) {
+    result.error = "Repair response is not valid JSON";
+    return result;
+  }
+  // Answered in the full tree format now and then - take its nodes
+  const json* returned = nullptr;
+  if (auto it = response.find("nodes"); it != response.end() && it->is_array()) {
+    returned = &*it;
+  } else if (json* schoolData = FindSchool(response, analysis.school);
+             schoolData && schoolData->is_object() && schoolData->contains("nodes")) {
+    returned = &(*schoolData)["nodes"];
+  }
+  if (!returned || !returned->is_array()) {
+    result.error = "Repair response has no nodes";
+    return result;
+  }
+
+  std::unordered_map<std::string, std::string> region;  // formId -> problem
+  for (const auto& entry : analysis.region) {
+    region[entry.formId] = entry.problem;
+  }
+  std::unordered_set<std::string> downstream(analysis.downstream.begin(), analysis.downstream.end());
+
+  Analysis spliced;
+  spliced.school   = analysis.school;
+  spliced.root     = analysis.root;
+  spliced.nodes    = analysis.nodes;
+  spliced.index    = analysis.index;
+  spliced.expected = analysis.expected;
+
+  for (const auto& node : *returned) {
+    std::string formId = node.is_object() ? FormIdOf(node.value("formId", json())) : std::string();
+    if (!region.contains(formId) || !node.contains("prerequisites") || !node["prerequisites"].is_array()) {
+      continue;  // Only the region may change
+    }
+
+    // Spells waiting on the region would only close a new cycle
+    std::vector<std::string> prerequisites;
+    for (const auto& prereq : node["prerequisites"]) {
+      std::string id = FormIdOf(prereq);
+      bool known     = analysis.index.contains(id) || region.contains(id);
+      if (known && id != formId && !downstream.contains(id)) {
+        AddUnique(prerequisites, std::move(id));
+      } else {
+        result.rejected++;
+      }
+    }
+    if (prerequisites.empty()) {
+      continue;
+    }
+
+    if (auto it = spliced.index.find(formId); it != spliced.index.end()) {
+      spliced.nodes[it->second].prerequisites = std::move(prerequisites);
+      result.repaired++;
+      continue;
+    }
+
+    const json& spell = analysis.expected.at(formId);
+    TreeNode added;
+    added.formId        = formId;
+    added.name          = NameOf(spell);
+    added.tier          = PromptBuilder::SpellTier(spell);
+    added.prerequisites = std::move(prerequisites);
+    added.data          = {{"formId", formId}, {"tier", added.tier}};
+    spliced.index[formId] = spliced.nodes.size();
+    spliced.nodes.push_back(std::move(added));
+    result.added++;
+  }
+
+  // Children are rebuilt from prerequisites so both directions agree
+  std::unordered_map<std::string, std::vector<std::string>> children;
+  for (const auto& node : spliced.nodes) {
+    for (const auto& prereq : node.prerequisites) {
+      children[prereq].push_back(node.formId);
+    }
+  }
+
+  json nodeArray = json::array();
+  for (const auto& node : spliced.nodes) {
+    json data             = node.data;
+    data["formId"]        = node.formId;
+    data["prerequisites"] = node.prerequisites;
+    data["children"]      = children[node.formId];
+    if (!data.contains("tier")) {
+      data["tier"] = node.tier;
+    }
+    nodeArray.push_back(std::move(data));
+  }
+
+  json document    = analysis.document;
+  json* schoolData = FindSchool(document, analysis.school);
+  (*schoolData)["root"]  = analysis.root;
+  (*schoolData)["nodes"] = std::move(nodeArray);
+
+  AnalyzeGraph(spliced);
+  result.remaining   = spliced.region.size();
+  result.unreachable = spliced.nodes.size() - spliced.reachableCount;
+  result.tree        = document.dump();
+  result.success     = true;
+  return result;
+}
+}  // namespace TreeRepair
@@ -0,0 +1,122 @@
+#include "TreeStreamParser.h"
+
+namespace
+{
+// Member names longer than this are not ours to track ("nodes", school names)
+constexpr size_t kMaxKeyLength = 256;
+}
+
+void TreeStreamParser::Feed(std::string_view text, std::vector<Node>& completed)
+{
+  for (char c : text) {
+    if (!m_started) {
+      if (c != '{')
+        continue;
+      m_started = true;
+    }
+
+    bool capturing = !m_capture.empty() || InNodeObject();
+
+    if (m_inString) {
+      if (capturing) {
+        m_capture.push_back(c);
+      }
+      if (m_escape) {
+        m_escape = false;
+        if (m_stringIsKey && m_string.size() < kMaxKeyLength) {
+          m_string.push_back(c);
+        }
+      } else if (c == '\\') {
+        m_escape = true;
+      } else if (c == '"') {
+        m_inString = false;
+        if (m_stringIsKey) {
+          m_pendingKey = std::move(m_string);
+          m_string.clear();
+          m_stack.back().expectingKey = false;
+        }
+      } else if (m_stringIsKey && m_string.size() < kMaxKeyLength) {
+        m_string.push_back(c);
+      }
+      continue;
+    }
+
+    switch (c) {
+    case '"':
+      m_inString    = true;
+      m_escape      = false;
+      m_stringIsKey = !m_stack.empty() && m_stack.back().isObject && m_stack.back().expectingKey;
+      m_string.clear();
+      break;
+    case '{':
+    case '[':
+      OnContainerOpen(c == '{');
+      break;
+    case '}':
+    case ']':
+      if (!m_capture.empty()) {
+        m_capture.push_back(c);
+      }
+      OnContainerClose(completed);
+      continue;
+    case ',':
+      if (!m_stack.empty() && m_stack.back().isObject) {
+        m_stack.back().expectingKey = true;
+        m_pendingKey.clear();
+      }
+      break;
+    default:
+      break;
+    }
+
+    if (!m_capture.empty() || InNodeObject()) {
+      m_capture.push_back(c);
+    }
+  }
+}
+
+void TreeStreamParser::OnContainerOpen(bool isObject)
+{
+  Frame frame;
+  frame.isObject     = isObject;
+  frame.expectingKey = isObject;
+  // Array elements inherit the array's key, members take their own name
+  if (!m_stack.empty()) {
+    frame.key = m_stack.back().isObject ? std::move(m_pendingKey) : m_stack.back().key;
+  }
+  m_pendingKey.clear();
+  m_stack.push_back(std::move(frame));
+}
+
+void TreeStreamParser::OnContainerClose(std::vector<Node>& completed)
+{
+  if (m_stack.empty()) {
+    return;
+  }
+
+  bool wasNode = InNodeObject();
+  m_stack.pop_back();
+
+  if (!wasNode) {
+    return;
+  }
+
+  // Stack is now [..., school object, nodes array]
+  std::string school = m_stack.size() >= 2 ? m_stack[m_stack.size() - 2].key : std::string();
+
+  json data = json::parse(m_capture, nullptr, false);
+  m_capture.clear();
+  if (data.is_discarded() || !data.is_object()) {
+    return;
+  }
+
+  m_nodeCount++;
+  completed.push_back({std::move(school), std::move(data)});
+}
+
+bool TreeStreamParser::InNodeObject() const
+{
+  size_t depth = m_stack.size();
+  return depth >= 2 && m_stack[depth - 1].isObject && !m_stack[depth - 2].isObject &&
+         m_stack[depth - 2].key == "nodes";
+}
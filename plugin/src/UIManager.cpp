@@ -1,13 +1,32 @@
 #include "UIManager.h"
+#include "AsyncFileWriter.h"
+#include "ConfigWatcher.h"
+#include "Coroutine.h"
+#include "HookStats.h"
 #include "ISLIntegration.h"
+#include "JsonWriter.h"
+#include "Logging.h"
+#include "LLMOutputParser.h"
+#include "LLMResponseCache.h"
+#include "LLMScheduler.h"
+#include "Metrics.h"
 #include "OpenRouterAPI.h"
 #include "PCH.h"
 #include "PapyrusAPI.h"
+#include "PromptBuilder.h"
+#include "TreeRepair.h"
+#include "ProcessRunner.h"
 #include "ProgressionManager.h"
 #include "SpellCastHandler.h"
 #include "SpellEffectivenessHook.h"
 #include "SpellScanner.h"
 #include "SpellTomeHook.h"
+#include "ThreadPool.h"
+#include "TreeBuilder.h"
+#include "TreeStreamParser.h"
+#include "Trace.h"
+
+#include <optional>
 
 // =============================================================================
 // JSON HELPER - Safe value accessor that handles null values
@@ -28,6 +47,295 @@ T SafeJsonValue(const nlohmann::json& j, const std::string& key, const T& defaul
   return defaultValue;
 }
 
+// =============================================================================
+// INTEROP - every message to the panel goes through here to be counted
+// =============================================================================
+
+static void SendToView(PRISMA_UI_API::IVPrismaUI1* api, PrismaView view, const char* function, const char* payload)
+{
+  Metrics::Labels labels{{"function", function}};
+  Metrics::GetCounter("spelllearning_interop_calls", "Interop calls to the panel by JS function", labels).Add();
+  Metrics::GetCounter("spelllearning_interop_bytes", "Interop payload bytes sent to the panel by JS function", labels)
+      .Add(strlen(payload));
+  api->InteropCall(view, function, payload);
+}
+
+// =============================================================================
+// LLM STREAMING - forwards tree nodes to the panel while the response streams
+// =============================================================================
+
+namespace
+{
+constexpr size_t kStreamBatchSize   = 16;
+constexpr auto kStreamBatchInterval = 250ms;
+
+class LLMNodeStream
+{
+public:
+  explicit LLMNodeStream(std::string school) : m_school(std::move(school)) {}
+
+  // Worker thread - every streamed piece of the response
+  void Feed(std::string_view delta)
+  {
+    std::vector<TreeStreamParser::Node> completed;
+    m_parser.Feed(delta, completed);
+    if (completed.empty())
+      return;
+
+    std::string payload;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto& node : completed) {
+        m_pending.push_back(std::move(node));
+      }
+
+      // First nodes go out right away, then in batches
+      auto now = std::chrono::steady_clock::now();
+      if (m_sent == 0 || m_pending.size() >= kStreamBatchSize || now - m_lastSend >= kStreamBatchInterval) {
+        payload    = TakePayloadLocked();
+        m_lastSend = now;
+      }
+    }
+
+    if (!payload.empty()) {
+      SKSE::GetTaskInterface()->AddTask([payload = std::move(payload)]() {
+        auto* instance = UIManager::GetSingleton();
+        if (instance->GetAPI() && instance->GetAPI()->IsValid(instance->GetView())) {
+          SendToView(instance->GetAPI(), instance->GetView(), "onLLMStreamNodes", payload.c_str());
+        }
+      });
+    }
+  }
+
+  // Nodes that have not been sent yet - empty if none
+  std::string TakePayload()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.empty() ? std::string() : TakePayloadLocked();
+  }
+
+private:
+  std::string TakePayloadLocked()
+  {
+    json nodes = json::array();
+    for (auto& node : m_pending) {
+      nodes.push_back(std::move(node.data));
+    }
+
+    json payload;
+    payload["school"]   = m_school.empty() ? m_pending.front().school : m_school;
+    payload["nodes"]    = std::move(nodes);
+    payload["received"] = m_parser.NodeCount();
+
+    m_sent += m_pending.size();
+    m_pending.clear();
+    return payload.dump();
+  }
+
+  std::string m_school;
+  TreeStreamParser m_parser;  // Worker thread only
+  std::mutex m_mutex;
+  std::vector<TreeStreamParser::Node> m_pending;
+  size_t m_sent = 0;
+  std::chrono::steady_clock::time_point m_lastSend;
+};
+
+// One LLMGenerate call - a single prompt, the parts of a school split by PromptBuilder,
+// or a TreeRepair request. The panel receives one onLLMPollResult once every part has completed.
+class LLMGeneration
+{
+public:
+  LLMGeneration(std::string school, std::shared_ptr<const PromptBuilder::Plan> plan,
+                std::shared_ptr<const TreeRepair::Analysis> repair, bool treeResponse, size_t partCount) :
+      m_school(std::move(school)),
+      m_plan(std::move(plan)),
+      m_repair(std::move(repair)),
+      m_treeResponse(treeResponse),
+      m_responses(partCount),
+      m_pending(partCount)
+  {
+  }
+
+  // Game thread - called exactly once per part
+  void OnPartComplete(size_t part, const OpenRouterAPI::Response& response, const json& metrics)
+  {
+    if (response.success) {
+      m_responses[part] = response.content;
+    } else if (m_error.empty()) {
+      m_error = response.error;
+    }
+    m_cancelled = m_cancelled || response.cancelled;
+    AddMetrics(metrics);
+
+    if (--m_pending == 0) {
+      Deliver();
+    }
+  }
+
+private:
+  // Parts run in parallel: wall time is the slowest part, tokens and attempts add up
+  void AddMetrics(const json& metrics)
+  {
+    if (m_metrics.is_null()) {
+      m_metrics = metrics;
+      return;
+    }
+    for (const char* key : {"queuedMs", "totalMs"}) {
+      m_metrics[key] = std::max(m_metrics.value(key, int64_t{0}), metrics.value(key, int64_t{0}));
+    }
+    for (const char* key : {"attempts", "promptTokens", "completionTokens", "liveMs"}) {
+      m_metrics[key] = m_metrics.value(key, int64_t{0}) + metrics.value(key, int64_t{0});
+    }
+    int64_t firstToken = metrics.value("firstTokenMs", int64_t{-1});
+    int64_t current    = m_metrics.value("firstTokenMs", int64_t{-1});
+    if (firstToken >= 0 && (current < 0 || firstToken < current)) {
+      m_metrics["firstTokenMs"] = firstToken;
+    }
+    m_metrics["cached"] = m_metrics.value("cached", false) && metrics.value("cached", false);
+    m_metrics["tag"]    = m_school;
+  }
+
+  // Tree responses are repaired before delivery. A single response is normalized against the
+  // scanned spells; parts only get their syntax fixed since they link to spells of other parts
+  // and MergeParts validates the combined tree.
+  json ParseResponses()
+  {
+    json defects = json::array();
+    if (m_responses.size() == 1) {
+      std::unordered_set<std::string> known;
+      if (m_plan) {
+        known.reserve(m_plan->tiers.size());
+        for (const auto& [formId, tier] : m_plan->tiers) {
+          known.insert(formId);
+        }
+      }
+
+      auto parsed = LLMOutputParser::ParseTree(m_responses.front(), m_school, m_plan ? &known : nullptr);
+      if (parsed.success) {
+        m_responses.front() = parsed.document.dump();
+        defects             = parsed.defects;
+      } else {
+        defects.push_back("Not parsed: " + parsed.error);
+      }
+    } else {
+      for (size_t part = 0; part < m_responses.size(); ++part) {
+        auto parsed = LLMOutputParser::RepairJson(m_responses[part]);
+        if (!parsed.success) {
+          continue;  // Reported by MergeParts
+        }
+        m_responses[part] = parsed.document.dump();
+        for (const auto& defect : parsed.defects) {
+          defects.push_back(std::format("Part {}: {}", part + 1, defect));
+        }
+      }
+    }
+
+    for (const auto& defect : defects) {
+      SL_LOG_INFO(LLM, "UIManager: {} response - {}", m_school, defect.get<std::string>());
+    }
+    return defects;
+  }
+
+  void Deliver()
+  {
+    json result;
+    result["hasResponse"] = true;
+    result["school"]      = m_school;
+    result["cancelled"]   = m_cancelled;
+    result["metrics"]     = std::move(m_metrics);
+    result["success"]     = 0;
+
+    if (m_responses.size() > 1) {
+      result["parts"] = m_responses.size();
+    }
+    if (m_treeResponse && !m_repair && m_error.empty() && !m_cancelled) {
+      result["defects"] = ParseResponses();
+    }
+
+    if (!m_error.empty() || m_cancelled) {
+      result["response"] = m_error.empty() ? std::string("Request cancelled") : m_error;
+      logger::error("UIManager: OpenRouter error for {}: {}", m_school, result["response"].get<std::string>());
+    } else if (m_repair) {
+      // Splice the repaired region back into the full tree
+      auto spliced     = TreeRepair::Splice(*m_repair, m_responses.front());
+      result["repair"] = m_repair->ToJson();
+      if (spliced.success) {
+        result["success"]  = 1;
+        result["response"] = std::move(spliced.tree);
+        result["repair"].update(spliced.ToJson());
+        logger::info("UIManager: Repaired {} - {} spell(s) relinked, {} added, {} link(s) rejected, {} defect(s) left",
+                     m_school, spliced.repaired, spliced.added, spliced.rejected, spliced.remaining);
+      } else {
+        result["response"] = "Repair failed: " + spliced.error;
+        logger::error("UIManager: {} - {}", m_school, result["response"].get<std::string>());
+      }
+    } else if (m_responses.size() == 1) {
+      result["success"]  = 1;
+      result["response"] = std::move(m_responses.front());
+      logger::info("UIManager: OpenRouter success for {}, response length: {}", m_school,
+                   result["response"].get<std::string>().length());
+    } else {
+      auto merged = PromptBuilder::MergeParts(*m_plan, m_responses);
+      if (merged.success) {
+        result["success"]     = 1;
+        result["response"]    = std::move(merged.tree);
+        result["mergeIssues"] = merged.issues;
+        logger::info("UIManager: Merged {} parts for {} - {} nodes", m_responses.size(), m_school, merged.nodeCount);
+        for (const auto& issue : merged.issues) {
+          SL_LOG_INFO(LLM, "UIManager:   {}", issue);
+        }
+      } else {
+        result["response"] = "Merging " + std::to_string(m_responses.size()) + " parts failed: " + merged.error;
+        logger::error("UIManager: {} - {}", m_school, result["response"].get<std::string>());
+      }
+    }
+
+    auto* instance = UIManager::GetSingleton();
+    if (instance->GetAPI() && instance->GetAPI()->IsValid(instance->GetView())) {
+      SendToView(instance->GetAPI(), instance->GetView(), "onLLMPollResult", result.dump().c_str());
+    }
+  }
+
+  std::string m_school;
+  std::shared_ptr<const PromptBuilder::Plan> m_plan;      // Null unless the spell data was planned
+  std::shared_ptr<const TreeRepair::Analysis> m_repair;  // Null unless this is a repair request
+  bool m_treeResponse;                                   // False for color suggestions
+  std::vector<std::string> m_responses;
+  size_t m_pending;
+  std::string m_error;
+  bool m_cancelled = false;
+  json m_metrics;
+};
+
+// Racing: a contender only wins with a JSON answer in the shape the request asked for
+bool IsUsableResponse(const std::string& content, const std::string& school, bool treeResponse, bool repairResponse)
+{
+  json doc = json::parse(PromptBuilder::JsonBody(content), nullptr, false);
+  if (doc.is_discarded() || !doc.is_object()) {
+    return false;
+  }
+  if (repairResponse && doc.contains("nodes")) {
+    return doc["nodes"].is_array() && !doc["nodes"].empty();
+  }
+  if (!treeResponse && !repairResponse) {
+    return true;
+  }
+
+  auto schools = doc.find("schools");
+  if (schools == doc.end() || !schools->is_object() || schools->empty()) {
+    return false;
+  }
+  auto schoolIt = schools->contains(school) ? schools->find(school) : schools->begin();
+  if (!schoolIt->is_object() || !schoolIt->contains("nodes") || !(*schoolIt)["nodes"].is_array()) {
+    return false;
+  }
+  const json& nodes = (*schoolIt)["nodes"];
+  return !nodes.empty() && std::all_of(nodes.begin(), nodes.end(), [](const json& node) {
+    return node.is_object() && node.contains("formId") && node["formId"].is_string();
+  });
+}
+}  // namespace
+
 // =============================================================================
 // SINGLETON
 // =============================================================================
@@ -118,6 +426,9 @@ bool UIManager::Initialize()
   m_prismaUI->RegisterJSListener(m_view, "SaveUnifiedConfig", OnSaveUnifiedConfig);
   m_prismaUI->RegisterJSListener(m_view, "SetHotkey", OnSetHotkey);
   m_prismaUI->RegisterJSListener(m_view, "SetPauseGameOnFocus", OnSetPauseGameOnFocus);
+  m_prismaUI->RegisterJSListener(m_view, "SetLogLevels", OnSetLogLevels);
+  m_prismaUI->RegisterJSListener(m_view, "SetTraceRecording", OnSetTraceRecording);
+  m_prismaUI->RegisterJSListener(m_view, "GetHookStats", OnGetHookStats);
 
   // Register JS callbacks - Clipboard
   m_prismaUI->RegisterJSListener(m_view, "CopyToClipboard", OnCopyToClipboard);
@@ -133,6 +444,7 @@ bool UIManager::Initialize()
 
   // Register JS callbacks - Procedural tree generation (Python)
   m_prismaUI->RegisterJSListener(m_view, "ProceduralPythonGenerate", OnProceduralPythonGenerate);
+  m_prismaUI->RegisterJSListener(m_view, "ProceduralPythonCancel", OnProceduralPythonCancel);
 
   // Register JS callbacks - Panel control
   m_prismaUI->RegisterJSListener(m_view, "HidePanel", OnHidePanel);
@@ -162,6 +474,8 @@ void UIManager::TogglePanel()
 
 void UIManager::ShowPanel()
 {
+  SL_TRACE_SCOPE("UIManager::ShowPanel");
+
   if (!m_prismaUI || !m_prismaUI->IsValid(m_view)) {
     logger::warn("UIManager: Cannot show panel - not initialized");
     return;
@@ -266,7 +580,7 @@ void UIManager::ShowPanel()
   });
 
   // Notify JS that panel is now visible - triggers refresh of known spells
-  m_prismaUI->InteropCall(m_view, "onPanelShowing", "");
+  SendToView(m_prismaUI, m_view, "onPanelShowing", "");
 
   // Check if Python addon is installed (SpellTreeBuilder) and notify JS
   CheckPythonAddonStatus();
@@ -280,20 +594,14 @@ void UIManager::CheckPythonAddonStatus()
   if (!m_prismaUI || !m_prismaUI->IsValid(m_view))
     return;
 
-  // Check if build_tree.py exists in the expected location
-  std::string pythonScript = "Data/SKSE/Plugins/SpellLearning/SpellTreeBuilder/build_tree.py";
-  bool installed           = std::filesystem::exists(pythonScript);
-
-  // Also check dev location as fallback
-  if (!installed) {
-    installed = std::filesystem::exists("SpellTreeBuilder/build_tree.py");
-  }
+  // Check if build_tree.py exists (game Data folder or dev location)
+  bool installed = !FindPythonTreeBuilder().empty();
 
   logger::info("UIManager: Python addon (SpellTreeBuilder) installed: {}", installed);
 
   // Send status to JS
   std::string status = installed ? "true" : "false";
-  m_prismaUI->InteropCall(m_view, "onPythonAddonStatus", status.c_str());
+  SendToView(m_prismaUI, m_view, "onPythonAddonStatus", status.c_str());
 }
 
 // Helper to schedule focus retries with exponential backoff
@@ -367,6 +675,12 @@ void UIManager::HidePanel()
   m_isPanelVisible = false;
   m_hasFocus       = false;
 
+  // Pending LLM generations are not worth finishing with the panel closed
+  LLMScheduler::GetSingleton()->CancelAll();
+
+  // Settings and tree saves from this session go to disk now rather than after the debounce window
+  AsyncFileWriter::GetSingleton()->Expedite();
+
   // Unfocus and hide immediately - PrismaUI handles the input release
   m_prismaUI->Unfocus(m_view);
   m_prismaUI->Hide(m_view);
@@ -378,7 +692,7 @@ void UIManager::HidePanel()
   m_prismaUI->SetOrder(m_view, 0);
 
   // Notify JS AFTER unfocus is complete (non-blocking)
-  m_prismaUI->InteropCall(m_view, "onPanelHiding", "");
+  SendToView(m_prismaUI, m_view, "onPanelHiding", "");
 
   // Send ModEvent for other mods listening
   PapyrusAPI::SendMenuClosedEvent();
@@ -457,7 +771,7 @@ void UIManager::SendSpellData(const std::string& jsonData)
   }
 
   logger::info("UIManager: Sending spell data to UI ({} bytes)", jsonData.size());
-  m_prismaUI->InteropCall(m_view, "updateSpellData", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "updateSpellData", jsonData.c_str());
 }
 
 void UIManager::UpdateStatus(const std::string& message)
@@ -467,7 +781,7 @@ void UIManager::UpdateStatus(const std::string& message)
   }
 
   json statusJson = message;
-  m_prismaUI->InteropCall(m_view, "updateStatus", statusJson.dump().c_str());
+  SendToView(m_prismaUI, m_view, "updateStatus", statusJson.dump().c_str());
 }
 
 void UIManager::SendPrompt(const std::string& promptContent)
@@ -478,7 +792,7 @@ void UIManager::SendPrompt(const std::string& promptContent)
   }
 
   logger::info("UIManager: Sending prompt to UI ({} bytes)", promptContent.size());
-  m_prismaUI->InteropCall(m_view, "updatePrompt", promptContent.c_str());
+  SendToView(m_prismaUI, m_view, "updatePrompt", promptContent.c_str());
 }
 
 void UIManager::NotifyPromptSaved(bool success)
@@ -488,7 +802,7 @@ void UIManager::NotifyPromptSaved(bool success)
   }
 
   std::string result = success ? "true" : "false";
-  m_prismaUI->InteropCall(m_view, "onPromptSaved", result.c_str());
+  SendToView(m_prismaUI, m_view, "onPromptSaved", result.c_str());
 }
 
 // =============================================================================
@@ -503,7 +817,7 @@ void UIManager::SendTreeData(const std::string& jsonData)
   }
 
   logger::info("UIManager: Sending tree data to UI ({} bytes)", jsonData.size());
-  m_prismaUI->InteropCall(m_view, "updateTreeData", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "updateTreeData", jsonData.c_str());
 }
 
 void UIManager::SendSpellInfo(const std::string& jsonData)
@@ -513,7 +827,7 @@ void UIManager::SendSpellInfo(const std::string& jsonData)
     return;
   }
 
-  m_prismaUI->InteropCall(m_view, "updateSpellInfo", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "updateSpellInfo", jsonData.c_str());
 }
 
 void UIManager::SendSpellInfoBatch(const std::string& jsonData)
@@ -524,7 +838,7 @@ void UIManager::SendSpellInfoBatch(const std::string& jsonData)
   }
 
   logger::info("UIManager: Sending batch spell info to UI ({} bytes)", jsonData.size());
-  m_prismaUI->InteropCall(m_view, "updateSpellInfoBatch", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "updateSpellInfoBatch", jsonData.c_str());
 }
 
 void UIManager::SendValidationResult(const std::string& jsonData)
@@ -535,7 +849,7 @@ void UIManager::SendValidationResult(const std::string& jsonData)
   }
 
   logger::info("UIManager: Sending tree validation result to UI");
-  m_prismaUI->InteropCall(m_view, "updateValidationResult", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "updateValidationResult", jsonData.c_str());
 }
 
 void UIManager::UpdateSpellState(const std::string& formId, const std::string& state)
@@ -548,7 +862,7 @@ void UIManager::UpdateSpellState(const std::string& formId, const std::string& s
   json stateData;
   stateData["formId"] = formId;
   stateData["state"]  = state;
-  m_prismaUI->InteropCall(m_view, "updateSpellState", stateData.dump().c_str());
+  SendToView(m_prismaUI, m_view, "updateSpellState", stateData.dump().c_str());
 }
 
 void UIManager::UpdateTreeStatus(const std::string& message)
@@ -558,7 +872,7 @@ void UIManager::UpdateTreeStatus(const std::string& message)
   }
 
   json statusJson = message;
-  m_prismaUI->InteropCall(m_view, "updateTreeStatus", statusJson.dump().c_str());
+  SendToView(m_prismaUI, m_view, "updateTreeStatus", statusJson.dump().c_str());
 }
 
 // =============================================================================
@@ -596,13 +910,49 @@ void UIManager::OnDomReady(PrismaView view)
   instance->m_prismaUI->Invoke(view, setupScript, nullptr);
 
   // Notify JS that we're ready
-  instance->m_prismaUI->InteropCall(view, "onPrismaReady", "");
+  SendToView(instance->m_prismaUI, view, "onPrismaReady", "");
 }
 
 // =============================================================================
 // SCANNER TAB CALLBACKS
 // =============================================================================
 
+namespace
+{
+// Both scans share the scan cache file, so a second click waits for the first
+std::atomic<bool> s_scanRunning{false};
+
+// Form data is read-only by now, so the scan runs on the thread pool while the game keeps rendering
+Coroutine::Task ScanSpells(SpellScanner::ScanConfig scanConfig, bool useTomeMode)
+{
+  co_await Coroutine::OnWorker(ThreadPool::Priority::High);
+
+  std::string payload;
+  try {
+    SpellScanner::ScanResult scan =
+        useTomeMode ? SpellScanner::ScanSpellTomeRecords(scanConfig) : SpellScanner::ScanSpellRecords(scanConfig);
+
+    // Stream the records straight into the UI payload and the output file - no json DOM in between.
+    // The panel re-indents the payload itself, so it is sent compact.
+    JsonWriter writer(payload);
+    SpellScanner::WriteScanOutput(writer, scan, scanConfig);
+    SpellScanner::SaveScanOutput(scan, scanConfig, SpellScanner::GetScanOutputPath());
+  } catch (const std::exception& e) {
+    logger::error("UIManager: Spell scan failed: {}", e.what());
+    payload.clear();
+  }
+  s_scanRunning = false;
+
+  // Send result back to UI
+  co_await Coroutine::OnGameThread();
+  if (payload.empty()) {
+    UIManager::GetSingleton()->UpdateStatus("Scan failed");
+  } else {
+    UIManager::GetSingleton()->SendSpellData(payload);
+  }
+}
+}  // namespace
+
 void UIManager::OnScanSpells(const char* argument)
 {
   logger::info("UIManager: ScanSpells callback triggered");
@@ -627,19 +977,20 @@ void UIManager::OnScanSpells(const char* argument)
     }
   }
 
-  std::string result;
+  if (s_scanRunning.exchange(true)) {
+    instance->UpdateStatus("Scan already running...");
+    return;
+  }
+
   if (useTomeMode) {
     instance->UpdateStatus("Scanning spell tomes...");
     scanConfig.fields.castingType = true;
     scanConfig.fields.plugin      = true;
-    result                        = SpellScanner::ScanSpellTomes(scanConfig);
   } else {
     instance->UpdateStatus("Scanning all spells...");
-    result = SpellScanner::ScanAllSpells(scanConfig);
   }
 
-  // Send result back to UI
-  instance->SendSpellData(result);
+  ScanSpells(std::move(scanConfig), useTomeMode);
 }
 
 void UIManager::OnSaveOutput(const char* argument)
@@ -651,30 +1002,16 @@ void UIManager::OnSaveOutput(const char* argument)
     return;
   }
 
-  auto* instance = GetSingleton();
-
-  // Create output directory
-  std::filesystem::path outputDir = "Data/SKSE/Plugins/SpellLearning";
-  std::filesystem::create_directories(outputDir);
+  std::filesystem::path outputPath = "Data/SKSE/Plugins/SpellLearning/spell_scan_output.json";
 
-  // Write to file
-  std::filesystem::path outputPath = outputDir / "spell_scan_output.json";
-
-  try {
-    std::ofstream file(outputPath);
-    if (file.is_open()) {
-      file << argument;
-      file.close();
+  AsyncFileWriter::GetSingleton()->Write(outputPath, argument, [outputPath](bool success) {
+    if (success) {
       logger::info("UIManager: Saved output to {}", outputPath.string());
-      instance->UpdateStatus("Saved to spell_scan_output.json");
+      GetSingleton()->UpdateStatus("Saved to spell_scan_output.json");
     } else {
-      logger::error("UIManager: Failed to open output file");
-      instance->UpdateStatus("Failed to save file");
+      GetSingleton()->UpdateStatus("Failed to save file");
     }
-  } catch (const std::exception& e) {
-    logger::error("UIManager: Exception while saving: {}", e.what());
-    instance->UpdateStatus("Error saving file");
-  }
+  });
 }
 
 void UIManager::OnSaveOutputBySchool(const char* argument)
@@ -692,37 +1029,35 @@ void UIManager::OnSaveOutputBySchool(const char* argument)
     // Parse the JSON object containing school outputs
     json schoolOutputs = json::parse(argument);
 
-    // Create output directory
     std::filesystem::path outputDir = "Data/SKSE/Plugins/SpellLearning/schools";
-    std::filesystem::create_directories(outputDir);
 
-    int savedCount = 0;
-
-    // Save each school to its own file
+    // Save each school to its own file - the status is reported once the last one is written
+    auto results = std::make_shared<std::vector<bool>>();
+    size_t total = schoolOutputs.size();
+    if (total == 0) {
+      instance->UpdateStatus("Saved 0 school files to /schools/");
+    }
     for (auto& [school, content] : schoolOutputs.items()) {
-      std::string filename             = school + "_spells.json";
-      std::filesystem::path outputPath = outputDir / filename;
-
-      std::ofstream file(outputPath);
-      if (file.is_open()) {
-        // Content is already a JSON string, write it directly
-        if (content.is_string()) {
-          file << content.get<std::string>();
+      std::filesystem::path outputPath = outputDir / (school + "_spells.json");
+
+      // Content is already a JSON string, write it directly
+      std::string data = content.is_string() ? content.get<std::string>() : content.dump(2);
+      AsyncFileWriter::GetSingleton()->Write(outputPath, std::move(data), [school, results, total](bool success) {
+        if (success) {
+          logger::info("UIManager: Saved {} school file", school);
         } else {
-          file << content.dump(2);
+          logger::error("UIManager: Failed to save {}", school);
         }
-        file.close();
-        logger::info("UIManager: Saved {} to {}", school, outputPath.string());
-        savedCount++;
-      } else {
-        logger::error("UIManager: Failed to save {}", school);
-      }
+        results->push_back(success);
+        if (results->size() == total) {
+          auto savedCount       = std::count(results->begin(), results->end(), true);
+          std::string statusMsg = "Saved " + std::to_string(savedCount) + " school files to /schools/";
+          logger::info("UIManager: {}", statusMsg);
+          GetSingleton()->UpdateStatus(statusMsg);
+        }
+      });
     }
 
-    std::string statusMsg = "Saved " + std::to_string(savedCount) + " school files to /schools/";
-    logger::info("UIManager: {}", statusMsg);
-    instance->UpdateStatus(statusMsg);
-
   } catch (const std::exception& e) {
     logger::error("UIManager: Exception in SaveOutputBySchool: {}", e.what());
     instance->UpdateStatus("Error saving school files");
@@ -735,6 +1070,7 @@ void UIManager::OnLoadPrompt(const char* argument)
 
   auto* instance  = GetSingleton();
   auto promptPath = GetPromptFilePath();
+  AsyncFileWriter::GetSingleton()->Flush(promptPath);
 
   // Check if saved prompt exists
   if (!std::filesystem::exists(promptPath)) {
@@ -770,161 +1106,183 @@ void UIManager::OnSavePrompt(const char* argument)
     return;
   }
 
-  auto* instance = GetSingleton();
-
-  // Create output directory
-  std::filesystem::path outputDir = "Data/SKSE/Plugins/SpellLearning";
-  std::filesystem::create_directories(outputDir);
-
   auto promptPath = GetPromptFilePath();
 
-  try {
-    std::ofstream file(promptPath);
-    if (file.is_open()) {
-      file << argument;
-      file.close();
+  AsyncFileWriter::GetSingleton()->Write(promptPath, argument, [promptPath](bool success) {
+    if (success) {
       logger::info("UIManager: Saved prompt to {}", promptPath.string());
-      instance->NotifyPromptSaved(true);
-    } else {
-      logger::error("UIManager: Failed to open prompt file for writing");
-      instance->NotifyPromptSaved(false);
     }
-  } catch (const std::exception& e) {
-    logger::error("UIManager: Exception while saving prompt: {}", e.what());
-    instance->NotifyPromptSaved(false);
-  }
+    GetSingleton()->NotifyPromptSaved(success);
+  });
 }
 
 // =============================================================================
 // TREE TAB CALLBACKS
 // =============================================================================
 
-void UIManager::OnLoadSpellTree(const char* argument)
+namespace
 {
-  logger::info("UIManager: LoadSpellTree callback triggered");
+// Game-thread time the spell info lookups of a tree load may take per frame
+constexpr auto kSpellInfoFrameBudget = 2ms;
 
-  auto* instance = GetSingleton();
-  auto treePath  = GetTreeFilePath();
-
-  // Check if saved tree exists
-  if (!std::filesystem::exists(treePath)) {
-    logger::info("UIManager: No saved spell tree found");
-    instance->UpdateTreeStatus("No saved tree - import one");
-    return;
-  }
+// Reading, parsing and validating a large tree runs on the thread pool - the player is waiting on the
+// panel, so it goes ahead of background work. Spell info reads learning state, so it is looked up on
+// the game thread, spread over frames.
+Coroutine::Task LoadSpellTree(std::filesystem::path treePath)
+{
+  auto* instance = UIManager::GetSingleton();
 
   try {
-    std::ifstream file(treePath);
-    if (file.is_open()) {
+    co_await Coroutine::OnWorker(ThreadPool::Priority::High);
+    AsyncFileWriter::GetSingleton()->Flush(treePath);
+
+    std::string treeContent;
+    {
+      std::ifstream file(treePath);
+      if (!file.is_open()) {
+        logger::warn("UIManager: Could not open spell tree file");
+        co_return;
+      }
       std::stringstream buffer;
       buffer << file.rdbuf();
-      file.close();
+      treeContent = buffer.str();
+    }
+    logger::info("UIManager: Loaded spell tree from file ({} bytes)", treeContent.size());
 
-      std::string treeContent = buffer.str();
-      logger::info("UIManager: Loaded spell tree from file ({} bytes)", treeContent.size());
+    // Parse and validate tree
+    json treeData;
+    bool parsed = true;
+    try {
+      treeData = json::parse(treeContent);
+    } catch (const std::exception& e) {
+      logger::error("UIManager: Failed to parse tree JSON: {}", e.what());
+      parsed = false;
+    }
+    if (!parsed) {
+      co_await Coroutine::OnGameThread();
+      instance->UpdateTreeStatus("Error: Invalid tree JSON");
+      co_return;
+    }
 
-      // Parse and validate tree
-      json treeData;
-      try {
-        treeData = json::parse(treeContent);
-      } catch (const std::exception& e) {
-        logger::error("UIManager: Failed to parse tree JSON: {}", e.what());
-        instance->UpdateTreeStatus("Error: Invalid tree JSON");
-        return;
-      }
+    // Validate and fix FormIDs (handles load order changes)
+    auto validationResult = SpellScanner::ValidateAndFixTree(treeData);
 
-      // Validate and fix FormIDs (handles load order changes)
-      auto validationResult = SpellScanner::ValidateAndFixTree(treeData);
+    // Log validation results
+    logger::info("UIManager: Tree validation - {}/{} valid, {} resolved, {} invalid", validationResult.validNodes,
+                 validationResult.totalNodes, validationResult.resolvedFromPersistent, validationResult.invalidNodes);
 
-      // Log validation results
-      logger::info("UIManager: Tree validation - {}/{} valid, {} resolved, {} invalid", validationResult.validNodes,
-                   validationResult.totalNodes, validationResult.resolvedFromPersistent, validationResult.invalidNodes);
+    if (!validationResult.missingPlugins.empty()) {
+      logger::warn("UIManager: Missing plugins:");
+      for (const auto& plugin : validationResult.missingPlugins) {
+        logger::warn("  - {}", plugin);
+      }
+    }
 
-      if (!validationResult.missingPlugins.empty()) {
-        logger::warn("UIManager: Missing plugins:");
-        for (const auto& plugin : validationResult.missingPlugins) {
-          logger::warn("  - {}", plugin);
-        }
+    // Save fixed tree if any changes were made
+    bool treeModified = (validationResult.resolvedFromPersistent > 0 || validationResult.invalidNodes > 0);
+    if (treeModified) {
+      // Update version to 2.0 if not already
+      if (!treeData.contains("version") || treeData["version"] != "2.0") {
+        treeData["version"] = "2.0";
       }
 
-      // Save fixed tree if any changes were made
-      bool treeModified = (validationResult.resolvedFromPersistent > 0 || validationResult.invalidNodes > 0);
-      if (treeModified) {
-        // Update version to 2.0 if not already
-        if (!treeData.contains("version") || treeData["version"] != "2.0") {
-          treeData["version"] = "2.0";
-        }
+      AsyncFileWriter::GetSingleton()->Write(treePath, treeData.dump(2));
+      logger::info("UIManager: Saving fixed tree with {} FormID updates", validationResult.resolvedFromPersistent);
+    }
 
-        try {
-          std::ofstream outFile(treePath);
-          if (outFile.is_open()) {
-            outFile << treeData.dump(2);
-            outFile.close();
-            logger::info("UIManager: Saved fixed tree with {} FormID updates", validationResult.resolvedFromPersistent);
-          }
-        } catch (const std::exception& e) {
-          logger::error("UIManager: Failed to save fixed tree: {}", e.what());
-        }
-      }
+    std::string treePayload = treeData.dump();
 
-      // Send validated tree data to viewer
-      instance->SendTreeData(treeData.dump());
-
-      // Build status message
-      std::string statusMsg;
-      if (validationResult.invalidNodes > 0) {
-        statusMsg = std::format("Loaded tree - {} spells ({} removed due to missing plugins)",
-                                validationResult.validNodes, validationResult.invalidNodes);
-      } else if (validationResult.resolvedFromPersistent > 0) {
-        statusMsg = std::format("Loaded tree - {} spells ({} fixed after load order change)",
-                                validationResult.validNodes, validationResult.resolvedFromPersistent);
-      } else {
-        statusMsg = std::format("Loaded tree - {} spells", validationResult.validNodes);
-      }
-      instance->UpdateTreeStatus(statusMsg);
-
-      // Send validation result to UI for potential warning display
-      json validationJson;
-      validationJson["totalNodes"]             = validationResult.totalNodes;
-      validationJson["validNodes"]             = validationResult.validNodes;
-      validationJson["invalidNodes"]           = validationResult.invalidNodes;
-      validationJson["resolvedFromPersistent"] = validationResult.resolvedFromPersistent;
-      validationJson["missingPlugins"]         = validationResult.missingPlugins;
-      instance->SendValidationResult(validationJson.dump());
-
-      // Fetch spell info for all valid formIds
-      std::vector<std::string> formIds;
-      if (treeData.contains("schools")) {
-        for (auto& [schoolName, schoolData] : treeData["schools"].items()) {
-          if (schoolData.contains("nodes")) {
-            for (auto& node : schoolData["nodes"]) {
-              if (node.contains("formId")) {
-                formIds.push_back(node["formId"].get<std::string>());
-              }
+    // Fetch spell info for all valid formIds - they point into treeData, which is not changed after this
+    std::vector<const std::string*> formIds;
+    formIds.reserve(validationResult.validNodes);
+    if (treeData.contains("schools")) {
+      for (auto& [schoolName, schoolData] : treeData["schools"].items()) {
+        if (schoolData.contains("nodes")) {
+          for (auto& node : schoolData["nodes"]) {
+            if (node.contains("formId")) {
+              formIds.push_back(&node["formId"].get_ref<const std::string&>());
             }
           }
         }
       }
+    }
 
-      // Fetch spell info and send as batch
-      if (!formIds.empty()) {
-        json spellInfoArray = json::array();
-        for (const auto& formIdStr : formIds) {
-          auto spellInfo = SpellScanner::GetSpellInfoByFormId(formIdStr);
-          if (!spellInfo.empty()) {
-            spellInfoArray.push_back(json::parse(spellInfo));
-          }
-        }
-        instance->SendSpellInfoBatch(spellInfoArray.dump());
+    co_await Coroutine::OnGameThread();
+
+    // Send validated tree data to viewer
+    instance->SendTreeData(treePayload);
+
+    if (treeData.contains("schools") && treeData["schools"].is_object()) {
+      for (const auto& [schoolName, schoolData] : treeData["schools"].items()) {
+        size_t nodes =
+            schoolData.contains("nodes") && schoolData["nodes"].is_array() ? schoolData["nodes"].size() : 0;
+        Metrics::GetGauge("spelllearning_tree_nodes", "Nodes per school in the loaded spell tree",
+                          {{"school", schoolName}})
+            .Set(static_cast<double>(nodes));
       }
+    }
 
+    // Build status message
+    std::string statusMsg;
+    if (validationResult.invalidNodes > 0) {
+      statusMsg = std::format("Loaded tree - {} spells ({} removed due to missing plugins)",
+                              validationResult.validNodes, validationResult.invalidNodes);
+    } else if (validationResult.resolvedFromPersistent > 0) {
+      statusMsg = std::format("Loaded tree - {} spells ({} fixed after load order change)",
+                              validationResult.validNodes, validationResult.resolvedFromPersistent);
     } else {
-      logger::warn("UIManager: Could not open spell tree file");
+      statusMsg = std::format("Loaded tree - {} spells", validationResult.validNodes);
+    }
+    instance->UpdateTreeStatus(statusMsg);
+
+    // Send validation result to UI for potential warning display
+    json validationJson;
+    validationJson["totalNodes"]             = validationResult.totalNodes;
+    validationJson["validNodes"]             = validationResult.validNodes;
+    validationJson["invalidNodes"]           = validationResult.invalidNodes;
+    validationJson["resolvedFromPersistent"] = validationResult.resolvedFromPersistent;
+    validationJson["missingPlugins"]         = validationResult.missingPlugins;
+    instance->SendValidationResult(validationJson.dump());
+
+    // Fetch spell info and send as batch
+    if (!formIds.empty()) {
+      json spellInfoArray = json::array();
+      auto sliceStart     = std::chrono::steady_clock::now();
+      for (const auto* formIdStr : formIds) {
+        if (std::chrono::steady_clock::now() - sliceStart > kSpellInfoFrameBudget) {
+          co_await Coroutine::NextFrame();
+          sliceStart = std::chrono::steady_clock::now();
+        }
+        auto spellInfo = SpellScanner::GetSpellInfo(*formIdStr);
+        if (!spellInfo.is_null()) {
+          spellInfoArray.push_back(std::move(spellInfo));
+        }
+      }
+      instance->SendSpellInfoBatch(spellInfoArray.dump());
     }
   } catch (const std::exception& e) {
     logger::error("UIManager: Exception while loading spell tree: {}", e.what());
   }
 }
+}  // namespace
+
+void UIManager::OnLoadSpellTree(const char* argument)
+{
+  SL_TRACE_SCOPE("UIManager::OnLoadSpellTree");
+  logger::info("UIManager: LoadSpellTree callback triggered");
+
+  auto* instance = GetSingleton();
+  auto treePath  = GetTreeFilePath();
+
+  // Check if saved tree exists
+  if (!std::filesystem::exists(treePath)) {
+    logger::info("UIManager: No saved spell tree found");
+    instance->UpdateTreeStatus("No saved tree - import one");
+    return;
+  }
+
+  LoadSpellTree(std::move(treePath));
+}
 
 void UIManager::OnGetSpellInfo(const char* argument)
 {
@@ -933,7 +1291,7 @@ void UIManager::OnGetSpellInfo(const char* argument)
     return;
   }
 
-  logger::info("UIManager: GetSpellInfo for formId: {}", argument);
+  SL_LOG_DEBUG(UI, "UIManager: GetSpellInfo for formId: {}", argument);
 
   auto* instance = GetSingleton();
 
@@ -972,7 +1330,7 @@ void UIManager::OnGetSpellInfoBatch(const char* argument)
     int notFoundCount = 0;
 
     for (const auto& formIdJson : formIdArray) {
-      std::string formIdStr = formIdJson.get<std::string>();
+      const auto& formIdStr = formIdJson.get_ref<const std::string&>();
 
       // Validate formId format (should be 0x followed by 8 hex chars)
       if (formIdStr.length() < 3 || formIdStr.substr(0, 2) != "0x") {
@@ -985,10 +1343,10 @@ void UIManager::OnGetSpellInfoBatch(const char* argument)
         continue;
       }
 
-      std::string spellInfo = SpellScanner::GetSpellInfoByFormId(formIdStr);
+      json spellInfo = SpellScanner::GetSpellInfo(formIdStr);
 
-      if (!spellInfo.empty()) {
-        resultArray.push_back(json::parse(spellInfo));
+      if (!spellInfo.is_null()) {
+        resultArray.push_back(std::move(spellInfo));
         foundCount++;
       } else {
         json notFound;
@@ -1018,30 +1376,14 @@ void UIManager::OnSaveSpellTree(const char* argument)
     return;
   }
 
-  auto* instance = GetSingleton();
-
-  // Create output directory
-  std::filesystem::path outputDir = "Data/SKSE/Plugins/SpellLearning";
-  std::filesystem::create_directories(outputDir);
-
-  // Write to file
   auto treePath = GetTreeFilePath();
 
-  try {
-    std::ofstream file(treePath);
-    if (file.is_open()) {
-      file << argument;
-      file.close();
+  AsyncFileWriter::GetSingleton()->Write(treePath, argument, [treePath](bool success) {
+    if (success) {
       logger::info("UIManager: Saved spell tree to {}", treePath.string());
-      instance->UpdateTreeStatus("Tree saved");
-    } else {
-      logger::error("UIManager: Failed to open spell tree file for writing");
-      instance->UpdateTreeStatus("Save failed");
     }
-  } catch (const std::exception& e) {
-    logger::error("UIManager: Exception while saving spell tree: {}", e.what());
-    instance->UpdateTreeStatus("Save failed");
-  }
+    GetSingleton()->UpdateTreeStatus(success ? "Tree saved" : "Save failed");
+  });
 }
 
 void UIManager::OnSetLearningTarget(const char* argument)
@@ -1087,7 +1429,7 @@ void UIManager::OnSetLearningTarget(const char* argument)
     response["success"] = true;
     response["school"]  = school;
     response["formId"]  = formIdStr;
-    instance->m_prismaUI->InteropCall(instance->m_view, "onLearningTargetSet", response.dump().c_str());
+    SendToView(instance->m_prismaUI, instance->m_view, "onLearningTargetSet", response.dump().c_str());
 
     // Update spell state to "learning" so canvas renderer shows learning visuals
     instance->UpdateSpellState(formIdStr, "learning");
@@ -1249,8 +1591,8 @@ void UIManager::OnGetPlayerKnownSpells(const char* argument)
               logger::info("UIManager: Player knows spell: {} ({})", spell->GetName(), ss.str());
             }
           } else {
-            logger::trace("UIManager: Skipping non-combat spell/ability: {} ({:08X})", spell->GetName(),
-                          spell->GetFormID());
+            SL_LOG_TRACE(UI, "UIManager: Skipping non-combat spell/ability: {} ({:08X})", spell->GetName(),
+                         spell->GetFormID());
           }
         }
       }
@@ -1282,7 +1624,7 @@ void UIManager::OnGetPlayerKnownSpells(const char* argument)
   result["count"]          = knownSpells.size();
 
   logger::info("UIManager: Found {} valid combat spells", knownSpells.size());
-  instance->m_prismaUI->InteropCall(instance->m_view, "onPlayerKnownSpells", result.dump().c_str());
+  SendToView(instance->m_prismaUI, instance->m_view, "onPlayerKnownSpells", result.dump().c_str());
 }
 
 void UIManager::OnCheatUnlockSpell(const char* argument)
@@ -1373,7 +1715,7 @@ void UIManager::OnRelockSpell(const char* argument)
     notify["success"]  = true;
     notify["relocked"] = true;
 
-    instance->m_prismaUI->InteropCall(instance->m_view, "onSpellRelocked", notify.dump().c_str());
+    SendToView(instance->m_prismaUI, instance->m_view, "onSpellRelocked", notify.dump().c_str());
     instance->UpdateSpellState(formIdStr, "available");
 
   } catch (const std::exception& e) {
@@ -1509,7 +1851,7 @@ void UIManager::OnSetTreePrerequisites(const char* argument)
       // Log spells with prerequisites for debugging
       if (!reqs.hardPrereqs.empty() || !reqs.softPrereqs.empty()) {
         auto* spell = RE::TESForm::LookupByID<RE::SpellItem>(formId);
-        logger::info("UIManager: Setting prereqs for {:08X} '{}': {} hard, {} soft (need {})", formId,
+        SL_LOG_DEBUG(UI, "UIManager: Setting prereqs for {:08X} '{}': {} hard, {} soft (need {})", formId,
                      spell ? spell->GetName() : "UNKNOWN", reqs.hardPrereqs.size(), reqs.softPrereqs.size(),
                      reqs.softNeeded);
       }
@@ -1566,6 +1908,9 @@ json GenerateDefaultConfig()
               {"pauseGameOnFocus", true},  // If false, game continues running when UI is open
               {"cheatMode", false},
               {"verboseLogging", false},
+              {"logLevels", Logging::GetLevels()},  // Per subsystem: trace, debug, info, warning, error, off
+              {"traceOnStartup", false},            // Record trace zones from plugin load (read by Main)
+              {"metricsExportSeconds", 0},          // Write metrics.prom this often, 0 = off (read by Main)
               // Heart animation settings
               {"heartAnimationEnabled", true},
               {"heartPulseSpeed", 0.06},
@@ -1639,48 +1984,73 @@ void MergeJsonNonNull(json& dst, const json& src)
   }
 }
 
-void UIManager::OnLoadUnifiedConfig(const char* argument)
-{
-  logger::info("UIManager: LoadUnifiedConfig requested");
-
-  auto* instance = GetSingleton();
-  auto path      = GetUnifiedConfigPath();
+// =============================================================================
+// CONFIG SECTIONS (re-applied only when they change)
+// =============================================================================
 
-  // Also check legacy paths and merge if needed
-  auto legacySettingsPath = GetSettingsFilePath();
-  auto legacyLLMPath      = std::filesystem::path("Data/SKSE/Plugins/SpellLearning/openrouter_config.json");
+namespace
+{
+std::filesystem::path GetLegacyLLMConfigPath()
+{
+  return "Data/SKSE/Plugins/SpellLearning/openrouter_config.json";
+}
 
+// Defaults with the unified config over them - what a save applies
+json WithDefaults(const json& config)
+{
   // Start with complete defaults - this ensures all fields exist
-  json unifiedConfig    = GenerateDefaultConfig();
-  bool configFileExists = false;
+  json unifiedConfig = GenerateDefaultConfig();
+  MergeJsonNonNull(unifiedConfig, config);
+  return unifiedConfig;
+}
 
-  // Try to load existing unified config and merge (non-null values only)
-  if (std::filesystem::exists(path)) {
-    try {
-      std::ifstream file(path);
-      json loadedConfig = json::parse(file);
-      MergeJsonNonNull(unifiedConfig, loadedConfig);
-      configFileExists = true;
-      logger::info("UIManager: Loaded and merged unified config");
-    } catch (const std::exception& e) {
-      logger::warn("UIManager: Failed to parse unified config: {} - using defaults", e.what());
-    }
-  } else {
-    logger::info("UIManager: No config file found, using defaults");
+// Move a legacy settings.json into the unified config once and retire it, so its values are not laid over
+// later saves. Returns false if there was nothing to migrate.
+bool MigrateLegacySettings(json& loadedConfig)
+{
+  auto legacySettingsPath = GetSettingsFilePath();
+  if (!std::filesystem::exists(legacySettingsPath)) {
+    return false;
   }
 
-  // Migrate legacy settings if they exist
-  if (std::filesystem::exists(legacySettingsPath)) {
-    try {
+  try {
+    json legacySettings;
+    {
       std::ifstream file(legacySettingsPath);
-      json legacySettings = json::parse(file);
-      MergeJsonNonNull(unifiedConfig, legacySettings);
-      logger::info("UIManager: Migrated legacy settings.json");
-    } catch (...) {
+      legacySettings = json::parse(file);
     }
+    if (!loadedConfig.is_object()) {
+      loadedConfig = json::object();
+    }
+    MergeJsonNonNull(loadedConfig, legacySettings);
+
+    // On disk before the legacy file goes away
+    auto path = GetUnifiedConfigPath();
+    AsyncFileWriter::GetSingleton()->Write(path, loadedConfig.dump(2));
+    AsyncFileWriter::GetSingleton()->Flush(path);
+
+    auto retiredPath = legacySettingsPath;
+    retiredPath += ".migrated";
+    std::error_code ec;
+    std::filesystem::rename(legacySettingsPath, retiredPath, ec);
+    if (ec) {
+      logger::warn("UIManager: Could not retire legacy settings.json: {}", ec.message());
+    }
+    logger::info("UIManager: Migrated legacy settings.json into {}", path.filename().string());
+    return true;
+  } catch (const std::exception& e) {
+    logger::warn("UIManager: Failed to migrate legacy settings.json: {}", e.what());
+    return false;
   }
+}
+
+// Defaults, the unified config over them, then the LLM settings OpenRouterAPI keeps in its own file
+json BuildUnifiedConfig(const json& loadedConfig)
+{
+  json unifiedConfig = WithDefaults(loadedConfig);
 
   // Migrate legacy LLM config
+  auto legacyLLMPath = GetLegacyLLMConfigPath();
   if (std::filesystem::exists(legacyLLMPath)) {
     try {
       std::ifstream file(legacyLLMPath);
@@ -1694,122 +2064,314 @@ void UIManager::OnLoadUnifiedConfig(const char* argument)
     }
   }
 
-  // Save defaults if no config file existed (creates the file for user)
-  if (!configFileExists) {
+  return unifiedConfig;
+}
+
+// Read config.json and build the unified config from it - configFileExists is false when it is missing or invalid
+json LoadUnifiedConfigFile(bool& configFileExists)
+{
+  auto path = GetUnifiedConfigPath();
+  AsyncFileWriter::GetSingleton()->Flush(path);
+  AsyncFileWriter::GetSingleton()->Flush(GetLegacyLLMConfigPath());
+
+  // Try to load existing unified config and merge (non-null values only)
+  json loadedConfig;
+  configFileExists = false;
+  if (std::filesystem::exists(path)) {
     try {
-      std::filesystem::create_directories(path.parent_path());
-      std::ofstream outFile(path);
-      outFile << unifiedConfig.dump(2);
-      logger::info("UIManager: Created default config file at {}", path.string());
+      std::ifstream file(path);
+      loadedConfig     = json::parse(file);
+      configFileExists = true;
+      logger::info("UIManager: Loaded and merged unified config");
     } catch (const std::exception& e) {
-      logger::warn("UIManager: Failed to save default config: {}", e.what());
+      logger::warn("UIManager: Failed to parse unified config: {} - using defaults", e.what());
     }
+  } else {
+    logger::info("UIManager: No config file found, using defaults");
   }
 
-  // Update InputHandler with loaded hotkey
-  if (unifiedConfig.contains("hotkeyCode") && !unifiedConfig["hotkeyCode"].is_null()) {
-    uint32_t keyCode = unifiedConfig["hotkeyCode"].get<uint32_t>();
-    UpdateInputHandlerHotkey(keyCode);
-    logger::info("UIManager: Updated hotkey from config: {}", keyCode);
+  // Not over a config.json that failed to parse - the user may still fix it
+  bool configUnreadable = !configFileExists && std::filesystem::exists(path);
+  if (!configUnreadable && MigrateLegacySettings(loadedConfig)) {
+    configFileExists = true;
   }
 
-  // Update pause game on focus setting
-  if (unifiedConfig.contains("pauseGameOnFocus") && !unifiedConfig["pauseGameOnFocus"].is_null()) {
-    bool pauseGame = unifiedConfig["pauseGameOnFocus"].get<bool>();
-    GetSingleton()->SetPauseGameOnFocus(pauseGame);
-    logger::info("UIManager: Updated pauseGameOnFocus from config: {}", pauseGame);
+  return BuildUnifiedConfig(loadedConfig);
+}
+
+// The flat keys read into ProgressionManager::XPSettings
+constexpr const char* kXPSettingKeys[] = {"learningMode", "xpGlobalMultiplier", "xpMultiplierDirect",
+                                          "xpMultiplierSchool", "xpMultiplierAny", "xpCapAny", "xpCapSchool",
+                                          "xpCapDirect", "xpNovice", "xpApprentice", "xpAdept", "xpExpert",
+                                          "xpMaster"};
+
+json ConfigValue(const json& config, const char* key)
+{
+  auto it = config.find(key);
+  return it != config.end() ? *it : json();
+}
+
+json ExtractXPSettings(const json& config)
+{
+  json xpConfig = json::object();
+  for (const char* key : kXPSettingKeys) {
+    if (auto it = config.find(key); it != config.end()) {
+      xpConfig[key] = *it;
+    }
   }
+  return xpConfig;
+}
 
-  // Update ProgressionManager with loaded XP settings
+// Power steps are their own section - changing a threshold should not re-apply the rest
+json ExtractEarlyLearning(const json& config)
+{
+  json elConfig = ConfigValue(config, "earlySpellLearning");
+  if (elConfig.is_object()) {
+    elConfig.erase("powerSteps");
+  }
+  return elConfig;
+}
+
+json ExtractPowerSteps(const json& config)
+{
+  auto it = config.find("earlySpellLearning");
+  return it != config.end() && it->is_object() ? ConfigValue(*it, "powerSteps") : json();
+}
+
+void ApplyHotkey(const json& hotkeyCode)
+{
+  // Update InputHandler with loaded hotkey
+  uint32_t keyCode = hotkeyCode.get<uint32_t>();
+  UpdateInputHandlerHotkey(keyCode);
+  logger::info("UIManager: Updated hotkey from config: {}", keyCode);
+}
+
+void ApplyPauseGameOnFocus(const json& pauseGameOnFocus)
+{
+  bool pauseGame = pauseGameOnFocus.get<bool>();
+  UIManager::GetSingleton()->SetPauseGameOnFocus(pauseGame);
+  logger::info("UIManager: Updated pauseGameOnFocus from config: {}", pauseGame);
+}
+
+void ApplyMetricsExport(const json& seconds)
+{
+  Metrics::SetExportInterval(seconds.is_number() ? seconds.get<uint32_t>() : 0);
+}
+
+void ApplyXPSettings(const json& xpConfig)
+{
   // All fields are guaranteed to exist from defaults, but use SafeJsonValue for extra safety
   ProgressionManager::XPSettings xpSettings;
-  xpSettings.learningMode     = SafeJsonValue<std::string>(unifiedConfig, "learningMode", "perSchool");
-  xpSettings.globalMultiplier = static_cast<float>(SafeJsonValue<int>(unifiedConfig, "xpGlobalMultiplier", 1));
-  xpSettings.multiplierDirect = SafeJsonValue<int>(unifiedConfig, "xpMultiplierDirect", 100) / 100.0f;
-  xpSettings.multiplierSchool = SafeJsonValue<int>(unifiedConfig, "xpMultiplierSchool", 50) / 100.0f;
-  xpSettings.multiplierAny    = SafeJsonValue<int>(unifiedConfig, "xpMultiplierAny", 10) / 100.0f;
+  xpSettings.learningMode     = SafeJsonValue<std::string>(xpConfig, "learningMode", "perSchool");
+  xpSettings.globalMultiplier = static_cast<float>(SafeJsonValue<int>(xpConfig, "xpGlobalMultiplier", 1));
+  xpSettings.multiplierDirect = SafeJsonValue<int>(xpConfig, "xpMultiplierDirect", 100) / 100.0f;
+  xpSettings.multiplierSchool = SafeJsonValue<int>(xpConfig, "xpMultiplierSchool", 50) / 100.0f;
+  xpSettings.multiplierAny    = SafeJsonValue<int>(xpConfig, "xpMultiplierAny", 10) / 100.0f;
   // XP caps (max contribution from each source)
-  xpSettings.capAny    = static_cast<float>(SafeJsonValue<int>(unifiedConfig, "xpCapAny", 5));
-  xpSettings.capSchool = static_cast<float>(SafeJsonValue<int>(unifiedConfig, "xpCapSchool", 15));
-  xpSettings.capDirect = static_cast<float>(SafeJsonValue<int>(unifiedConfig, "xpCapDirect", 50));
+  xpSettings.capAny    = static_cast<float>(SafeJsonValue<int>(xpConfig, "xpCapAny", 5));
+  xpSettings.capSchool = static_cast<float>(SafeJsonValue<int>(xpConfig, "xpCapSchool", 15));
+  xpSettings.capDirect = static_cast<float>(SafeJsonValue<int>(xpConfig, "xpCapDirect", 50));
   // Tier XP requirements
-  xpSettings.xpNovice     = SafeJsonValue<int>(unifiedConfig, "xpNovice", 100);
-  xpSettings.xpApprentice = SafeJsonValue<int>(unifiedConfig, "xpApprentice", 200);
-  xpSettings.xpAdept      = SafeJsonValue<int>(unifiedConfig, "xpAdept", 400);
-  xpSettings.xpExpert     = SafeJsonValue<int>(unifiedConfig, "xpExpert", 800);
-  xpSettings.xpMaster     = SafeJsonValue<int>(unifiedConfig, "xpMaster", 1500);
+  xpSettings.xpNovice     = SafeJsonValue<int>(xpConfig, "xpNovice", 100);
+  xpSettings.xpApprentice = SafeJsonValue<int>(xpConfig, "xpApprentice", 200);
+  xpSettings.xpAdept      = SafeJsonValue<int>(xpConfig, "xpAdept", 400);
+  xpSettings.xpExpert     = SafeJsonValue<int>(xpConfig, "xpExpert", 800);
+  xpSettings.xpMaster     = SafeJsonValue<int>(xpConfig, "xpMaster", 1500);
   ProgressionManager::GetSingleton()->SetXPSettings(xpSettings);
+}
 
-  // Update SpellEffectivenessHook with early learning settings
-  if (unifiedConfig.contains("earlySpellLearning") && !unifiedConfig["earlySpellLearning"].is_null()) {
-    auto& elConfig = unifiedConfig["earlySpellLearning"];
-    SpellEffectivenessHook::EarlyLearningSettings elSettings;
-    elSettings.enabled               = SafeJsonValue<bool>(elConfig, "enabled", true);
-    elSettings.unlockThreshold       = SafeJsonValue<float>(elConfig, "unlockThreshold", 25.0f);
-    elSettings.selfCastRequiredAt    = SafeJsonValue<float>(elConfig, "selfCastRequiredAt", 75.0f);
-    elSettings.selfCastXPMultiplier  = SafeJsonValue<float>(elConfig, "selfCastXPMultiplier", 150.0f) / 100.0f;
-    elSettings.binaryEffectThreshold = SafeJsonValue<float>(elConfig, "binaryEffectThreshold", 80.0f);
-    elSettings.modifyGameDisplay     = SafeJsonValue<bool>(elConfig, "modifyGameDisplay", true);
-    SpellEffectivenessHook::GetSingleton()->SetSettings(elSettings);
-
-    // Load configurable power steps if present
-    if (elConfig.contains("powerSteps") && !elConfig["powerSteps"].is_null() && elConfig["powerSteps"].is_array()) {
-      std::vector<SpellEffectivenessHook::PowerStep> steps;
-      for (const auto& stepJson : elConfig["powerSteps"]) {
-        if (stepJson.is_null())
-          continue;
-        SpellEffectivenessHook::PowerStep step;
-        step.progressThreshold = SafeJsonValue<float>(stepJson, "xp", 25.0f);
-        step.effectiveness     = SafeJsonValue<float>(stepJson, "power", 20.0f) / 100.0f;  // Convert % to 0-1
-        step.label             = SafeJsonValue<std::string>(stepJson, "label", "Stage");
-        steps.push_back(step);
-      }
-      if (!steps.empty()) {
-        SpellEffectivenessHook::GetSingleton()->SetPowerSteps(steps);
-      }
+void ApplyEarlyLearning(const json& elConfig)
+{
+  SpellEffectivenessHook::EarlyLearningSettings elSettings;
+  elSettings.enabled               = SafeJsonValue<bool>(elConfig, "enabled", true);
+  elSettings.unlockThreshold       = SafeJsonValue<float>(elConfig, "unlockThreshold", 25.0f);
+  elSettings.selfCastRequiredAt    = SafeJsonValue<float>(elConfig, "selfCastRequiredAt", 75.0f);
+  elSettings.selfCastXPMultiplier  = SafeJsonValue<float>(elConfig, "selfCastXPMultiplier", 150.0f) / 100.0f;
+  elSettings.binaryEffectThreshold = SafeJsonValue<float>(elConfig, "binaryEffectThreshold", 80.0f);
+  elSettings.modifyGameDisplay     = SafeJsonValue<bool>(elConfig, "modifyGameDisplay", true);
+  SpellEffectivenessHook::GetSingleton()->SetSettings(elSettings);
+}
+
+void ApplyPowerSteps(const json& powerSteps)
+{
+  if (!powerSteps.is_array())
+    return;
+
+  std::vector<SpellEffectivenessHook::PowerStep> steps;
+  for (const auto& stepJson : powerSteps) {
+    if (stepJson.is_null())
+      continue;
+    SpellEffectivenessHook::PowerStep step;
+    step.progressThreshold = SafeJsonValue<float>(stepJson, "xp", 25.0f);
+    step.effectiveness     = SafeJsonValue<float>(stepJson, "power", 20.0f) / 100.0f;  // Convert % to 0-1
+    step.label             = SafeJsonValue<std::string>(stepJson, "label", "Stage");
+    steps.push_back(step);
+  }
+  if (!steps.empty()) {
+    SpellEffectivenessHook::GetSingleton()->SetPowerSteps(steps);
+  }
+}
+
+void ApplyTomeLearning(const json& tomeConfig)
+{
+  SpellTomeHook::Settings tomeSettings;
+  tomeSettings.enabled                   = SafeJsonValue<bool>(tomeConfig, "enabled", true);
+  tomeSettings.useProgressionSystem      = SafeJsonValue<bool>(tomeConfig, "useProgressionSystem", true);
+  tomeSettings.grantXPOnRead             = SafeJsonValue<bool>(tomeConfig, "grantXPOnRead", true);
+  tomeSettings.autoSetLearningTarget     = SafeJsonValue<bool>(tomeConfig, "autoSetLearningTarget", true);
+  tomeSettings.showNotifications         = SafeJsonValue<bool>(tomeConfig, "showNotifications", true);
+  tomeSettings.xpPercentToGrant          = SafeJsonValue<float>(tomeConfig, "xpPercentToGrant", 25.0f);
+  tomeSettings.tomeInventoryBoost        = SafeJsonValue<bool>(tomeConfig, "tomeInventoryBoost", true);
+  tomeSettings.tomeInventoryBoostPercent = SafeJsonValue<float>(tomeConfig, "tomeInventoryBoostPercent", 25.0f);
+  // Learning requirements
+  tomeSettings.requirePrereqs    = SafeJsonValue<bool>(tomeConfig, "requirePrereqs", true);
+  tomeSettings.requireAllPrereqs = SafeJsonValue<bool>(tomeConfig, "requireAllPrereqs", true);
+  tomeSettings.requireSkillLevel = SafeJsonValue<bool>(tomeConfig, "requireSkillLevel", false);
+  SpellTomeHook::GetSingleton()->SetSettings(tomeSettings);
+  logger::info("UIManager: Applied SpellTomeHook settings - useProgressionSystem: {}, requirePrereqs: {}, "
+               "requireAllPrereqs: {}, requireSkillLevel: {}",
+               tomeSettings.useProgressionSystem, tomeSettings.requirePrereqs, tomeSettings.requireAllPrereqs,
+               tomeSettings.requireSkillLevel);
+}
+
+void ApplyNotifications(const json& notifConfig)
+{
+  auto* castHandler = SpellCastHandler::GetSingleton();
+  castHandler->SetWeakenedNotificationsEnabled(SafeJsonValue<bool>(notifConfig, "weakenedSpellNotifications", true));
+  castHandler->SetNotificationInterval(SafeJsonValue<float>(notifConfig, "weakenedSpellInterval", 10.0f));
+  logger::info("UIManager: Applied notification settings - weakened enabled: {}, interval: {}s",
+               castHandler->GetWeakenedNotificationsEnabled(), castHandler->GetNotificationInterval());
+}
+
+// A part of the unified config that one subsystem takes - applied again only when its hash changes.
+// The "llm" block is not a section: OpenRouterAPI reads its settings from openrouter_config.json once,
+// so LLM edits on disk take effect after a restart (the panel's LLM settings apply at once).
+struct ConfigSection
+{
+  const char* name;
+  json (*extract)(const json& config);
+  void (*apply)(const json& section);  // Not called for a null section
+};
+
+const ConfigSection kConfigSections[] = {
+    {"hotkey", [](const json& config) { return ConfigValue(config, "hotkeyCode"); }, ApplyHotkey},
+    {"pauseGameOnFocus", [](const json& config) { return ConfigValue(config, "pauseGameOnFocus"); },
+     ApplyPauseGameOnFocus},
+    {"logLevels", [](const json& config) { return ConfigValue(config, "logLevels"); },
+     [](const json& levels) { Logging::SetLevels(levels); }},
+    {"metricsExport", [](const json& config) { return ConfigValue(config, "metricsExportSeconds"); },
+     ApplyMetricsExport},
+    {"xp", ExtractXPSettings, ApplyXPSettings},
+    {"earlySpellLearning", ExtractEarlyLearning, ApplyEarlyLearning},
+    {"powerSteps", ExtractPowerSteps, ApplyPowerSteps},
+    {"spellTomeLearning", [](const json& config) { return ConfigValue(config, "spellTomeLearning"); },
+     ApplyTomeLearning},
+    {"notifications", [](const json& config) { return ConfigValue(config, "notifications"); }, ApplyNotifications},
+};
+
+std::mutex s_configApplyMutex;
+std::optional<uint64_t> s_appliedSectionHashes[std::size(kConfigSections)];
+
+// Apply the sections that differ from the last applied config - returns how many differed
+size_t ApplyUnifiedConfig(const json& config)
+{
+  std::lock_guard lock(s_configApplyMutex);
+
+  size_t changed = 0;
+  for (size_t i = 0; i < std::size(kConfigSections); ++i) {
+    const auto& section = kConfigSections[i];
+    json value          = section.extract(config);
+    uint64_t hash       = ConfigWatcher::Hash(value);
+    if (s_appliedSectionHashes[i] == hash)
+      continue;
+
+    // Recorded only once applied, so a section that failed is tried again on the next load
+    try {
+      if (!value.is_null())
+        section.apply(value);
+    } catch (const std::exception& e) {
+      logger::error("UIManager: Failed to apply config section {}: {}", section.name, e.what());
+      continue;
     }
+    s_appliedSectionHashes[i] = hash;
+    changed++;
   }
 
-  // Update SpellTomeHook with tome learning settings
-  if (unifiedConfig.contains("spellTomeLearning") && !unifiedConfig["spellTomeLearning"].is_null()) {
-    auto& tomeConfig = unifiedConfig["spellTomeLearning"];
-    SpellTomeHook::Settings tomeSettings;
-    tomeSettings.enabled                   = SafeJsonValue<bool>(tomeConfig, "enabled", true);
-    tomeSettings.useProgressionSystem      = SafeJsonValue<bool>(tomeConfig, "useProgressionSystem", true);
-    tomeSettings.grantXPOnRead             = SafeJsonValue<bool>(tomeConfig, "grantXPOnRead", true);
-    tomeSettings.autoSetLearningTarget     = SafeJsonValue<bool>(tomeConfig, "autoSetLearningTarget", true);
-    tomeSettings.showNotifications         = SafeJsonValue<bool>(tomeConfig, "showNotifications", true);
-    tomeSettings.xpPercentToGrant          = SafeJsonValue<float>(tomeConfig, "xpPercentToGrant", 25.0f);
-    tomeSettings.tomeInventoryBoost        = SafeJsonValue<bool>(tomeConfig, "tomeInventoryBoost", true);
-    tomeSettings.tomeInventoryBoostPercent = SafeJsonValue<float>(tomeConfig, "tomeInventoryBoostPercent", 25.0f);
-    // Learning requirements
-    tomeSettings.requirePrereqs    = SafeJsonValue<bool>(tomeConfig, "requirePrereqs", true);
-    tomeSettings.requireAllPrereqs = SafeJsonValue<bool>(tomeConfig, "requireAllPrereqs", true);
-    tomeSettings.requireSkillLevel = SafeJsonValue<bool>(tomeConfig, "requireSkillLevel", false);
-    SpellTomeHook::GetSingleton()->SetSettings(tomeSettings);
-    logger::info("UIManager: Applied SpellTomeHook settings - useProgressionSystem: {}, requirePrereqs: {}, "
-                 "requireAllPrereqs: {}, requireSkillLevel: {}",
-                 tomeSettings.useProgressionSystem, tomeSettings.requirePrereqs, tomeSettings.requireAllPrereqs,
-                 tomeSettings.requireSkillLevel);
-  }
-
-  // Update SpellCastHandler with notification settings
-  if (unifiedConfig.contains("notifications") && !unifiedConfig["notifications"].is_null()) {
-    auto& notifConfig = unifiedConfig["notifications"];
-    auto* castHandler = SpellCastHandler::GetSingleton();
-    castHandler->SetWeakenedNotificationsEnabled(SafeJsonValue<bool>(notifConfig, "weakenedSpellNotifications", true));
-    castHandler->SetNotificationInterval(SafeJsonValue<float>(notifConfig, "weakenedSpellInterval", 10.0f));
-    logger::info("UIManager: Applied notification settings - weakened enabled: {}, interval: {}s",
-                 castHandler->GetWeakenedNotificationsEnabled(), castHandler->GetNotificationInterval());
+  SL_LOG_DEBUG(UI, "UIManager: {} of {} config sections changed", changed, std::size(kConfigSections));
+  return changed;
+}
+
+// A setter applied a section directly - record its value, so a reload compares against what is live
+void SetAppliedSection(const char* name, const json& value)
+{
+  std::lock_guard lock(s_configApplyMutex);
+  for (size_t i = 0; i < std::size(kConfigSections); ++i) {
+    if (std::string_view(kConfigSections[i].name) == name) {
+      s_appliedSectionHashes[i] = ConfigWatcher::Hash(value);
+      return;
+    }
   }
+}
+
+void SendUnifiedConfig(json& unifiedConfig)
+{
+  auto* instance = UIManager::GetSingleton();
+  if (!instance->GetAPI() || !instance->GetAPI()->IsValid(instance->GetView()))
+    return;
+
+  // Runtime state for the panel, not saved
+  unifiedConfig["traceRecording"] = Trace::IsRecording();
 
   // Send to UI
   std::string configStr = unifiedConfig.dump();
   logger::info("UIManager: Sending unified config to UI ({} bytes)", configStr.size());
-  instance->m_prismaUI->InteropCall(instance->m_view, "onUnifiedConfigLoaded", configStr.c_str());
+  SendToView(instance->GetAPI(), instance->GetView(), "onUnifiedConfigLoaded", configStr.c_str());
+}
+
+// Game thread - config.json or settings.json was edited on disk
+void ReloadUnifiedConfig()
+{
+  bool configFileExists = false;
+  json unifiedConfig    = LoadUnifiedConfigFile(configFileExists);
+  if (!configFileExists) {
+    logger::warn("UIManager: Config file missing or invalid after an edit - keeping the current settings");
+    return;
+  }
+
+  // Nothing differs after our own saves
+  if (ApplyUnifiedConfig(unifiedConfig) == 0)
+    return;
+
+  logger::info("UIManager: Applied config changes from disk");
+  SendUnifiedConfig(unifiedConfig);
+}
+}  // namespace
+
+void UIManager::OnLoadUnifiedConfig(const char* argument)
+{
+  logger::info("UIManager: LoadUnifiedConfig requested");
+
+  auto path             = GetUnifiedConfigPath();
+  bool configFileExists = false;
+  json unifiedConfig    = LoadUnifiedConfigFile(configFileExists);
+
+  // Save defaults if no config file existed (creates the file for user)
+  if (!configFileExists) {
+    AsyncFileWriter::GetSingleton()->Write(path, unifiedConfig.dump(2));
+    logger::info("UIManager: Creating default config file at {}", path.string());
+  }
+
+  ApplyUnifiedConfig(unifiedConfig);
+
+  // Edits on disk are applied from here on, compared against what was just applied
+  static std::once_flag watchStarted;
+  std::call_once(watchStarted,
+                 [&path]() { ConfigWatcher::Watch({path, GetSettingsFilePath()}, ReloadUnifiedConfig); });
+
+  SendUnifiedConfig(unifiedConfig);
 
   // Notify UI of ISL detection status (fresh detection, not from saved config)
-  instance->NotifyISLDetectionStatus();
+  GetSingleton()->NotifyISLDetectionStatus();
 }
 
 void UIManager::OnSetHotkey(const char* argument)
@@ -1823,6 +2385,7 @@ void UIManager::OnSetHotkey(const char* argument)
     uint32_t keyCode = static_cast<uint32_t>(std::stoul(argument));
     logger::info("UIManager: Setting hotkey to code {}", keyCode);
     UpdateInputHandlerHotkey(keyCode);
+    SetAppliedSection("hotkey", keyCode);
   } catch (const std::exception& e) {
     logger::error("UIManager: SetHotkey exception: {}", e.what());
   }
@@ -1839,6 +2402,70 @@ void UIManager::OnSetPauseGameOnFocus(const char* argument)
   bool pause = (value == "true" || value == "1");
   logger::info("UIManager: Setting pauseGameOnFocus to {}", pause);
   GetSingleton()->SetPauseGameOnFocus(pause);
+  SetAppliedSection("pauseGameOnFocus", pause);
+}
+
+void UIManager::OnSetLogLevels(const char* argument)
+{
+  if (!argument || strlen(argument) == 0) {
+    logger::warn("UIManager: SetLogLevels - no value provided");
+    return;
+  }
+
+  json levels = json::parse(argument, nullptr, false);
+  if (levels.is_discarded() || !levels.is_object()) {
+    logger::warn("UIManager: SetLogLevels - expected an object of subsystem levels");
+    return;
+  }
+  Logging::SetLevels(levels);
+  SetAppliedSection("logLevels", levels);
+}
+
+void UIManager::OnSetTraceRecording(const char* argument)
+{
+  std::string value(argument ? argument : "");
+  if (value == "true" || value == "1") {
+    Trace::Start();
+    return;
+  }
+
+  // Stopping saves what was recorded
+  Trace::Stop();
+  auto path   = Trace::GetTracePath();
+  auto dumped = Trace::WriteChromeTrace(path);
+
+  json result;
+  result["success"] = dumped.success;
+  result["path"]    = path.string();
+  result["events"]  = dumped.events;
+  result["dropped"] = dumped.dropped;
+  result["threads"] = dumped.threads;
+  if (!dumped.success) {
+    result["error"] = dumped.error;
+    logger::warn("UIManager: Trace not saved - {}", dumped.error);
+  }
+
+  auto* instance = GetSingleton();
+  if (instance->m_prismaUI && instance->m_prismaUI->IsValid(instance->m_view)) {
+    SendToView(instance->m_prismaUI, instance->m_view, "onTraceSaved", result.dump().c_str());
+  }
+}
+
+void UIManager::OnGetHookStats(const char* argument)
+{
+  auto summaries = HookStats::Collect();
+  HookStats::LogSummary(summaries);
+  json result = HookStats::ToJson(summaries);
+
+  // "reset" starts a new window after reporting the current one
+  if (argument && std::string_view(argument) == "reset") {
+    HookStats::Reset();
+  }
+
+  auto* instance = GetSingleton();
+  if (instance->m_prismaUI && instance->m_prismaUI->IsValid(instance->m_view)) {
+    SendToView(instance->m_prismaUI, instance->m_view, "onHookStats", result.dump().c_str());
+  }
 }
 
 void UIManager::OnSaveUnifiedConfig(const char* argument)
@@ -1861,6 +2488,7 @@ void UIManager::OnSaveUnifiedConfig(const char* argument)
 
     // Load existing config to preserve any fields not in the update
     json existingConfig;
+    AsyncFileWriter::GetSingleton()->Flush(path);
     if (std::filesystem::exists(path)) {
       try {
         std::ifstream existingFile(path);
@@ -1874,101 +2502,11 @@ void UIManager::OnSaveUnifiedConfig(const char* argument)
       existingConfig[key] = value;
     }
 
-    // Update hotkey in InputHandler if changed
-    if (newConfig.contains("hotkeyCode")) {
-      uint32_t keyCode = newConfig["hotkeyCode"].get<uint32_t>();
-      UpdateInputHandlerHotkey(keyCode);
-    }
-
-    // Update pause game on focus if changed
-    if (newConfig.contains("pauseGameOnFocus")) {
-      bool pauseGame = newConfig["pauseGameOnFocus"].get<bool>();
-      GetSingleton()->SetPauseGameOnFocus(pauseGame);
-    }
-
-    // Update XP settings in ProgressionManager if changed
-    ProgressionManager::XPSettings xpSettings;
-    xpSettings.learningMode     = SafeJsonValue<std::string>(newConfig, "learningMode", "perSchool");
-    xpSettings.globalMultiplier = static_cast<float>(SafeJsonValue<int>(newConfig, "xpGlobalMultiplier", 1));
-    xpSettings.multiplierDirect = SafeJsonValue<int>(newConfig, "xpMultiplierDirect", 100) / 100.0f;
-    xpSettings.multiplierSchool = SafeJsonValue<int>(newConfig, "xpMultiplierSchool", 50) / 100.0f;
-    xpSettings.multiplierAny    = SafeJsonValue<int>(newConfig, "xpMultiplierAny", 10) / 100.0f;
-    // XP caps (max contribution from each source)
-    xpSettings.capAny    = static_cast<float>(SafeJsonValue<int>(newConfig, "xpCapAny", 5));
-    xpSettings.capSchool = static_cast<float>(SafeJsonValue<int>(newConfig, "xpCapSchool", 15));
-    xpSettings.capDirect = static_cast<float>(SafeJsonValue<int>(newConfig, "xpCapDirect", 50));
-    // Tier XP requirements
-    xpSettings.xpNovice     = SafeJsonValue<int>(newConfig, "xpNovice", 100);
-    xpSettings.xpApprentice = SafeJsonValue<int>(newConfig, "xpApprentice", 200);
-    xpSettings.xpAdept      = SafeJsonValue<int>(newConfig, "xpAdept", 400);
-    xpSettings.xpExpert     = SafeJsonValue<int>(newConfig, "xpExpert", 800);
-    xpSettings.xpMaster     = SafeJsonValue<int>(newConfig, "xpMaster", 1500);
-    ProgressionManager::GetSingleton()->SetXPSettings(xpSettings);
-
-    // Update early learning settings in SpellEffectivenessHook if changed
-    if (newConfig.contains("earlySpellLearning") && !newConfig["earlySpellLearning"].is_null()) {
-      auto& elConfig = newConfig["earlySpellLearning"];
-      SpellEffectivenessHook::EarlyLearningSettings elSettings;
-      elSettings.enabled               = SafeJsonValue<bool>(elConfig, "enabled", true);
-      elSettings.unlockThreshold       = SafeJsonValue<float>(elConfig, "unlockThreshold", 25.0f);
-      elSettings.selfCastRequiredAt    = SafeJsonValue<float>(elConfig, "selfCastRequiredAt", 75.0f);
-      elSettings.selfCastXPMultiplier  = SafeJsonValue<float>(elConfig, "selfCastXPMultiplier", 150.0f) / 100.0f;
-      elSettings.binaryEffectThreshold = SafeJsonValue<float>(elConfig, "binaryEffectThreshold", 80.0f);
-      elSettings.modifyGameDisplay     = SafeJsonValue<bool>(elConfig, "modifyGameDisplay", true);
-      SpellEffectivenessHook::GetSingleton()->SetSettings(elSettings);
-
-      // Load configurable power steps if present
-      if (elConfig.contains("powerSteps") && !elConfig["powerSteps"].is_null() && elConfig["powerSteps"].is_array()) {
-        std::vector<SpellEffectivenessHook::PowerStep> steps;
-        for (const auto& stepJson : elConfig["powerSteps"]) {
-          if (stepJson.is_null())
-            continue;
-          SpellEffectivenessHook::PowerStep step;
-          step.progressThreshold = SafeJsonValue<float>(stepJson, "xp", 25.0f);
-          step.effectiveness     = SafeJsonValue<float>(stepJson, "power", 20.0f) / 100.0f;  // Convert % to 0-1
-          step.label             = SafeJsonValue<std::string>(stepJson, "label", "Stage");
-          steps.push_back(step);
-        }
-        if (!steps.empty()) {
-          SpellEffectivenessHook::GetSingleton()->SetPowerSteps(steps);
-        }
-      }
-    }
-
-    // Update SpellTomeHook settings if changed
-    if (newConfig.contains("spellTomeLearning") && !newConfig["spellTomeLearning"].is_null()) {
-      auto& tomeConfig = newConfig["spellTomeLearning"];
-      SpellTomeHook::Settings tomeSettings;
-      tomeSettings.enabled                   = SafeJsonValue<bool>(tomeConfig, "enabled", true);
-      tomeSettings.useProgressionSystem      = SafeJsonValue<bool>(tomeConfig, "useProgressionSystem", true);
-      tomeSettings.grantXPOnRead             = SafeJsonValue<bool>(tomeConfig, "grantXPOnRead", true);
-      tomeSettings.autoSetLearningTarget     = SafeJsonValue<bool>(tomeConfig, "autoSetLearningTarget", true);
-      tomeSettings.showNotifications         = SafeJsonValue<bool>(tomeConfig, "showNotifications", true);
-      tomeSettings.xpPercentToGrant          = SafeJsonValue<float>(tomeConfig, "xpPercentToGrant", 25.0f);
-      tomeSettings.tomeInventoryBoost        = SafeJsonValue<bool>(tomeConfig, "tomeInventoryBoost", true);
-      tomeSettings.tomeInventoryBoostPercent = SafeJsonValue<float>(tomeConfig, "tomeInventoryBoostPercent", 25.0f);
-      // Learning requirements
-      tomeSettings.requirePrereqs    = SafeJsonValue<bool>(tomeConfig, "requirePrereqs", true);
-      tomeSettings.requireAllPrereqs = SafeJsonValue<bool>(tomeConfig, "requireAllPrereqs", true);
-      tomeSettings.requireSkillLevel = SafeJsonValue<bool>(tomeConfig, "requireSkillLevel", false);
-      SpellTomeHook::GetSingleton()->SetSettings(tomeSettings);
-      logger::info("UIManager: Applied SpellTomeHook settings from save");
-    }
-
-    // Update notification settings if changed
-    if (newConfig.contains("notifications") && !newConfig["notifications"].is_null()) {
-      auto& notifConfig = newConfig["notifications"];
-      auto* castHandler = SpellCastHandler::GetSingleton();
-      castHandler->SetWeakenedNotificationsEnabled(
-          SafeJsonValue<bool>(notifConfig, "weakenedSpellNotifications", true));
-      castHandler->SetNotificationInterval(SafeJsonValue<float>(notifConfig, "weakenedSpellInterval", 10.0f));
-      logger::info("UIManager: Applied notification settings from save - interval: {}s",
-                   castHandler->GetNotificationInterval());
-    }
+    // Re-apply the sections this save changed, from the saved values
+    ApplyUnifiedConfig(WithDefaults(existingConfig));
 
     // Write merged config
-    std::ofstream file(path);
-    file << existingConfig.dump(2);  // Pretty print with 2 space indent
+    AsyncFileWriter::GetSingleton()->Write(path, existingConfig.dump(2));  // Pretty print with 2 space indent
 
     logger::info("UIManager: Unified config saved to {}", path.string());
 
@@ -2005,7 +2543,7 @@ void UIManager::SendClipboardContent(const std::string& content)
   }
 
   logger::info("UIManager: Sending clipboard content to UI ({} bytes)", content.size());
-  m_prismaUI->InteropCall(m_view, "onClipboardContent", content.c_str());
+  SendToView(m_prismaUI, m_view, "onClipboardContent", content.c_str());
 }
 
 void UIManager::NotifyCopyComplete(bool success)
@@ -2015,7 +2553,7 @@ void UIManager::NotifyCopyComplete(bool success)
   }
 
   std::string result = success ? "true" : "false";
-  m_prismaUI->InteropCall(m_view, "onCopyComplete", result.c_str());
+  SendToView(m_prismaUI, m_view, "onCopyComplete", result.c_str());
 }
 
 // =============================================================================
@@ -2049,9 +2587,9 @@ void UIManager::NotifyProgressUpdate(RE::FormID formId, float currentXP, float r
   update["unlocked"]   = progress.unlocked;  // Include unlocked status
 
   // PERFORMANCE: Use trace for frequent progress updates
-  logger::trace("UIManager: Sending progress update to UI - formId: {}, XP: {:.1f}/{:.1f}, unlocked: {}", ss.str(),
-                currentXP, requiredXP, progress.unlocked);
-  m_prismaUI->InteropCall(m_view, "onProgressUpdate", update.dump().c_str());
+  SL_LOG_TRACE(UI, "UIManager: Sending progress update to UI - formId: {}, XP: {:.1f}/{:.1f}, unlocked: {}", ss.str(),
+               currentXP, requiredXP, progress.unlocked);
+  SendToView(m_prismaUI, m_view, "onProgressUpdate", update.dump().c_str());
 }
 
 void UIManager::NotifyProgressUpdate(const std::string& formIdStr)
@@ -2086,7 +2624,7 @@ void UIManager::NotifySpellReady(RE::FormID formId)
   notify["formId"] = ss.str();
   notify["ready"]  = true;
 
-  m_prismaUI->InteropCall(m_view, "onSpellReady", notify.dump().c_str());
+  SendToView(m_prismaUI, m_view, "onSpellReady", notify.dump().c_str());
 }
 
 void UIManager::NotifySpellUnlocked(RE::FormID formId, bool success)
@@ -2101,7 +2639,7 @@ void UIManager::NotifySpellUnlocked(RE::FormID formId, bool success)
   notify["formId"]  = ss.str();
   notify["success"] = success;
 
-  m_prismaUI->InteropCall(m_view, "onSpellUnlocked", notify.dump().c_str());
+  SendToView(m_prismaUI, m_view, "onSpellUnlocked", notify.dump().c_str());
 }
 
 void UIManager::NotifyLearningTargetSet(const std::string& school, RE::FormID formId, const std::string& spellName)
@@ -2120,7 +2658,7 @@ void UIManager::NotifyLearningTargetSet(const std::string& school, RE::FormID fo
   notify["spellName"] = spellName;
 
   logger::info("UIManager: Notifying UI of learning target set: {} -> {} ({})", school, spellName, formIdStr);
-  m_prismaUI->InteropCall(m_view, "onLearningTargetSet", notify.dump().c_str());
+  SendToView(m_prismaUI, m_view, "onLearningTargetSet", notify.dump().c_str());
 
   // Also update the spell state to "learning" so canvas renderer shows learning visuals
   UpdateSpellState(formIdStr, "learning");
@@ -2154,7 +2692,7 @@ void UIManager::NotifyMainMenuLoaded()
   }
 
   logger::info("UIManager: Notifying UI - main menu loaded, resetting tree states");
-  m_prismaUI->InteropCall(m_view, "onResetTreeStates", "");
+  SendToView(m_prismaUI, m_view, "onResetTreeStates", "");
 }
 
 void UIManager::NotifySaveGameLoaded()
@@ -2168,7 +2706,7 @@ void UIManager::NotifySaveGameLoaded()
   }
 
   logger::info("UIManager: Notifying UI - save game loaded, refreshing player data");
-  m_prismaUI->InteropCall(m_view, "onSaveGameLoaded", "");
+  SendToView(m_prismaUI, m_view, "onSaveGameLoaded", "");
 }
 
 void UIManager::SendProgressData(const std::string& jsonData)
@@ -2177,7 +2715,7 @@ void UIManager::SendProgressData(const std::string& jsonData)
     return;
   }
 
-  m_prismaUI->InteropCall(m_view, "onProgressData", jsonData.c_str());
+  SendToView(m_prismaUI, m_view, "onProgressData", jsonData.c_str());
 }
 
 void UIManager::OnCopyToClipboard(const char* argument)
@@ -2287,11 +2825,12 @@ void UIManager::OnCheckLLM(const char* argument)
   }
 
   // Send result to UI
-  instance->m_prismaUI->InteropCall(instance->m_view, "onLLMStatus", result.dump().c_str());
+  SendToView(instance->m_prismaUI, instance->m_view, "onLLMStatus", result.dump().c_str());
 }
 
 void UIManager::OnLLMGenerate(const char* argument)
 {
+  SL_TRACE_SCOPE("UIManager::OnLLMGenerate");
   logger::info("UIManager: LLM Generate callback triggered (OpenRouter mode)");
 
   if (!argument || strlen(argument) == 0) {
@@ -2308,8 +2847,8 @@ void UIManager::OnLLMGenerate(const char* argument)
     std::string spellData   = request.value("spellData", "");
     std::string promptRules = request.value("promptRules", "");
 
-    // Override config from request if provided
-    auto& config = OpenRouterAPI::GetConfig();
+    // Per-request copy of the config - requests for other schools may still be running with theirs
+    OpenRouterAPI::Config config = OpenRouterAPI::GetConfig();
     if (request.contains("model") && !request["model"].get<std::string>().empty()) {
       config.model = request["model"].get<std::string>();
       logger::info("UIManager: Using model from request: {}", config.model);
@@ -2324,6 +2863,12 @@ void UIManager::OnLLMGenerate(const char* argument)
         config.apiKey = newKey;
       }
     }
+    config.maxRetries = SafeJsonValue<int>(request, "maxRetries", config.maxRetries);
+    if (request.contains("raceModels") && request["raceModels"].is_array()) {
+      config.raceModels = request["raceModels"].get<std::vector<std::string>>();
+    }
+    int maxConcurrent = SafeJsonValue<int>(request, "maxConcurrentRequests", config.maxConcurrentRequests);
+    LLMScheduler::GetSingleton()->SetConcurrencyLimit(static_cast<size_t>(std::max(maxConcurrent, 1)));
 
     // Get tree generation settings
     bool allowMultiplePrereqs = request.value("allowMultiplePrereqs", true);
@@ -2340,17 +2885,10 @@ void UIManager::OnLLMGenerate(const char* argument)
       errorResponse["status"]  = "error";
       errorResponse["school"]  = schoolName;
       errorResponse["message"] = "API key not configured - check Settings";
-      instance->m_prismaUI->InteropCall(instance->m_view, "onLLMQueued", errorResponse.dump().c_str());
+      SendToView(instance->m_prismaUI, instance->m_view, "onLLMQueued", errorResponse.dump().c_str());
       return;
     }
 
-    // Notify UI that we're processing
-    json queuedResponse;
-    queuedResponse["status"]  = "queued";
-    queuedResponse["school"]  = schoolName;
-    queuedResponse["message"] = "Sending to OpenRouter...";
-    instance->m_prismaUI->InteropCall(instance->m_view, "onLLMQueued", queuedResponse.dump().c_str());
-
     // Build prompts
     std::string systemPrompt =
         R"(You are a Skyrim spell tree architect. Your task is to create a logical spell learning tree for a single magic school. You MUST return ONLY valid JSON - no explanations, no markdown code blocks, just raw JSON.
@@ -2393,7 +2931,7 @@ Return ONLY this JSON structure:
 6. NEVER put a spell as its own prerequisite (no self-references!)
 7. Choose layoutStyle based on how you structured the tree
 8. AVOID long linear chains (A->B->C->D->...) - prefer branching trees where nodes have 2-3 children
-9. Group similar spell variants (e.g. Locust I, II, III) under a common parent rather than in a chain
+9. Spells sharing a "familyId" are variants of one spell (e.g. Locust I, II, III) - put them under a common parent rather than in a chain
 10. Return raw JSON ONLY - no markdown, no explanations
 11. EVERY spell MUST be reachable from the root! There must be a valid unlock path from root to EVERY spell
 12. NO PREREQUISITE CYCLES! Never create circular dependencies (A->B->C->A). The tree must be a DAG (directed acyclic graph)
@@ -2428,54 +2966,224 @@ You have more freedom in tree design:
     // Check request type
     bool isCorrection            = request.value("isCorrection", false);
     bool isColorSuggestion       = request.value("isColorSuggestion", false);
+    bool isRepair                = SafeJsonValue<bool>(request, "isRepair", false);
     std::string correctionPrompt = request.value("correctionPrompt", "");
 
-    std::string userPrompt;
+    std::vector<std::string> userPrompts;
+    std::shared_ptr<PromptBuilder::Plan> plan;
+    std::shared_ptr<TreeRepair::Analysis> repair;
     std::string effectiveSystemPrompt = systemPrompt;
 
     if (isColorSuggestion) {
       // Color suggestion mode - simple prompt, no system context needed
       effectiveSystemPrompt = "You are a helpful assistant. Respond only with valid JSON.";
-      userPrompt            = promptRules;  // The full prompt is in promptRules for color suggestions
+      userPrompts.push_back(promptRules);  // The full prompt is in promptRules for color suggestions
       logger::info("UIManager: Color suggestion request");
+    } else if (isRepair) {
+      // Repair mode - only the invalid region of the previous tree goes back to the model
+      std::string originalResponse = SafeJsonValue<std::string>(request, "originalResponse", "");
+      std::string error;
+      repair        = std::make_shared<TreeRepair::Analysis>();
+      bool analysed = TreeRepair::Analyze(schoolName, originalResponse, spellData, *repair, error);
+      if (!analysed || repair->Valid()) {
+        json result;
+        result["hasResponse"] = true;
+        result["school"]      = schoolName;
+        result["cancelled"]   = false;
+        result["success"]     = analysed ? 1 : 0;
+        result["response"]    = analysed ? originalResponse : error;
+        if (analysed) {
+          result["repair"] = repair->ToJson();
+        }
+        logger::info("UIManager: Repair request for {} - {}", schoolName, analysed ? "nothing to repair" : error);
+
+        SKSE::GetTaskInterface()->AddTask([payload = result.dump()]() {
+          auto* instance = GetSingleton();
+          if (instance->m_prismaUI && instance->m_prismaUI->IsValid(instance->m_view)) {
+            SendToView(instance->m_prismaUI, instance->m_view, "onLLMPollResult", payload.c_str());
+          }
+        });
+        return;
+      }
+
+      effectiveSystemPrompt = TreeRepair::GetSystemPrompt();
+      userPrompts.push_back(TreeRepair::BuildRepairPrompt(*repair, promptRules));
+      logger::info("UIManager: Repair request for {}: {} spell(s) to repair ({} cycle(s)), {} downstream, "
+                   "{} attachment points, {} of {} reachable",
+                   schoolName, repair->region.size(), repair->cycles.size(), repair->downstream.size(),
+                   repair->neighborhood.size(), repair->reachableCount, repair->nodes.size());
     } else if (isCorrection && !correctionPrompt.empty()) {
       // Correction mode - use the correction prompt directly
-      userPrompt = correctionPrompt;
+      userPrompts.push_back(correctionPrompt);
       logger::info("UIManager: Correction request for {}", schoolName);
     } else {
-      // Normal generation mode
-      userPrompt = "Create a spell learning tree for the " + schoolName + " school of magic.\n\n";
+      // Normal generation mode - spell data as a compact table, split into parts when the
+      // school does not fit the token budget or the response limit
+      PromptBuilder::Limits limits;
+      limits.tokenBudget     = static_cast<size_t>(std::max(config.promptTokenBudget, 1000));
+      limits.maxOutputTokens = config.maxTokens;
+
+      plan = std::make_shared<PromptBuilder::Plan>();
+      if (PromptBuilder::BuildPlan(schoolName, spellData, limits, *plan)) {
+        for (size_t part = 0; part < plan->parts.size(); ++part) {
+          userPrompts.push_back(PromptBuilder::BuildUserPrompt(*plan, part, promptRules));
+        }
+        logger::info("UIManager: {} prompt: {} spells in {} part(s), spell data {} -> {} bytes, ~{} -> ~{} tokens",
+                     schoolName, plan->SpellCount(), plan->parts.size(), plan->jsonBytes, plan->compactBytes,
+                     plan->jsonTokens, plan->compactTokens);
+      } else {
+        // Not a spell array - pass it through as received
+        plan.reset();
+        std::string userPrompt = "Create a spell learning tree for the " + schoolName + " school of magic.\n\n";
+        if (!promptRules.empty()) {
+          userPrompt += "## USER RULES\n" + promptRules + "\n\n";
+        }
+        userPrompt += "## SPELL DATA FOR " + schoolName + "\n\n" + spellData;
+        userPrompts.push_back(std::move(userPrompt));
+      }
+    }
+
+    logger::info("UIManager: Sending to OpenRouter, system prompt length: {}, user prompt length: {}, parts: {}",
+                 effectiveSystemPrompt.length(), userPrompts.front().length(), userPrompts.size());
 
-      if (!promptRules.empty()) {
-        userPrompt += "## USER RULES\n" + promptRules + "\n\n";
+    // Notify UI that we're processing
+    json queuedResponse;
+    queuedResponse["status"]  = "queued";
+    queuedResponse["school"]  = schoolName;
+    queuedResponse["message"] = userPrompts.size() > 1
+                                    ? std::format("Sending to OpenRouter in {} parts...", userPrompts.size())
+                                    : std::string("Sending to OpenRouter...");
+    if (plan) {
+      queuedResponse["prompt"] = plan->StatsToJson();
+    }
+    SendToView(instance->m_prismaUI, instance->m_view, "onLLMQueued", queuedResponse.dump().c_str());
+
+    auto generation  = std::make_shared<LLMGeneration>(schoolName, plan, repair, !isColorSuggestion,
+                                                       userPrompts.size());
+    int maxTokens    = config.maxTokens;
+    bool bypassCache = SafeJsonValue<bool>(request, "bypassCache", false);
+    if (config.responseCache) {
+      auto maxBytes = static_cast<uint64_t>(std::max(config.responseCacheMaxMB, 1)) * 1024 * 1024;
+      ThreadPool::GetSingleton()->SubmitBlocking([maxBytes]() { LLMResponseCache::SetMaxBytes(maxBytes); });
+    }
+
+    // A raced answer may come from any of the models - they share cache entries as a set
+    std::string cacheModel = config.model;
+    for (const auto& model : config.raceModels) {
+      cacheModel += "," + model;
+    }
+    bool treeResponse   = !isColorSuggestion;
+    bool repairResponse = static_cast<bool>(repair);
+    OpenRouterAPI::ResponseValidator accept = [schoolName, treeResponse,
+                                               repairResponse](const OpenRouterAPI::Response& response) {
+      return IsUsableResponse(response.content, schoolName, treeResponse, repairResponse);
+    };
+
+    for (size_t part = 0; part < userPrompts.size(); ++part) {
+      std::string tag = userPrompts.size() > 1 ? std::format("{} {}/{}", schoolName, part + 1, userPrompts.size())
+                                               : schoolName;
+
+      std::string cacheKey;
+      if (config.responseCache) {
+        cacheKey = LLMResponseCache::MakeKey(cacheModel, effectiveSystemPrompt, userPrompts[part], maxTokens);
       }
 
-      userPrompt += "## SPELL DATA FOR " + schoolName + "\n\n" + spellData;
-    }
+      // Tree responses stream their nodes to the panel as they are generated
+      std::shared_ptr<LLMNodeStream> nodeStream;
+      OpenRouterAPI::DeltaCallback onDelta;
+      if (!isColorSuggestion && !repair) {
+        nodeStream = std::make_shared<LLMNodeStream>(schoolName);
+        onDelta    = [nodeStream](std::string_view delta) { nodeStream->Feed(delta); };
+      }
 
-    logger::info("UIManager: Sending to OpenRouter, system prompt length: {}, user prompt length: {}",
-                 effectiveSystemPrompt.length(), userPrompt.length());
+      LLMScheduler::Request llmRequest;
+      llmRequest.tag          = tag;
+      llmRequest.config       = config;
+      llmRequest.systemPrompt = effectiveSystemPrompt;
+      llmRequest.userPrompt   = std::move(userPrompts[part]);
+      llmRequest.onDelta      = std::move(onDelta);
+      llmRequest.accept       = accept;
+
+      // Queue the request - runs alongside the other schools up to the concurrency limit
+      auto submit = [instance, generation, part, nodeStream, cacheKey, maxTokens, schoolName](
+                        LLMScheduler::Request llmRequest) {
+        LLMScheduler::GetSingleton()->Submit(
+            std::move(llmRequest),
+            [instance, generation, part, nodeStream, cacheKey, maxTokens](const OpenRouterAPI::Response& response,
+                                                                          const LLMScheduler::Metrics& metrics) {
+              // Last partial batch before the complete result
+              if (nodeStream) {
+                if (auto payload = nodeStream->TakePayload(); !payload.empty()) {
+                  SendToView(instance->m_prismaUI, instance->m_view, "onLLMStreamNodes", payload.c_str());
+                }
+              }
 
-    // Send async request to OpenRouter
-    OpenRouterAPI::SendPromptAsync(
-        effectiveSystemPrompt, userPrompt, [instance, schoolName](const OpenRouterAPI::Response& response) {
-          json result;
+              if (response.success && !cacheKey.empty()) {
+                LLMResponseCache::Entry entry{response.content, metrics.totalMs, response.promptTokens,
+                                              response.completionTokens};
+                ThreadPool::GetSingleton()->SubmitBlocking(
+                    [cacheKey, model = metrics.model, maxTokens, entry = std::move(entry)]() {
+                      LLMResponseCache::Store(cacheKey, model, maxTokens, entry);
+                    });
+              }
+              generation->OnPartComplete(part, response, metrics.ToJson());
+            },
+            [instance, schoolName](int attempt, int httpStatus, std::chrono::milliseconds delay) {
+              json status;
+              status["school"]     = schoolName;
+              status["attempt"]    = attempt;
+              status["httpStatus"] = httpStatus;
+              status["delayMs"]    = delay.count();
+              status["message"]    = std::format("{} (HTTP {}), retrying in {}s...",
+                                                 httpStatus == 429 ? "Rate limited" : "Server error", httpStatus,
+                                                 (delay.count() + 999) / 1000);
+              SendToView(instance->m_prismaUI, instance->m_view, "onLLMRequestStatus", status.dump().c_str());
+            });
+      };
+
+      if (cacheKey.empty() || bypassCache) {
+        submit(std::move(llmRequest));
+        continue;
+      }
 
-          if (response.success) {
-            result["hasResponse"] = true;
-            result["success"]     = 1;
-            result["response"]    = response.content;
-            logger::info("UIManager: OpenRouter success for {}, response length: {}", schoolName,
-                         response.content.length());
-          } else {
-            result["hasResponse"] = true;
-            result["success"]     = 0;
-            result["response"]    = response.error;
-            logger::error("UIManager: OpenRouter error for {}: {}", schoolName, response.error);
-          }
+      // Same model, prompts and maxTokens as an earlier request - answer from disk. The lookup reads the
+      // entry file, so it runs on the pool and only queues the live request on a miss.
+      ThreadPool::GetSingleton()->SubmitBlocking([generation, part, tag, cacheKey, model = config.model,
+                                                  llmRequest = std::move(llmRequest), submit]() mutable {
+        auto lookupStart = std::chrono::steady_clock::now();
+        auto cached      = LLMResponseCache::Lookup(cacheKey);
+        if (!cached) {
+          submit(std::move(llmRequest));
+          return;
+        }
 
-          instance->m_prismaUI->InteropCall(instance->m_view, "onLLMPollResult", result.dump().c_str());
-        });
+        LLMScheduler::Metrics metrics;
+        metrics.tag              = tag;
+        metrics.model            = model;
+        metrics.totalMs          = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::steady_clock::now() - lookupStart)
+                                       .count();
+        metrics.promptTokens     = cached->promptTokens;
+        metrics.completionTokens = cached->completionTokens;
+
+        json metricsJson      = metrics.ToJson();
+        metricsJson["cached"] = true;
+        metricsJson["liveMs"] = cached->liveMs;
+
+        OpenRouterAPI::Response response;
+        response.success          = true;
+        response.content          = std::move(cached->content);
+        response.promptTokens     = cached->promptTokens;
+        response.completionTokens = cached->completionTokens;
+        logger::info("UIManager: Cached response for {} ({} ms)", tag, metrics.totalMs);
+
+        // Delivered like a live result, on the game thread
+        SKSE::GetTaskInterface()->AddTask(
+            [generation, part, response = std::move(response), metricsJson = std::move(metricsJson)]() {
+              generation->OnPartComplete(part, response, metricsJson);
+            });
+      });
+    }
 
   } catch (const std::exception& e) {
     logger::error("UIManager: LLM Generate exception: {}", e.what());
@@ -2484,7 +3192,7 @@ You have more freedom in tree design:
     errorResult["hasResponse"] = true;
     errorResult["success"]     = 0;
     errorResult["response"]    = std::string("Exception: ") + e.what();
-    instance->m_prismaUI->InteropCall(instance->m_view, "onLLMPollResult", errorResult.dump().c_str());
+    SendToView(instance->m_prismaUI, instance->m_view, "onLLMPollResult", errorResult.dump().c_str());
   }
 }
 
@@ -2497,6 +3205,8 @@ void UIManager::OnPollLLMResponse(const char* argument)
   json result;
   result["hasResponse"] = false;
 
+  // A response that was read last poll may still be queued for clearing
+  AsyncFileWriter::GetSingleton()->Flush(responsePath);
   if (std::filesystem::exists(responsePath)) {
     try {
       std::ifstream file(responsePath);
@@ -2526,9 +3236,7 @@ void UIManager::OnPollLLMResponse(const char* argument)
           logger::info("UIManager: Found LLM response, success={}, length={}", success, response.length());
 
           // Clear the response file after reading
-          std::ofstream clearFile(responsePath);
-          clearFile << "";
-          clearFile.close();
+          AsyncFileWriter::GetSingleton()->Write(responsePath, "");
         } else {
           logger::warn("UIManager: Response missing delimiter, content: {}", content.substr(0, 50));
         }
@@ -2538,7 +3246,7 @@ void UIManager::OnPollLLMResponse(const char* argument)
     }
   }
 
-  instance->m_prismaUI->InteropCall(instance->m_view, "onLLMPollResult", result.dump().c_str());
+  SendToView(instance->m_prismaUI, instance->m_view, "onLLMPollResult", result.dump().c_str());
 }
 
 // =============================================================================
@@ -2561,7 +3269,7 @@ void UIManager::OnLoadLLMConfig(const char* argument)
   result["model"]     = config.model;
   result["maxTokens"] = config.maxTokens;
 
-  instance->m_prismaUI->InteropCall(instance->m_view, "onLLMConfigLoaded", result.dump().c_str());
+  SendToView(instance->m_prismaUI, instance->m_view, "onLLMConfigLoaded", result.dump().c_str());
 
   logger::info("UIManager: LLM config sent to UI, hasKey: {}", !config.apiKey.empty());
 }
@@ -2601,7 +3309,7 @@ void UIManager::OnSaveLLMConfig(const char* argument)
     logger::error("UIManager: Failed to save LLM config: {}", e.what());
   }
 
-  instance->m_prismaUI->InteropCall(instance->m_view, "onLLMConfigSaved", result.dump().c_str());
+  SendToView(instance->m_prismaUI, instance->m_view, "onLLMConfigSaved", result.dump().c_str());
 }
 
 void UIManager::OnLogMessage(const char* argument)
@@ -2628,125 +3336,247 @@ void UIManager::OnLogMessage(const char* argument)
 }
 
 // =============================================================================
-// PROCEDURAL PYTHON GENERATION
+// PROCEDURAL TREE GENERATION
 // =============================================================================
 
-void UIManager::OnProceduralPythonGenerate(const char* argument)
+std::filesystem::path UIManager::FindPythonTreeBuilder()
 {
-  logger::info("UIManager: ProceduralPythonGenerate callback triggered");
+  // Tool location relative to game Data folder, then the development location
+  for (const char* candidate :
+       {"Data/SKSE/Plugins/SpellLearning/SpellTreeBuilder/build_tree.py", "SpellTreeBuilder/build_tree.py"}) {
+    if (std::filesystem::exists(candidate)) {
+      return candidate;
+    }
+  }
+  return {};
+}
 
-  auto* instance = GetSingleton();
-  if (!instance || !instance->m_prismaUI)
-    return;
+// Older addon releases only have the temp-file CLI (-i/-o/--config); argparse rejects --stdio there
+static bool PythonBuilderSupportsStdio(const std::filesystem::path& script)
+{
+  std::ifstream file(script, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str().find("--stdio") != std::string::npos;
+}
 
-  auto startTime = std::chrono::high_resolution_clock::now();
+std::string UIManager::RunPythonTreeBuilder(const nlohmann::json& spells, const nlohmann::json& config,
+                                            std::stop_token stopToken)
+{
+  auto pythonScript = FindPythonTreeBuilder();
+  if (pythonScript.empty()) {
+    throw std::runtime_error("Python addon (SpellTreeBuilder) is not installed");
+  }
 
-  try {
-    // Parse incoming request
-    nlohmann::json request = nlohmann::json::parse(argument);
-    auto spells            = request.value("spells", nlohmann::json::array());
-    auto config            = request.value("config", nlohmann::json::object());
+  ProcessRunner::Options options;
+  options.timeout = std::chrono::seconds(SafeJsonValue<int>(config, "process_timeout_seconds", 600));
 
-    logger::info("UIManager: Processing {} spells with Python", spells.size());
+  options.onProgress = [](std::string_view message) {
+    nlohmann::json progress;
+    progress["message"] = message;
 
-    // Get paths
-    auto dataPath = std::filesystem::path("Data/SKSE/Plugins/SpellLearning");
-    std::filesystem::create_directories(dataPath);
+    SKSE::GetTaskInterface()->AddTask([payload = progress.dump()]() {
+      auto* instance = GetSingleton();
+      if (instance->m_prismaUI && instance->m_prismaUI->IsValid(instance->m_view)) {
+        SendToView(instance->m_prismaUI, instance->m_view, "onProceduralPythonProgress", payload.c_str());
+      }
+    });
+  };
 
-    auto inputPath  = dataPath / "procedural_input.json";
-    auto outputPath = dataPath / "procedural_output.json";
+  // --stdio: request JSON on stdin, tree JSON on stdout, "@progress <text>" lines while working
+  bool useStdio = PythonBuilderSupportsStdio(pythonScript);
+
+  // Own files per run - a cancelled build may still be running and cleaning up its files
+  static std::atomic<uint32_t> s_runCounter{0};
+  auto runId      = std::to_string(++s_runCounter);
+  auto dataPath   = std::filesystem::path("Data/SKSE/Plugins/SpellLearning");
+  auto inputPath  = dataPath / ("procedural_input_" + runId + ".json");
+  auto outputPath = dataPath / ("procedural_output_" + runId + ".json");
+  auto configPath = dataPath / ("procedural_config_" + runId + ".json");
+
+  if (useStdio) {
+    nlohmann::json request;
+    request["spells"] = spells;
+    request["config"] = config;
+
+    options.args  = {"python", "-u", pythonScript.string(), "--stdio"};
+    options.input = request.dump();
+    logger::info("UIManager: Executing python \"{}\" --stdio ({} bytes input, timeout {}s)", pythonScript.string(),
+                 options.input.size(), options.timeout.count() / 1000);
+  } else {
+    // Temp-file CLI: spells and config in, tree out
+    std::filesystem::create_directories(dataPath);
+    std::filesystem::remove(outputPath);
 
-    // Write input file (just the spells array wrapped for the tool)
     nlohmann::json inputData;
     inputData["spells"] = spells;
-
     {
       std::ofstream inputFile(inputPath);
-      if (!inputFile.is_open()) {
+      if (!inputFile.is_open() || !(inputFile << inputData.dump())) {
         throw std::runtime_error("Failed to create input file");
       }
-      inputFile << inputData.dump();
     }
-
-    // Write config file (full config including LLM options, shape, etc.)
-    auto configPath = dataPath / "procedural_config.json";
     {
       std::ofstream configFile(configPath);
-      if (!configFile.is_open()) {
+      if (!configFile.is_open() || !(configFile << config.dump())) {
         throw std::runtime_error("Failed to create config file");
       }
-      configFile << config.dump();
-      logger::info("UIManager: Config written: {}", config.dump().substr(0, 200));
     }
 
-    // Build Python command
-    // Tool location relative to game Data folder
-    std::string pythonScript = "Data/SKSE/Plugins/SpellLearning/SpellTreeBuilder/build_tree.py";
+    options.args = {"python", "-u", pythonScript.string(), "-i",      inputPath.string(),
+                    "-o",     outputPath.string(), "--config", configPath.string()};
+    logger::info("UIManager: Executing python \"{}\" -i/-o/--config (addon without --stdio, timeout {}s)",
+                 pythonScript.string(), options.timeout.count() / 1000);
+  }
+
+  auto result = ProcessRunner::Run(options, stopToken);
 
-    // Check if the tool exists in the expected location
-    if (!std::filesystem::exists(pythonScript)) {
-      // Try alternate location (development)
-      pythonScript = "SpellTreeBuilder/build_tree.py";
+  std::string treeJson;
+  if (useStdio) {
+    treeJson = std::move(result.output);
+  } else {
+    if (result.Succeeded()) {
+      std::ifstream outputFile(outputPath);
+      std::stringstream buffer;
+      buffer << outputFile.rdbuf();
+      treeJson = buffer.str();
     }
 
-    // Build command line with config file
-    std::string cmd = "python \"" + pythonScript + "\"";
-    cmd += " -i \"" + inputPath.string() + "\"";
-    cmd += " -o \"" + outputPath.string() + "\"";
-    cmd += " --config \"" + configPath.string() + "\"";
+    std::error_code ec;
+    std::filesystem::remove(inputPath, ec);
+    std::filesystem::remove(outputPath, ec);
+    std::filesystem::remove(configPath, ec);
+  }
 
-    logger::info("UIManager: Executing: {}", cmd);
+  if (!result.Succeeded()) {
+    if (!result.errorOutput.empty()) {
+      logger::error("UIManager: Python stderr:\n{}", result.errorOutput);
+    }
+    throw std::runtime_error("Python tree builder " + result.Describe());
+  }
+  if (treeJson.find_first_not_of(" \t\r\n") == std::string::npos) {
+    throw std::runtime_error("Python tree builder returned no output");
+  }
 
-    // Execute Python
-    int result = std::system(cmd.c_str());
+  return treeJson;
+}
 
-    if (result != 0) {
-      throw std::runtime_error("Python script failed with code " + std::to_string(result));
-    }
+void UIManager::OnProceduralPythonGenerate(const char* argument)
+{
+  logger::info("UIManager: ProceduralPythonGenerate callback triggered");
 
-    // Read output
-    if (!std::filesystem::exists(outputPath)) {
-      throw std::runtime_error("Python did not create output file");
-    }
+  auto* instance = GetSingleton();
+  if (!instance || !instance->m_prismaUI)
+    return;
 
-    std::string treeJson;
-    {
-      std::ifstream outputFile(outputPath);
-      if (!outputFile.is_open()) {
-        throw std::runtime_error("Failed to read output file");
+  std::string request = argument ? argument : "";
+
+  // A new request replaces a build that is still running
+  std::stop_token stopToken;
+  {
+    std::lock_guard<std::mutex> lock(instance->m_treeBuildMutex);
+    instance->m_treeBuildStop.request_stop();
+    instance->m_treeBuildStop = std::stop_source();
+    stopToken                 = instance->m_treeBuildStop.get_token();
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  // Panel response for one build - the tree, or the error. The stop token is not handed to the pool: a build
+  // cancelled before it starts still reports back.
+  auto build = [stopToken, startTime](const nlohmann::json& spells, const nlohmann::json& config, bool usePython) {
+    nlohmann::json response;
+    try {
+      if (stopToken.stop_requested()) {
+        throw std::runtime_error("Cancelled before the build started");
       }
-      std::stringstream buffer;
-      buffer << outputFile.rdbuf();
-      treeJson = buffer.str();
+
+      std::string treeJson;
+      if (usePython) {
+        logger::info("UIManager: Processing {} spells with Python", spells.size());
+        treeJson = RunPythonTreeBuilder(spells, config, stopToken);
+      } else {
+        logger::info("UIManager: Processing {} spells with native tree builder", spells.size());
+        treeJson = TreeBuilder::BuildTrees(spells, TreeBuilder::ParseBuildConfig(config)).dump();
+      }
+
+      auto elapsedMs =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+      double elapsed = elapsedMs / 1000.0;
+
+      response["success"]  = true;
+      response["treeData"] = std::move(treeJson);
+      response["elapsed"]  = elapsed;
+
+      logger::info("UIManager: Procedural generation completed in {:.2f}s", elapsed);
+    } catch (const std::exception& e) {
+      logger::error("UIManager: Procedural generation failed: {}", e.what());
+
+      response["success"]   = false;
+      response["error"]     = e.what();
+      response["cancelled"] = stopToken.stop_requested();
     }
+    return response.dump();
+  };
 
-    // Calculate elapsed time
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() / 1000.0;
+  // Game thread
+  auto sendResult = [](std::string payload) {
+    auto* instance = GetSingleton();
+    if (instance->m_prismaUI && instance->m_prismaUI->IsValid(instance->m_view)) {
+      SendToView(instance->m_prismaUI, instance->m_view, "onProceduralPythonComplete", payload.c_str());
+    }
+  };
 
-    // Clean up temp files
-    std::filesystem::remove(inputPath);
-    std::filesystem::remove(outputPath);
-    std::filesystem::remove(configPath);
+  // Parsing and the native builder are CPU work. The Python addon waits on its child process for up to
+  // process_timeout_seconds, so that build moves to the blocking lane instead of holding a CPU worker.
+  ThreadPool::GetSingleton()->Submit([request = std::move(request), build, sendResult]() {
+    nlohmann::json spells;
+    nlohmann::json config;
+    try {
+      nlohmann::json parsed = nlohmann::json::parse(request);
+      spells                = parsed.value("spells", nlohmann::json::array());
+      config                = parsed.value("config", nlohmann::json::object());
+    } catch (const std::exception& e) {
+      logger::error("UIManager: Procedural generation failed: {}", e.what());
 
-    // Send success response
-    nlohmann::json response;
-    response["success"]  = true;
-    response["treeData"] = treeJson;
-    response["elapsed"]  = elapsed;
+      nlohmann::json response;
+      response["success"] = false;
+      response["error"]   = e.what();
+      ThreadPool::RunOnGameThread([sendResult, payload = response.dump()]() { sendResult(payload); });
+      return;
+    }
 
-    logger::info("UIManager: Python procedural generation completed in {:.2f}s", elapsed);
-    instance->m_prismaUI->InteropCall(instance->m_view, "onProceduralPythonComplete", response.dump().c_str());
+    // LLM auto-configure / LLM groups are only implemented by the Python addon.
+    // Everything else is built natively, so Python is no longer required.
+    bool wantsLLM  = config.value("/llm_auto_configure/enabled"_json_pointer, false) ||
+                    config.value("/llm_groups/enabled"_json_pointer, false);
+    bool usePython = config.value("builder", "") == "python" || (wantsLLM && !FindPythonTreeBuilder().empty());
 
-  } catch (const std::exception& e) {
-    logger::error("UIManager: Python procedural generation failed: {}", e.what());
+    if (usePython) {
+      ThreadPool::GetSingleton()->SubmitBlocking(
+          [build, sendResult, spells = std::move(spells), config = std::move(config)]() {
+            ThreadPool::RunOnGameThread([sendResult, payload = build(spells, config, true)]() { sendResult(payload); });
+          });
+      return;
+    }
 
-    nlohmann::json response;
-    response["success"] = false;
-    response["error"]   = e.what();
+    if (wantsLLM) {
+      logger::warn("UIManager: LLM tree options need the Python addon - building without them");
+    }
+    ThreadPool::RunOnGameThread([sendResult, payload = build(spells, config, false)]() { sendResult(payload); });
+  });
+}
 
-    instance->m_prismaUI->InteropCall(instance->m_view, "onProceduralPythonComplete", response.dump().c_str());
-  }
+void UIManager::OnProceduralPythonCancel(const char* argument)
+{
+  logger::info("UIManager: ProceduralPythonCancel callback triggered");
+
+  auto* instance = GetSingleton();
+  std::lock_guard<std::mutex> lock(instance->m_treeBuildMutex);
+  instance->m_treeBuildStop.request_stop();
 }
 
 // =============================================================================
@@ -2774,5 +3604,5 @@ void UIManager::NotifyISLDetectionStatus()
   std::string js = detected ? "true" : "false";
 
   logger::info("UIManager: Notifying UI of DEST detection status: {}", detected ? "Detected" : "Not Detected");
-  m_prismaUI->InteropCall(m_view, "onDESTDetectionUpdate", js.c_str());
+  SendToView(m_prismaUI, m_view, "onDESTDetectionUpdate", js.c_str());
 }